@@ -29,18 +29,56 @@
 #include <ghoul/glm.h>
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/csvreader.h>
+#include <cstddef>
 #include <filesystem>
+#include <future>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace openspace::dataloader {
 
+/**
+ * A non-owning view of the columns of a Dataset. All data of the entries is stored in
+ * contiguous arrays, one for the positions, one for each data column, and a single
+ * string that contains all comments back to back. A view is invalidated by any change
+ * to the Dataset that it was created from.
+ */
+struct DatasetView {
+    /// The positions of all entries
+    std::span<const glm::vec3> positions;
+
+    /// The data columns, where `values[v][i]` is the value of variable `v` for entry `i`
+    std::vector<std::span<const float>> values;
+
+    /// The comment of entry `i` is located at `[commentOffsets[i], commentOffsets[i+1])`
+    /// in the #comments. If no entry has a comment, the #commentOffsets are empty
+    std::string_view comments;
+    std::span<const uint64_t> commentOffsets;
+
+    size_t nEntries() const;
+
+    /**
+     * Returns the comment of the entry with the provided \p index, or `std::nullopt` if
+     * the entry does not have a comment.
+     *
+     * \param index The index of the entry whose comment should be returned
+     * \return The comment of the entry or `std::nullopt` if it does not have a comment
+     */
+    std::optional<std::string_view> comment(size_t index) const;
+};
+
 /**
  * A dataset representing objects with positions and various other data columns.
  * Based on the SPECK format originally used for the digital universe datasets.
  * Mostly used for point-data.
  *
+ * The entries are stored in columns rather than rows (see DatasetView), so that a
+ * dataset with many points does not require any per-entry allocations and the columns
+ * can be read from and written to the cache files in one piece.
+ *
  * The read data files may also have associated texture values to be used for the
  * points.
  */
@@ -60,18 +98,58 @@ struct Dataset {
     int textureDataIndex = -1;
     int orientationDataIndex = -1;
 
-    struct Entry {
-        glm::vec3 position = glm::vec3(0.f);
-        std::vector<float> data;
-        std::optional<std::string> comment;
-    };
-    std::vector<Entry> entries;
+    /// The positions of all entries
+    std::vector<glm::vec3> positions;
+
+    /// The data columns, where `values[v][i]` is the value of variable `v` for entry `i`
+    std::vector<std::vector<float>> values;
+
+    /// The comment of entry `i` is located at `[commentOffsets[i], commentOffsets[i+1])`
+    /// in the #comments. If no entry has a comment, the #commentOffsets are empty
+    std::string comments;
+    std::vector<uint64_t> commentOffsets;
 
     /// This variable can be used to get an understanding of the world scale size of
     /// the dataset
     float maxPositionComponent = 0.f;
 
     bool isEmpty() const;
+    size_t nEntries() const;
+    std::optional<std::string_view> comment(size_t index) const;
+    DatasetView view() const;
+
+    /**
+     * Adds a new entry to the end of the dataset. The first entry that is added to an
+     * empty dataset determines the number of data columns.
+     *
+     * \param position The position of the new entry
+     * \param data The values of the new entry, one for each data column
+     * \param comment The comment of the new entry, if it has one
+     *
+     * \pre \p data must contain one value for each data column
+     */
+    void addEntry(const glm::vec3& position, std::span<const float> data,
+        std::optional<std::string_view> comment = std::nullopt);
+
+    /**
+     * Adds all entries of the \p other dataset to the end of this dataset. Only the
+     * entries are added, the variables and textures of the \p other dataset are
+     * ignored.
+     *
+     * \param other The dataset whose entries are added
+     *
+     * \pre \p other must have the same number of data columns as this dataset
+     */
+    void append(const Dataset& other);
+
+    /**
+     * Removes the entry with the provided \p index from the dataset.
+     *
+     * \param index The index of the entry that should be removed
+     *
+     * \pre \p index must be smaller than the number of entries
+     */
+    void removeEntry(size_t index);
 
     int index(std::string_view variableName) const;
     bool normalizeVariable(std::string_view variableName);
@@ -79,16 +157,86 @@ struct Dataset {
     glm::vec2 findValueRange(std::string_view variableName) const;
 };
 
+/**
+ * A set of labels, each consisting of a position, an optional identifier, and a text.
+ * The identifiers and texts of all labels are stored back to back in a single string
+ * (#strings) that the entries refer to, so that the labels do not require any per-entry
+ * allocations.
+ */
 struct Labelset {
     int textColorIndex = -1;
 
     struct Entry {
         glm::vec3 position = glm::vec3(0.f);
-        std::string identifier;
-        std::string text;
+        /// The identifier starts at this offset into the #strings and is directly
+        /// followed by the text
+        uint32_t offset = 0;
+        uint16_t identifierLength = 0;
+        uint16_t textLength = 0;
         bool isEnabled = true;
     };
     std::vector<Entry> entries;
+
+    /// The identifiers and texts of all entries
+    std::string strings;
+
+    /**
+     * The glyphs of all texts laid out with a specific font. The layout only depends on
+     * the metrics of the font and not on where the glyphs are located in the font atlas,
+     * which means that it can be stored in the label cache file and reused as long as the
+     * same font is used.
+     */
+    struct TextLayout {
+        struct Glyph {
+            /// The left, top, right, and bottom edges of the glyph relative to the
+            /// position of the label, in pixels of the font
+            glm::vec4 rectangle = glm::vec4(0.f);
+            /// The character that is displayed by this glyph
+            uint32_t character = 0;
+        };
+
+        /// A description of the font that was used to create this layout
+        std::string font;
+
+        std::vector<Glyph> glyphs;
+
+        /// The glyphs of entry `i` are located at `[glyphOffsets[i], glyphOffsets[i+1])`
+        /// in the #glyphs
+        std::vector<uint32_t> glyphOffsets;
+
+        /// The width of the longest line and the height of all lines of each text, in
+        /// pixels of the font
+        std::vector<glm::vec2> sizes;
+    };
+    std::optional<TextLayout> layout;
+
+    std::string_view identifier(const Entry& entry) const;
+    std::string_view text(const Entry& entry) const;
+
+    /**
+     * Adds a new entry to the end of the labelset. The \p identifier and \p text must
+     * not point into the #strings of this labelset.
+     *
+     * \param position The position of the new label
+     * \param identifier The identifier of the new label, which might be empty
+     * \param text The text that is displayed for the new label
+     *
+     * \throw RuntimeError If the identifier or text is too long to be stored
+     */
+    void addEntry(const glm::vec3& position, std::string_view identifier,
+        std::string_view text);
+
+    /**
+     * Replaces the text of the \p entry, which has to be part of this labelset. As the
+     * strings are stored back to back, the previous text is not reused. Changing a text
+     * invalidates the #layout.
+     *
+     * \param entry The entry whose text should be replaced
+     * \param text The new text for the entry
+     *
+     * \throw RuntimeError If the text is too long to be stored
+     */
+    void setText(Entry& entry, std::string_view text);
 };
 
 struct ColorMap {
@@ -121,6 +269,19 @@ namespace label {
 
     Labelset loadFileWithCache(std::filesystem::path path);
 
+    /**
+     * Overwrites the cache file that belongs to the label file at \p path with the
+     * \p labelset, for example to store a Labelset::TextLayout that was created after
+     * the labels were loaded. The file is written on a background thread, so this
+     * function can be called while rendering.
+     *
+     * \param labelset The labelset that was loaded from the file at \p path
+     * \param path The path to the original label file, not to the cache file
+     * \return A future that becomes ready once the cache file has been written
+     */
+    std::future<void> updateCachedFile(Labelset labelset,
+        const std::filesystem::path& path);
+
     Labelset loadFromDataset(const dataloader::Dataset& dataset);
 } // namespace label
 
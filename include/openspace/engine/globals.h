@@ -48,6 +48,7 @@ class RaycasterManager;
 class RenderEngine;
 class ScreenSpaceRenderable;
 class SyncEngine;
+class TaskScheduler;
 class TimeManager;
 class VersionChecker;
 struct WindowDelegate;
@@ -84,6 +85,7 @@ inline RaycasterManager* raycasterManager;
 inline RenderEngine* renderEngine;
 inline std::vector<std::unique_ptr<ScreenSpaceRenderable>>* screenSpaceRenderables;
 inline SyncEngine* syncEngine;
+inline TaskScheduler* taskScheduler;
 inline TimeManager* timeManager;
 inline VersionChecker* versionChecker;
 inline WindowDelegate* windowDelegate;
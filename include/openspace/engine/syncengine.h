@@ -28,6 +28,7 @@
 #include <openspace/util/syncbuffer.h>
 
 #include <ghoul/misc/boolean.h>
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -38,17 +39,39 @@ class Syncable;
 /**
  * Manages a collection of `Syncable`s and ensures they are synchronized over SGCT nodes.
  * Encoding/Decoding order is handles internally.
+ *
+ * Every `keyframeInterval`-th frame is a keyframe that contains all Syncables. All other
+ * frames are delta frames that only contain the Syncables that report themselves as
+ * dirty, identified by their index in the list of Syncables. A keyframe is also sent
+ * whenever the list of Syncables changes.
  */
 class SyncEngine {
 public:
     BooleanType(IsMaster);
 
+    /// Information about the most recently encoded or decoded frame
+    struct FrameStatistics {
+        bool isKeyframe = false;
+        /// The number of Syncables that were included in the frame
+        size_t nEncodedSyncables = 0;
+        /// The total number of registered Syncables
+        size_t nSyncables = 0;
+        /// The size of the frame in bytes
+        size_t nBytes = 0;
+        /// The time it took to encode or decode the frame
+        std::chrono::microseconds duration = std::chrono::microseconds(0);
+    };
+
     /**
      * Creates a new SyncEngine which a buffer size of \p syncBufferSize.
      *
+     * \param syncBufferSize The initial size of the buffer used for encoding
+     * \param keyframeInterval The number of frames between two keyframes
+     *
      * \pre syncBufferSize must be bigger than 0
+     * \pre keyframeInterval must be bigger than 0
      */
-    SyncEngine(unsigned int syncBufferSize);
+    SyncEngine(unsigned int syncBufferSize, unsigned int keyframeInterval = 60);
 
     /**
      * Encodes all added Syncables in the injected `SyncBuffer`. This method is only
@@ -96,12 +119,28 @@ public:
     */
     void removeSyncables(const std::vector<Syncable*>& syncables);
 
+    /**
+     * Returns the statistics of the frame that was last encoded or decoded.
+     */
+    const FrameStatistics& lastFrameStatistics() const;
+
 private:
     /// Vector of Syncables. The vectors ensures consistent encode/decode order.
     std::vector<Syncable*> _syncables;
 
     /// Databuffer used in encoding/decoding
     SyncBuffer _syncBuffer;
+
+    /// The number of frames between two keyframes
+    const unsigned int _keyframeInterval;
+
+    /// The number of frames that have been encoded since the last keyframe
+    unsigned int _framesSinceKeyframe = 0;
+
+    /// Set when the list of Syncables changes, forcing the next frame to be a keyframe
+    bool _forceKeyframe = true;
+
+    FrameStatistics _lastFrameStatistics;
 };
 
 } // namespace openspace
@@ -62,6 +62,7 @@ T NumericalProperty<T>::minValue() const {
 template <typename T>
 void NumericalProperty<T>::setMinValue(T value) {
     _minimumValue = std::move(value);
+    this->invalidateJsonDescription();
 }
 
 template <typename T>
@@ -72,6 +73,7 @@ T NumericalProperty<T>::maxValue() const {
 template <typename T>
 void NumericalProperty<T>::setMaxValue(T value) {
     _maximumValue = std::move(value);
+    this->invalidateJsonDescription();
 }
 
 template <typename T>
@@ -82,6 +84,7 @@ T NumericalProperty<T>::steppingValue() const {
 template <typename T>
 void NumericalProperty<T>::setSteppingValue(T value) {
     _stepping = std::move(value);
+    this->invalidateJsonDescription();
 }
 
 template <typename T>
@@ -117,11 +120,13 @@ void NumericalProperty<T>::setExponent(float exponent) {
                 )
             );
             _exponent = 1.f;
+            this->invalidateJsonDescription();
             return;
         }
     }
 
     _exponent = exponent;
+    this->invalidateJsonDescription();
 }
 
 template <typename T>
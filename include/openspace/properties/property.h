@@ -28,6 +28,7 @@
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/easing.h>
 #include <any>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <string_view>
@@ -464,6 +465,15 @@ public:
      */
     std::string generateJsonDescription() const;
 
+    /**
+     * Returns a number that changes whenever the result of #generateJsonDescription
+     * might have changed, for example because the meta data was modified. This makes it
+     * possible to cache the description instead of generating it for every use.
+     *
+     * \return The current version of the JSON description of this Property
+     */
+    uint64_t jsonDescriptionVersion() const;
+
     /**
      * Creates the information for the `MetaData` key-part of the JSON description for
      * the Property. The result can be included as one key-value pair in the description
@@ -513,6 +523,12 @@ protected:
      */
     void notifyChangeListeners();
 
+    /**
+     * This method must be called by all subclasses whenever information that is part of
+     * their #generateAdditionalJsonDescription has changed.
+     */
+    void invalidateJsonDescription();
+
     /// The PropetyOwner this Property belongs to, or `nullptr`
     PropertyOwner* _owner = nullptr;
 
@@ -542,6 +558,9 @@ private:
 
     OnChangeHandle _currentHandleValue = 0;
 
+    /// Incremented whenever the JSON description of this Property changes
+    uint64_t _jsonDescriptionVersion = 0;
+
 #ifdef _DEBUG
     // These identifiers can be used for debugging. Each Property is assigned one unique
     // identifier.
@@ -0,0 +1,144 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PROPERTYINDEX___H__
+#define __OPENSPACE_CORE___PROPERTYINDEX___H__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace openspace::properties {
+
+class Property;
+class PropertyOwner;
+
+/**
+ * The PropertyIndex is a lookup structure over all Propertys that are reachable from a
+ * root PropertyOwner. Upon construction of the index, the URI of every Property is
+ * computed once in a single traversal of the property tree, rather than walking the
+ * chain of owners for each Property, and stored next to the Property. Additionally, an
+ * index from tags to the PropertyOwners that have been assigned that tag is maintained.
+ *
+ * The index is invalidated whenever the structure of any property tree changes (see
+ * PropertyOwner::structureGeneration) and is lazily rebuilt on the next query. Results
+ * of wildcard queries are cached until the next invalidation, meaning that repeated
+ * queries with the same pattern only cost time proportional to the number of matches.
+ */
+class PropertyIndex {
+public:
+    /**
+     * Returns the Property with the provided \p uri, or `nullptr` if no Property with
+     * that URI exists in the property tree below \p root.
+     *
+     * \param root The root of the property tree that should be searched
+     * \param uri The full URI of the requested Property
+     * \return The Property with the requested URI or `nullptr`
+     */
+    Property* property(const PropertyOwner& root, std::string_view uri);
+
+    /**
+     * Returns all Propertys below \p root that match the provided \p regex. The regex is
+     * either a literal URI or contains a single `*` wildcard separating a node part and a
+     * property part. If \p groupName is not empty, only Propertys which have an owner
+     * (directly or indirectly) that has been tagged with \p groupName are returned.
+     *
+     * \param root The root of the property tree that should be searched
+     * \param regex The literal URI or wildcard pattern that should be matched
+     * \param groupName The optional tag that the Property's owners must contain
+     * \return A list of all matching Propertys in the order of a depth-first traversal
+     *
+     * \throw ghoul::RuntimeError If the \p regex is malformed
+     */
+    std::vector<Property*> matchingProperties(const PropertyOwner& root,
+        const std::string& regex, const std::string& groupName);
+
+    /**
+     * Returns all PropertyOwners below \p root that have the provided \p tag.
+     *
+     * \param root The root of the property tree that should be searched
+     * \param tag The tag that the PropertyOwners must have
+     * \return A list of all PropertyOwners that have the provided \p tag
+     */
+    const std::vector<PropertyOwner*>& ownersWithTag(const PropertyOwner& root,
+        const std::string& tag);
+
+    /**
+     * Returns the URI of the Property \p prop as it was computed when the index was last
+     * built. If the Property is not part of the index, an empty string is returned.
+     */
+    const std::string& uri(const PropertyOwner& root, const Property* prop);
+
+    /**
+     * Marks the index as outdated, causing it to be rebuilt on the next query.
+     */
+    void invalidate();
+
+private:
+    struct Entry {
+        std::string uri;
+        Property* property = nullptr;
+    };
+
+    /// The range [first, second) into the _entries of all Propertys below an owner
+    using Range = std::pair<size_t, size_t>;
+
+    void rebuildIfNeeded(const PropertyOwner& root);
+    void addOwner(const PropertyOwner& owner, const std::string& prefix, bool isRoot);
+
+    std::vector<Range> rangesForTag(const std::string& tag) const;
+
+    /// The root that this index was last built for
+    const PropertyOwner* _root = nullptr;
+    /// The PropertyOwner::structureGeneration that this index was last built for
+    uint64_t _generation = 0;
+    /// Whether the index has been built at least once
+    bool _isValid = false;
+
+    /// All Propertys in depth-first order, which means that every subtree of the
+    /// property tree occupies a contiguous range in this vector
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string_view, size_t> _entriesByUri;
+    std::unordered_map<const Property*, size_t> _entriesByProperty;
+    /// The identifiers of all Propertys together with their index, sorted
+    std::vector<std::pair<std::string_view, size_t>> _entriesByIdentifier;
+    /// The indices of all entries sorted by their URI
+    std::vector<size_t> _entriesSortedByUri;
+
+    struct TagEntry {
+        std::vector<PropertyOwner*> owners;
+        std::vector<Range> ranges;
+    };
+    std::unordered_map<std::string, TagEntry> _ownersByTag;
+
+    /// Cached results for previous queries, keyed by the group name and the regex
+    std::unordered_map<std::string, std::vector<Property*>> _queryCache;
+};
+
+} // namespace openspace::properties
+
+#endif // __OPENSPACE_CORE___PROPERTYINDEX___H__
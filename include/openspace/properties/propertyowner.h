@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_CORE___PROPERTYOWNER___H__
 #define __OPENSPACE_CORE___PROPERTYOWNER___H__
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -317,6 +318,17 @@ public:
      */
     void removeTag(const std::string& tag);
 
+    /**
+     * Returns a counter that is incremented whenever the structure of any property tree
+     * changes, that is whenever a Property or sub-owner is added or removed, an
+     * identifier is changed, or a tag is added or removed. This value can be used to
+     * invalidate caches that depend on the structure of the property tree, such as the
+     * PropertyIndex.
+     *
+     * \return The current generation of the property tree structure
+     */
+    static uint64_t structureGeneration();
+
 protected:
     /// The unique identifier of this PropertyOwner
     std::string _identifier;
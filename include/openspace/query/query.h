@@ -45,6 +45,17 @@ properties::Property* property(const std::string& uri);
 properties::PropertyOwner* propertyOwner(const std::string& uri);
 std::vector<properties::Property*> allProperties();
 
+/**
+ * Returns all properties whose URI match the provided \p regex and, if \p groupName is
+ * not empty, that have an owner tagged with \p groupName. The lookup is performed on an
+ * index of all properties that is kept up-to-date with the property tree, and repeated
+ * queries for the same \p regex are cached.
+ *
+ * \throw ghoul::RuntimeError If the \p regex is malformed
+ */
+std::vector<properties::Property*> matchingProperties(const std::string& regex,
+    const std::string& groupName = "");
+
 } // namespace openspace
 
 #endif // __OPENSPACE_CORE___QUERY___H__
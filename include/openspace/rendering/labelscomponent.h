@@ -35,9 +35,15 @@
 #include <openspace/properties/vector/vec3property.h>
 #include <openspace/util/distanceconversion.h>
 #include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
 #include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
 
 namespace ghoul::fontrendering { class Font; }
+namespace ghoul::opengl { class ProgramObject; }
 
 namespace openspace {
 struct RenderData;
@@ -54,6 +60,8 @@ public:
     const dataloader::Labelset& labelSet() const;
 
     void initialize();
+    void initializeGL();
+    void deinitializeGL();
 
     /**
      * Create the labels from an already loaded dataset. That dataset should have a
@@ -79,6 +87,33 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /**
+     * Measures the texts of all labels with the current font and stores the result as
+     * the layout of the `_labelset`. If the labels were loaded from a cached label file,
+     * the layout is also stored in that cache file.
+     */
+    void createTextLayout();
+
+    /**
+     * Uploads the glyphs of all labels into the vertex buffer, so that all labels can be
+     * drawn with a single instanced draw call. The layout of the `_labelset` is reused if
+     * it was created for the current font.
+     */
+    void updateLayout();
+
+    /// Returns a string that identifies the font that is used for the text layout
+    std::string fontDescription() const;
+
+    /**
+     * Determines for each label whether it is visible in the current frame, based on
+     * whether it is enabled, in front of the camera, and within the minimum and maximum
+     * size in pixels, and uploads the result to the `_visibilityBuffer`.
+     *
+     * \return The number of visible labels
+     */
+    size_t updateVisibility(const RenderData& data,
+        const glm::dmat4& modelViewProjectionMatrix, const glm::vec3& orthoUp);
+
     std::filesystem::path _labelFile;
     DistanceUnit _unit = DistanceUnit::Parsec;
     dataloader::Labelset _labelset;
@@ -97,6 +132,28 @@ private:
     properties::FloatProperty _fontSize;
     properties::IVec2Property _minMaxSize;
     properties::BoolProperty _faceCamera;
+
+    /// Set when the text or position of the labels or the font might have changed
+    bool _layoutIsDirty = true;
+    /// Set when the labelset might differ from the file that it was loaded from
+    bool _labelsetIsModified = false;
+    /// Writes the text layout into the cache file in the background
+    std::future<void> _cacheWrite;
+
+    /// The positions of the anchors of the labels in model space
+    std::vector<glm::vec3> _labelPositions;
+    std::vector<float> _labelVisibility;
+    GLsizei _nGlyphs = 0;
+
+    GLuint _vao = 0;
+    GLuint _vbo = 0;
+    GLuint _visibilityBuffer = 0;
+    GLuint _visibilityTexture = 0;
+
+    ghoul::opengl::ProgramObject* _program = nullptr;
+    UniformCache(modelViewProjection, scale, faceCamera, orthoRight, orthoUp,
+        cameraPosition, cameraLookUp, labelVisibility, atlas, color,
+        outlineColor) _uniformCache;
 };
 
 } // namespace openspace
@@ -57,6 +57,9 @@ namespace documentation { struct Documentation; }
 struct RenderableSettings {
     bool automaticallyUpdateRenderBin = true;
     bool shouldUpdateIfDisabled = false;
+    /// Set by renderables whose `update` only touches their own state and can thus be
+    /// called from a worker thread concurrently with other nodes
+    bool supportsParallelUpdate = false;
 };
 
 class Renderable : public properties::PropertyOwner, public Fadeable {
@@ -85,6 +88,7 @@ public:
     virtual bool isReady() const = 0;
     bool isEnabled() const;
     bool shouldUpdateIfDisabled() const noexcept;
+    bool supportsParallelUpdate() const noexcept;
 
     double boundingSphere() const noexcept;
     double interactionSphere() const noexcept;
@@ -215,6 +219,7 @@ private:
     double _interactionSphere = 0.0;
     SceneGraphNode* _parent = nullptr;
     const bool _shouldUpdateIfDisabled = false;
+    const bool _supportsParallelUpdate = false;
     bool _automaticallyUpdateRenderBin = true;
     bool _hasOverrideRenderBin = false;
 
@@ -52,6 +52,12 @@ public:
     virtual glm::dvec3 scaleValue(const UpdateData& data) const = 0;
     virtual void update(const UpdateData& data);
 
+    /**
+     * Returns whether #update can be called concurrently with the updates of other scene
+     * graph nodes (see Translation::supportsParallelUpdate).
+     */
+    virtual bool supportsParallelUpdate(const UpdateData& data) const;
+
     static documentation::Documentation Documentation();
 
 protected:
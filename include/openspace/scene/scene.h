@@ -27,6 +27,7 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/scene/profile.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scripting/scriptengine.h>
@@ -34,6 +35,7 @@
 #include <ghoul/misc/easing.h>
 #include <ghoul/misc/exception.h>
 #include <ghoul/misc/memorypool.h>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <set>
@@ -250,6 +252,30 @@ public:
      */
     std::vector<std::string> allTags();
 
+    /**
+     * Returns the time that the last call to #update spent in each scene graph node,
+     * sorted from the slowest to the fastest node. The list is only populated while the
+     * `MeasureUpdateTimes` property is enabled.
+     *
+     * \return The update time for each scene graph node that was updated in the last
+     *         frame
+     */
+    std::vector<std::pair<SceneGraphNode*, std::chrono::nanoseconds>>
+        nodeUpdateTimes() const;
+
+    /**
+     * Groups nodes into update levels such that every node is in a later level than all
+     * nodes it depends on. All nodes of a level are therefore independent of each other.
+     * Every node is placed in the earliest level that is possible.
+     *
+     * \param predecessors For each node in topological order, the indices of the nodes
+     *        it depends on, i.e. its parent and its dependencies. All of these have to
+     *        be smaller than the index of the node itself
+     * \return The indices of the nodes in each update level
+     */
+    static std::vector<std::vector<size_t>> groupIntoUpdateLevels(
+        const std::vector<std::vector<size_t>>& predecessors);
+
 private:
     /**
      * Accepts string version of a property value from a profile, converts it to the
@@ -307,6 +333,19 @@ private:
     void updateNodeRegistry();
     void sortTopologically();
 
+    /**
+     * Groups the topologically sorted nodes into levels such that every node only
+     * depends on nodes in earlier levels, which makes all nodes of a level independent
+     * of each other.
+     */
+    void computeUpdateLevels();
+
+    /**
+     * Updates the node at position \p index of the topologically sorted nodes, recording
+     * the time it took if \p measure is `true`.
+     */
+    void updateNode(size_t index, const UpdateData& data, bool measure);
+
     std::unique_ptr<Camera> _camera;
     std::vector<SceneGraphNode*> _topologicallySortedNodes;
     std::vector<SceneGraphNode*> _circularNodes;
@@ -332,6 +371,17 @@ private:
     };
     std::vector<PropertyInterpolationInfo> _propertyInterpolationInfos;
 
+    properties::BoolProperty _parallelUpdate;
+    properties::BoolProperty _measureUpdateTimes;
+
+    /// The indices of the topologically sorted nodes grouped by their update level
+    std::vector<std::vector<size_t>> _updateLevels;
+    /// Scratch space for the nodes of a level that can be updated from a worker thread
+    std::vector<size_t> _parallelNodes;
+    /// Scratch space for the nodes of a level that have to be updated on this thread
+    std::vector<size_t> _serialNodes;
+    std::vector<std::chrono::nanoseconds> _nodeUpdateTimes;
+
     ghoul::MemoryPool<4096> _memoryPool;
 };
 
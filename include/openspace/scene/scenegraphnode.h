@@ -140,6 +140,14 @@ public:
 
     bool supportsDirectInteraction() const;
 
+    /**
+     * Returns `true` if the transforms and the renderable of this node can all be
+     * updated with the provided \p data from a worker thread, in which case #update may
+     * run concurrently with the update of any other node that does not depend on this
+     * one. Nodes whose translation has observers are always updated on the main thread.
+     */
+    bool supportsParallelUpdate(const UpdateData& data) const;
+
     SceneGraphNode* childNode(const std::string& id);
 
     const Renderable* renderable() const;
@@ -49,6 +49,23 @@ public:
     virtual bool initialize();
 
     virtual void update(const UpdateData& data);
+
+    /**
+     * Returns whether #update can be called with the provided \p data concurrently with
+     * the updates of other scene graph nodes. This is only the case if the position only
+     * depends on the state of this object and does not use any services that are not
+     * thread-safe, such as SPICE. The default implementation returns `false`.
+     *
+     * An #update that runs on a worker thread must not change the value of any property,
+     * as the `onChange` callbacks of that property would then be called on the worker
+     * thread as well. A translation that has an observer registered through
+     * #onParameterChange is always updated on the main thread, regardless of the return
+     * value of this function, so that the observer is only ever notified there.
+     *
+     * \param data The data that will be passed to the next call of #update
+     */
+    virtual bool supportsParallelUpdate(const UpdateData& data) const;
+
     glm::dvec3 position() const;
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
@@ -57,6 +74,9 @@ public:
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
 
+    /// Returns whether a callback has been registered through #onParameterChange
+    bool hasObservers() const;
+
     static documentation::Documentation Documentation();
 
 protected:
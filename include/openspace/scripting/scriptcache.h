@@ -0,0 +1,145 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SCRIPTCACHE___H__
+#define __OPENSPACE_CORE___SCRIPTCACHE___H__
+
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct lua_State;
+
+namespace openspace::scripting {
+
+/**
+ * A cache of compiled Lua scripts that allows scripts that are executed repeatedly to
+ * skip the parsing and compilation step. Each compiled script is stored as a function in
+ * the Lua registry and the least recently used functions are evicted once the number of
+ * cached scripts exceeds the capacity of the cache.
+ *
+ * Scripts are cached as templates in which all number and string literals are replaced
+ * by parameters, so `openspace.setPropertyValueSingle('Scene.Earth.Opacity', 0.5)` and
+ * `openspace.setPropertyValueSingle('Scene.Mars.Opacity', 1.0)` share the same compiled
+ * function. Scripts that cannot safely be converted into a template, for example because
+ * they contain comments, long strings, or escaped characters, are cached by their text.
+ */
+class ScriptCache {
+public:
+    /// The name prefix of the local variables that hold the parameters of a template
+    static constexpr std::string_view ParameterPrefix = "__osp";
+
+    struct Template {
+        struct Parameter {
+            enum class Type {
+                Number,
+                String
+            };
+
+            Type type;
+            /// The text of the number or the contents of the string without quotes
+            std::string_view value;
+        };
+
+        /// The script in which the literals are replaced by parameters
+        std::string text;
+        std::vector<Parameter> parameters;
+    };
+
+    /**
+     * Creates a template from the provided \p script by replacing all number and string
+     * literals with parameters that are assigned from the varargs of the chunk. If the
+     * script cannot be converted safely, `std::nullopt` is returned instead.
+     *
+     * \param script The Lua script that should be converted into a template
+     * \return The template for the script or `std::nullopt` if the script cannot be
+     *         converted. The parameters of the template refer to the \p script
+     */
+    static std::optional<Template> createTemplate(std::string_view script);
+
+    /**
+     * Creates a new cache that holds at most \p capacity compiled scripts.
+     *
+     * \param capacity The maximum number of scripts in the cache. If it is 0, scripts are
+     *        compiled every time they are loaded
+     */
+    explicit ScriptCache(size_t capacity);
+
+    /**
+     * Pushes the compiled function for the \p script onto the stack of the \p state,
+     * followed by the parameters that have to be passed to the function, compiling the
+     * script first if it is not already in the cache.
+     *
+     * \param state The Lua state onto which the function and its parameters are pushed.
+     *        It must be the same state for all calls to the same cache
+     * \param script The script that should be loaded
+     * \return The number of parameters that were pushed after the function
+     *
+     * \throw LuaLoadingException If the script could not be compiled
+     */
+    int load(lua_State* state, const std::string& script);
+
+    /**
+     * Changes the maximum number of compiled scripts, evicting the least recently used
+     * scripts if the cache currently contains more scripts.
+     */
+    void setCapacity(lua_State* state, size_t capacity);
+
+    /**
+     * Removes all scripts from the cache and releases their functions in \p state.
+     */
+    void clear(lua_State* state);
+
+    /// Returns the number of scripts that were loaded from the cache
+    size_t nHits() const;
+
+    /// Returns the number of scripts that had to be compiled
+    size_t nMisses() const;
+
+    /// Returns the number of scripts that are currently in the cache
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::string key;
+        int reference;
+    };
+
+    void evict(lua_State* state, size_t capacity);
+
+    size_t _capacity;
+    size_t _nHits = 0;
+    size_t _nMisses = 0;
+
+    /// The cached scripts, ordered from the most to the least recently used
+    std::list<Entry> _entries;
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> _lookup;
+};
+
+} // namespace openspace::scripting
+
+#endif // __OPENSPACE_CORE___SCRIPTCACHE___H__
@@ -25,8 +25,12 @@
 #ifndef __OPENSPACE_CORE___SCRIPTENGINE___H__
 #define __OPENSPACE_CORE___SCRIPTENGINE___H__
 
+#include <openspace/properties/propertyowner.h>
 #include <openspace/util/syncable.h>
+
+#include <openspace/properties/scalar/intproperty.h>
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/scripting/scriptcache.h>
 #include <ghoul/lua/luastate.h>
 #include <ghoul/misc/boolean.h>
 #include <filesystem>
@@ -46,8 +50,12 @@ namespace openspace::scripting {
  * Library::Function%s have to be added which can then be called using the
  * `openspace` namespace prefix in Lua. The same functions can be exposed to other Lua
  * states by passing them to the #initializeLuaState method.
+ *
+ * Scripts that are executed through #runScript are compiled once and kept in a
+ * ScriptCache, so that scripts that are sent repeatedly, possibly with different
+ * arguments, do not have to be parsed again.
  */
-class ScriptEngine : public Syncable {
+class ScriptEngine : public properties::PropertyOwner, public Syncable {
 public:
     using ScriptCallback = std::function<void(ghoul::Dictionary)>;
     BooleanType(ShouldBeSynchronized);
@@ -91,6 +99,7 @@ public:
     virtual void encode(SyncBuffer* syncBuffer) override;
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
+    virtual bool isDirty() const override;
 
     void queueScript(std::string script, ShouldBeSynchronized shouldBeSynchronized,
         ShouldSendToRemote shouldSendToRemote,
@@ -104,6 +113,15 @@ private:
 
     void writeLog(const std::string& script);
 
+    /**
+     * Executes the \p script using the ScriptCache and returns all values returned by
+     * the script in an array dictionary if \p returnValues is `true`.
+     *
+     * \throw LuaLoadingException If the script could not be compiled
+     * \throw LuaExecutionException If an error occurred while executing the script
+     */
+    ghoul::Dictionary executeScript(const std::string& script, bool returnValues);
+
     bool registerLuaLibrary(lua_State* state, LuaLibrary& library);
     void addLibraryFunctions(lua_State* state, LuaLibrary& library, Replace replace);
 
@@ -114,6 +132,11 @@ private:
     ghoul::lua::LuaState _state;
     std::vector<LuaLibrary> _registeredLibraries;
 
+    ScriptCache _scriptCache;
+    properties::IntProperty _scriptCacheSize;
+    properties::IntProperty _scriptCacheHits;
+    properties::IntProperty _scriptCacheMisses;
+
     std::queue<QueueItem> _incomingScripts;
 
     // Client scripts are mutex protected since decode and rendering may happen
@@ -33,6 +33,7 @@
 #include <array>
 #include <filesystem>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <set>
@@ -241,6 +242,14 @@ public:
      */
     std::vector<std::filesystem::path> loadedKernels() const;
 
+    /**
+     * Returns a number that changes whenever a kernel is loaded or unloaded. Values that
+     * were derived from SPICE while a different number was returned might be outdated.
+     *
+     * \return The current generation of the kernel pool
+     */
+    uint64_t kernelGeneration() const;
+
     /**
      * Unloads a SPICE kernel identified by the \p filePath which was used in the
      * loading call to #loadKernel. The unloading is done by calling the `unload_c`
@@ -577,6 +586,7 @@ public:
         static_assert(N != 0, "Format must not be empty");
         ghoul_assert(N >= bufferSize - 1, "Buffer size too small");
 
+        const std::lock_guard lock(mutex());
         timout_c(ephemerisTime, format, bufferSize, outBuf);
         if (failed_c()) {
             throwSpiceError(std::format(
@@ -1013,6 +1023,12 @@ public:
     static scripting::LuaLibrary luaLibrary();
 
 private:
+    /**
+     * Returns the mutex that is held while calling SPICE, which is not thread-safe. All
+     * functions of the SpiceManager acquire it, so they can be called from any thread.
+     */
+    static std::recursive_mutex& mutex();
+
     /**
      * Struct storing the information about all loaded kernels.
      */
@@ -1144,6 +1160,9 @@ private:
     /// The last assigned kernel-id, used to determine the next free kernel id
     KernelHandle _lastAssignedKernel = KernelHandle(0);
 
+    /// Incremented whenever a kernel is loaded into or removed from the kernel pool
+    uint64_t _kernelGeneration = 0;
+
     static SpiceManager* _instance;
 };
 
@@ -45,6 +45,16 @@ protected:
     virtual void encode(SyncBuffer* /*syncBuffer*/) = 0;
     virtual void decode(SyncBuffer* /*syncBuffer*/) = 0;
     virtual void postSync(bool /*isMaster*/) {}
+
+    /**
+     * Returns whether the state of this Syncable has changed since the last time it was
+     * encoded. Syncables that have not changed are left out of the delta frames that
+     * the #SyncEngine sends between its periodic keyframes. The default implementation
+     * conservatively reports every Syncable as changed in every frame.
+     *
+     * \return `true` if this Syncable has to be encoded in the next frame
+     */
+    virtual bool isDirty() const { return true; }
 };
 
 } // namespace openspace
@@ -26,6 +26,7 @@
 #define __OPENSPACE_CORE___SYNCBUFFER___H__
 
 #include <ghoul/glm.h>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -43,6 +44,22 @@ public:
     template <typename T>
     void encode(const T& v);
 
+    /**
+     * Encodes the \p value as a variable length integer, using 7 bits per byte with the
+     * most significant bit set for all but the last byte. Small values, such as counts
+     * and indices, only require a single byte this way.
+     *
+     * \param value The value that is encoded
+     */
+    void encodeVarint(uint64_t value);
+
+    /**
+     * Decodes a variable length integer that was encoded with #encodeVarint.
+     *
+     * \return The decoded value
+     */
+    uint64_t decodeVarint();
+
     std::string decode();
 
     template <typename T>
@@ -62,6 +79,12 @@ public:
     void setData(std::vector<std::byte> data);
     std::vector<std::byte> data();
 
+    /**
+     * Returns the number of bytes that have been encoded into this buffer since the last
+     * call to #reset.
+     */
+    size_t encodedSize() const;
+
 private:
     size_t _n;
     size_t _encodeOffset = 0;
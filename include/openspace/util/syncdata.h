@@ -41,6 +41,9 @@ namespace openspace {
  * or variables, user may have to do explicit casts.
  *
  * `((T&) t).method();`
+ *
+ * If T is trivially copyable, the data is only reported as dirty to the SyncEngine if
+ * its value has changed since it was last encoded.
  */
 template<class T>
 class SyncData : public Syncable {
@@ -78,10 +81,14 @@ protected:
     virtual void encode(SyncBuffer* syncBuffer) override;
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
+    virtual bool isDirty() const override;
 
     T _data;
     T _doubleBufferedData;
-    std::mutex _mutex;
+    /// The value that was last encoded, used to detect whether the data has changed
+    T _lastEncodedData;
+    bool _hasEncodedData = false;
+    mutable std::mutex _mutex;
 };
 
 } // namespace openspace
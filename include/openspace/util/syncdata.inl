@@ -23,6 +23,8 @@
  ****************************************************************************************/
 
 #include <openspace/util/syncbuffer.h>
+#include <cstring>
+#include <type_traits>
 
 namespace openspace {
 
@@ -62,6 +64,8 @@ template<class T>
 void SyncData<T>::encode(SyncBuffer* syncBuffer) {
     _mutex.lock();
     syncBuffer->encode(_data);
+    _lastEncodedData = _data;
+    _hasEncodedData = true;
     _mutex.unlock();
 }
 
@@ -72,6 +76,18 @@ void SyncData<T>::decode(SyncBuffer* syncBuffer) {
     _mutex.unlock();
 }
 
+template<class T>
+bool SyncData<T>::isDirty() const {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::lock_guard lock(_mutex);
+        return !_hasEncodedData ||
+               std::memcmp(&_data, &_lastEncodedData, sizeof(T)) != 0;
+    }
+    else {
+        return true;
+    }
+}
+
 template<class T>
 void SyncData<T>::postSync(bool isMaster) {
     // apply synced update
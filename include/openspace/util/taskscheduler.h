@@ -0,0 +1,211 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TASKSCHEDULER___H__
+#define __OPENSPACE_CORE___TASKSCHEDULER___H__
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A work-stealing task scheduler. Each worker thread owns a set of deques (one per
+ * Priority) into which tasks that are created by tasks running on that worker are
+ * placed. A worker takes tasks from the back of its own deques and, if they are empty,
+ * steals from the front of the deques of other workers. Tasks that are submitted from
+ * threads outside of the scheduler are pushed onto a lock-free list that is picked up by
+ * the next worker that runs out of work, so that submitting a task never blocks.
+ *
+ * Tasks can be grouped into a TaskGroup, which makes it possible to wait for the
+ * completion of a set of tasks. While waiting, the waiting thread executes the tasks of
+ * that group that have not been started yet, which means that tasks can spawn subtasks
+ * and wait for them without blocking a worker. Tasks of other groups are never executed
+ * by a waiting thread, so waiting for a group of short tasks is not delayed by an
+ * unrelated long-running task.
+ * An exception that is thrown by a task of a TaskGroup is passed on to the thread that
+ * waits for the group, whereas exceptions of tasks without a group are logged.
+ *
+ * The interface is a superset of the ThreadPool's, so a ThreadPool can be replaced by a
+ * TaskScheduler without changes to the code that enqueues tasks.
+ */
+class TaskScheduler {
+public:
+    /// The priority of a task. Higher priority tasks are executed first within the same
+    /// queue, but there is no global ordering between tasks in different queues
+    enum class Priority {
+        High = 0,
+        Normal,
+        Low
+    };
+
+    /**
+     * A TaskGroup collects tasks that are executed in a TaskScheduler and makes it
+     * possible to wait for all of them to finish. The destructor waits for all
+     * outstanding tasks of the group, but does not rethrow their exceptions.
+     */
+    class TaskGroup {
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler);
+        ~TaskGroup();
+
+        /**
+         * Enqueues the \p task in the TaskScheduler as part of this TaskGroup.
+         *
+         * \param task The task that should be executed
+         * \param priority The priority of the task
+         */
+        void run(std::function<void()> task, Priority priority = Priority::Normal);
+
+        /**
+         * Waits until all tasks that have been added to this TaskGroup have finished. The
+         * calling thread executes tasks of this TaskGroup while waiting. If any of the
+         * tasks threw an exception, the first one is rethrown once all tasks have
+         * finished.
+         */
+        void wait();
+
+    private:
+        friend class TaskScheduler;
+
+        struct State {
+            std::atomic_uint32_t nPending = 0;
+
+            std::mutex exceptionMutex;
+            /// The first exception that was thrown by a task of the group
+            std::exception_ptr exception;
+        };
+
+        void waitForTasks();
+
+        TaskScheduler& _scheduler;
+        std::shared_ptr<State> _state;
+    };
+
+    /**
+     * Creates a new TaskScheduler with \p numThreads worker threads.
+     *
+     * \param numThreads The number of worker threads. If this is 0, the number of
+     *        hardware threads is used
+     */
+    explicit TaskScheduler(size_t numThreads = 0);
+
+    /**
+     * Stops and joins all worker threads. Tasks that have not been started at this point
+     * are discarded.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * Enqueues the \p task for execution on one of the worker threads.
+     *
+     * \param task The task that should be executed
+     * \param priority The priority of the task
+     */
+    void enqueue(std::function<void()> task, Priority priority = Priority::Normal);
+
+    /**
+     * Removes all tasks that have not been started yet.
+     */
+    void clearTasks();
+
+    /**
+     * Returns `true` if there are tasks that have been enqueued but not started yet.
+     */
+    bool hasOutstandingTasks() const;
+
+    /**
+     * Returns the number of worker threads of this TaskScheduler.
+     */
+    size_t numThreads() const;
+
+private:
+    static constexpr size_t NPriorities = 3;
+    static constexpr size_t NoWorker = static_cast<size_t>(-1);
+
+    struct Task {
+        std::function<void()> function;
+        std::shared_ptr<TaskGroup::State> group;
+        Priority priority = Priority::Normal;
+        /// The next task in the lock-free submission list
+        Task* next = nullptr;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::array<std::deque<Task*>, NPriorities> tasks;
+    };
+
+    void submit(Task* task);
+    void wakeWorkers(bool all);
+
+    /// Executes a single task if one is available and returns whether it did
+    bool runOneTask(size_t worker);
+    /// Executes a single task of the \p group if one is available and returns whether it
+    /// did
+    bool runGroupTask(size_t worker, const TaskGroup::State& group);
+    void runTask(Task* task);
+    void finishTask(Task* task);
+
+    Task* popLocal(size_t worker);
+    Task* popSubmitted(size_t worker);
+    Task* popGroupTask(size_t worker, const TaskGroup::State& group);
+    /// Takes all tasks that were submitted from outside the scheduler in submission order
+    Task* takeSubmitted();
+    /// Moves all tasks of the \p list except \p skip into the worker queues
+    void distribute(Task* list, const Task* skip, size_t worker);
+    Task* steal(size_t thief);
+
+    void workerLoop(size_t worker);
+
+    /// The worker index of the calling thread in this scheduler, or NoWorker
+    size_t currentWorker() const;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    /// Tasks submitted from outside the scheduler, in reverse submission order
+    std::atomic<Task*> _submitted = nullptr;
+    /// The number of tasks that have been enqueued but not started yet
+    std::atomic_size_t _nOutstanding = 0;
+    /// Incremented whenever new work is available to wake up sleeping workers
+    std::atomic_uint32_t _wakeEpoch = 0;
+    /// The worker that receives the next submitted task that no worker has taken
+    std::atomic_size_t _nextWorker = 0;
+    std::atomic_bool _stop = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___TASKSCHEDULER___H__
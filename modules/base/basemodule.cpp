@@ -75,6 +75,7 @@
 #include <modules/base/scale/nonuniformstaticscale.h>
 #include <modules/base/scale/staticscale.h>
 #include <modules/base/scale/timedependentscale.h>
+#include <modules/base/tasks/benchmarkdataloadingtask.h>
 #include <modules/base/translation/timelinetranslation.h>
 #include <modules/base/translation/luatranslation.h>
 #include <modules/base/translation/statictranslation.h>
@@ -85,6 +86,7 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -206,6 +208,10 @@ void BaseModule::internalInitialize(const ghoul::Dictionary&) {
 
     fLightSource->registerClass<CameraLightSource>("CameraLightSource");
     fLightSource->registerClass<SceneGraphLightSource>("SceneGraphLightSource");
+
+    ghoul::TemplateFactory<Task>* fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "Task factory was not created");
+    fTask->registerClass<BenchmarkDataLoadingTask>("BenchmarkDataLoadingTask");
 }
 
 void BaseModule::internalDeinitializeGL() {
@@ -276,7 +282,9 @@ std::vector<documentation::Documentation> BaseModule::documentations() const {
         TimeFrameUnion::Documentation(),
 
         CameraLightSource::Documentation(),
-        SceneGraphLightSource::Documentation()
+        SceneGraphLightSource::Documentation(),
+
+        BenchmarkDataLoadingTask::Documentation()
     };
 }
 
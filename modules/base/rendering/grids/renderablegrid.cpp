@@ -215,9 +215,17 @@ void RenderableGrid::initializeGL() {
 
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderableGrid::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     glDeleteVertexArrays(1, &_vaoID);
     _vaoID = 0;
     glDeleteVertexArrays(1, &_highlightVaoID);
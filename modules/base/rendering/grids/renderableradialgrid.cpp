@@ -178,9 +178,17 @@ void RenderableRadialGrid::initializeGL() {
             );
         }
     );
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderableRadialGrid::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     BaseModule::ProgramObjectManager.release(
         "GridProgram",
         [](ghoul::opengl::ProgramObject* p) {
@@ -0,0 +1,303 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/rendering/pointcloud/pointclusterindex.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+#include <random>
+
+namespace {
+    constexpr std::string_view _loggerCat = "PointClusterIndex";
+
+    constexpr int8_t CurrentCacheVersion = 1;
+
+    // Octree nodes are not subdivided any further at this depth, which only happens if
+    // many points share (almost) the same position
+    constexpr int MaxDepth = 21;
+
+    using Cluster = openspace::PointClusterIndex::Cluster;
+
+    struct Builder {
+        std::span<const glm::dvec3> positions;
+        uint32_t maxClusterSize = 0;
+        std::vector<uint32_t>& order;
+        std::vector<Cluster>& clusters;
+
+        // Splits the points in the range [first, first + count) of the order, which
+        // are contained in the box between min and max, into the eight octants
+        void subdivide(uint32_t first, uint32_t count, const glm::dvec3& min,
+                       const glm::dvec3& max, int depth)
+        {
+            if (count == 0) {
+                return;
+            }
+
+            if (count <= maxClusterSize || depth == MaxDepth) {
+                for (uint32_t i = 0; i < count; i += maxClusterSize) {
+                    addCluster(first + i, std::min(maxClusterSize, count - i));
+                }
+                return;
+            }
+
+            const glm::dvec3 mid = (min + max) * 0.5;
+            auto isLower = [this](int axis, double split) {
+                return [this, axis, split](uint32_t i) {
+                    return positions[i][axis] < split;
+                };
+            };
+
+            // The bits of the octant index select the upper half along x, y, and z
+            using It = std::vector<uint32_t>::iterator;
+            std::array<It, 9> bounds;
+            bounds[0] = order.begin() + first;
+            bounds[8] = bounds[0] + count;
+            bounds[4] = std::partition(bounds[0], bounds[8], isLower(0, mid.x));
+            bounds[2] = std::partition(bounds[0], bounds[4], isLower(1, mid.y));
+            bounds[6] = std::partition(bounds[4], bounds[8], isLower(1, mid.y));
+            for (int i = 1; i < 8; i += 2) {
+                bounds[i] = std::partition(
+                    bounds[i - 1],
+                    bounds[i + 1],
+                    isLower(2, mid.z)
+                );
+            }
+
+            for (int octant = 0; octant < 8; octant++) {
+                const glm::dvec3 lo = glm::dvec3(
+                    (octant & 4) ? mid.x : min.x,
+                    (octant & 2) ? mid.y : min.y,
+                    (octant & 1) ? mid.z : min.z
+                );
+                const glm::dvec3 hi = glm::dvec3(
+                    (octant & 4) ? max.x : mid.x,
+                    (octant & 2) ? max.y : mid.y,
+                    (octant & 1) ? max.z : mid.z
+                );
+                subdivide(
+                    static_cast<uint32_t>(bounds[octant] - order.begin()),
+                    static_cast<uint32_t>(bounds[octant + 1] - bounds[octant]),
+                    lo,
+                    hi,
+                    depth + 1
+                );
+            }
+        }
+
+        void addCluster(uint32_t first, uint32_t count) {
+            auto begin = order.begin() + first;
+            auto end = begin + count;
+
+            glm::dvec3 min = glm::dvec3(std::numeric_limits<double>::max());
+            glm::dvec3 max = glm::dvec3(-std::numeric_limits<double>::max());
+            for (auto it = begin; it != end; it++) {
+                min = glm::min(min, positions[*it]);
+                max = glm::max(max, positions[*it]);
+            }
+
+            Cluster cluster = {
+                .center = (min + max) * 0.5,
+                .first = first,
+                .count = count
+            };
+            for (auto it = begin; it != end; it++) {
+                cluster.radius = std::max(
+                    cluster.radius,
+                    glm::distance(cluster.center, positions[*it])
+                );
+            }
+            clusters.push_back(cluster);
+
+            // Seeding with the offset makes the order reproducible between runs
+            std::shuffle(begin, end, std::mt19937(first));
+        }
+    };
+} // namespace
+
+namespace openspace {
+
+PointClusterIndex PointClusterIndex::build(std::span<const glm::dvec3> positions,
+                                           uint32_t maxClusterSize)
+{
+    ZoneScoped;
+
+    ghoul_assert(maxClusterSize > 0, "maxClusterSize must be positive");
+    ghoul_assert(
+        positions.size() <= std::numeric_limits<uint32_t>::max(),
+        "Too many positions"
+    );
+
+    PointClusterIndex res;
+    res._order.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        res._order[i] = static_cast<uint32_t>(i);
+    }
+
+    glm::dvec3 min = glm::dvec3(std::numeric_limits<double>::max());
+    glm::dvec3 max = glm::dvec3(-std::numeric_limits<double>::max());
+    for (const glm::dvec3& p : positions) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    Builder builder = {
+        .positions = positions,
+        .maxClusterSize = maxClusterSize,
+        .order = res._order,
+        .clusters = res._clusters
+    };
+    builder.subdivide(0, static_cast<uint32_t>(positions.size()), min, max, 0);
+    return res;
+}
+
+PointClusterIndex PointClusterIndex::cachedOrBuild(const std::filesystem::path& dataFile,
+                                                   std::string_view information,
+                                                   std::span<const glm::dvec3> positions,
+                                                   uint32_t maxClusterSize)
+{
+    ZoneScoped;
+
+    const std::string info = std::format(
+        "clusterindex|{}|{}|{}", information, positions.size(), maxClusterSize
+    );
+    const std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
+        dataFile,
+        info
+    );
+
+    if (std::filesystem::is_regular_file(cached)) {
+        std::optional<PointClusterIndex> index = load(cached, positions.size());
+        if (index.has_value()) {
+            return *std::move(index);
+        }
+        LWARNING(std::format("Ignoring invalid cached cluster index '{}'", cached));
+    }
+
+    LINFO(std::format("Building cluster index for '{}'", dataFile));
+    PointClusterIndex index = build(positions, maxClusterSize);
+    index.save(cached);
+    return index;
+}
+
+const std::vector<uint32_t>& PointClusterIndex::order() const {
+    return _order;
+}
+
+const std::vector<PointClusterIndex::Cluster>& PointClusterIndex::clusters() const {
+    return _clusters;
+}
+
+void PointClusterIndex::save(const std::filesystem::path& file) const {
+    std::ofstream stream(file, std::ofstream::binary);
+    if (!stream.good()) {
+        LERROR(std::format("Error opening file '{}' for saving the cluster index", file));
+        return;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+    const uint64_t nPoints = _order.size();
+    stream.write(reinterpret_cast<const char*>(&nPoints), sizeof(uint64_t));
+    const uint64_t nClusters = _clusters.size();
+    stream.write(reinterpret_cast<const char*>(&nClusters), sizeof(uint64_t));
+    stream.write(
+        reinterpret_cast<const char*>(_order.data()),
+        _order.size() * sizeof(uint32_t)
+    );
+    stream.write(
+        reinterpret_cast<const char*>(_clusters.data()),
+        _clusters.size() * sizeof(Cluster)
+    );
+}
+
+std::optional<PointClusterIndex> PointClusterIndex::load(
+                                                        const std::filesystem::path& file,
+                                                        size_t nPoints)
+{
+    std::ifstream stream(file, std::ifstream::binary);
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+
+    int8_t version = 0;
+    stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        return std::nullopt;
+    }
+
+    uint64_t nStoredPoints = 0;
+    stream.read(reinterpret_cast<char*>(&nStoredPoints), sizeof(uint64_t));
+    uint64_t nClusters = 0;
+    stream.read(reinterpret_cast<char*>(&nClusters), sizeof(uint64_t));
+    if (!stream.good() || nStoredPoints != nPoints) {
+        return std::nullopt;
+    }
+
+    // Guard against truncated files before allocating any memory
+    const uint64_t expectedSize = sizeof(int8_t) + 2 * sizeof(uint64_t) +
+        nPoints * sizeof(uint32_t) + nClusters * sizeof(Cluster);
+    if (std::filesystem::file_size(file) != expectedSize) {
+        return std::nullopt;
+    }
+
+    PointClusterIndex res;
+    res._order.resize(nPoints);
+    stream.read(reinterpret_cast<char*>(res._order.data()), nPoints * sizeof(uint32_t));
+    res._clusters.resize(nClusters);
+    stream.read(
+        reinterpret_cast<char*>(res._clusters.data()),
+        nClusters * sizeof(Cluster)
+    );
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+
+    // The order and clusters are used to index into the vertex buffers, so a corrupt
+    // file must not produce out-of-bounds values
+    const bool validOrder = std::all_of(
+        res._order.begin(),
+        res._order.end(),
+        [nPoints](uint32_t i) { return i < nPoints; }
+    );
+    const bool validClusters = std::all_of(
+        res._clusters.begin(),
+        res._clusters.end(),
+        [nPoints](const Cluster& c) {
+            return static_cast<uint64_t>(c.first) + c.count <= nPoints;
+        }
+    );
+    if (!validOrder || !validClusters) {
+        return std::nullopt;
+    }
+    return res;
+}
+
+} // namespace openspace
@@ -0,0 +1,124 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_BASE___POINTCLUSTERINDEX___H__
+#define __OPENSPACE_MODULE_BASE___POINTCLUSTERINDEX___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A spatial index for a point cloud that partitions the points into clusters of nearby
+ * points using an octree. The points are reordered so that the points of each cluster
+ * are stored contiguously, which makes it possible to cull entire clusters against the
+ * view frustum and to draw the remaining clusters with a single multi-draw call.
+ *
+ * Within a cluster, the points are stored in a shuffled order so that every prefix of a
+ * cluster is an evenly distributed subset of its points. Rendering only the first part
+ * of a cluster is therefore a cheap level of detail for clusters that are far away.
+ */
+class PointClusterIndex {
+public:
+    struct Cluster {
+        /// The center of the bounding sphere of the points in the cluster
+        glm::dvec3 center = glm::dvec3(0.0);
+        /// The radius of the bounding sphere of the points in the cluster
+        double radius = 0.0;
+        /// The index in the #order of the first point of the cluster
+        uint32_t first = 0;
+        /// The number of points in the cluster
+        uint32_t count = 0;
+    };
+
+    /**
+     * Creates the index for the provided \p positions by subdividing their bounding box
+     * until each octree node contains at most \p maxClusterSize points.
+     *
+     * \param positions The positions of all points in the point cloud
+     * \param maxClusterSize The largest number of points that end up in one cluster
+     * \return The index for the \p positions
+     *
+     * \pre \p maxClusterSize must be positive
+     */
+    static PointClusterIndex build(std::span<const glm::dvec3> positions,
+        uint32_t maxClusterSize);
+
+    /**
+     * Returns the index stored in the cache next to the cache of the \p dataFile, or
+     * creates it using #build and stores it in the cache if there is none.
+     *
+     * \param dataFile The file from which the \p positions were loaded
+     * \param information Has to include everything besides the contents of the
+     *        \p dataFile that changes the \p positions, for example their unit
+     * \param positions The positions of all points in the point cloud
+     * \param maxClusterSize The largest number of points that end up in one cluster
+     * \return The index for the \p positions
+     */
+    static PointClusterIndex cachedOrBuild(const std::filesystem::path& dataFile,
+        std::string_view information, std::span<const glm::dvec3> positions,
+        uint32_t maxClusterSize);
+
+    /**
+     * Returns the index of each point in the original list of positions in the order in
+     * which they are grouped into clusters.
+     */
+    const std::vector<uint32_t>& order() const;
+
+    /**
+     * Returns the clusters, which together cover the entire #order.
+     */
+    const std::vector<Cluster>& clusters() const;
+
+    /**
+     * Writes the index into the provided \p file.
+     */
+    void save(const std::filesystem::path& file) const;
+
+    /**
+     * Reads an index from the provided \p file that was previously written with #save.
+     *
+     * \param file The file that is read
+     * \param nPoints The number of points that the index has to contain
+     * \return The index stored in the \p file, or `std::nullopt` if the \p file could
+     *         not be read, was written by a different version, or does not contain
+     *         \p nPoints points
+     */
+    static std::optional<PointClusterIndex> load(const std::filesystem::path& file,
+        size_t nPoints);
+
+private:
+    std::vector<uint32_t> _order;
+    std::vector<Cluster> _clusters;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___POINTCLUSTERINDEX___H__
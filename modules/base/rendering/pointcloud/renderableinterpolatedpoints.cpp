@@ -36,6 +36,7 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <optional>
+#include <span>
 
 namespace {
     constexpr std::string_view _loggerCat = "RenderableInterpolatedPoints";
@@ -292,6 +293,15 @@ RenderableInterpolatedPoints::RenderableInterpolatedPoints(
         );
         _skipFirstDataPoint = false;
     }
+
+    if (_useClusterIndex) {
+        LWARNING(
+            "Found a spatial index in asset. This is not supported for interpolated "
+            "point clouds, as the positions of the points change. Ignoring"
+        );
+        _useClusterIndex = false;
+        removePropertySubOwner(_culling);
+    }
 }
 
 void RenderableInterpolatedPoints::initialize() {
@@ -387,14 +397,10 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
                                                            std::vector<float>& result,
                                                            double& maxRadius) const
 {
-    using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
 
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
-
-    glm::dvec3 position0 = transformedPosition(e0);
-    glm::dvec3 position1 = transformedPosition(e1);
+    glm::dvec3 position0 = transformedPosition(firstIndex);
+    glm::dvec3 position1 = transformedPosition(secondIndex);
 
     const double r = glm::max(glm::length(position0), glm::length(position1));
     maxRadius = glm::max(maxRadius, r);
@@ -418,10 +424,8 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
             maxAllowedindex
         );
 
-        const Dataset::Entry& e00 = _dataset.entries[beforeIndex];
-        const Dataset::Entry& e11 = _dataset.entries[afterIndex];
-        glm::dvec3 positionBefore = transformedPosition(e00);
-        glm::dvec3 positionAfter = transformedPosition(e11);
+        glm::dvec3 positionBefore = transformedPosition(beforeIndex);
+        glm::dvec3 positionAfter = transformedPosition(afterIndex);
 
         for (int j = 0; j < 3; ++j) {
             result.push_back(static_cast<float>(positionBefore[j]));
@@ -436,40 +440,34 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
 void RenderableInterpolatedPoints::addColorAndSizeDataForPoint(unsigned int index,
                                                         std::vector<float>& result) const
 {
-    using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
 
     if (hasColorData()) {
-        const int colorParamIndex = currentColorParameterIndex();
-        result.push_back(e0.data[colorParamIndex]);
-        result.push_back(e1.data[colorParamIndex]);
+        const std::span<const float> column = _data.values[currentColorParameterIndex()];
+        result.push_back(column[firstIndex]);
+        result.push_back(column[secondIndex]);
     }
 
     if (hasSizeData()) {
-        const int sizeParamIndex = currentSizeParameterIndex();
+        const std::span<const float> column = _data.values[currentSizeParameterIndex()];
         // @TODO: Consider more detailed control over the scaling. Currently the value
         // is multiplied with the value as is. Should have similar mapping properties
         // as the color mapping
 
         // Convert to diameter if data is given as radius
         float multiplier = _sizeSettings.sizeMapping->isRadius ? 2.f : 1.f;
-        result.push_back(multiplier * e0.data[sizeParamIndex]);
-        result.push_back(multiplier * e1.data[sizeParamIndex]);
+        result.push_back(multiplier * column[firstIndex]);
+        result.push_back(multiplier * column[secondIndex]);
     }
 }
 
 void RenderableInterpolatedPoints::addOrientationDataForPoint(unsigned int index,
                                                         std::vector<float>& result) const
 {
-    using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
 
-    glm::quat q0 = orientationQuaternion(e0);
-    glm::quat q1 = orientationQuaternion(e1);
+    glm::quat q0 = orientationQuaternion(firstIndex);
+    glm::quat q1 = orientationQuaternion(secondIndex);
 
     result.push_back(q0.x);
     result.push_back(q0.y);
@@ -533,7 +531,7 @@ void RenderableInterpolatedPoints::initializeBufferData() {
 }
 
 void RenderableInterpolatedPoints::updateBufferData() {
-    if (!_hasDataFile || _dataset.entries.empty()) {
+    if (!_hasDataFile || _data.nEntries() == 0) {
         return;
     }
 
@@ -550,7 +548,11 @@ void RenderableInterpolatedPoints::updateBufferData() {
 
     glBindVertexArray(0);
 
+    // The interleaved buffer contains all attributes, so all of them are up to date now
     _dataIsDirty = false;
+    _colorDataIsDirty = false;
+    _sizeDataIsDirty = false;
+    _orientationDataIsDirty = false;
 }
 
 bool RenderableInterpolatedPoints::isAtKnot() const {
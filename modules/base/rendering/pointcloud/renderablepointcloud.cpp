@@ -25,9 +25,11 @@
 #include <modules/base/rendering/pointcloud/renderablepointcloud.h>
 
 #include <modules/base/basemodule.h>
+#include <openspace/data/datamapping.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/rendering/renderengine.h>
 #include <ghoul/filesystem/file.h>
@@ -46,6 +48,7 @@
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/vector_angle.hpp>
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
@@ -53,11 +56,30 @@
 #include <fstream>
 #include <locale>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace {
     constexpr std::string_view _loggerCat = "RenderablePointCloud";
 
+    // The number of points for which the values of an attribute are generated in one
+    // task when regenerating a vertex buffer
+    constexpr size_t PointsPerTask = 1 << 16;
+
+    struct AttributeLayout {
+        const char* name;
+        int nValues;
+    };
+
+    // Has to be in the same order as RenderablePointCloud::PointAttribute
+    constexpr std::array<AttributeLayout, 5> AttributeLayouts = {
+        AttributeLayout { "in_position", 3 },
+        AttributeLayout { "in_colorParameter", 1 },
+        AttributeLayout { "in_scalingParameter", 1 },
+        AttributeLayout { "in_orientation", 4 },
+        AttributeLayout { "in_textureLayer", 1 }
+    };
+
     enum RenderOption {
         ViewDirection = 0,
         PositionNormal,
@@ -307,6 +329,41 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo FrustumCullingInfo = {
+        "FrustumCulling",
+        "Frustum Culling",
+        "If true, clusters of points that are completely outside of the view frustum "
+        "of the camera are not rendered.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MinPointSizeInfo = {
+        "MinimumPointSize",
+        "Minimum Point Size",
+        "Clusters in which every point would appear smaller than this angle, in "
+        "degrees, are not rendered. A value of 0 disables this culling. The culling is "
+        "not applied when the points are sized based on a data value.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo LodAngularSizeInfo = {
+        "LodAngularSize",
+        "Level of Detail Angular Size",
+        "Clusters whose bounding sphere appears smaller than this angle, in degrees, are "
+        "rendered with fewer points. The number of points decreases with the square of "
+        "the apparent size of the cluster. A value of 0 renders all points of all "
+        "visible clusters.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo NumRenderedPointsInfo = {
+        "NumberOfRenderedPoints",
+        "Number of Rendered Points",
+        "Information about how many points were rendered in the last frame after the "
+        "culling and level of detail have been applied.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     // A RenderablePointCloud can be used to render point-based datasets in 3D space,
     // optionally including color mapping, a sprite texture and labels. There are several
     // properties that affect the visuals of the points, such as settings for scaling,
@@ -482,6 +539,27 @@ namespace {
 
         // Transformation matrix to be applied to the position of each object.
         std::optional<glm::dmat4x4> transformationMatrix;
+
+        struct SpatialIndex {
+            // The largest number of points that are grouped into one cluster. Smaller
+            // clusters are culled more precisely but increase the number of draw calls
+            std::optional<int> maxClusterSize [[codegen::greater(0)]];
+
+            // [[codegen::verbatim(FrustumCullingInfo.description)]]
+            std::optional<bool> frustumCulling;
+
+            // [[codegen::verbatim(MinPointSizeInfo.description)]]
+            std::optional<float> minimumPointSize [[codegen::greaterequal(0.f)]];
+
+            // [[codegen::verbatim(LodAngularSizeInfo.description)]]
+            std::optional<float> lodAngularSize [[codegen::greaterequal(0.f)]];
+        };
+        // If this value is specified, the points are grouped into clusters of nearby
+        // points when the dataset is loaded, and the grouping is cached together with
+        // the dataset. Only the clusters that are visible from the camera are rendered,
+        // which makes the rendering time depend on the number of visible points rather
+        // than on the size of the dataset. This is useful for very large datasets.
+        std::optional<SpatialIndex> spatialIndex;
     };
 
 #include "renderablepointcloud_codegen.cpp"
@@ -629,6 +707,30 @@ RenderablePointCloud::Fading::Fading(const ghoul::Dictionary& dictionary)
     addProperty(invert);
 }
 
+RenderablePointCloud::Culling::Culling(const ghoul::Dictionary& dictionary)
+    : properties::PropertyOwner({ "Culling", "Culling and Level of Detail", "" })
+    , frustumCulling(FrustumCullingInfo, true)
+    , minPointSize(MinPointSizeInfo, 0.f, 0.f, 1.f)
+    , lodAngularSize(LodAngularSizeInfo, 0.f, 0.f, 45.f)
+    , nRenderedPoints(NumRenderedPointsInfo, 0)
+{
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+
+    if (p.spatialIndex.has_value()) {
+        const Parameters::SpatialIndex settings = *p.spatialIndex;
+        frustumCulling = settings.frustumCulling.value_or(frustumCulling);
+        minPointSize = settings.minimumPointSize.value_or(minPointSize);
+        lodAngularSize = settings.lodAngularSize.value_or(lodAngularSize);
+    }
+
+    addProperty(frustumCulling);
+    addProperty(minPointSize);
+    addProperty(lodAngularSize);
+
+    nRenderedPoints.setReadOnly(true);
+    addProperty(nRenderedPoints);
+}
+
 RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
     : Renderable(dictionary)
     , _sizeSettings(dictionary)
@@ -643,6 +745,7 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
     )
     , _nDataPoints(NumShownDataPointsInfo, 0)
     , _hasOrientationData(HasOrientationDataInfo, false)
+    , _culling(dictionary)
 {
     ZoneScoped;
 
@@ -675,7 +778,7 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
     addProperty(_renderOption);
 
     _useRotation = p.useOrientationData.value_or(_useRotation);
-    _useRotation.onChange([this]() { _dataIsDirty = true; });
+    _useRotation.onChange([this]() { _orientationDataIsDirty = true; });
     addProperty(_useRotation);
 
     _useAdditiveBlending = p.useAdditiveBlending.value_or(_useAdditiveBlending);
@@ -732,9 +835,11 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
 
     if (_sizeSettings.sizeMapping != nullptr) {
         _sizeSettings.sizeMapping->parameterOption.onChange(
-            [this]() { _dataIsDirty = true; }
+            [this]() { _sizeDataIsDirty = true; }
+        );
+        _sizeSettings.sizeMapping->isRadius.onChange(
+            [this]() { _sizeDataIsDirty = true; }
         );
-        _sizeSettings.sizeMapping->isRadius.onChange([this]() { _dataIsDirty = true; });
         _hasDatavarSize = true;
     }
 
@@ -745,11 +850,19 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
         addPropertySubOwner(_fading);
     }
 
+    if (p.spatialIndex.has_value()) {
+        _useClusterIndex = true;
+        if (p.spatialIndex->maxClusterSize.has_value()) {
+            _maxClusterSize = static_cast<uint32_t>(*p.spatialIndex->maxClusterSize);
+        }
+        addPropertySubOwner(_culling);
+    }
+
     if (p.coloring.has_value() && (*p.coloring).colorMapping.has_value()) {
         _hasColorMapFile = true;
 
         _colorSettings.colorMapping->dataColumn.onChange(
-            [this]() { _dataIsDirty = true; }
+            [this]() { _colorDataIsDirty = true; }
         );
 
         _colorSettings.colorMapping->setRangeFromData.onChange([this]() {
@@ -760,7 +873,7 @@ RenderablePointCloud::RenderablePointCloud(const ghoul::Dictionary& dictionary)
         });
 
         _colorSettings.colorMapping->colorMapFile.onChange([this]() {
-            _dataIsDirty = true;
+            _colorDataIsDirty = true;
             _hasColorMapFile = std::filesystem::exists(
                 _colorSettings.colorMapping->colorMapFile.value()
             );
@@ -828,13 +941,18 @@ void RenderablePointCloud::initialize() {
             _dataset = dataloader::data::loadFile(_dataFile, _dataMapping);
         }
 
-        if (_skipFirstDataPoint) {
-            _dataset.entries.erase(_dataset.entries.begin());
+        if (_skipFirstDataPoint && _dataset.nEntries() > 0) {
+            _dataset.removeEntry(0);
         }
+        _data = _dataset.view();
 
-        _nDataPoints = static_cast<unsigned int>(_dataset.entries.size());
+        _nDataPoints = static_cast<unsigned int>(_data.nEntries());
         _hasOrientationData = _dataset.orientationDataIndex >= 0;
 
+        if (_useClusterIndex && _data.nEntries() > 0) {
+            buildClusterIndex();
+        }
+
         // If no scale exponent was specified, compute one that will at least show the
         // points based on the scale of the positions in the dataset
         if (_shouldComputeScaleExponent) {
@@ -882,11 +1000,24 @@ void RenderablePointCloud::initializeGL() {
                 break;
         }
     }
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderablePointCloud::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
+    glDeleteBuffers(
+        static_cast<GLsizei>(_attributeBuffers.size()),
+        _attributeBuffers.data()
+    );
+    _attributeBuffers.fill(0);
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
 
@@ -1169,7 +1300,7 @@ void RenderablePointCloud::renderPoints(const RenderData& data,
                                         const glm::dvec3& orthoUp,
                                         float fadeInVariable)
 {
-    if (!_hasDataFile || _dataset.entries.empty()) {
+    if (!_hasDataFile || _data.nEntries() == 0) {
         return;
     }
 
@@ -1299,25 +1430,50 @@ void RenderablePointCloud::renderPoints(const RenderData& data,
 
     glBindVertexArray(_vao);
 
+    const bool useClusters = !_clusterRanges.empty();
+    if (useClusters) {
+        updateClusterVisibility(data, modelMatrix);
+    }
+
+    size_t nRenderedPoints = 0;
     if (useTexture && !_textureArrays.empty()) {
         spriteTextureUnit.activate();
-        for (const TextureArrayInfo& arrayInfo : _textureArrays) {
+        for (size_t i = 0; i < _textureArrays.size(); i++) {
+            const TextureArrayInfo& arrayInfo = _textureArrays[i];
             _program->setUniform(
                 _uniformCache.aspectRatioScale,
                 arrayInfo.aspectRatioScale
             );
             glBindTexture(GL_TEXTURE_2D_ARRAY, arrayInfo.renderId);
-            glDrawArrays(
-                GL_POINTS,
-                arrayInfo.startOffset,
-                static_cast<GLsizei>(arrayInfo.nPoints)
-            );
+            if (useClusters) {
+                nRenderedPoints += drawClusters(i);
+            }
+            else {
+                glDrawArrays(
+                    GL_POINTS,
+                    arrayInfo.startOffset,
+                    static_cast<GLsizei>(arrayInfo.nPoints)
+                );
+            }
         }
         glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
     }
     else {
         _program->setUniform(_uniformCache.aspectRatioScale, glm::vec2(1.f));
-        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(_nDataPoints));
+        if (useClusters) {
+            const size_t nGroups =
+                _clusterRanges.size() / _clusterIndex->clusters().size();
+            for (size_t i = 0; i < nGroups; i++) {
+                nRenderedPoints += drawClusters(i);
+            }
+        }
+        else {
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(_nDataPoints));
+        }
+    }
+
+    if (useClusters && _culling.nRenderedPoints.value() != nRenderedPoints) {
+        _culling.nRenderedPoints = static_cast<unsigned int>(nRenderedPoints);
     }
 
     glBindVertexArray(0);
@@ -1378,30 +1534,28 @@ void RenderablePointCloud::update(const UpdateData&) {
         updateSpriteTexture();
     }
 
-    if (_dataIsDirty) {
+    const bool isDirty = _dataIsDirty || _colorDataIsDirty || _sizeDataIsDirty ||
+        _orientationDataIsDirty;
+    if (isDirty) {
         updateBufferData();
     }
 }
 
-glm::dvec3 RenderablePointCloud::transformedPosition(
-                                                const dataloader::Dataset::Entry& e) const
-{
+glm::dvec3 RenderablePointCloud::transformedPosition(size_t index) const {
     const double unitMeter = toMeter(_unit);
-    glm::dvec4 position = glm::dvec4(glm::dvec3(e.position) * unitMeter, 1.0);
+    glm::dvec4 position = glm::dvec4(glm::dvec3(_data.positions[index]) * unitMeter, 1.0);
     return glm::dvec3(_transformationMatrix * position);
 }
 
-glm::quat RenderablePointCloud::orientationQuaternion(
-                                                const dataloader::Dataset::Entry& e) const
-{
+glm::quat RenderablePointCloud::orientationQuaternion(size_t index) const {
     const int orientationDataIndex = _dataset.orientationDataIndex;
 
     const glm::vec3 u = glm::normalize(glm::vec3(
         _transformationMatrix *
         glm::dvec4(
-            e.data[orientationDataIndex + 0],
-            e.data[orientationDataIndex + 1],
-            e.data[orientationDataIndex + 2],
+            _data.values[orientationDataIndex + 0][index],
+            _data.values[orientationDataIndex + 1][index],
+            _data.values[orientationDataIndex + 2][index],
             1.f
         )
     ));
@@ -1409,9 +1563,9 @@ glm::quat RenderablePointCloud::orientationQuaternion(
     const glm::vec3 v = glm::normalize(glm::vec3(
         _transformationMatrix *
         glm::dvec4(
-            e.data[orientationDataIndex + 3],
-            e.data[orientationDataIndex + 4],
-            e.data[orientationDataIndex + 5],
+            _data.values[orientationDataIndex + 3][index],
+            _data.values[orientationDataIndex + 4][index],
+            _data.values[orientationDataIndex + 5][index],
             1.f
         )
     ));
@@ -1459,55 +1613,459 @@ int RenderablePointCloud::bufferVertexAttribute(const std::string& name, GLint n
 }
 
 void RenderablePointCloud::updateBufferData() {
-    if (!_hasDataFile || _dataset.entries.empty()) {
+    if (!_hasDataFile || _data.nEntries() == 0) {
         return;
     }
 
     ZoneScopedN("Data dirty");
     TracyGpuZone("Data dirty");
-    LDEBUG("Regenerating data");
-
-    std::vector<float> slice = createDataSlice();
-
-    int size = static_cast<int>(slice.size());
 
     if (_vao == 0) {
         glGenVertexArrays(1, &_vao);
         LDEBUG(std::format("Generating Vertex Array id '{}'", _vao));
     }
-    if (_vbo == 0) {
-        glGenBuffers(1, &_vbo);
-        LDEBUG(std::format("Generating Vertex Buffer Object id '{}'", _vbo));
+
+    if (_dataIsDirty) {
+        LDEBUG("Regenerating data");
+        updatePointOrder();
+        updateAttributeBuffer(PointAttribute::Position);
+        updateAttributeBuffer(PointAttribute::TextureLayer);
+        // The order of the points might have changed, so all other attributes have to
+        // be regenerated as well
+        _colorDataIsDirty = true;
+        _sizeDataIsDirty = true;
+        _orientationDataIsDirty = true;
+        _dataIsDirty = false;
+    }
+
+    if (_colorDataIsDirty) {
+        updateAttributeBuffer(PointAttribute::ColorParameter);
+        _colorDataIsDirty = false;
+    }
+    if (_sizeDataIsDirty) {
+        updateAttributeBuffer(PointAttribute::SizeParameter);
+        _sizeDataIsDirty = false;
+    }
+    if (_orientationDataIsDirty) {
+        updateAttributeBuffer(PointAttribute::Orientation);
+        _orientationDataIsDirty = false;
     }
+}
 
-    glBindVertexArray(_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, size * sizeof(float), slice.data(), GL_STATIC_DRAW);
+void RenderablePointCloud::updatePointOrder() {
+    ZoneScoped;
+
+    _pointOrder.clear();
+    _clusterRanges.clear();
+    for (TextureArrayInfo& arrayInfo : _textureArrays) {
+        arrayInfo.startOffset = 0;
+        arrayInfo.nPoints = 0;
+    }
+
+    const size_t nPoints = _data.nEntries();
+    const bool useMultiTexture =
+        _textureMode == TextureInputMode::Multi && hasMultiTextureData();
+
+    // The texture array of each point in the dataset, if there is more than one
+    std::vector<unsigned int> arrayIds;
+    if (useMultiTexture && _textureArrays.size() > 1) {
+        arrayIds.resize(nPoints);
+        const std::span<const float> texIds = _data.values[_dataset.textureDataIndex];
+        for (size_t i = 0; i < nPoints; i++) {
+            const int texId = static_cast<int>(texIds[i]);
+            const size_t texIndex = _indexInDataToTextureIndex[texId];
+            arrayIds[i] = _textureIndexToArrayMap[texIndex].arrayId;
+        }
+    }
 
-    const int attibsPerPoint = nAttributesPerPoint();
-    int offset = 0;
+    if (arrayIds.empty() && !_clusterIndex.has_value()) {
+        // All points are rendered with the first texture array in dataset order
+        if (!_textureArrays.empty()) {
+            _textureArrays.front().nPoints = static_cast<int>(nPoints);
+        }
+        return;
+    }
 
-    offset = bufferVertexAttribute("in_position", 3, attibsPerPoint, offset);
+    // Without a spatial index, all points are treated as part of a single cluster
+    std::vector<uint32_t> identity;
+    std::vector<PointClusterIndex::Cluster> single;
+    if (!_clusterIndex.has_value()) {
+        identity.resize(nPoints);
+        for (size_t i = 0; i < nPoints; i++) {
+            identity[i] = static_cast<uint32_t>(i);
+        }
+        single.push_back({ .first = 0, .count = static_cast<uint32_t>(nPoints) });
+    }
+    const std::vector<uint32_t>& order =
+        _clusterIndex.has_value() ? _clusterIndex->order() : identity;
+    const std::vector<PointClusterIndex::Cluster>& clusters =
+        _clusterIndex.has_value() ? _clusterIndex->clusters() : single;
+
+    // Sort the points by texture array and then by cluster with a counting sort, which
+    // keeps the order of the points within each cluster
+    const size_t nGroups = arrayIds.empty() ? 1 : _textureArrays.size();
+    const size_t nClusters = clusters.size();
+    _clusterRanges.resize(nGroups * nClusters);
+    auto rangeIndex = [&arrayIds, nClusters](uint32_t point, size_t cluster) {
+        return (arrayIds.empty() ? 0 : arrayIds[point]) * nClusters + cluster;
+    };
+    for (size_t c = 0; c < nClusters; c++) {
+        const PointClusterIndex::Cluster& cluster = clusters[c];
+        for (uint32_t i = cluster.first; i < cluster.first + cluster.count; i++) {
+            _clusterRanges[rangeIndex(order[i], c)].count++;
+        }
+    }
 
-    if (hasColorData()) {
-        offset = bufferVertexAttribute("in_colorParameter", 1, attibsPerPoint, offset);
+    std::vector<GLint> next(_clusterRanges.size());
+    GLint offset = 0;
+    for (size_t g = 0; g < nGroups; g++) {
+        const GLint groupOffset = offset;
+        for (size_t c = 0; c < nClusters; c++) {
+            ClusterRange& range = _clusterRanges[g * nClusters + c];
+            range.first = offset;
+            next[g * nClusters + c] = offset;
+            offset += range.count;
+        }
+        if (g < _textureArrays.size()) {
+            _textureArrays[g].startOffset = groupOffset;
+            _textureArrays[g].nPoints = offset - groupOffset;
+        }
     }
 
-    if (hasSizeData()) {
-        offset = bufferVertexAttribute("in_scalingParameter", 1, attibsPerPoint, offset);
+    _pointOrder.resize(nPoints);
+    for (size_t c = 0; c < nClusters; c++) {
+        const PointClusterIndex::Cluster& cluster = clusters[c];
+        for (uint32_t i = cluster.first; i < cluster.first + cluster.count; i++) {
+            _pointOrder[next[rangeIndex(order[i], c)]++] = order[i];
+        }
     }
 
-    if (useOrientationData()) {
-        offset = bufferVertexAttribute("in_orientation", 4, attibsPerPoint, offset);
+    if (!_clusterIndex.has_value()) {
+        // The ranges of the single cluster are already covered by the texture arrays
+        _clusterRanges.clear();
     }
+}
 
-    if (_hasSpriteTexture) {
-        offset = bufferVertexAttribute("in_textureLayer", 1, attibsPerPoint, offset);
+void RenderablePointCloud::buildClusterIndex() {
+    ZoneScoped;
+
+    std::vector<glm::dvec3> positions;
+    positions.reserve(_data.nEntries());
+    for (size_t i = 0; i < _data.nEntries(); i++) {
+        positions.push_back(transformedPosition(i));
+    }
+
+    if (_useCaching) {
+        // Everything that changes the positions besides the content of the data file
+        const std::string info = std::format(
+            "{}|{}|{}|{}",
+            dataloader::generateHashString(_dataMapping), toMeter(_unit),
+            glm::to_string(_transformationMatrix), _skipFirstDataPoint
+        );
+        _clusterIndex = PointClusterIndex::cachedOrBuild(
+            _dataFile,
+            info,
+            positions,
+            _maxClusterSize
+        );
+    }
+    else {
+        _clusterIndex = PointClusterIndex::build(positions, _maxClusterSize);
+    }
+    _clusterLodFractions.resize(_clusterIndex->clusters().size(), 1.f);
+}
+
+void RenderablePointCloud::updateClusterVisibility(const RenderData& data,
+                                                   const glm::dmat4& modelMatrix)
+{
+    ZoneScoped;
+
+    const std::vector<PointClusterIndex::Cluster>& clusters = _clusterIndex->clusters();
+
+    // The planes of the view frustum in world space, pointing inwards
+    const glm::dmat4 viewProjection =
+        glm::dmat4(data.camera.projectionMatrix()) * data.camera.combinedViewMatrix();
+    const glm::dmat4 rows = glm::transpose(viewProjection);
+    std::array<glm::dvec4, 6> planes;
+    for (int i = 0; i < 3; i++) {
+        planes[2 * i] = rows[3] + rows[i];
+        planes[2 * i + 1] = rows[3] - rows[i];
+    }
+    for (glm::dvec4& plane : planes) {
+        plane /= glm::length(glm::dvec3(plane));
     }
 
+    // The clusters are stored in model space, so their radii have to be scaled
+    const double scale = std::max({
+        glm::length(glm::dvec3(modelMatrix[0])),
+        glm::length(glm::dvec3(modelMatrix[1])),
+        glm::length(glm::dvec3(modelMatrix[2]))
+    });
+    const glm::dvec3 cameraPosition = data.camera.positionVec3();
+
+    // The half size of each point in world space, which is only known if the points are
+    // not sized based on a data value. The max size control can only make points smaller
+    const bool useSizeMapping = _hasDatavarSize && _sizeSettings.sizeMapping &&
+        _sizeSettings.sizeMapping->enabled;
+    const double pointRadius = useSizeMapping ?
+        0.0 :
+        0.5 * std::pow(10.0, _sizeSettings.scaleExponent.value()) *
+            _sizeSettings.scaleFactor.value();
+    const double minPointSize = useSizeMapping ?
+        0.0 :
+        std::tan(glm::radians(static_cast<double>(_culling.minPointSize.value())));
+    const double lodAngle =
+        glm::radians(static_cast<double>(_culling.lodAngularSize.value()));
+
+    for (size_t i = 0; i < clusters.size(); i++) {
+        const PointClusterIndex::Cluster& cluster = clusters[i];
+        const glm::dvec3 center = glm::dvec3(
+            modelMatrix * glm::dvec4(cluster.center, 1.0)
+        );
+        const double radius = cluster.radius * scale;
+
+        bool isVisible = true;
+        if (_culling.frustumCulling) {
+            for (const glm::dvec4& plane : planes) {
+                const double dist = glm::dot(glm::dvec3(plane), center) + plane.w;
+                if (dist < -(radius + pointRadius)) {
+                    isVisible = false;
+                    break;
+                }
+            }
+        }
+
+        const double distance = glm::distance(center, cameraPosition);
+        const double closestDistance = distance - radius;
+        if (minPointSize > 0.0 && closestDistance > 0.0 &&
+            pointRadius / closestDistance < minPointSize)
+        {
+            isVisible = false;
+        }
+
+        float fraction = isVisible ? 1.f : 0.f;
+        if (isVisible && lodAngle > 0.0 && closestDistance > 0.0) {
+            // The number of points is reduced with the apparent area of the cluster
+            const double ratio = (radius / distance) / lodAngle;
+            fraction = static_cast<float>(std::min(ratio * ratio, 1.0));
+        }
+        _clusterLodFractions[i] = fraction;
+    }
+}
+
+size_t RenderablePointCloud::drawClusters(size_t group) {
+    const size_t nClusters = _clusterIndex->clusters().size();
+    if ((group + 1) * nClusters > _clusterRanges.size()) {
+        return 0;
+    }
+
+    _drawFirsts.clear();
+    _drawCounts.clear();
+    size_t nPoints = 0;
+    for (size_t c = 0; c < nClusters; c++) {
+        const ClusterRange& range = _clusterRanges[group * nClusters + c];
+        const float fraction = _clusterLodFractions[c];
+        if (range.count == 0 || fraction == 0.f) {
+            continue;
+        }
+
+        // The points of a cluster are shuffled, so any prefix is an even subsample
+        const GLsizei count = std::max(
+            static_cast<GLsizei>(std::ceil(range.count * fraction)),
+            1
+        );
+        nPoints += count;
+
+        const bool isAdjacent = !_drawFirsts.empty() &&
+            _drawFirsts.back() + _drawCounts.back() == range.first;
+        if (isAdjacent) {
+            // Merge with the previous cluster as it was drawn completely
+            _drawCounts.back() += count;
+        }
+        else {
+            _drawFirsts.push_back(range.first);
+            _drawCounts.push_back(count);
+        }
+    }
+
+    if (!_drawFirsts.empty()) {
+        glMultiDrawArrays(
+            GL_POINTS,
+            _drawFirsts.data(),
+            _drawCounts.data(),
+            static_cast<GLsizei>(_drawFirsts.size())
+        );
+    }
+    return nPoints;
+}
+
+void RenderablePointCloud::updateAttributeBuffer(PointAttribute attribute) {
+    ZoneScoped;
+
+    const AttributeLayout layout = AttributeLayouts[static_cast<int>(attribute)];
+    const GLint location = _program->attributeLocation(layout.name);
+
+    bool isUsed = true;
+    switch (attribute) {
+        case PointAttribute::Position:
+            break;
+        case PointAttribute::ColorParameter:
+            isUsed = hasColorData();
+            break;
+        case PointAttribute::SizeParameter:
+            isUsed = hasSizeData();
+            break;
+        case PointAttribute::Orientation:
+            isUsed = useOrientationData();
+            break;
+        case PointAttribute::TextureLayer:
+            isUsed = _hasSpriteTexture;
+            break;
+    }
+
+    glBindVertexArray(_vao);
+    if (!isUsed || location < 0) {
+        // The shader will read the constant default value of the attribute instead
+        if (location >= 0) {
+            glDisableVertexAttribArray(location);
+        }
+        glBindVertexArray(0);
+        return;
+    }
+
+    GLuint& buffer = _attributeBuffers[static_cast<int>(attribute)];
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+    }
+
+    const size_t nPoints = _data.nEntries();
+    const size_t nValues = nPoints * layout.nValues;
+    const size_t nTasks = (nPoints + PointsPerTask - 1) / PointsPerTask;
+
+    // Generates the values directly into the destination, splitting the points among
+    // the worker threads if there are enough of them to make that worthwhile
+    std::vector<double> maxRadii = std::vector<double>(nTasks, 0.0);
+    auto fill = [this, attribute, nPoints, nTasks, &maxRadii](float* values) {
+        if (nTasks == 1) {
+            maxRadii[0] = fillAttributeValues(attribute, 0, nPoints, values);
+            return;
+        }
+
+        TaskScheduler::TaskGroup group(*global::taskScheduler);
+        for (size_t i = 0; i < nTasks; i++) {
+            group.run([this, attribute, nPoints, values, i, &maxRadii]() {
+                const size_t begin = i * PointsPerTask;
+                const size_t end = std::min(begin + PointsPerTask, nPoints);
+                maxRadii[i] = fillAttributeValues(attribute, begin, end, values);
+            });
+        }
+        group.wait();
+    };
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // Orphan the previous storage so that we do not have to wait for draw calls that
+    // might still be reading from it, and then write into the new storage directly
+    glBufferData(GL_ARRAY_BUFFER, nValues * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    float* mapped = reinterpret_cast<float*>(
+        glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY)
+    );
+    bool isUploaded = false;
+    if (mapped) {
+        fill(mapped);
+        // Unmapping fails if the storage was lost while it was mapped
+        isUploaded = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    }
+    if (!isUploaded) {
+        std::vector<float> values = std::vector<float>(nValues);
+        fill(values.data());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, nValues * sizeof(float), values.data());
+    }
+
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, layout.nValues, GL_FLOAT, GL_FALSE, 0, nullptr);
     glBindVertexArray(0);
 
-    _dataIsDirty = false;
+    if (attribute == PointAttribute::Position) {
+        setBoundingSphere(*std::max_element(maxRadii.begin(), maxRadii.end()));
+    }
+}
+
+double RenderablePointCloud::fillAttributeValues(PointAttribute attribute, size_t begin,
+                                                 size_t end, float* values) const
+{
+    // The index in the dataset of the point at position i in the vertex buffer
+    auto entry = [this](size_t i) -> size_t {
+        return _pointOrder.empty() ? i : _pointOrder[i];
+    };
+
+    double maxRadius = 0.0;
+    switch (attribute) {
+        case PointAttribute::Position:
+            for (size_t i = begin; i < end; i++) {
+                const glm::dvec3 position = transformedPosition(entry(i));
+                values[3 * i] = static_cast<float>(position.x);
+                values[3 * i + 1] = static_cast<float>(position.y);
+                values[3 * i + 2] = static_cast<float>(position.z);
+                maxRadius = std::max(maxRadius, glm::length(position));
+            }
+            break;
+        case PointAttribute::ColorParameter:
+        {
+            const std::span<const float> column =
+                _data.values[currentColorParameterIndex()];
+            for (size_t i = begin; i < end; i++) {
+                values[i] = column[entry(i)];
+            }
+            break;
+        }
+        case PointAttribute::SizeParameter:
+        {
+            const std::span<const float> column =
+                _data.values[currentSizeParameterIndex()];
+            // Convert to diameter if data is given as radius
+            const float multiplier = _sizeSettings.sizeMapping->isRadius ? 2.f : 1.f;
+            for (size_t i = begin; i < end; i++) {
+                values[i] = multiplier * column[entry(i)];
+            }
+            break;
+        }
+        case PointAttribute::Orientation:
+            for (size_t i = begin; i < end; i++) {
+                const glm::quat q = orientationQuaternion(entry(i));
+                values[4 * i] = q.x;
+                values[4 * i + 1] = q.y;
+                values[4 * i + 2] = q.z;
+                values[4 * i + 3] = q.w;
+            }
+            break;
+        case PointAttribute::TextureLayer:
+        {
+            const bool useMultiTexture =
+                _textureMode == TextureInputMode::Multi && hasMultiTextureData();
+            if (!useMultiTexture) {
+                // Default texture layer for single texture is zero
+                std::fill(values + begin, values + end, 0.f);
+                break;
+            }
+            const std::span<const float> texIds =
+                _data.values[_dataset.textureDataIndex];
+            for (size_t i = begin; i < end; i++) {
+                const int texId = static_cast<int>(texIds[entry(i)]);
+                // Points with an unknown texture use the first layer
+                values[i] = 0.f;
+                const auto texIndex = _indexInDataToTextureIndex.find(texId);
+                if (texIndex == _indexInDataToTextureIndex.end()) {
+                    continue;
+                }
+                const auto id = _textureIndexToArrayMap.find(texIndex->second);
+                if (id != _textureIndexToArrayMap.end()) {
+                    values[i] = static_cast<float>(id->second.layer);
+                }
+            }
+            break;
+        }
+    }
+    return maxRadius;
 }
 
 void RenderablePointCloud::updateSpriteTexture() {
@@ -1597,8 +2155,7 @@ void RenderablePointCloud::addPositionDataForPoint(unsigned int index,
                                                    std::vector<float>& result,
                                                    double& maxRadius) const
 {
-    const dataloader::Dataset::Entry& e = _dataset.entries[index];
-    glm::dvec3 position = transformedPosition(e);
+    glm::dvec3 position = transformedPosition(index);
     const double r = glm::length(position);
 
     // Add values to result
@@ -1612,11 +2169,9 @@ void RenderablePointCloud::addPositionDataForPoint(unsigned int index,
 void RenderablePointCloud::addColorAndSizeDataForPoint(unsigned int index,
                                                        std::vector<float>& result) const
 {
-    const dataloader::Dataset::Entry& e = _dataset.entries[index];
-
     if (hasColorData()) {
         const int colorParamIndex = currentColorParameterIndex();
-        result.push_back(e.data[colorParamIndex]);
+        result.push_back(_data.values[colorParamIndex][index]);
     }
 
     if (hasSizeData()) {
@@ -1627,15 +2182,14 @@ void RenderablePointCloud::addColorAndSizeDataForPoint(unsigned int index,
 
         // Convert to diameter if data is given as radius
         float multiplier = _sizeSettings.sizeMapping->isRadius ? 2.f : 1.f;
-        result.push_back(multiplier * e.data[sizeParamIndex]);
+        result.push_back(multiplier * _data.values[sizeParamIndex][index]);
     }
 }
 
 void RenderablePointCloud::addOrientationDataForPoint(unsigned int index,
                                                       std::vector<float>& result) const
 {
-    const dataloader::Dataset::Entry& e = _dataset.entries[index];
-    glm::quat q = orientationQuaternion(e);
+    glm::quat q = orientationQuaternion(index);
 
     result.push_back(q.x);
     result.push_back(q.y);
@@ -1646,7 +2200,7 @@ void RenderablePointCloud::addOrientationDataForPoint(unsigned int index,
 std::vector<float> RenderablePointCloud::createDataSlice() {
     ZoneScoped;
 
-    if (_dataset.entries.empty()) {
+    if (_data.nEntries() == 0) {
         return std::vector<float>();
     }
 
@@ -1660,12 +2214,10 @@ std::vector<float> RenderablePointCloud::createDataSlice() {
 
     // Reserve enough space for all points in each for now
     for (std::vector<float>& subres : subResults) {
-        subres.reserve(nAttributesPerPoint() * _dataset.entries.size());
+        subres.reserve(nAttributesPerPoint() * _data.nEntries());
     }
 
     for (unsigned int i = 0; i < _nDataPoints; i++) {
-        const dataloader::Dataset::Entry& e = _dataset.entries[i];
-
         unsigned int subresultIndex = 0;
         // Default texture layer for single texture is zero
         float textureLayer = 0.f;
@@ -1674,7 +2226,7 @@ std::vector<float> RenderablePointCloud::createDataSlice() {
             hasMultiTextureData();
 
         if (useMultiTexture) {
-            int texId = static_cast<int>(e.data[_dataset.textureDataIndex]);
+            int texId = static_cast<int>(_data.values[_dataset.textureDataIndex][i]);
             size_t texIndex = _indexInDataToTextureIndex[texId];
             textureLayer = static_cast<float>(
                 _textureIndexToArrayMap[texIndex].layer
@@ -1704,7 +2256,7 @@ std::vector<float> RenderablePointCloud::createDataSlice() {
 
     // Combine subresults, which should be in same order as texture arrays
     std::vector<float> result;
-    result.reserve(nAttributesPerPoint() * _dataset.entries.size());
+    result.reserve(nAttributesPerPoint() * _data.nEntries());
     size_t vertexCount = 0;
     for (size_t i = 0; i < subResults.size(); ++i) {
         result.insert(result.end(), subResults[i].begin(), subResults[i].end());
@@ -27,6 +27,7 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/base/rendering/pointcloud/pointclusterindex.h>
 #include <modules/base/rendering/pointcloud/sizemappingcomponent.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
@@ -42,8 +43,10 @@
 #include <openspace/util/distanceconversion.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <array>
 #include <filesystem>
 #include <functional>
+#include <optional>
 
 namespace ghoul::opengl {
     class ProgramObject;
@@ -97,8 +100,8 @@ protected:
     virtual void setExtraUniforms();
     virtual void preUpdate();
 
-    glm::dvec3 transformedPosition(const dataloader::Dataset::Entry& e) const;
-    glm::quat orientationQuaternion(const dataloader::Dataset::Entry& e) const;
+    glm::dvec3 transformedPosition(size_t index) const;
+    glm::quat orientationQuaternion(size_t index) const;
 
     virtual int nAttributesPerPoint() const;
 
@@ -114,6 +117,64 @@ protected:
     virtual void updateBufferData();
     void updateSpriteTexture();
 
+    /// The attributes of a point. Each attribute is stored in a separate vertex buffer so
+    /// that changing, for example, the color parameter only has to regenerate and upload
+    /// the values of that one attribute
+    enum class PointAttribute {
+        Position = 0,
+        ColorParameter,
+        SizeParameter,
+        Orientation,
+        TextureLayer
+    };
+
+    /**
+     * Computes the order in which the points are stored in the vertex buffers, which
+     * groups the points by the texture array that they use so that each texture array
+     * can be drawn with a single draw call. Also updates the offsets and number of points
+     * of the `_textureArrays`.
+     */
+    void updatePointOrder();
+
+    /**
+     * Builds the #_clusterIndex from the positions of the points in the dataset, or
+     * loads it from the cache if caching is enabled.
+     */
+    void buildClusterIndex();
+
+    /**
+     * Determines for each cluster of the #_clusterIndex whether it is visible from the
+     * camera and which fraction of its points should be rendered. The result is stored
+     * in the `_clusterLodFractions`.
+     */
+    void updateClusterVisibility(const RenderData& data, const glm::dmat4& modelMatrix);
+
+    /**
+     * Draws the visible part of each cluster in the provided point \p group with a single
+     * multi-draw call.
+     *
+     * \return The number of points that were drawn
+     */
+    size_t drawClusters(size_t group);
+
+    /**
+     * Regenerates the values of the provided \p attribute for all points and uploads
+     * them to the attribute's vertex buffer. If the attribute is currently not used, the
+     * vertex attribute array is disabled instead.
+     */
+    void updateAttributeBuffer(PointAttribute attribute);
+
+    /**
+     * Writes the values of the \p attribute for the points in the range [\p begin,
+     * \p end) in buffer order into \p values. This function does not modify any state
+     * and is called concurrently for different ranges.
+     *
+     * \return The largest distance of any of the points from the origin if the
+     *         \p attribute is the PointAttribute::Position, 0 otherwise
+     */
+    double fillAttributeValues(PointAttribute attribute, size_t begin, size_t end,
+        float* values) const;
+
     /// Find the index of the currently chosen color parameter in the dataset
     int currentColorParameterIndex() const;
     /// Find the index of the currently chosen size parameter in the dataset
@@ -161,6 +222,9 @@ protected:
     ghoul::opengl::Texture::Format glFormat(bool useAlpha) const;
 
     bool _dataIsDirty = true;
+    bool _colorDataIsDirty = false;
+    bool _sizeDataIsDirty = false;
+    bool _orientationDataIsDirty = false;
     bool _spriteTextureIsDirty = false;
     bool _cmapIsDirty = true;
 
@@ -212,6 +276,15 @@ protected:
     properties::UIntProperty _nDataPoints;
     properties::BoolProperty _hasOrientationData;
 
+    struct Culling : properties::PropertyOwner {
+        explicit Culling(const ghoul::Dictionary& dictionary);
+        properties::BoolProperty frustumCulling;
+        properties::FloatProperty minPointSize;
+        properties::FloatProperty lodAngularSize;
+        properties::UIntProperty nRenderedPoints;
+    };
+    Culling _culling;
+
     struct Texture : properties::PropertyOwner {
         Texture();
         properties::BoolProperty enabled;
@@ -246,6 +319,9 @@ protected:
     bool _skipFirstDataPoint = false;
 
     dataloader::Dataset _dataset;
+    /// The columns of the `_dataset` that all point data is read from. Updated whenever
+    /// the `_dataset` is loaded
+    dataloader::DatasetView _data;
     dataloader::DataMapping _dataMapping;
 
     std::unique_ptr<LabelsComponent> _labels;
@@ -255,6 +331,31 @@ protected:
     GLuint _vao = 0;
     GLuint _vbo = 0;
 
+    /// One vertex buffer per PointAttribute
+    std::array<GLuint, 5> _attributeBuffers = {};
+
+    /// The index in the dataset of each point in the vertex buffers. If this is empty,
+    /// the points are stored in the same order as in the dataset
+    std::vector<unsigned int> _pointOrder;
+
+    bool _useClusterIndex = false;
+    uint32_t _maxClusterSize = 4096;
+    std::optional<PointClusterIndex> _clusterIndex;
+
+    struct ClusterRange {
+        GLint first = 0;
+        GLsizei count = 0;
+    };
+    /// The range in the vertex buffers of the points of each cluster. The points are
+    /// grouped by texture array first, so there is one range per cluster for each group,
+    /// and the ranges of group `g` start at index `g * nClusters`
+    std::vector<ClusterRange> _clusterRanges;
+    /// The fraction of the points of each cluster that is rendered in the current frame,
+    /// where 0 means that the cluster is culled
+    std::vector<float> _clusterLodFractions;
+    std::vector<GLint> _drawFirsts;
+    std::vector<GLsizei> _drawCounts;
+
     // List of (unique) loaded textures. The other maps refer to the index in this vector
     std::vector<std::unique_ptr<ghoul::opengl::Texture>> _textures;
     std::unordered_map<std::string, size_t> _textureNameToIndex;
@@ -285,7 +285,7 @@ RenderableNodeArrow::Shading::Shading()
 }
 
 RenderableNodeArrow::RenderableNodeArrow(const ghoul::Dictionary& dictionary)
-    : Renderable(dictionary)
+    : Renderable(dictionary, { .supportsParallelUpdate = true })
     , _start(StartNodeInfo)
     , _end(EndNodeInfo)
     , _color(ColorInfo, glm::vec3(1.f), glm::vec3(0.f), glm::vec3(1.f))
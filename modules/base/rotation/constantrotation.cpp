@@ -104,4 +104,8 @@ glm::dmat3 ConstantRotation::matrix(const UpdateData& data) const {
     return glm::toMat3(q);
 }
 
+bool ConstantRotation::supportsParallelUpdate(const UpdateData&) const {
+    return true;
+}
+
 } // namespace openspace
@@ -127,4 +127,8 @@ glm::dmat3 StaticRotation::matrix(const UpdateData&) const {
     return _cachedMatrix;
 }
 
+bool StaticRotation::supportsParallelUpdate(const UpdateData&) const {
+    return true;
+}
+
 } // namespace openspace
@@ -73,4 +73,8 @@ glm::dvec3 NonUniformStaticScale::scaleValue(const UpdateData&) const {
     return _scaleValue;
 }
 
+bool NonUniformStaticScale::supportsParallelUpdate(const UpdateData&) const {
+    return true;
+}
+
 } // namespace openspace
@@ -37,6 +37,7 @@ class NonUniformStaticScale : public Scale {
 public:
     explicit NonUniformStaticScale(const ghoul::Dictionary& dictionary);
     glm::dvec3 scaleValue(const UpdateData& data) const override;
+    bool supportsParallelUpdate(const UpdateData& data) const override;
 
     static documentation::Documentation Documentation();
 
@@ -0,0 +1,146 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/tasks/benchmarkdataloadingtask.h>
+
+#include <openspace/data/dataloader.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/stringhelper.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+    constexpr std::string_view _loggerCat = "BenchmarkDataLoadingTask";
+
+    bool isDataFile(const std::filesystem::path& path) {
+        const std::string extension = ghoul::toLowerCase(path.extension().string());
+        return extension == ".speck" || extension == ".csv";
+    }
+
+    // This task loads the SPECK and CSV files through the DataLoader without using the
+    // cache and reports the number of rows per second that were parsed for each file
+    struct [[codegen::Dictionary(BenchmarkDataLoadingTask)]] Parameters {
+        // The SPECK and CSV files that should be loaded. If a folder is specified
+        // instead, all data files in that folder and its subfolders are loaded. If this
+        // value is not specified, the synchronization folder is used
+        std::optional<std::vector<std::filesystem::path>> files;
+
+        // The number of times each file is loaded. The fastest of these is reported
+        std::optional<int> repetitions [[codegen::greater(0)]];
+    };
+#include "benchmarkdataloadingtask_codegen.cpp"
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation BenchmarkDataLoadingTask::Documentation() {
+    return codegen::doc<Parameters>("base_benchmark_data_loading_task");
+}
+
+BenchmarkDataLoadingTask::BenchmarkDataLoadingTask(const ghoul::Dictionary& dictionary) {
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+
+    const std::vector<std::filesystem::path> paths =
+        p.files.value_or(std::vector<std::filesystem::path>{ absPath("${SYNC}") });
+    for (const std::filesystem::path& path : paths) {
+        if (std::filesystem::is_directory(path)) {
+            namespace fs = std::filesystem;
+            for (const fs::directory_entry& e : fs::recursive_directory_iterator(path)) {
+                if (e.is_regular_file() && isDataFile(e.path())) {
+                    _files.push_back(e.path());
+                }
+            }
+        }
+        else if (isDataFile(path)) {
+            _files.push_back(path);
+        }
+        else {
+            LWARNING(std::format("Skipping '{}' as it is not a data file", path));
+        }
+    }
+
+    _nRepetitions = p.repetitions.value_or(_nRepetitions);
+}
+
+std::string BenchmarkDataLoadingTask::description() {
+    return std::format(
+        "Load {} data files {} times each and report the parsing throughput",
+        _files.size(), _nRepetitions
+    );
+}
+
+void BenchmarkDataLoadingTask::perform(const Task::ProgressCallback& onProgress) {
+    onProgress(0.f);
+
+    size_t totalRows = 0;
+    double totalSeconds = 0.0;
+    for (size_t i = 0; i < _files.size(); i++) {
+        const std::filesystem::path& file = _files[i];
+
+        size_t nRows = 0;
+        double bestSeconds = std::numeric_limits<double>::max();
+        try {
+            for (int j = 0; j < _nRepetitions; j++) {
+                const auto t0 = std::chrono::high_resolution_clock::now();
+                const dataloader::Dataset dataset = dataloader::data::loadFile(file);
+                const auto t1 = std::chrono::high_resolution_clock::now();
+
+                nRows = dataset.nEntries();
+                const double seconds = std::chrono::duration<double>(t1 - t0).count();
+                bestSeconds = std::min(bestSeconds, seconds);
+            }
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(std::format("Error loading '{}': {}", file, e.message));
+            continue;
+        }
+
+        const double megabytes =
+            static_cast<double>(std::filesystem::file_size(file)) / (1024.0 * 1024.0);
+        LINFO(std::format(
+            "{}: {} rows in {:.3f} s ({:.0f} rows/s, {:.1f} MB/s)",
+            file, nRows, bestSeconds, nRows / bestSeconds, megabytes / bestSeconds
+        ));
+        totalRows += nRows;
+        totalSeconds += bestSeconds;
+
+        onProgress(static_cast<float>(i + 1) / static_cast<float>(_files.size()));
+    }
+
+    if (totalSeconds > 0.0) {
+        LINFO(std::format(
+            "Total: {} rows in {:.3f} s ({:.0f} rows/s)",
+            totalRows, totalSeconds, totalRows / totalSeconds
+        ));
+    }
+    onProgress(1.f);
+}
+
+} // namespace openspace
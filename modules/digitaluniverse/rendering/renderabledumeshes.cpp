@@ -387,7 +387,7 @@ void RenderableDUMeshes::renderLabels(const RenderData& data,
         ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
             *_font,
             scaledPos,
-            e.text,
+            _labelset.text(e),
             textColor,
             labelInfo
         );
@@ -1,3 +1,4 @@
 set (OPENSPACE_DEPENDENCIES
   kameleon
+  volume
 )
@@ -25,6 +25,7 @@
 #include <modules/fieldlinessequence/rendering/renderablefieldlinessequence.h>
 
 #include <modules/fieldlinessequence/fieldlinessequencemodule.h>
+#include <modules/fieldlinessequence/util/doublebuffer.h>
 #include <modules/fieldlinessequence/util/kameleonfieldlinehelper.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
@@ -40,8 +41,10 @@
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <map>
 #include <optional>
 #include <thread>
@@ -220,6 +223,15 @@ namespace {
         // Set to true if you are streaming data during runtime
         std::optional<bool> loadAtRuntime;
 
+        // The maximum number of states that are kept in memory at the same time if
+        // `LoadAtRuntime` is enabled
+        std::optional<int> statesInMemory [[codegen::greaterequal(2)]];
+
+        // The number of states in the direction of time that are loaded before they are
+        // needed if `LoadAtRuntime` is enabled. This value has to be smaller than
+        // `StatesInMemory`
+        std::optional<int> prefetchedStates [[codegen::greaterequal(0)]];
+
         // [[codegen::verbatim(ColorUniformInfo.description)]]
         std::optional<glm::vec4> color [[codegen::color()]];
 
@@ -278,6 +290,21 @@ namespace {
         // elapsed_time_in_seconds might be in relation to start of run.
         // ManuelTimeOffset will be added to trigger time.
         std::optional<double> manualTimeOffset;
+
+        // The number of threads that are used to trace field lines from CDF files. If
+        // there are fewer CDF files than threads, the seed points of each file are split
+        // between the remaining threads. Every thread opens its own copy of a CDF file,
+        // so the memory that is used by the conversion grows with this value. Defaults
+        // to 1
+        std::optional<int> conversionThreads [[codegen::greaterequal(1)]];
+
+        // If true, the positions and extra quantities of states that are converted from
+        // CDF or JSON files are stored as 16-bit values relative to the range they cover
+        // in each state. This reduces the memory, disk space and upload time of the
+        // states by about half at the cost of precision. The .osfls files that are
+        // written to `OutputFolder` keep this representation, and quantized .osfls files
+        // are always loaded as they are stored
+        std::optional<bool> quantizeStates;
     };
 #include "renderablefieldlinessequence_codegen.cpp"
 } // namespace
@@ -424,6 +451,10 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
     _flowSpeed = p.flowSpeed.value_or(_flowSpeed);
     _lineWidth = p.lineWidth.value_or(_lineWidth);
     _manualTimeOffset = p.manualTimeOffset.value_or(_manualTimeOffset);
+    _nConversionThreads = static_cast<unsigned int>(
+        p.conversionThreads.value_or(_nConversionThreads)
+    );
+    _quantizeStates = p.quantizeStates.value_or(_quantizeStates);
     _modelStr = p.simulationModel.value_or(_modelStr);
     _seedPointDirectory = p.seedPointDirectory.value_or(_seedPointDirectory);
     _maskingEnabled = p.maskingEnabled.value_or(_maskingEnabled);
@@ -470,6 +501,19 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
         LWARNING("Load at run time is only supported for osfls file type");
         _loadingStatesDynamically = false;
     }
+    if (p.statesInMemory.has_value()) {
+        _nStatesInMemory = static_cast<size_t>(*p.statesInMemory);
+    }
+    if (p.prefetchedStates.has_value()) {
+        _nPrefetchedStates = static_cast<size_t>(*p.prefetchedStates);
+    }
+    if (_nPrefetchedStates >= _nStatesInMemory) {
+        LWARNING(std::format(
+            "Only {} states fit into memory, limiting the prefetched states",
+            _nStatesInMemory
+        ));
+        _nPrefetchedStates = _nStatesInMemory - 1;
+    }
 
     if (p.maskingRanges.has_value()) {
         _maskingRanges = *p.maskingRanges;
@@ -543,10 +587,12 @@ void RenderableFieldlinesSequence::initializeGL() {
     setModelDependentConstants();
     setupProperties();
 
-    glGenVertexArrays(1, &_vertexArrayObject);
-    glGenBuffers(1, &_vertexPositionBuffer);
-    glGenBuffers(1, &_vertexColorBuffer);
-    glGenBuffers(1, &_vertexMaskingBuffer);
+    for (GpuState& gpuState : _gpuStates) {
+        glGenVertexArrays(1, &gpuState.vertexArrayObject);
+        glGenBuffers(1, &gpuState.vertexPositionBuffer);
+        glGenBuffers(1, &gpuState.vertexColorBuffer);
+        glGenBuffers(1, &gpuState.vertexMaskingBuffer);
+    }
 
     // Needed for additive blending
     setRenderBin(Renderable::RenderBin::Overlay);
@@ -568,10 +614,13 @@ bool RenderableFieldlinesSequence::loadJsonStatesIntoRAM() {
             _scalingFactor
         );
         if (loadedSuccessfully) {
-            addStateToSequence(newState);
+            if (_quantizeStates) {
+                newState.quantize();
+            }
             if (!_outputFolderPath.empty()) {
                 newState.saveStateToOsfls(_outputFolderPath);
             }
+            addStateToSequence(std::move(newState));
         }
     }
     return true;
@@ -579,18 +628,32 @@ bool RenderableFieldlinesSequence::loadJsonStatesIntoRAM() {
 
 bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
     extractTriggerTimesFromFileNames();
-    FieldlinesState newState;
-    if (!newState.loadStateFromOsfls(_sourceFiles[0])) {
+    auto newState = std::make_shared<FieldlinesState>();
+    if (!newState->loadStateFromOsfls(_sourceFiles[0])) {
         LERROR("The provided .osfls files seem to be corrupt");
         return false;
     }
-    _states.push_back(newState);
+    _states.push_back(std::move(newState));
     _nStates = _startTimes.size();
     if (_nStates == 1) {
         // loading dynamicaly is not nessesary if only having one set in the sequence
         _loadingStatesDynamically = false;
+        return true;
     }
-    _activeStateIndex = 0;
+
+    _stateStreamer = std::make_unique<volume::TimestepStreamer<FieldlinesState>>(
+        *global::taskScheduler,
+        _sourceFiles.size(),
+        _nStatesInMemory,
+        _nPrefetchedStates,
+        [files = _sourceFiles](size_t index) -> std::shared_ptr<FieldlinesState> {
+            auto state = std::make_shared<FieldlinesState>();
+            if (!state->loadStateFromOsfls(files[index])) {
+                return nullptr;
+            }
+            return state;
+        }
+    );
     return true;
 }
 
@@ -598,12 +661,12 @@ void RenderableFieldlinesSequence::loadOsflsStatesIntoRAM() {
     for (const std::string& filePath : _sourceFiles) {
         FieldlinesState newState;
         if (newState.loadStateFromOsfls(filePath)) {
-            addStateToSequence(newState);
             if (!_outputFolderPath.empty()) {
                 newState.saveStateToJson(
                     _outputFolderPath + std::filesystem::path(filePath).stem().string()
                 );
             }
+            addStateToSequence(std::move(newState));
         }
         else {
             LWARNING(std::format("Failed to load state from '{}'", filePath));
@@ -612,7 +675,7 @@ void RenderableFieldlinesSequence::loadOsflsStatesIntoRAM() {
 }
 
 void RenderableFieldlinesSequence::setupProperties() {
-    bool hasExtras = (_states[0].nExtraQuantities() > 0);
+    bool hasExtras = (_states[0]->nExtraQuantities() > 0);
 
     // Add non-grouped properties (enablers and buttons)
     addProperty(_colorABlendEnabled);
@@ -660,8 +723,8 @@ void RenderableFieldlinesSequence::setupProperties() {
         // Add option for each extra quantity. Assumes there are just as many names to
         // extra quantities as there are extra quantities. Also assume that all states in
         // the given sequence have the same extra quantities
-        const size_t nExtraQuantities = _states[0].nExtraQuantities();
-        const std::vector<std::string>& extraNamesVec = _states[0].extraQuantityNames();
+        const size_t nExtraQuantities = _states[0]->nExtraQuantities();
+        const std::vector<std::string>& extraNamesVec = _states[0]->extraQuantityNames();
         for (int i = 0; i < static_cast<int>(nExtraQuantities); i++) {
             _colorQuantity.addOption(i, extraNamesVec[i]);
             _maskingQuantity.addOption(i, extraNamesVec[i]);
@@ -688,10 +751,9 @@ void RenderableFieldlinesSequence::setupProperties() {
 
 void RenderableFieldlinesSequence::definePropertyCallbackFunctions() {
     // Add Property Callback Functions
-    bool hasExtras = (_states[0].nExtraQuantities() > 0);
+    bool hasExtras = (_states[0]->nExtraQuantities() > 0);
     if (hasExtras) {
         _colorQuantity.onChange([this]() {
-            _shouldUpdateColorBuffer = true;
             _colorQuantityMinMax = _colorTableRanges[_colorQuantity];
             _colorTablePath = _colorTablePaths[_colorQuantity].string();
         });
@@ -705,7 +767,6 @@ void RenderableFieldlinesSequence::definePropertyCallbackFunctions() {
         });
 
         _maskingQuantity.onChange([this]() {
-            _shouldUpdateMaskingBuffer = true;
             _maskingMinMax = _maskingRanges[_maskingQuantity];
         });
 
@@ -731,7 +792,7 @@ void RenderableFieldlinesSequence::computeSequenceEndTime() {
 }
 
 void RenderableFieldlinesSequence::setModelDependentConstants() {
-    const fls::Model simulationModel = _states[0].model();
+    const fls::Model simulationModel = _states[0]->model();
     float limit = 100.f; // Just used as a default value.
     switch (simulationModel) {
         case fls::Model::Batsrus:
@@ -796,9 +857,9 @@ void RenderableFieldlinesSequence::extractTriggerTimesFromFileNames() {
     }
 }
 
-void RenderableFieldlinesSequence::addStateToSequence(FieldlinesState& state) {
-    _states.push_back(state);
+void RenderableFieldlinesSequence::addStateToSequence(FieldlinesState state) {
     _startTimes.push_back(state.triggerTime());
+    _states.push_back(std::make_shared<FieldlinesState>(std::move(state)));
     ++_nStates;
 }
 
@@ -812,23 +873,62 @@ bool RenderableFieldlinesSequence::getStatesFromCdfFiles() {
         return false;
     }
 
-    for (const std::string& cdfPath : _sourceFiles) {
-        FieldlinesState newState;
-        bool isSuccessful = fls::convertCdfToFieldlinesState(
-            newState,
-            cdfPath,
-            seedsPerFiles,
-            _manualTimeOffset,
-            _tracingVariable,
-            _extraVars,
-            extraMagVars
-        );
+    // Several files are converted at the same time and any threads that are left over
+    // are used to split the seed points of each file
+    const size_t nFiles = _sourceFiles.size();
+    const size_t nConcurrentFiles = std::max<size_t>(
+        std::min<size_t>(_nConversionThreads, nFiles),
+        1
+    );
+    const unsigned int nTracingThreads = std::max(
+        _nConversionThreads / static_cast<unsigned int>(nConcurrentFiles),
+        1u
+    );
+
+    std::vector<std::optional<FieldlinesState>> states(nFiles);
+    std::atomic_size_t nextFile = 0;
+    auto convertFiles = [&]() {
+        for (size_t i = nextFile++; i < nFiles; i = nextFile++) {
+            // The conversion removes variables that the file doesn't contain, so every
+            // file gets its own copy of them
+            std::vector<std::string> extraVars = _extraVars;
+            std::vector<std::string> magVars = extraMagVars;
+
+            FieldlinesState newState;
+            const bool isSuccessful = fls::convertCdfToFieldlinesState(
+                newState,
+                _sourceFiles[i],
+                seedsPerFiles,
+                _manualTimeOffset,
+                _tracingVariable,
+                extraVars,
+                magVars,
+                nTracingThreads
+            );
+            if (isSuccessful) {
+                if (_quantizeStates) {
+                    newState.quantize();
+                }
+                states[i] = std::move(newState);
+            }
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < nConcurrentFiles; i++) {
+        futures.push_back(std::async(std::launch::async, convertFiles));
+    }
+    convertFiles();
+    for (std::future<void>& future : futures) {
+        future.get();
+    }
 
-        if (isSuccessful) {
-            addStateToSequence(newState);
+    for (std::optional<FieldlinesState>& state : states) {
+        if (state.has_value()) {
             if (!_outputFolderPath.empty()) {
-                newState.saveStateToOsfls(_outputFolderPath);
+                state->saveStateToOsfls(_outputFolderPath);
             }
+            addStateToSequence(std::move(*state));
         }
     }
     return true;
@@ -930,32 +1030,21 @@ std::vector<std::string>
 }
 
 void RenderableFieldlinesSequence::deinitializeGL() {
-    glDeleteVertexArrays(1, &_vertexArrayObject);
-    _vertexArrayObject = 0;
-
-    glDeleteBuffers(1, &_vertexPositionBuffer);
-    _vertexPositionBuffer = 0;
-
-    glDeleteBuffers(1, &_vertexColorBuffer);
-    _vertexColorBuffer = 0;
-
-    glDeleteBuffers(1, &_vertexMaskingBuffer);
-    _vertexMaskingBuffer = 0;
+    for (GpuState& gpuState : _gpuStates) {
+        glDeleteVertexArrays(1, &gpuState.vertexArrayObject);
+        glDeleteBuffers(1, &gpuState.vertexPositionBuffer);
+        glDeleteBuffers(1, &gpuState.vertexColorBuffer);
+        glDeleteBuffers(1, &gpuState.vertexMaskingBuffer);
+        gpuState = GpuState();
+    }
 
     if (_shaderProgram) {
         global::renderEngine->removeRenderProgram(_shaderProgram.get());
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // Waits for the states that are still being loaded from disk
+    _stateStreamer = nullptr;
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -963,7 +1052,8 @@ bool RenderableFieldlinesSequence::isReady() const {
 }
 
 void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&) {
-    if (_activeTriggerTimeIndex == -1) {
+    const GpuState& gpuState = _gpuStates[0];
+    if (_activeTriggerTimeIndex == -1 || !gpuState.state) {
         return;
     }
     _shaderProgram->activate();
@@ -983,6 +1073,8 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
     _shaderProgram->setUniform("lineColor", _colorUniform);
     _shaderProgram->setUniform("usingDomain", _domainEnabled);
     _shaderProgram->setUniform("usingMasking", _maskingEnabled);
+    _shaderProgram->setUniform("positionOffset", gpuState.positionOffset);
+    _shaderProgram->setUniform("positionScale", gpuState.positionScale);
 
     if (_colorMethod == static_cast<int>(ColorMethod::ByQuantity)) {
         ghoul::opengl::TextureUnit textureUnit;
@@ -990,10 +1082,12 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
         _transferFunction->bind(); // Calls update internally
         _shaderProgram->setUniform("colorTable", textureUnit);
         _shaderProgram->setUniform("colorTableRange", _colorTableRanges[_colorQuantity]);
+        _shaderProgram->setUniform("colorQuantization", gpuState.colorQuantization);
     }
 
     if (_maskingEnabled) {
         _shaderProgram->setUniform("maskingRange", _maskingRanges[_maskingQuantity]);
+        _shaderProgram->setUniform("maskingQuantization", gpuState.maskingQuantization);
     }
 
     _shaderProgram->setUniform("domainLimR", _domainR.value() * _scalingFactor);
@@ -1021,7 +1115,7 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
         glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     }
 
-    glBindVertexArray(_vertexArrayObject);
+    glBindVertexArray(gpuState.vertexArrayObject);
 #ifndef __APPLE__
     glLineWidth(_lineWidth);
 #else
@@ -1030,9 +1124,9 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
 
     glMultiDrawArrays(
         GL_LINE_STRIP,
-        _states[_activeStateIndex].lineStart().data(),
-        _states[_activeStateIndex].lineCount().data(),
-        static_cast<GLsizei>(_states[_activeStateIndex].lineStart().size())
+        gpuState.state->lineStart().data(),
+        gpuState.state->lineCount().data(),
+        static_cast<GLsizei>(gpuState.state->lineStart().size())
     );
 
     glBindVertexArray(0);
@@ -1049,13 +1143,11 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
     if (_shaderProgram->isDirty()) {
         _shaderProgram->rebuildFromFile();
     }
-    // True if new 'runtime-state' must be loaded from disk.
-    // False => the previous frame's state should still be shown
-    bool mustLoadNewStateFromDisk = false;
-    // True if new 'in-RAM-state'  must be loaded.
-    // False => the previous frame's state should still be shown
-    bool needUpdate = false;
     const double currentTime = data.time.j2000Seconds();
+    if (currentTime != _lastTime) {
+        _isMovingForward = currentTime > _lastTime;
+        _lastTime = currentTime;
+    }
     const bool isInInterval = (currentTime >= _startTimes[0]) &&
                               (currentTime < _sequenceEndTime);
 
@@ -1071,77 +1163,50 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
             (nextIdx < _nStates && currentTime >= _startTimes[nextIdx]))
         {
             updateActiveTriggerTimeIndex(currentTime);
-
-            if (_loadingStatesDynamically) {
-                mustLoadNewStateFromDisk = true;
-            }
-            else {
-                needUpdate = true;
-                _activeStateIndex = _activeTriggerTimeIndex;
-            }
         } // else {we're still in same state as previous frame (no changes needed)}
     }
     // if only one state
     else if (_nStates == 1) {
         _activeTriggerTimeIndex = 0;
-        _activeStateIndex = 0;
-        if (!_hasBeenUpdated) {
-            updateVertexPositionBuffer();
-        }
-
-        if (_states[_activeStateIndex].nExtraQuantities() > 0) {
-            _shouldUpdateColorBuffer = true;
-            _shouldUpdateMaskingBuffer = true;
-        }
-
-        _hasBeenUpdated = true;
     }
     else {
-        // Not in interval => set everything to false
+        // Not in interval => nothing to show
         _activeTriggerTimeIndex = -1;
-        mustLoadNewStateFromDisk = false;
-        needUpdate = false;
-    }
-
-    if (mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk = true;
-            mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)]() {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
-        }
+        return;
     }
 
-    if (needUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
-        }
-
-        updateVertexPositionBuffer();
-
-        if (_states[_activeStateIndex].nExtraQuantities() > 0) {
-            _shouldUpdateColorBuffer = true;
-            _shouldUpdateMaskingBuffer = true;
-        }
-
-        // Everything is set and ready for rendering
-        needUpdate = false;
-        _newStateIsReady = false;
+    if (_stateStreamer) {
+        _stateStreamer->update(
+            static_cast<size_t>(_activeTriggerTimeIndex),
+            _isMovingForward
+        );
     }
 
-    if (_colorMethod == 1) { //By quantity
-        if (_shouldUpdateColorBuffer) {
-            updateVertexColorBuffer();
-            _shouldUpdateColorBuffer = false;
+    // Switch to the active state. Usually it has already been uploaded ahead of time so
+    // that only the buffers have to be swapped. Otherwise it is uploaded now if it is in
+    // memory and until then the previous state is still shown. The state that follows in
+    // the direction of time is prepared afterwards, if it is in memory
+    int next = _activeTriggerTimeIndex + (_isMovingForward ? 1 : -1);
+    if (next >= static_cast<int>(_nStates)) {
+        next = -1;
+    }
+    fls::updateDoubleBuffer(
+        _gpuStates,
+        _activeTriggerTimeIndex,
+        next,
+        [this](GpuState& gpuState, int triggerTimeIndex) {
+            std::shared_ptr<const FieldlinesState> state =
+                residentState(triggerTimeIndex);
+            if (state) {
+                uploadState(gpuState, triggerTimeIndex, std::move(state));
+            }
         }
+    );
 
-        if (_shouldUpdateMaskingBuffer) {
-            updateVertexMaskingBuffer();
-            _shouldUpdateMaskingBuffer = false;
-        }
+    // The quantities that color and mask the lines might have been changed
+    for (GpuState& gpuState : _gpuStates) {
+        updateVertexColorBuffer(gpuState);
+        updateVertexMaskingBuffer(gpuState);
     }
 }
 
@@ -1166,13 +1231,13 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
+std::shared_ptr<const FieldlinesState> RenderableFieldlinesSequence::residentState(
+                                                               int triggerTimeIndex) const
+{
+    if (_stateStreamer) {
+        return _stateStreamer->timestep(static_cast<size_t>(triggerTimeIndex));
     }
-    _isLoadingStateFromDisk = false;
+    return _states[triggerTimeIndex];
 }
 
 // Unbind buffers and arrays
@@ -1181,76 +1246,109 @@ void unbindGL() {
     glBindVertexArray(0);
 }
 
-void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
-    if (_activeStateIndex == -1) { return; }
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
-
-    const std::vector<glm::vec3>& vertPos = _states[_activeStateIndex].vertexPositions();
-
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        vertPos.size() * sizeof(glm::vec3),
-        vertPos.data(),
-        GL_STATIC_DRAW
-    );
+void RenderableFieldlinesSequence::uploadState(GpuState& gpuState,
+                                               int triggerTimeIndex,
+                                             std::shared_ptr<const FieldlinesState> state)
+{
+    glBindVertexArray(gpuState.vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuState.vertexPositionBuffer);
 
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-
-    unbindGL();
-}
-
-void RenderableFieldlinesSequence::updateVertexColorBuffer() {
-    if (_activeStateIndex == -1) { return; }
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
-
-    bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
-        _colorQuantity,
-        isSuccessful
-    );
-
-    if (isSuccessful) {
+    if (state->isQuantized()) {
+        std::span<const uint16_t> vertPos = state->quantizedVertexPositions();
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            vertPos.size_bytes(),
+            vertPos.data(),
+            GL_STATIC_DRAW
+        );
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, 0, 0);
+        gpuState.positionOffset = state->positionOffset();
+        gpuState.positionScale = state->positionScale();
+    }
+    else {
+        const std::vector<glm::vec3>& vertPos = state->vertexPositions();
         glBufferData(
             GL_ARRAY_BUFFER,
-            quantities.size() * sizeof(float),
-            quantities.data(),
+            vertPos.size() * sizeof(glm::vec3),
+            vertPos.data(),
             GL_STATIC_DRAW
         );
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        gpuState.positionOffset = glm::vec3(0.f);
+        gpuState.positionScale = glm::vec3(1.f);
+    }
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 0, 0);
+    unbindGL();
 
-        unbindGL();
-    }
+    gpuState.state = std::move(state);
+    gpuState.triggerTimeIndex = triggerTimeIndex;
+    gpuState.colorQuantity = -1;
+    gpuState.maskingQuantity = -1;
 }
 
-void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
-    if (_activeStateIndex == -1) { return; }
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
-
-    bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
-        _maskingQuantity,
-        isSuccessful
-    );
+// Uploads one of the extra quantities of a state to the buffer that feeds the vertex
+// attribute with the provided location and returns the offset and scale that restore its
+// values in the shader
+glm::vec2 uploadExtraQuantity(const FieldlinesState& state, int quantity, GLuint buffer,
+                              GLuint location)
+{
+    const size_t index = static_cast<size_t>(quantity);
+    if (index >= state.nExtraQuantities()) {
+        return glm::vec2(0.f, 1.f);
+    }
 
-    if (isSuccessful) {
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            maskings.size() * sizeof(float),
-            maskings.data(),
-            GL_STATIC_DRAW
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glEnableVertexAttribArray(location);
+    if (state.isQuantized()) {
+        std::span<const uint16_t> values = state.quantizedExtraQuantity(index);
+        glBufferData(GL_ARRAY_BUFFER, values.size_bytes(), values.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(location, 1, GL_UNSIGNED_SHORT, GL_TRUE, 0, 0);
+        return glm::vec2(
+            state.extraQuantityOffset(index),
+            state.extraQuantityScale(index)
         );
+    }
+    else {
+        std::span<const float> values = state.extraQuantity(index);
+        glBufferData(GL_ARRAY_BUFFER, values.size_bytes(), values.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(location, 1, GL_FLOAT, GL_FALSE, 0, 0);
+        return glm::vec2(0.f, 1.f);
+    }
+}
 
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 0, 0);
+void RenderableFieldlinesSequence::updateVertexColorBuffer(GpuState& gpuState) {
+    if (!gpuState.state || _colorMethod != static_cast<int>(ColorMethod::ByQuantity) ||
+        gpuState.colorQuantity == _colorQuantity.value())
+    {
+        return;
+    }
+    glBindVertexArray(gpuState.vertexArrayObject);
+    gpuState.colorQuantization = uploadExtraQuantity(
+        *gpuState.state,
+        _colorQuantity,
+        gpuState.vertexColorBuffer,
+        1
+    );
+    unbindGL();
+    gpuState.colorQuantity = _colorQuantity.value();
+}
 
-        unbindGL();
+void RenderableFieldlinesSequence::updateVertexMaskingBuffer(GpuState& gpuState) {
+    if (!gpuState.state || !_maskingEnabled ||
+        gpuState.maskingQuantity == _maskingQuantity.value())
+    {
+        return;
     }
+    glBindVertexArray(gpuState.vertexArrayObject);
+    gpuState.maskingQuantization = uploadExtraQuantity(
+        *gpuState.state,
+        _maskingQuantity,
+        gpuState.vertexMaskingBuffer,
+        2
+    );
+    unbindGL();
+    gpuState.maskingQuantity = _maskingQuantity.value();
 }
 
 } // namespace openspace
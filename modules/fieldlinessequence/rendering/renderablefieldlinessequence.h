@@ -28,6 +28,7 @@
 #include <openspace/rendering/renderable.h>
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/volume/timestepstreamer.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
@@ -35,7 +36,8 @@
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
+#include <array>
+#include <memory>
 
 namespace openspace {
 
@@ -54,7 +56,32 @@ public:
     static documentation::Documentation Documentation();
 
 private:
-    void addStateToSequence(FieldlinesState& STATE);
+    // The vertex array and buffers that a single state is uploaded into. There are two
+    // sets of these, so that the state that follows in the direction of time can be
+    // uploaded while the current one is rendered
+    struct GpuState {
+        GLuint vertexArrayObject = 0;
+        GLuint vertexPositionBuffer = 0;
+        GLuint vertexColorBuffer = 0;
+        GLuint vertexMaskingBuffer = 0;
+
+        // The state that is uploaded and the index of its trigger time, or -1 if the
+        // buffers are empty
+        std::shared_ptr<const FieldlinesState> state;
+        int triggerTimeIndex = -1;
+        // The extra quantities that are in the color and masking buffers, or -1
+        int colorQuantity = -1;
+        int maskingQuantity = -1;
+
+        // Offset and scale that restore the values in the buffers if the state is
+        // quantized. The buffers then hold normalized 16-bit values
+        glm::vec3 positionOffset = glm::vec3(0.f);
+        glm::vec3 positionScale = glm::vec3(1.f);
+        glm::vec2 colorQuantization = glm::vec2(0.f, 1.f);
+        glm::vec2 maskingQuantization = glm::vec2(0.f, 1.f);
+    };
+
+    void addStateToSequence(FieldlinesState state);
     void computeSequenceEndTime();
     void definePropertyCallbackFunctions();
     void extractTriggerTimesFromFileNames();
@@ -65,11 +92,12 @@ private:
     void setupProperties();
     bool prepareForOsflsStreaming();
 
-    void readNewState(const std::string& filePath);
+    std::shared_ptr<const FieldlinesState> residentState(int triggerTimeIndex) const;
     void updateActiveTriggerTimeIndex(double currentTime);
-    void updateVertexPositionBuffer();
-    void updateVertexColorBuffer();
-    void updateVertexMaskingBuffer();
+    void uploadState(GpuState& gpuState, int triggerTimeIndex,
+        std::shared_ptr<const FieldlinesState> state);
+    void updateVertexColorBuffer(GpuState& gpuState);
+    void updateVertexMaskingBuffer(GpuState& gpuState);
 
     // Used to determine if lines should be colored UNIFORMLY or by an extraQuantity
     enum class ColorMethod {
@@ -93,33 +121,28 @@ private:
     // optional except when using json input
     std::string _modelStr;
 
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
-    // True when new state is loaded or user change which quantity to color the lines by
-    bool _shouldUpdateColorBuffer   = false;
-    // True when new state is loaded or user change which quantity used for masking out
-    // line segments
-    bool _shouldUpdateMaskingBuffer = false;
-    // note Elon: rework the case of only one state
-    // hasBeenUpdated only gets sets once, first iteration of update function, to
-    // guarantee the vertext position buffer to be initialized.
-    bool _hasBeenUpdated = false;
-
-    // Active index of _states. If(==-1)=>no state available for current time. Always the
-    // same as _activeTriggerTimeIndex if(_loadingStatesDynamically==true), else
-    // always = 0
-    int _activeStateIndex = -1;
+    // Used for 'runtime-states'. The maximum number of states kept in memory
+    size_t _nStatesInMemory = 8;
+    // Used for 'runtime-states'. The number of states that are loaded ahead of time
+    size_t _nPrefetchedStates = 3;
+    // Used for 'runtime-states'. Loads the states in the background
+    std::unique_ptr<volume::TimestepStreamer<FieldlinesState>> _stateStreamer;
+    // The time of the previous frame and whether the time is moving forwards, which
+    // determines which states are prepared ahead of time
+    double _lastTime = 0.0;
+    bool _isMovingForward = true;
+
     // Active index of _startTimes
     int _activeTriggerTimeIndex = -1;
     // Manual time offset
     double _manualTimeOffset = 0.0;
+    // Number of threads used to trace field lines when the input files are CDF files
+    unsigned int _nConversionThreads = 1;
+    // Whether states converted from CDF or JSON files are quantized to 16 bits
+    bool _quantizeStates = false;
     // Number of states in the sequence
     size_t _nStates = 0;
     // In setup it is used to scale JSON coordinates. During runtime it is used to scale
@@ -128,20 +151,10 @@ private:
     // Estimated end of sequence.
     // If there's just one state it should never disappear
     double _sequenceEndTime = std::numeric_limits<double>::max();
-    // OpenGL Vertex Array Object
-    GLuint _vertexArrayObject = 0;
-    // OpenGL Vertex Buffer Object containing the extraQuantity values used for coloring
-    // the lines
-    GLuint _vertexColorBuffer = 0;
-    // OpenGL Vertex Buffer Object containing the extraQuantity values used for masking
-    // out segments of the lines
-    GLuint _vertexMaskingBuffer = 0;
-    // OpenGL Vertex Buffer Object containing the vertex positions
-    GLuint _vertexPositionBuffer = 0;
-
-    // The Lua-Modfile-Dictionary used during initialization
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
+    // The state that is rendered is in the first entry, the second entry holds the
+    // state that is expected next, if it has already been uploaded
+    std::array<GpuState, 2> _gpuStates;
+
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -159,8 +172,8 @@ private:
     std::vector<std::string> _extraVars;
     // Contains the _triggerTimes for all FieldlineStates in the sequence
     std::vector<double> _startTimes;
-    // Stores the FieldlineStates
-    std::vector<FieldlinesState> _states;
+    // Stores the FieldlineStates. For 'runtime-states' only the first state is stored
+    std::vector<std::shared_ptr<const FieldlinesState>> _states;
 
     // Group to hold the color properties
     properties::PropertyOwner _colorGroup;
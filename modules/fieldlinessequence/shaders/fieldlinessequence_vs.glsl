@@ -37,6 +37,13 @@ out float vs_depth;
 uniform vec4 lineColor;
 uniform mat4 modelViewProjection;
 
+// Quantized states provide normalized values that are restored as offset + scale * value.
+// The vec2 uniforms store the offset in x and the scale in y
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+uniform vec2 colorQuantization;
+uniform vec2 maskingQuantization;
+
 // Uniforms needed to color by quantity
 uniform int colorMethod;
 uniform sampler1D colorTable;
@@ -67,9 +74,10 @@ const int colorByQuantity = 1;
 
 
 vec4 getTransferFunctionColor() {
+  float colorScalar = colorQuantization.x + colorQuantization.y * in_color_scalar;
   // Remap the color scalar to a [0,1] range
   float lookUpVal =
-    (in_color_scalar - colorTableRange.x) / (colorTableRange.y - colorTableRange.x);
+    (colorScalar - colorTableRange.x) / (colorTableRange.y - colorTableRange.x);
   return texture(colorTable, lookUpVal);
 }
 
@@ -83,20 +91,22 @@ bool isPartOfParticle(double time, int vertexId, int particleSize, int particleS
 
 void main() {
   bool hasColor = true;
+  vec3 position = positionOffset + positionScale * in_position;
+  float maskingScalar = maskingQuantization.x + maskingQuantization.y * in_masking_scalar;
 
-  if (usingMasking && (in_masking_scalar < maskingRange.x ||
-                        in_masking_scalar > maskingRange.y))
+  if (usingMasking && (maskingScalar < maskingRange.x ||
+                        maskingScalar > maskingRange.y))
   {
     hasColor = false;
   }
 
   if (usingDomain && hasColor) {
-    float radius = length(in_position);
+    float radius = length(position);
 
-    if (in_position.x < domainLimX.x || in_position.x > domainLimX.y ||
-        in_position.y < domainLimY.x || in_position.y > domainLimY.y ||
-        in_position.z < domainLimZ.x || in_position.z > domainLimZ.y ||
-        radius        < domainLimR.x || radius        > domainLimR.y)
+    if (position.x < domainLimX.x || position.x > domainLimX.y ||
+        position.y < domainLimY.x || position.y > domainLimY.y ||
+        position.z < domainLimZ.x || position.z > domainLimZ.y ||
+        radius     < domainLimR.x || radius     > domainLimR.y)
     {
       hasColor = false;
     }
@@ -122,7 +132,7 @@ void main() {
     vs_color = vec4(0);
   }
 
-  vec4 position_in_meters = vec4(in_position, 1);
+  vec4 position_in_meters = vec4(position, 1);
   vec4 positionClipSpace = modelViewProjection * position_in_meters;
   //vs_gPosition = vec4(modelViewTransform * dvec4(in_point_position, 1));
   gl_Position = vec4(positionClipSpace.xy, 0, positionClipSpace.w);
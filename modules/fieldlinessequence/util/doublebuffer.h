@@ -0,0 +1,64 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___DOUBLEBUFFER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___DOUBLEBUFFER___H__
+
+#include <array>
+#include <utility>
+
+namespace openspace::fls {
+
+/**
+ * Makes the \p active state the front buffer of \p buffers and prepares the \p next
+ * state in the back buffer. Each buffer has a `triggerTimeIndex` member that is -1 if it
+ * is empty. The active state is only uploaded if it is not already in the back buffer,
+ * in which case the buffers are swapped. If the active state cannot be uploaded, the
+ * front buffer is kept so that the previous state stays visible.
+ *
+ * \param buffers The front (index 0) and back (index 1) buffer
+ * \param active The index of the state that should be shown
+ * \param next The index of the state that is shown next, or -1 if there is none
+ * \param upload Uploads the state with the provided index into the buffer and sets its
+ *        `triggerTimeIndex`. It leaves the buffer unchanged if the state is not in memory
+ */
+template <typename T, typename Upload>
+void updateDoubleBuffer(std::array<T, 2>& buffers, int active, int next, Upload upload) {
+    if (buffers[0].triggerTimeIndex != active) {
+        if (buffers[1].triggerTimeIndex != active) {
+            upload(buffers[1], active);
+        }
+        if (buffers[1].triggerTimeIndex == active) {
+            std::swap(buffers[0], buffers[1]);
+        }
+    }
+
+    if (next >= 0 && buffers[1].triggerTimeIndex != next) {
+        upload(buffers[1], next);
+    }
+}
+
+} // namespace openspace::fls
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___DOUBLEBUFFER___H__
@@ -28,13 +28,59 @@
 #include <openspace/util/time.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <utility>
 
 namespace {
     constexpr std::string_view _loggerCat = "FieldlinesState";
-    constexpr int CurrentVersion = 0;
+    constexpr int CurrentVersion = 1;
     using json = nlohmann::json;
+
+    // The largest value of a quantized position or quantity
+    constexpr float MaxQuantizedValue = 65535.f;
+
+    // Returns the offset and scale that map the finite values in every stride-th element
+    // of values onto [0, 1]. Values such as NaN that are produced by the interpolation
+    // outside of a model's domain would otherwise destroy the precision of all others
+    std::pair<float, float> quantizationRange(const float* values, size_t nValues,
+                                              size_t stride)
+    {
+        float minimum = std::numeric_limits<float>::max();
+        float maximum = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < nValues; i++) {
+            const float v = values[i * stride];
+            if (std::isfinite(v)) {
+                minimum = std::min(minimum, v);
+                maximum = std::max(maximum, v);
+            }
+        }
+        if (minimum > maximum) {
+            return { 0.f, 0.f };
+        }
+        return { minimum, maximum - minimum };
+    }
+
+    uint16_t quantizeValue(float value, float offset, float scale) {
+        const float normalized = (value - offset) / scale;
+        // Written so that NaN, as well as values in a range with a scale of 0, become 0
+        if (!(normalized > 0.f)) {
+            return 0;
+        }
+        return static_cast<uint16_t>(
+            std::round(std::min(normalized, 1.f) * MaxQuantizedValue)
+        );
+    }
+
+    float restoreValue(uint16_t value, float offset, float scale) {
+        return offset + scale * (static_cast<float>(value) / MaxQuantizedValue);
+    }
 } // namespace
 
 namespace openspace {
@@ -45,6 +91,8 @@ namespace openspace {
  * expected to be in degrees. scale is an optional scaling factor.
  */
 void FieldlinesState::convertLatLonToCartesian(float scale) {
+    ghoul_assert(!_isQuantized, "Quantized positions can't be converted");
+
     for (glm::vec3& p : _vertexPositions) {
         const float r = p.x * scale;
         const float lat = glm::radians(p.y);
@@ -59,21 +107,92 @@ void FieldlinesState::scalePositions(float scale) {
     for (glm::vec3& p : _vertexPositions) {
         p *= scale;
     }
+    _positionOffset *= scale;
+    _positionScale *= scale;
+}
+
+void FieldlinesState::quantize() {
+    if (_isQuantized) {
+        return;
+    }
+
+    const size_t nPoints = _vertexPositions.size();
+    const float* positions = reinterpret_cast<const float*>(_vertexPositions.data());
+    _quantizedPositions.resize(3 * nPoints);
+    for (int c = 0; c < 3; c++) {
+        const auto [offset, scale] = quantizationRange(positions + c, nPoints, 3);
+        _positionOffset[c] = offset;
+        _positionScale[c] = scale;
+        for (size_t i = 0; i < nPoints; i++) {
+            _quantizedPositions[3 * i + c] =
+                quantizeValue(positions[3 * i + c], offset, scale);
+        }
+    }
+
+    const size_t nExtras = nExtraQuantities();
+    ghoul_assert(
+        _extraQuantities.size() == nExtras * nPoints,
+        "Each extra quantity needs one value per vertex"
+    );
+    _quantizedExtraQuantities.resize(nExtras * nPoints);
+    _extraQuantityOffsets.resize(nExtras);
+    _extraQuantityScales.resize(nExtras);
+    for (size_t q = 0; q < nExtras; q++) {
+        const float* values = _extraQuantities.data() + q * nPoints;
+        const auto [offset, scale] = quantizationRange(values, nPoints, 1);
+        _extraQuantityOffsets[q] = offset;
+        _extraQuantityScales[q] = scale;
+        for (size_t i = 0; i < nPoints; i++) {
+            _quantizedExtraQuantities[q * nPoints + i] =
+                quantizeValue(values[i], offset, scale);
+        }
+    }
+
+    _vertexPositions.clear();
+    _vertexPositions.shrink_to_fit();
+    _extraQuantities.clear();
+    _extraQuantities.shrink_to_fit();
+    _isQuantized = true;
 }
 
 bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
-    std::ifstream ifs(pathToOsflsFile, std::ifstream::binary);
-    if (!ifs.is_open()) {
+    // The whole file is read with a single call and then decoded from memory, rather than
+    // issuing a separate read for each of its sections
+    std::ifstream ifs(pathToOsflsFile, std::ifstream::binary | std::ifstream::ate);
+    if (!ifs.is_open() || !std::filesystem::is_regular_file(pathToOsflsFile)) {
         LERROR("Couldn't open file: " + pathToOsflsFile);
         return false;
     }
+    const std::streamoff fileSize = ifs.tellg();
+    if (fileSize < 0) {
+        LERROR(std::format("Couldn't determine the size of file '{}'", pathToOsflsFile));
+        return false;
+    }
+    std::vector<char> buffer(static_cast<size_t>(fileSize));
+    ifs.seekg(0);
+    if (!ifs.read(buffer.data(), buffer.size())) {
+        LERROR(std::format("Couldn't read file '{}'", pathToOsflsFile));
+        return false;
+    }
+
+    size_t offset = 0;
+    // Copies the next bytes of the file into the destination if the file is long enough
+    auto read = [&buffer, &offset](void* destination, size_t nBytes) {
+        if (nBytes > buffer.size() - offset) {
+            return false;
+        }
+        std::memcpy(destination, buffer.data() + offset, nBytes);
+        offset += nBytes;
+        return true;
+    };
 
-    int binFileVersion;
-    ifs.read(reinterpret_cast<char*>(&binFileVersion), sizeof(int));
+    int binFileVersion = -1;
+    read(&binFileVersion, sizeof(int));
 
     switch (binFileVersion) {
         case 0:
-            // No need to put everything in this scope now, as only version 0 exists!
+        case 1:
+            // Version 1 only adds the quantized representation to version 0
             break;
         default:
             LERROR("VERSION OF BINARY FILE WAS NOT RECOGNIZED");
@@ -81,53 +200,109 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     }
 
     // Define tmp variables to store meta data in
-    size_t nLines;
-    size_t nPoints;
-    size_t nExtras;
-    size_t byteSizeAllNames;
+    uint64_t nLines = 0;
+    uint64_t nPoints = 0;
+    uint64_t nExtras = 0;
+    uint64_t byteSizeAllNames = 0;
 
     // Read single value variables
-    ifs.read(reinterpret_cast<char*>(&_triggerTime), sizeof(double));
-    ifs.read(reinterpret_cast<char*>(&_model), sizeof(int32_t));
-    ifs.read(reinterpret_cast<char*>(&_isMorphable), sizeof(bool));
-    ifs.read(reinterpret_cast<char*>(&nLines), sizeof(uint64_t));
-    ifs.read(reinterpret_cast<char*>(&nPoints), sizeof(uint64_t));
-    ifs.read(reinterpret_cast<char*>(&nExtras), sizeof(uint64_t));
-    ifs.read(reinterpret_cast<char*>(&byteSizeAllNames), sizeof(uint64_t));
+    bool hasHeader =
+        read(&_triggerTime, sizeof(double)) &&
+        read(&_model, sizeof(int32_t)) &&
+        read(&_isMorphable, sizeof(bool));
+    _isQuantized = false;
+    if (binFileVersion >= 1) {
+        hasHeader = hasHeader && read(&_isQuantized, sizeof(bool));
+    }
+    hasHeader = hasHeader &&
+        read(&nLines, sizeof(uint64_t)) &&
+        read(&nPoints, sizeof(uint64_t)) &&
+        read(&nExtras, sizeof(uint64_t)) &&
+        read(&byteSizeAllNames, sizeof(uint64_t));
+
+    // Make sure that the file is large enough for the sizes it claims before allocating
+    const size_t valueSize = _isQuantized ? sizeof(uint16_t) : sizeof(float);
+    const size_t remaining = buffer.size() - offset;
+    const bool hasValidSizes = hasHeader &&
+        nLines <= remaining / (sizeof(int32_t) + sizeof(uint32_t)) &&
+        nPoints <= remaining / (3 * valueSize) &&
+        nExtras <= remaining &&
+        (nExtras == 0 || nPoints <= remaining / (nExtras * valueSize)) &&
+        byteSizeAllNames <= remaining;
+    if (!hasValidSizes) {
+        LERROR(std::format("File '{}' is truncated or corrupt", pathToOsflsFile));
+        return false;
+    }
 
     _lineStart.resize(nLines);
     _lineCount.resize(nLines);
-    _vertexPositions.resize(nPoints);
-    _extraQuantities.resize(nExtras);
     _extraQuantityNames.resize(nExtras);
 
-    // Read vertex position data
-    ifs.read(reinterpret_cast<char*>(_lineStart.data()), sizeof(int32_t) * nLines);
-    ifs.read(reinterpret_cast<char*>(_lineCount.data()), sizeof(uint32_t) * nLines);
-    ifs.read(
-        reinterpret_cast<char*>(_vertexPositions.data()),
-        3 * sizeof(float) * nPoints
-    );
-
-    // Read all extra quantities
-    for (std::vector<float>& vec : _extraQuantities) {
-        vec.resize(nPoints);
-        ifs.read(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
+    bool success =
+        read(_lineStart.data(), sizeof(int32_t) * nLines) &&
+        read(_lineCount.data(), sizeof(uint32_t) * nLines);
+
+    // The values of all extra quantities follow each other, so they are read at once
+    if (_isQuantized) {
+        _extraQuantityOffsets.resize(nExtras);
+        _extraQuantityScales.resize(nExtras);
+        _quantizedPositions.resize(3 * nPoints);
+        _quantizedExtraQuantities.resize(nExtras * nPoints);
+        success = success &&
+            read(&_positionOffset, sizeof(glm::vec3)) &&
+            read(&_positionScale, sizeof(glm::vec3)) &&
+            read(_extraQuantityOffsets.data(), sizeof(float) * nExtras) &&
+            read(_extraQuantityScales.data(), sizeof(float) * nExtras) &&
+            read(_quantizedPositions.data(), sizeof(uint16_t) * 3 * nPoints) &&
+            read(
+                _quantizedExtraQuantities.data(),
+                sizeof(uint16_t) * nExtras * nPoints
+            );
+    }
+    else {
+        _vertexPositions.resize(nPoints);
+        _extraQuantities.resize(nExtras * nPoints);
+        success = success &&
+            read(_vertexPositions.data(), 3 * sizeof(float) * nPoints) &&
+            read(_extraQuantities.data(), sizeof(float) * nExtras * nPoints);
     }
 
     // Read all extra quantities' names. Stored as multiple c-strings
     std::string allNamesInOne;
-    std::vector<char> buffer(byteSizeAllNames);
-    ifs.read(buffer.data(), byteSizeAllNames);
-    allNamesInOne.assign(buffer.data(), byteSizeAllNames);
+    allNamesInOne.resize(byteSizeAllNames);
+    success = success && read(allNamesInOne.data(), byteSizeAllNames);
+    if (!success) {
+        LERROR(std::format("File '{}' is truncated or corrupt", pathToOsflsFile));
+        return false;
+    }
 
-    size_t offset = 0;
+    // Every line has to lie within the vertices of the state
+    for (size_t i = 0; i < nLines; i++) {
+        const int64_t start = _lineStart[i];
+        const int64_t count = _lineCount[i];
+        if (start < 0 || count < 0 || static_cast<uint64_t>(start + count) > nPoints) {
+            LERROR(std::format(
+                "File '{}' is corrupt. Line {} is out of bounds", pathToOsflsFile, i
+            ));
+            return false;
+        }
+    }
+
+    size_t nameOffset = 0;
     for (size_t i = 0; i < nExtras; i++) {
-        auto endOfVarName = allNamesInOne.find('\0', offset);
-        endOfVarName -= offset;
-        const std::string varName = allNamesInOne.substr(offset, endOfVarName);
-        offset += varName.size() + 1;
-        _extraQuantityNames[i] = varName;
+        const size_t endOfVarName = allNamesInOne.find('\0', nameOffset);
+        if (endOfVarName == std::string::npos) {
+            LERROR(std::format(
+                "File '{}' is corrupt. Name of extra quantity {} is not terminated",
+                pathToOsflsFile, i
+            ));
+            return false;
+        }
+        _extraQuantityNames[i] = allNamesInOne.substr(
+            nameOffset,
+            endOfVarName - nameOffset
+        );
+        nameOffset = endOfVarName + 1;
     }
 
     return true;
@@ -177,8 +352,14 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
         }
     }
 
+    // The values of each extra quantity are stored after each other, so the total number
+    // of points is needed before they can be placed
+    size_t nTotalPoints = 0;
+    for (json::iterator lineIter = jFile.begin(); lineIter != jFile.end(); ++lineIter) {
+        nTotalPoints += (*lineIter)[sTrace][sData].size();
+    }
     const size_t nExtras = _extraQuantityNames.size();
-    _extraQuantities.resize(nExtras);
+    _extraQuantities.resize(nExtras * nTotalPoints);
 
     size_t lineStartIdx = 0;
     // Loop through all fieldlines
@@ -206,7 +387,8 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
             // Add the extra quantites. Stored in the same array as the x,y,z variables.
             // Hence index of the first extra quantity = 3
             for (size_t xtraIdx = 3, k = 0; k < nExtras; k++, xtraIdx++) {
-                _extraQuantities[k].push_back(variables[xtraIdx]);
+                _extraQuantities[k * nTotalPoints + lineStartIdx + j] =
+                    variables[xtraIdx];
             }
         }
         _lineCount.push_back(static_cast<GLsizei>(nPoints));
@@ -219,26 +401,34 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
 /**
  * \param absPath must be the path to the file (incl. filename but excl. extension!)
  * Directory must exist! File is created (or overwritten if already existing).
- * File is structured like this: (for version 0)
+ * File is structured like this: (for version 1)
  *  0. int                    - version number of binary state file! (in case something
  *                              needs to be altered in the future, then increase
- *                              CurrentVersion)
+ *                              CurrentVersion). States that are not quantized are
+ *                              written as version 0, so that they stay readable by
+ *                              earlier versions
  *  1. double                 - _triggerTime
  *  2. int                    - _model
  *  3. bool                   - _isMorphable
+ *     bool                   - _isQuantized (not present in version 0)
  *  4. size_t                 - Number of lines in the state  == _lineStart.size()
  *                                                            == _lineCount.size()
  *  5. size_t                 - Total number of vertex points == _vertexPositions.size()
- *                                                           == _extraQuantities[i].size()
- *  6. size_t                 - Number of extra quantites     == _extraQuantities.size()
- *                                                           == _extraQuantityNames.size()
+ *  6. size_t                 - Number of extra quantites == _extraQuantityNames.size()
  *  7. site_t                 - Number of total bytes that ALL _extraQuantityNames
  *                              consists of (Each such name is stored as a c_str which
  *                              means it ends with the null char '\0' )
  *  7. std::vector<GLint>     - _lineStart
  *  8. std::vector<GLsizei>   - _lineCount
  *  9. std::vector<glm::vec3> - _vertexPositions
- * 10. std::vector<float>     - _extraQuantities
+ * 10. std::vector<float>     - _extraQuantities, one quantity after the other
+ *     If the state is quantized 9. and 10. are replaced by:
+ *     glm::vec3              - _positionOffset
+ *     glm::vec3              - _positionScale
+ *     std::vector<float>     - _extraQuantityOffsets
+ *     std::vector<float>     - _extraQuantityScales
+ *     std::vector<uint16_t>  - _quantizedPositions
+ *     std::vector<uint16_t>  - _quantizedExtraQuantities
  * 11. array of c_str         - Strings naming the extra quantities (elements of
  *                              _extraQuantityNames). Each string ends with null char '\0'
  */
@@ -265,18 +455,22 @@ void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
     }
 
     const size_t nLines = _lineStart.size();
-    const size_t nPoints = _vertexPositions.size();
-    const size_t nExtras = _extraQuantities.size();
+    const size_t nPoints = nVertices();
+    const size_t nExtras = nExtraQuantities();
     const size_t nStringBytes = allExtraQuantityNamesInOne.size();
 
     //----------------------------- WRITE EVERYTHING TO FILE -----------------------------
     // VERSION OF BINARY FIELDLINES STATE FILE - IN CASE STRUCTURE CHANGES IN THE FUTURE
-    ofs.write(reinterpret_cast<const char*>(&CurrentVersion), sizeof(int));
+    const int version = _isQuantized ? CurrentVersion : 0;
+    ofs.write(reinterpret_cast<const char*>(&version), sizeof(int));
 
     //-------------------- WRITE META DATA FOR STATE --------------------------------
     ofs.write(reinterpret_cast<const char*>(&_triggerTime), sizeof(_triggerTime));
     ofs.write(reinterpret_cast<const char*>(&_model), sizeof(int32_t));
     ofs.write(reinterpret_cast<const char*>(&_isMorphable), sizeof(bool));
+    if (version >= 1) {
+        ofs.write(reinterpret_cast<const char*>(&_isQuantized), sizeof(bool));
+    }
 
     ofs.write(reinterpret_cast<const char*>(&nLines), sizeof(uint64_t));
     ofs.write(reinterpret_cast<const char*>(&nPoints), sizeof(uint64_t));
@@ -286,13 +480,35 @@ void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
     //---------------------- WRITE ALL ARRAYS OF DATA --------------------------------
     ofs.write(reinterpret_cast<char*>(_lineStart.data()), sizeof(int32_t) * nLines);
     ofs.write(reinterpret_cast<char*>(_lineCount.data()), sizeof(uint32_t) * nLines);
-    ofs.write(
-        reinterpret_cast<char*>(_vertexPositions.data()),
-        3 * sizeof(float) * nPoints
-    );
-    // Write the data for each vector in _extraQuantities
-    for (std::vector<float>& vec : _extraQuantities) {
-        ofs.write(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
+    if (_isQuantized) {
+        ofs.write(reinterpret_cast<const char*>(&_positionOffset), sizeof(glm::vec3));
+        ofs.write(reinterpret_cast<const char*>(&_positionScale), sizeof(glm::vec3));
+        ofs.write(
+            reinterpret_cast<const char*>(_extraQuantityOffsets.data()),
+            sizeof(float) * nExtras
+        );
+        ofs.write(
+            reinterpret_cast<const char*>(_extraQuantityScales.data()),
+            sizeof(float) * nExtras
+        );
+        ofs.write(
+            reinterpret_cast<const char*>(_quantizedPositions.data()),
+            sizeof(uint16_t) * _quantizedPositions.size()
+        );
+        ofs.write(
+            reinterpret_cast<const char*>(_quantizedExtraQuantities.data()),
+            sizeof(uint16_t) * _quantizedExtraQuantities.size()
+        );
+    }
+    else {
+        ofs.write(
+            reinterpret_cast<const char*>(_vertexPositions.data()),
+            3 * sizeof(float) * nPoints
+        );
+        ofs.write(
+            reinterpret_cast<const char*>(_extraQuantities.data()),
+            sizeof(float) * _extraQuantities.size()
+        );
     }
     ofs.write(allExtraQuantityNamesInOne.c_str(), nStringBytes);
 }
@@ -342,18 +558,44 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
 
     std::string_view timeStr = Time(_triggerTime).ISO8601();
     const size_t nLines = _lineStart.size();
-    // const size_t nPoints      = _vertexPositions.size();
-    const size_t nExtras = _extraQuantities.size();
+    const size_t nPoints = nVertices();
+    const size_t nExtras = nExtraQuantities();
+
+    // Quantized states are written with their restored values
+    auto position = [this](size_t i) {
+        if (!_isQuantized) {
+            return _vertexPositions[i];
+        }
+        glm::vec3 p;
+        for (int c = 0; c < 3; c++) {
+            p[c] = restoreValue(
+                _quantizedPositions[3 * i + c],
+                _positionOffset[c],
+                _positionScale[c]
+            );
+        }
+        return p;
+    };
+    auto extraValue = [this, nPoints](size_t q, size_t i) {
+        if (!_isQuantized) {
+            return _extraQuantities[q * nPoints + i];
+        }
+        return restoreValue(
+            _quantizedExtraQuantities[q * nPoints + i],
+            _extraQuantityOffsets[q],
+            _extraQuantityScales[q]
+        );
+    };
 
     size_t pointIndex = 0;
     for (size_t lineIndex = 0; lineIndex < nLines; ++lineIndex) {
         json jData = json::array();
         for (GLsizei i = 0; i < _lineCount[lineIndex]; i++, ++pointIndex) {
-            const glm::vec3 pos = _vertexPositions[pointIndex];
+            const glm::vec3 pos = position(pointIndex);
             json jDataElement = { pos.x, pos.y, pos.z };
 
             for (size_t extraIndex = 0; extraIndex < nExtras; ++extraIndex) {
-                jDataElement.push_back(_extraQuantities[extraIndex][pointIndex]);
+                jDataElement.push_back(extraValue(extraIndex, pointIndex));
             }
             jData.push_back(jDataElement);
         }
@@ -382,19 +624,47 @@ void FieldlinesState::setTriggerTime(double t) {
     _triggerTime = t;
 }
 
-// Returns one of the extra quantity vectors, _extraQuantities[index].
-// If index is out of scope an empty vector is returned and the referenced bool is false.
-std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessful) const
-{
-    if (index < _extraQuantities.size()) {
-        isSuccessful = true;
-        return _extraQuantities[index];
-    }
-    else {
-        isSuccessful = false;
+std::span<const float> FieldlinesState::extraQuantity(size_t index) const {
+    if (index >= nExtraQuantities()) {
         LERROR("Provided Index was out of scope");
         return {};
     }
+    const size_t nPoints = nVertices();
+    if (_extraQuantities.size() < (index + 1) * nPoints) {
+        return {};
+    }
+    return std::span<const float>(_extraQuantities).subspan(index * nPoints, nPoints);
+}
+
+std::span<const uint16_t> FieldlinesState::quantizedVertexPositions() const {
+    return _quantizedPositions;
+}
+
+glm::vec3 FieldlinesState::positionOffset() const {
+    return _positionOffset;
+}
+
+glm::vec3 FieldlinesState::positionScale() const {
+    return _positionScale;
+}
+
+std::span<const uint16_t> FieldlinesState::quantizedExtraQuantity(size_t index) const {
+    const size_t nPoints = nVertices();
+    if (_quantizedExtraQuantities.size() < (index + 1) * nPoints) {
+        return {};
+    }
+    return std::span<const uint16_t>(_quantizedExtraQuantities).subspan(
+        index * nPoints,
+        nPoints
+    );
+}
+
+float FieldlinesState::extraQuantityOffset(size_t index) const {
+    return index < _extraQuantityOffsets.size() ? _extraQuantityOffsets[index] : 0.f;
+}
+
+float FieldlinesState::extraQuantityScale(size_t index) const {
+    return index < _extraQuantityScales.size() ? _extraQuantityScales[index] : 1.f;
 }
 
 // Moves the points in @param line over to _vertexPositions and updates
@@ -405,7 +675,6 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
     const size_t nOldPoints = _vertexPositions.size();
     _lineStart.push_back(static_cast<GLint>(nOldPoints));
     _lineCount.push_back(static_cast<GLsizei>(nNewPoints));
-    _vertexPositions.reserve(nOldPoints + nNewPoints);
     _vertexPositions.insert(
         _vertexPositions.end(),
         std::make_move_iterator(line.begin()),
@@ -414,17 +683,16 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
     line.clear();
 }
 
-void FieldlinesState::appendToExtra(size_t idx, float val) {
-    _extraQuantities[idx].push_back(val);
+void FieldlinesState::setExtraQuantities(std::vector<float> quantities) {
+    ghoul_assert(
+        quantities.size() == nExtraQuantities() * _vertexPositions.size(),
+        "Each extra quantity needs one value per vertex"
+    );
+    _extraQuantities = std::move(quantities);
 }
 
 void FieldlinesState::setExtraQuantityNames(std::vector<std::string> names) {
     _extraQuantityNames = std::move(names);
-    _extraQuantities.resize(_extraQuantityNames.size());
-}
-
-const std::vector<std::vector<float>>& FieldlinesState::extraQuantities() const {
-    return _extraQuantities;
 }
 
 const std::vector<std::string>& FieldlinesState::extraQuantityNames() const {
@@ -443,8 +711,16 @@ fls::Model FieldlinesState::FieldlinesState::model() const {
     return _model;
 }
 
+bool FieldlinesState::isQuantized() const {
+    return _isQuantized;
+}
+
 size_t FieldlinesState::nExtraQuantities() const {
-    return _extraQuantities.size();
+    return _extraQuantityNames.size();
+}
+
+size_t FieldlinesState::nVertices() const {
+    return _isQuantized ? _quantizedPositions.size() / 3 : _vertexPositions.size();
 }
 
 double FieldlinesState::triggerTime() const {
@@ -28,6 +28,7 @@
 #include <modules/fieldlinessequence/util/commons.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,15 @@ public:
     void convertLatLonToCartesian(float scale = 1.f);
     void scalePositions(float scale);
 
+    /**
+     * Replaces the vertex positions and extra quantities with 16-bit values that are
+     * mapped linearly onto the range each of them covers in this state. This reduces the
+     * size of the state in memory, on disk and on the GPU to roughly half at the cost of
+     * precision. Once quantized, vertexPositions() and extraQuantity() are empty and the
+     * quantized accessors have to be used instead.
+     */
+    void quantize();
+
     bool loadStateFromOsfls(const std::string& pathToOsflsFile);
     void saveStateToOsfls(const std::string& pathToOsflsFile);
 
@@ -45,36 +55,72 @@ public:
         float coordToMeters);
     void saveStateToJson(const std::string& pathToJsonFile);
 
-    const std::vector<std::vector<float>>& extraQuantities() const;
     const std::vector<std::string>& extraQuantityNames() const;
     const std::vector<GLsizei>& lineCount() const;
     const std::vector<GLint>& lineStart() const;
 
+    bool isQuantized() const;
     fls::Model model() const;
     size_t nExtraQuantities() const;
+    size_t nVertices() const;
     double triggerTime() const;
     const std::vector<glm::vec3>& vertexPositions() const;
 
-    // Special getter. Returns extraQuantities[index].
-    std::vector<float> extraQuantity(size_t index, bool& isSuccesful) const;
+    /**
+     * Returns the values of the extra quantity with the provided \p index for all
+     * vertices without copying them. The span is empty if the index is out of range or if
+     * the state is quantized.
+     */
+    std::span<const float> extraQuantity(size_t index) const;
+
+    /**
+     * Returns the quantized x, y and z coordinates of all vertices. A coordinate is
+     * restored as `positionOffset() + positionScale() * value / 65535`.
+     */
+    std::span<const uint16_t> quantizedVertexPositions() const;
+    glm::vec3 positionOffset() const;
+    glm::vec3 positionScale() const;
+
+    /**
+     * Returns the quantized values of the extra quantity with the provided \p index. A
+     * value is restored as `extraQuantityOffset(index) + extraQuantityScale(index) *
+     * value / 65535`.
+     */
+    std::span<const uint16_t> quantizedExtraQuantity(size_t index) const;
+    float extraQuantityOffset(size_t index) const;
+    float extraQuantityScale(size_t index) const;
 
     void setModel(fls::Model m);
     void setTriggerTime(double t);
     void setExtraQuantityNames(std::vector<std::string> names);
 
     void addLine(std::vector<glm::vec3>& line);
-    void appendToExtra(size_t idx, float val);
+
+    /**
+     * Sets the values of all extra quantities, which have to be provided one quantity
+     * after the other with one value per vertex of the lines that have been added.
+     */
+    void setExtraQuantities(std::vector<float> quantities);
 
 private:
     bool _isMorphable = false;
     double _triggerTime = -1.0;
     fls::Model _model;
 
-    std::vector<std::vector<float>> _extraQuantities;
+    // The values of each extra quantity are stored after each other in one block
+    std::vector<float> _extraQuantities;
     std::vector<std::string> _extraQuantityNames;
     std::vector<GLsizei> _lineCount;
     std::vector<GLint> _lineStart;
     std::vector<glm::vec3> _vertexPositions;
+
+    bool _isQuantized = false;
+    std::vector<uint16_t> _quantizedExtraQuantities;
+    std::vector<uint16_t> _quantizedPositions;
+    glm::vec3 _positionOffset = glm::vec3(0.f);
+    glm::vec3 _positionScale = glm::vec3(1.f);
+    std::vector<float> _extraQuantityOffsets;
+    std::vector<float> _extraQuantityScales;
 };
 
 } // namespace openspace
@@ -29,7 +29,11 @@
 #include <openspace/util/spicemanager.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
+#include <future>
 #include <memory>
+#include <mutex>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 
@@ -57,17 +61,59 @@ namespace {
     constexpr std::string_view JParallelB  = "Current: mag(J||B)";
     // [nPa]/[amu/cm^3] * ToKelvin => Temperature in Kelvin
     constexpr float ToKelvin = 72429735.6984f;
+
+    // SPICE is not thread-safe, but multiple CDF files can be converted at the same time
+    std::mutex SpiceMutex;
+
+    // Kameleon reads CDF files through a library that is not thread-safe, so opening
+    // files and loading variables is serialized. Tracing through loaded variables is not
+    std::mutex KameleonMutex;
+
+    // Describes how the extra quantities of a vertex are computed from the variables that
+    // are interpolated at its position. Each variable is only interpolated once per
+    // vertex, even if it is used by more than one quantity
+    struct ExtraQuantityLayout {
+        enum class Type {
+            Scalar,
+            Temperature,
+            EnlilDensity,
+            Magnitude,
+            ParallelCurrent
+        };
+
+        struct Quantity {
+            Type type = Type::Scalar;
+            // Indices into `variables` of the values this quantity is computed from
+            std::array<size_t, 6> inputs = {};
+        };
+
+        std::vector<std::string> variables;
+        std::vector<Quantity> quantities;
+    };
+
+    // The field lines and extra quantities that one worker has traced from its share of
+    // the seed points
+    struct TracedLines {
+        std::vector<std::vector<glm::vec3>> lines;
+        std::vector<std::vector<float>> extraQuantities;
+        bool isValid = false;
+    };
 } // namespace
 
 namespace openspace::fls {
 
 // -------------------- DECLARE FUNCTIONS USED (ONLY) IN THIS FILE -------------------- //
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
-    bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
-        const std::string& tracingVar, FieldlinesState& state);
-    void addExtraQuantities(ccmc::Kameleon* kameleon,
-        std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
+    bool addLinesToState(ccmc::Kameleon* kameleon, const std::string& cdfPath,
+        const std::vector<glm::vec3>& seeds, const std::string& tracingVar,
+        const ExtraQuantityLayout& layout, unsigned int nThreads,
         FieldlinesState& state);
+    void traceLines(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
+        const std::string& tracingVar, float innerBoundaryLimit,
+        const ExtraQuantityLayout& layout, TracedLines& result);
+    ExtraQuantityLayout createExtraQuantityLayout(
+        const std::vector<std::string>& extraScalarVars,
+        const std::vector<std::string>& extraMagVars, const FieldlinesState& state);
     void prepareStateAndKameleonForExtras(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
         FieldlinesState& state);
@@ -80,34 +126,66 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
                                  double manualTimeOffset,
                                  const std::string& tracingVar,
                                  std::vector<std::string>& extraVars,
-                                 std::vector<std::string>& extraMagVars)
+                                 std::vector<std::string>& extraMagVars,
+                                 unsigned int nThreads)
 {
 #ifndef OPENSPACE_MODULE_KAMELEON_ENABLED
     LERROR("CDF inputs provided but Kameleon module is deactivated");
     return false;
 #else // OPENSPACE_MODULE_KAMELEON_ENABLED
     // Create Kameleon object and open CDF file!
-    std::unique_ptr<ccmc::Kameleon> kameleon = kameleonHelper::createKameleonObject(
-        cdfPath
-    );
+    std::unique_ptr<ccmc::Kameleon> kameleon;
+    {
+        std::lock_guard lock(KameleonMutex);
+        kameleon = kameleonHelper::createKameleonObject(cdfPath);
+    }
+    if (!kameleon) {
+        return false;
+    }
 
     state.setModel(fls::stringToModel(kameleon->getModelName()));
-    double cdfDoubleTime = kameleonHelper::getTime(kameleon.get(), manualTimeOffset);
+
+    double cdfDoubleTime = 0.0;
+    std::string cdfStringTime;
+    {
+        std::lock_guard lock(SpiceMutex);
+        cdfDoubleTime = kameleonHelper::getTime(kameleon.get(), manualTimeOffset);
+
+        // get time as string.
+        cdfStringTime = SpiceManager::ref().dateFromEphemerisTime(
+            cdfDoubleTime, "YYYYMMDDHRMNSC::RND"
+        );
+    }
     state.setTriggerTime(cdfDoubleTime);
 
-    // get time as string.
-    std::string cdfStringTime = SpiceManager::ref().dateFromEphemerisTime(
-        cdfDoubleTime, "YYYYMMDDHRMNSC::RND"
+    // use time as string for picking seedpoints from seedm
+    const std::vector<glm::vec3>& seedPoints = seedMap.at(cdfStringTime);
+
+    // The extra quantities are validated before tracing, so that the Kameleon objects of
+    // the tracing workers know which variables they have to load
+    {
+        std::lock_guard lock(KameleonMutex);
+        prepareStateAndKameleonForExtras(kameleon.get(), extraVars, extraMagVars, state);
+    }
+    const ExtraQuantityLayout layout = createExtraQuantityLayout(
+        extraVars,
+        extraMagVars,
+        state
     );
 
-    // use time as string for picking seedpoints from seedm
-    std::vector<glm::vec3> seedPoints = seedMap.at(cdfStringTime);
-    bool success = addLinesToState(kameleon.get(), seedPoints, tracingVar, state);
+    // The extra quantities are sampled while tracing, as the interpolator needs the line
+    // points in their RAW format (unscaled & maybe spherical). Only afterwards are they
+    // scaled to meters (and maybe converted to cartesian)
+    bool success = addLinesToState(
+        kameleon.get(),
+        cdfPath,
+        seedPoints,
+        tracingVar,
+        layout,
+        std::max(nThreads, 1u),
+        state
+    );
     if (success) {
-        // The line points are in their RAW format (unscaled & maybe spherical)
-        // Before we scale to meters (and maybe cartesian) we must extract
-        // the extraQuantites, as the iterpolator needs the unaltered positions
-        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state);
         switch (state.model()) {
             case fls::Model::Batsrus:
                 state.scalePositions(fls::ReToMeter);
@@ -128,14 +206,19 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 /**
- * Traces and adds line vertices to state.
+ * Traces and adds line vertices and their extra quantities to state.
  * Vertices are not scaled to meters nor converted from spherical into cartesian
  * coordinates.
- * Note that extraQuantities will NOT be set!
+ * The seed points are split into \p nThreads contiguous ranges. The first range is traced
+ * with the provided \p kameleon, every other range on its own thread with its own
+ * Kameleon object opened from \p cdfPath, as neither Kameleon nor its interpolators may
+ * be shared between threads.
  */
-bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
-                     const std::string& tracingVar, FieldlinesState& state) {
-
+bool addLinesToState(ccmc::Kameleon* kameleon, const std::string& cdfPath,
+                     const std::vector<glm::vec3>& seedPoints,
+                     const std::string& tracingVar, const ExtraQuantityLayout& layout,
+                     unsigned int nThreads, FieldlinesState& state)
+{
     float innerBoundaryLimit;
 
     switch (state.model()) {
@@ -154,13 +237,125 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
     }
 
     // ---------------------------- LOAD TRACING VARIABLE ---------------------------- //
-    if (!kameleon->loadVariable(tracingVar)) {
+    bool isLoaded = false;
+    {
+        std::lock_guard lock(KameleonMutex);
+        isLoaded = kameleon->loadVariable(tracingVar);
+    }
+    if (!isLoaded) {
         LERROR("Failed to load tracing variable: " + tracingVar);
         return false;
     }
 
-    bool success = false;
     LINFO("Tracing field lines");
+    const size_t nSeeds = seedPoints.size();
+    const size_t nWorkers = std::max<size_t>(std::min<size_t>(nThreads, nSeeds), 1);
+    auto seedRange = [&](size_t worker) {
+        return std::vector<glm::vec3>(
+            seedPoints.begin() + nSeeds * worker / nWorkers,
+            seedPoints.begin() + nSeeds * (worker + 1) / nWorkers
+        );
+    };
+
+    std::vector<TracedLines> results(nWorkers);
+    auto traceWithOwnKameleon = [&](size_t worker) {
+        std::unique_ptr<ccmc::Kameleon> k;
+        {
+            std::lock_guard lock(KameleonMutex);
+            k = kameleonHelper::createKameleonObject(cdfPath);
+            if (!k || !k->loadVariable(tracingVar)) {
+                return;
+            }
+            for (const std::string& variable : layout.variables) {
+                if (!k->loadVariable(variable)) {
+                    return;
+                }
+            }
+        }
+        traceLines(
+            k.get(),
+            seedRange(worker),
+            tracingVar,
+            innerBoundaryLimit,
+            layout,
+            results[worker]
+        );
+    };
+
+    std::vector<std::future<void>> futures;
+    for (size_t worker = 1; worker < nWorkers; worker++) {
+        futures.push_back(std::async(std::launch::async, traceWithOwnKameleon, worker));
+    }
+    traceLines(
+        kameleon,
+        seedRange(0),
+        tracingVar,
+        innerBoundaryLimit,
+        layout,
+        results[0]
+    );
+    for (size_t worker = 1; worker < nWorkers; worker++) {
+        futures[worker - 1].get();
+        if (!results[worker].isValid) {
+            // Fall back to the Kameleon object of the calling thread rather than losing
+            // the field lines of this worker
+            LWARNING(std::format(
+                "Could not open a second Kameleon object for '{}'. Tracing on one thread",
+                cdfPath
+            ));
+            traceLines(
+                kameleon,
+                seedRange(worker),
+                tracingVar,
+                innerBoundaryLimit,
+                layout,
+                results[worker]
+            );
+        }
+    }
+
+    // Merge the results in the order of the seed points. The state stores the values of
+    // each extra quantity after each other, so they are merged one quantity at a time
+    bool success = false;
+    for (TracedLines& result : results) {
+        for (std::vector<glm::vec3>& line : result.lines) {
+            success |= !line.empty();
+            state.addLine(line);
+        }
+    }
+    std::vector<float> extraQuantities;
+    extraQuantities.reserve(layout.quantities.size() * state.nVertices());
+    for (size_t i = 0; i < layout.quantities.size(); i++) {
+        for (const TracedLines& result : results) {
+            extraQuantities.insert(
+                extraQuantities.end(),
+                result.extraQuantities[i].begin(),
+                result.extraQuantities[i].end()
+            );
+        }
+    }
+    state.setExtraQuantities(std::move(extraQuantities));
+    return success;
+}
+
+/**
+ * Traces one field line for each of the \p seedPoints and samples the extra quantities
+ * described by \p layout at each of its vertices. All variables that are used have to be
+ * loaded into \p kameleon already.
+ */
+void traceLines(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
+                const std::string& tracingVar, float innerBoundaryLimit,
+                const ExtraQuantityLayout& layout, TracedLines& result)
+{
+    result.lines.clear();
+    result.lines.reserve(seedPoints.size());
+    result.extraQuantities.assign(layout.quantities.size(), std::vector<float>());
+
+    auto extraInterpolator = std::make_unique<ccmc::KameleonInterpolator>(
+        kameleon->model
+    );
+    std::vector<float> values(layout.variables.size());
+
     // LOOP THROUGH THE SEED POINTS, TRACE LINES, CONVERT POINTS TO glm::vec3 AND STORE //
     for (const glm::vec3& seed : seedPoints) {
         //--------------------------------------------------------------------------//
@@ -178,96 +373,139 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
         );
         const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
 
-        const size_t nLinePoints = positions.size();
-
         std::vector<glm::vec3> vertices;
-        vertices.reserve(nLinePoints);
+        vertices.reserve(positions.size());
         for (const ccmc::Point3f& p : positions) {
             vertices.emplace_back(p.component1, p.component2, p.component3);
         }
-        state.addLine(vertices);
-        success |= (nLinePoints > 0);
-    }
 
-    return success;
+        // ---- Extract all the extraQuantities from kameleon for the new vertices ---- //
+        for (const glm::vec3& p : vertices) {
+            for (size_t i = 0; i < layout.variables.size(); i++) {
+                values[i] = extraInterpolator->interpolate(
+                    layout.variables[i],
+                    p.x,
+                    p.y,
+                    p.z
+                );
+            }
+
+            for (size_t i = 0; i < layout.quantities.size(); i++) {
+                using Type = ExtraQuantityLayout::Type;
+                const ExtraQuantityLayout::Quantity& q = layout.quantities[i];
+                float val = 0.f;
+                switch (q.type) {
+                    case Type::Scalar:
+                        val = values[q.inputs[0]];
+                        break;
+                    case Type::Temperature:
+                        val = values[q.inputs[0]];
+                        val *= ToKelvin;
+                        val /= values[q.inputs[1]];
+                        break;
+                    case Type::EnlilDensity:
+                        // When measuring density in ENLIL CCMC multiply by the radius^2
+                        val = values[q.inputs[0]];
+                        val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+                        break;
+                    case Type::Magnitude:
+                    {
+                        const glm::vec3 v = glm::vec3(
+                            values[q.inputs[0]],
+                            values[q.inputs[1]],
+                            values[q.inputs[2]]
+                        );
+                        val = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+                        break;
+                    }
+                    case Type::ParallelCurrent:
+                    {
+                        const glm::vec3 current = glm::vec3(
+                            values[q.inputs[0]],
+                            values[q.inputs[1]],
+                            values[q.inputs[2]]
+                        );
+                        const glm::vec3 normMagnetic = glm::normalize(glm::vec3(
+                            values[q.inputs[3]],
+                            values[q.inputs[4]],
+                            values[q.inputs[5]]
+                        ));
+                        // Magnitude of the part of the current vector that's parallel to
+                        // the magnetic field vector!
+                        val = glm::dot(current, normMagnetic);
+                        break;
+                    }
+                }
+                result.extraQuantities[i].push_back(val);
+            }
+        }
+
+        result.lines.push_back(std::move(vertices));
+    }
+    result.isValid = true;
 }
-#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
 
 /**
- * Loops through state's _vertexPositions and extracts corresponding 'extraQuantities'
- * from the kameleon object using a ccmc::interpolator.
- * Note that the positions MUST be unaltered (NOT scaled NOR converted to a different
- * coordinate system)!
+ * Creates the layout describing how the extra quantities of the \p state are computed.
+ * The variables must have been validated by prepareStateAndKameleonForExtras first.
  *
- * @param kameleon raw pointer to an already opened Kameleon object
- * @param extraScalarVars vector of strings. Strings should be names of a scalar
- * quantities to load into _extraQuantites; such as: "T" for temperature or "rho" for
- * density.
- * @param extraMagVars vector of strings. Size must be multiple of 3. Strings should be
- * names of the components needed to calculate magnitude. E.g. {"ux", "uy", "uz"} will
- * calculate: sqrt(ux*ux + uy*uy + uz*uz). Magnitude will be stored in _extraQuantities
- * @param state, The FieldlinesState which the extra quantities should be added to.
+ * \param extraScalarVars Names of the scalar quantities; such as: "T" for temperature or
+ *        "rho" for density.
+ * \param extraMagVars Names of the components needed to calculate magnitudes, three per
+ *        magnitude. E.g. {"ux", "uy", "uz"} will calculate: sqrt(ux*ux + uy*uy + uz*uz)
+ * \param state The FieldlinesState whose extra quantity names have already been set
  */
-#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
-void addExtraQuantities(ccmc::Kameleon* kameleon,
-                        std::vector<std::string>& extraScalarVars,
-                        std::vector<std::string>& extraMagVars,
-                        FieldlinesState& state)
+ExtraQuantityLayout createExtraQuantityLayout(
+                                          const std::vector<std::string>& extraScalarVars,
+                                             const std::vector<std::string>& extraMagVars,
+                                                             const FieldlinesState& state)
 {
-
-    prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
-
-    const size_t nXtraScalars = extraScalarVars.size();
-    const size_t nXtraMagnitudes = extraMagVars.size() / 3;
-
-    auto interpolator = std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-
-    // ------ Extract all the extraQuantities from kameleon and store in state! ------ //
-    for (const glm::vec3& p : state.vertexPositions()) {
-        // Load the scalars!
-        for (size_t i = 0; i < nXtraScalars; i++) {
-            float val;
-            if (extraScalarVars[i] == TAsPOverRho) {
-                val = interpolator->interpolate("p", p.x, p.y, p.z);
-                val *= ToKelvin;
-                val /= interpolator->interpolate("rho", p.x, p.y, p.z);
-            }
-            else {
-                val = interpolator->interpolate(extraScalarVars[i], p.x, p.y, p.z);
-
-                // When measuring density in ENLIL CCMC multiply by the radius^2
-                if (extraScalarVars[i] == "rho" && state.model() == fls::Model::Enlil) {
-                    val *= std::pow(p.x * fls::AuToMeter, 2.0f);
-                }
-            }
-            state.appendToExtra(i, val);
+    ExtraQuantityLayout layout;
+    auto variableIndex = [&layout](const std::string& variable) {
+        auto it = std::find(layout.variables.begin(), layout.variables.end(), variable);
+        if (it != layout.variables.end()) {
+            return static_cast<size_t>(std::distance(layout.variables.begin(), it));
         }
-        // Calculate and store the magnitudes!
-        for (size_t i = 0; i < nXtraMagnitudes; i++) {
-            const size_t idx = i*3;
-
-            const float x = interpolator->interpolate(extraMagVars[idx]  , p.x, p.y, p.z);
-            const float y = interpolator->interpolate(extraMagVars[idx+1], p.x, p.y, p.z);
-            const float z = interpolator->interpolate(extraMagVars[idx+2], p.x, p.y, p.z);
-            float val;
-            // When looking at the current's magnitude in Batsrus, CCMC staff are
-            // only interested in the magnitude parallel to the magnetic field
-            if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
-                const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
-                        interpolator->interpolate("bx", p.x, p.y, p.z),
-                        interpolator->interpolate("by", p.x, p.y, p.z),
-                        interpolator->interpolate("bz", p.x, p.y, p.z)));
-                // Magnitude of the part of the current vector that's parallel to
-                // the magnetic field vector!
-                val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+        layout.variables.push_back(variable);
+        return layout.variables.size() - 1;
+    };
+
+    using Type = ExtraQuantityLayout::Type;
+    for (const std::string& var : extraScalarVars) {
+        ExtraQuantityLayout::Quantity q;
+        if (var == TAsPOverRho) {
+            q.type = Type::Temperature;
+            q.inputs[0] = variableIndex("p");
+            q.inputs[1] = variableIndex("rho");
+        }
+        else {
+            const bool isEnlil = state.model() == fls::Model::Enlil;
+            q.type = (var == "rho" && isEnlil) ? Type::EnlilDensity : Type::Scalar;
+            q.inputs[0] = variableIndex(var);
+        }
+        layout.quantities.push_back(q);
+    }
 
-            }
-            else {
-                val = std::sqrt(x*x + y*y + z*z);
-            }
-            state.appendToExtra(i + nXtraScalars, val);
+    for (size_t i = 0; i < extraMagVars.size() / 3; i++) {
+        ExtraQuantityLayout::Quantity q;
+        q.inputs[0] = variableIndex(extraMagVars[i * 3]);
+        q.inputs[1] = variableIndex(extraMagVars[i * 3 + 1]);
+        q.inputs[2] = variableIndex(extraMagVars[i * 3 + 2]);
+        // When looking at the current's magnitude in Batsrus, CCMC staff are
+        // only interested in the magnitude parallel to the magnetic field
+        if (state.extraQuantityNames()[extraScalarVars.size() + i] == JParallelB) {
+            q.type = Type::ParallelCurrent;
+            q.inputs[3] = variableIndex("bx");
+            q.inputs[4] = variableIndex("by");
+            q.inputs[5] = variableIndex("bz");
         }
+        else {
+            q.type = Type::Magnitude;
+        }
+        layout.quantities.push_back(q);
     }
+
+    return layout;
 }
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
 
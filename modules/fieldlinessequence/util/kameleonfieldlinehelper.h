@@ -52,11 +52,14 @@ namespace fls {
  * \param extraMagVars Variables which should be used for extracting magnitudes, must be a
  *        multiple of 3; e.g. "ux", "uy" & "uz" to get the magnitude of the velocity
  *        vector at each line vertex
+ * \param nThreads The number of threads that trace the seed points. Each additional
+ *        thread opens the CDF file once more, so the memory usage grows with this value
  */
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
     const std::unordered_map<std::string, std::vector<glm::vec3>>& seedMap,
     double manualTimeOffset, const std::string& tracingVar,
-    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars);
+    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars,
+    unsigned int nThreads = 1);
 
 } // namespace fls
 } // namespace openspace
@@ -29,12 +29,21 @@
 #include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 #include <fstream>
-#include <thread>
 
 namespace {
     constexpr std::string_view _loggerCat = "OctreeManager";
 
+    // The streaming is limited by the disk, so more threads than this only increase the
+    // contention and the number of reads that are in flight when the camera moves
+    constexpr size_t NumStreamingThreads = 4;
+
+    // Comparator that turns the fetch requests into a min-heap on the camera distance
+    constexpr auto IsFartherAway = [](const auto& lhs, const auto& rhs) {
+        return lhs.distance > rhs.distance;
+    };
+
     /**
      * \return the correct index of child node. Maps [1,1,1] to 0 and [-1,-1,-1] to 7
      */
@@ -57,9 +66,23 @@ namespace {
 
 namespace openspace {
 
+OctreeManager::~OctreeManager() {
+    waitForStreamingIdle();
+    {
+        const std::lock_guard lock(_streamingMutex);
+        _stopStreaming = true;
+    }
+    _streamingCondition.notify_all();
+    for (std::thread& thread : _streamingThreads) {
+        thread.join();
+    }
+}
+
 void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStarsPerNode) {
     if (_root) {
         LDEBUG("Clear existing Octree");
+        // Make sure that no streaming thread is still working on the old tree
+        waitForStreamingIdle();
         clearAllData();
     }
 
@@ -175,22 +198,9 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
     if (_datasetFitInMemory) {
         // Only traverse Octree once
         if (_parentNodeOfCamera == 8) {
-            // Fetch first layer of children
-            fetchChildrenNodes(*_root, 0);
-
-            for (const std::shared_ptr<OctreeNode>& child : _root->children) {
-                // Check so branch doesn't have a single layer
-                if (child->isLeaf) {
-                    continue;
-                }
-
-                // Use multithreading to load files and detach thread from main execution
-                // so it can execute independently. Thread will be destroyed when
-                // finished
-                std::thread([this, n = child]() {
-                    fetchChildrenNodes(*n, -1);
-                }).detach();
-            }
+            // Fetch the first layer of children and then all of their descendants. These
+            // requests are never cancelled as the entire dataset should end up in RAM
+            requestFetch(_root, -1, false);
             _parentNodeOfCamera = 0;
         }
         return;
@@ -198,6 +208,10 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
 
     // Get leaf node in which the camera resides
     const glm::vec3 fCameraPos = cameraPos / (1000.0 * distanceconstants::Parsec);
+    {
+        const std::lock_guard lock(_streamingMutex);
+        _streamingCameraPos = fCameraPos;
+    }
     size_t idx = childIndex(fCameraPos.x, fCameraPos.y, fCameraPos.z);
     std::shared_ptr<OctreeNode> node = _root->children[idx];
 
@@ -222,6 +236,10 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
     }
     _parentNodeOfCamera = firstParentId;
 
+    // The camera has moved to a new node, so the nodes that were requested for the
+    // previous position might not be visible anymore
+    cancelFetchRequests();
+
     // Each parent level may be root, make sure to propagate it in that case!
     const unsigned long long secondParentId = (firstParentId == 8) ? 8 : leafId / 100;
     const unsigned long long thirdParentId = (secondParentId == 8) ? 8 : leafId / 1000;
@@ -297,15 +315,19 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
         const long long bytesToTenthOfRam = tenthOfRamBudget - _cpuRamBudget;
         size_t nNodesToRemove = static_cast<size_t>(bytesToTenthOfRam / chunkSizeInBytes);
         std::vector<unsigned long long> nodesToRemove;
-        while (nNodesToRemove > 0) {
-            // Dequeue nodes that were least recently fetched by findAndFetchNeighborNode
-            nodesToRemove.push_back(_leastRecentlyFetchedNodes.front());
-            _leastRecentlyFetchedNodes.pop();
-            nNodesToRemove--;
+        {
+            const std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+            while (nNodesToRemove > 0 && !_leastRecentlyFetchedNodes.empty()) {
+                // Dequeue nodes that were least recently fetched by
+                // findAndFetchNeighborNode
+                nodesToRemove.push_back(_leastRecentlyFetchedNodes.front());
+                _leastRecentlyFetchedNodes.pop();
+                nNodesToRemove--;
+            }
         }
-        // Use asynchronous removal.
+        // Use asynchronous removal
         if (!nodesToRemove.empty()) {
-            std::thread(&OctreeManager::removeNodesFromRam, this, nodesToRemove).detach();
+            requestRemoval(std::move(nodesToRemove));
         }
     }
 }
@@ -318,7 +340,7 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
 
     // Fetch first layer children if we're already at root
     if (parentId == 8) {
-        fetchChildrenNodes(*_root, 0);
+        requestFetch(_root, 0, true);
         return;
     }
 
@@ -401,12 +423,8 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
         indexStack.pop();
     }
 
-    // Fetch all children nodes from found parent. Use multithreading to load files
-    // asynchronously! Detach thread from main execution so it can execute independently.
-    // Thread will then be destroyed when it has finished
-    std::thread([this, node, additionalLevelsToFetch]() {
-        fetchChildrenNodes(*node, additionalLevelsToFetch);
-    }).detach();
+    // Fetch all children nodes from found parent asynchronously
+    requestFetch(std::move(node), additionalLevelsToFetch, true);
 }
 
 std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4& mvp,
@@ -770,29 +788,36 @@ void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
 }
 
 void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
-                                       int additionalLevelsToFetch)
+                                       int additionalLevelsToFetch, bool isCancellable)
 {
-    // Lock node to make sure nobody else are trying to load the same children
-    const std::lock_guard lock(parentNode.loadingLock);
-
-    for (const std::shared_ptr<OctreeNode>& child : parentNode.children) {
-        // Fetch node data if we're streaming and it doesn't exist in RAM yet.
-        // (As long as there is any RAM budget left and node actually has any data!)
-        if (!child->isLoaded && (child->numStars > 0) &&
-            _cpuRamBudget > static_cast<long long>(child->numStars
-                                                  * (POS_SIZE + COL_SIZE + VEL_SIZE) * 4))
-        {
-            fetchNodeDataFromFile(*child);
+    {
+        // Lock node to make sure nobody else are trying to load the same children
+        const std::lock_guard lock(parentNode.loadingLock);
+
+        for (const std::shared_ptr<OctreeNode>& child : parentNode.children) {
+            // Fetch node data if we're streaming and it doesn't exist in RAM yet.
+            // (As long as there is any RAM budget left and node actually has any data!)
+            if (!child->isLoaded && (child->numStars > 0) &&
+                _cpuRamBudget > static_cast<long long>(child->numStars *
+                                                   (POS_SIZE + COL_SIZE + VEL_SIZE) * 4))
+            {
+                fetchNodeDataFromFile(*child);
+            }
         }
+    }
 
-        // Fetch all Children's Children if recursive is set to true
-        if (additionalLevelsToFetch != 0 && !child->isLeaf) {
-            fetchChildrenNodes(*child, --additionalLevelsToFetch);
+    // Queue the children's children as separate requests so that they are ordered with
+    // all other requests and can be cancelled if they are no longer needed
+    if (additionalLevelsToFetch != 0) {
+        for (const std::shared_ptr<OctreeNode>& child : parentNode.children) {
+            if (!child->isLeaf) {
+                requestFetch(child, additionalLevelsToFetch - 1, isCancellable);
+            }
         }
     }
 }
 
-void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
+bool OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
     // Remove root ID ("8") from index before loading file
     std::string posId = std::to_string(node.octreePositionIndex);
     posId.erase(posId.begin());
@@ -803,41 +828,189 @@ void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
     std::ifstream inFileStream(inFilePath, std::ifstream::binary);
     // LINFO("Fetch node data file: " + inFilePath);
 
-    if (inFileStream.good()) {
-        // Read node data
-        int32_t nDataSize = 0;
+    if (!inFileStream.good()) {
+        LERROR("Error opening node data file: " + inFilePath);
+        return false;
+    }
 
-        // Octree knows if we have any data in this node = it exists
-        // Otherwise don't call this function!
-        inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
+    // Read node data
+    int32_t nDataSize = 0;
 
-        std::vector<float> readData(nDataSize, 0.f);
-        const int nBytes = nDataSize * sizeof(float);
-        if (nDataSize > 0) {
-            inFileStream.read(reinterpret_cast<char*>(readData.data()), nBytes);
+    // Octree knows if we have any data in this node = it exists
+    // Otherwise don't call this function!
+    inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
+    const long long nBytes = static_cast<long long>(nDataSize) * sizeof(float);
+    if (!inFileStream.good() || nDataSize < 0 || !reserveRam(nBytes)) {
+        return false;
+    }
+
+    // Read the attributes straight into the node in large contiguous reads instead of
+    // going through an intermediate buffer, which would double the memory footprint
+    const size_t starsInNode = nDataSize / _valuesPerStar;
+    const auto readInto = [&inFileStream](std::vector<float>& data, size_t nValues) {
+        data.resize(nValues);
+        inFileStream.read(
+            reinterpret_cast<char*>(data.data()),
+            static_cast<std::streamsize>(nValues * sizeof(float))
+        );
+    };
+    readInto(node.posData, starsInNode * POS_SIZE);
+    readInto(node.colData, starsInNode * COL_SIZE);
+    readInto(node.velData, starsInNode * VEL_SIZE);
+
+    if (!inFileStream.good()) {
+        LERROR("Error reading node data file: " + inFilePath);
+        node.posData.clear();
+        node.colData.clear();
+        node.velData.clear();
+        _cpuRamBudget += nBytes;
+        return false;
+    }
+
+    // Keep track of nodes that are loaded. The flag is set last so that the render
+    // thread only ever sees fully loaded data
+    node.isLoaded = true;
+    if (!_datasetFitInMemory) {
+        const std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+        _leastRecentlyFetchedNodes.push(node.octreePositionIndex);
+    }
+    return true;
+}
+
+void OctreeManager::requestFetch(std::shared_ptr<OctreeNode> node,
+                                 int additionalLevelsToFetch, bool isCancellable)
+{
+    const unsigned long long id = node->octreePositionIndex;
+    {
+        const std::lock_guard lock(_streamingMutex);
+        if (_stopStreaming) {
+            return;
         }
 
-        const int starsInNode = static_cast<int>(nDataSize / _valuesPerStar);
-        const auto posEnd = readData.begin() + (starsInNode * POS_SIZE);
-        const auto colEnd = posEnd + (starsInNode * COL_SIZE);
-        const auto velEnd = colEnd + (starsInNode * VEL_SIZE);
-        node.posData = std::vector<float>(readData.begin(), posEnd);
-        node.colData = std::vector<float>(posEnd, colEnd);
-        node.velData = std::vector<float>(colEnd, velEnd);
-
-        // Keep track of nodes that are loaded and update CPU RAM budget
-        node.isLoaded = true;
-        if (!_datasetFitInMemory) {
-            const std::lock_guard g(_leastRecentlyFetchedNodesMutex);
-            _leastRecentlyFetchedNodes.push(node.octreePositionIndex);
+        // Skip requests that are already covered by a queued request for the same node
+        const auto it = _queuedFetches.find(id);
+        if (it != _queuedFetches.end() &&
+            (it->second < 0 ||
+            (additionalLevelsToFetch >= 0 && it->second >= additionalLevelsToFetch)))
+        {
+            return;
+        }
+        _queuedFetches[id] = additionalLevelsToFetch;
+
+        const glm::vec3 origin = glm::vec3(node->originX, node->originY, node->originZ);
+        const glm::vec3 diff = origin - _streamingCameraPos;
+        const float distance = glm::dot(diff, diff);
+        _fetchRequests.push_back({
+            std::move(node),
+            additionalLevelsToFetch,
+            distance,
+            isCancellable
+        });
+        std::push_heap(_fetchRequests.begin(), _fetchRequests.end(), IsFartherAway);
+        startStreamingThreads();
+    }
+    _streamingCondition.notify_one();
+}
+
+void OctreeManager::requestRemoval(std::vector<unsigned long long> nodesToRemove) {
+    {
+        const std::lock_guard lock(_streamingMutex);
+        if (_stopStreaming) {
+            return;
         }
-        _cpuRamBudget -= nBytes;
+        _removalRequests.push_back(std::move(nodesToRemove));
+        startStreamingThreads();
     }
-    else {
-        LERROR("Error opening node data file: " + inFilePath);
+    _streamingCondition.notify_one();
+}
+
+void OctreeManager::startStreamingThreads() {
+    if (_streamingThreads.empty()) {
+        for (size_t i = 0; i < NumStreamingThreads; i++) {
+            _streamingThreads.emplace_back(&OctreeManager::streamingLoop, this);
+        }
+    }
+}
+
+void OctreeManager::cancelFetchRequests() {
+    const std::lock_guard lock(_streamingMutex);
+    std::erase_if(
+        _fetchRequests,
+        [](const FetchRequest& request) { return request.isCancellable; }
+    );
+    std::make_heap(_fetchRequests.begin(), _fetchRequests.end(), IsFartherAway);
+    _queuedFetches.clear();
+    for (const FetchRequest& request : _fetchRequests) {
+        _queuedFetches[request.node->octreePositionIndex] =
+            request.additionalLevelsToFetch;
+    }
+}
+
+void OctreeManager::waitForStreamingIdle() {
+    std::unique_lock lock(_streamingMutex);
+    _fetchRequests.clear();
+    _queuedFetches.clear();
+    _removalRequests.clear();
+    // Requests that are processed right now might queue new requests for descendants,
+    // so we have to keep clearing the queue until all threads are done
+    _streamingIdleCondition.wait(lock, [this]() {
+        _fetchRequests.clear();
+        _queuedFetches.clear();
+        return _nActiveRequests == 0;
+    });
+}
+
+void OctreeManager::streamingLoop() {
+    while (true) {
+        std::unique_lock lock(_streamingMutex);
+        _streamingCondition.wait(lock, [this]() {
+            return _stopStreaming || !_removalRequests.empty() || !_fetchRequests.empty();
+        });
+        if (_stopStreaming) {
+            return;
+        }
+
+        _nActiveRequests++;
+        if (!_removalRequests.empty()) {
+            // Removals go first as they free up RAM for the fetches
+            std::vector<unsigned long long> nodes = std::move(_removalRequests.front());
+            _removalRequests.pop_front();
+            lock.unlock();
+
+            removeNodesFromRam(nodes);
+        }
+        else {
+            std::pop_heap(_fetchRequests.begin(), _fetchRequests.end(), IsFartherAway);
+            FetchRequest request = std::move(_fetchRequests.back());
+            _fetchRequests.pop_back();
+            _queuedFetches.erase(request.node->octreePositionIndex);
+            lock.unlock();
+
+            fetchChildrenNodes(
+                *request.node,
+                request.additionalLevelsToFetch,
+                request.isCancellable
+            );
+        }
+
+        lock.lock();
+        _nActiveRequests--;
+        if (_nActiveRequests == 0) {
+            _streamingIdleCondition.notify_all();
+        }
     }
 }
 
+bool OctreeManager::reserveRam(long long nBytes) {
+    long long budget = _cpuRamBudget.load();
+    do {
+        if (budget < nBytes) {
+            return false;
+        }
+    } while (!_cpuRamBudget.compare_exchange_weak(budget, budget - nBytes));
+    return true;
+}
+
 void OctreeManager::removeNodesFromRam(
                                      const std::vector<unsigned long long>& nodesToRemove)
 {
@@ -869,6 +1042,10 @@ void OctreeManager::removeNode(OctreeNode& node) {
     // Lock node to make sure nobody else is trying to access it while removing
     const std::lock_guard lock(node.loadingLock);
 
+    if (!node.isLoaded) {
+        return;
+    }
+
     const int nBytes = static_cast<int>(
         node.numStars * _valuesPerStar * sizeof(node.posData[0])
     );
@@ -29,11 +29,15 @@
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <map>
 #include <mutex>
 #include <queue>
 #include <stack>
+#include <thread>
 #include <vector>
 
 namespace openspace {
@@ -54,7 +58,7 @@ public:
         float halfDimension;
         size_t numStars;
         bool isLeaf;
-        bool isLoaded;
+        std::atomic_bool isLoaded;
         bool hasLoadedDescendant;
         std::mutex loadingLock;
         int bufferIndex;
@@ -62,7 +66,11 @@ public:
     };
 
     OctreeManager() = default;
-    ~OctreeManager() = default;
+
+    /**
+     * Cancels all outstanding streaming requests and joins the streaming threads.
+     */
+    ~OctreeManager();
 
     /**
      * Initializes a one layer Octree with root and 8 children that covers all stars.
@@ -103,7 +111,9 @@ public:
      * unloaded. If entire dataset fits in RAM then the whole dataset will be loaded
      * asynchronously. Otherwise only nodes close to the camera will be fetched. When RAM
      * stars to fill up least-recently used nodes will start to unload. Calls
-     * #findAndFetchNeighborNode and #removeNodesFromRam internally.
+     * #findAndFetchNeighborNode internally and queues removals for the streaming threads.
+     * Fetches that were requested for a previous camera position and that have not
+     * started yet are cancelled when the camera moves to a different node.
      */
     void fetchSurroundingNodes(const glm::dvec3& cameraPos, size_t chunkSizeInBytes,
         const glm::ivec2& additionalNodes);
@@ -355,16 +365,67 @@ private:
      * \param additionalLevelsToFetch determines how many levels of descendants to fetch.
      *        If it is set to 0 no additional level will be fetched. If it is set to a
      *        negative value then all descendants will be fetched recursively. Calls
-     *        #fetchNodeDataFromFile for every child that passes the tests
+     *        #fetchNodeDataFromFile for every child that passes the tests. The
+     *        descendants are queued as separate requests via #requestFetch
+     * \param isCancellable whether the requests for the descendants can be cancelled
      */
-    void fetchChildrenNodes(OctreeNode& parentNode, int additionalLevelsToFetch);
+    void fetchChildrenNodes(OctreeNode& parentNode, int additionalLevelsToFetch,
+        bool isCancellable = true);
 
     /**
-     * Fetches data for specified node from file.
+     * Fetches data for specified node from file, if the data fits in the remaining RAM
+     * budget. Returns `true` if the node was loaded.
      * OBS! Only call if node file exists (i.e. node has any data, node->numStars > 0)
      * and is not already loaded.
      */
-    void fetchNodeDataFromFile(OctreeNode& node);
+    bool fetchNodeDataFromFile(OctreeNode& node);
+
+    /**
+     * Queues a request for the streaming threads to fetch the children of \p node. The
+     * requests are ordered by the distance from the node to the last known camera
+     * position so that the closest nodes are loaded first. A request for a node that is
+     * already queued is ignored unless it asks for more levels of descendants.
+     *
+     * \param node the node whose children should be fetched
+     * \param additionalLevelsToFetch see #fetchChildrenNodes
+     * \param isCancellable if `false` the request is kept even if the camera moves
+     */
+    void requestFetch(std::shared_ptr<OctreeNode> node, int additionalLevelsToFetch,
+        bool isCancellable);
+
+    /**
+     * Queues the removal of the nodes in \p nodesToRemove from RAM. Removals are
+     * processed before any fetch requests to free up the RAM budget.
+     */
+    void requestRemoval(std::vector<unsigned long long> nodesToRemove);
+
+    /**
+     * Starts the streaming threads if they are not running yet. Must be called while
+     * holding the _streamingMutex.
+     */
+    void startStreamingThreads();
+
+    /**
+     * Removes all queued fetch requests that are cancellable.
+     */
+    void cancelFetchRequests();
+
+    /**
+     * Removes all queued requests and waits until the requests that are currently being
+     * processed by the streaming threads have finished.
+     */
+    void waitForStreamingIdle();
+
+    /**
+     * The function that is executed by each of the streaming threads.
+     */
+    void streamingLoop();
+
+    /**
+     * Tries to reserve \p nBytes of the CPU RAM budget. Returns `false` without changing
+     * the budget if there is not enough RAM left.
+     */
+    bool reserveRam(long long nBytes);
 
     /**
     * Loops though all nodes in \p nodesToRemove and clears them from RAM. Also checks if
@@ -409,12 +470,35 @@ private:
     bool _useVBO = false;
     bool _streamOctree = false;
     bool _datasetFitInMemory = false;
-    long long _cpuRamBudget = 0;
+    std::atomic<long long> _cpuRamBudget = 0;
     long long _maxCpuRamBudget = 0;
     unsigned long long _parentNodeOfCamera = 8;
     std::filesystem::path _streamFolderPath;
     size_t _traversedBranchesInRenderCall = 0;
 
+    struct FetchRequest {
+        std::shared_ptr<OctreeNode> node;
+        int additionalLevelsToFetch = 0;
+        /// Squared distance to the camera at the time of the request
+        float distance = 0.f;
+        bool isCancellable = true;
+    };
+
+    // The streaming requests are processed by a fixed number of threads that are started
+    // on the first request. All members below are protected by _streamingMutex
+    std::vector<std::thread> _streamingThreads;
+    std::mutex _streamingMutex;
+    std::condition_variable _streamingCondition;
+    std::condition_variable _streamingIdleCondition;
+    /// Min-heap ordered by the distance to the camera
+    std::vector<FetchRequest> _fetchRequests;
+    /// The octreePositionIndex of all queued fetches mapped to their requested levels
+    std::map<unsigned long long, int> _queuedFetches;
+    std::deque<std::vector<unsigned long long>> _removalRequests;
+    int _nActiveRequests = 0;
+    bool _stopStreaming = false;
+    glm::vec3 _streamingCameraPos = glm::vec3(0.f);
+
 }; // class OctreeManager
 
 }  // namespace openspace
@@ -25,7 +25,8 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
-#include <list>
+#include <cstdint>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -34,12 +35,15 @@ namespace openspace::globebrowsing::cache {
 /**
  * Templated class implementing a Least-Recently-Used Cache. `KeyType` needs to be an
  * enumerable type.
+ *
+ * The items are stored in a pool of nodes that form an intrusive doubly-linked list, so
+ * bumping an item to the front of the queue only relinks two nodes and does not allocate
+ * any memory. Nodes of removed items are reused for later insertions.
  */
 template <typename KeyType, typename ValueType, typename HasherType>
 class LRUCache {
 public:
     using Item = std::pair<KeyType, ValueType>;
-    using Items = std::list<Item>;
 
     /**
      * \param size This is the maximum size of the cache given in number of cached items
@@ -73,13 +77,34 @@ public:
     size_t maximumCacheSize() const;
 
 private:
+    static constexpr uint32_t NoNode = UINT32_MAX;
+
+    struct Node {
+        std::optional<Item> item;
+        uint32_t prev = NoNode;
+        uint32_t next = NoNode;
+    };
+
     void putWithoutCleaning(KeyType key, ValueType value);
     void clean();
 
     std::vector<Item> cleanAndFetchPopped();
 
-    Items _itemList;
-    std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+    uint32_t allocateNode();
+    void link(uint32_t node);
+    void unlink(uint32_t node);
+    Item release(uint32_t node);
+
+    /// The pool of all nodes, including the ones that are currently unused
+    std::vector<Node> _nodes;
+    /// The list of node indices in _nodes that are currently unused
+    std::vector<uint32_t> _freeNodes;
+    /// The most recently used node
+    uint32_t _head = NoNode;
+    /// The least recently used node
+    uint32_t _tail = NoNode;
+
+    std::unordered_map<KeyType, uint32_t, HasherType> _itemMap;
 
     size_t _maximumCacheSize;
 };
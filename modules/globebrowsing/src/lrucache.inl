@@ -34,7 +34,10 @@ LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size)
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clear() {
-    _itemList.clear();
+    _nodes.clear();
+    _freeNodes.clear();
+    _head = NoNode;
+    _tail = NoNode;
     _itemMap.clear();
 }
 
@@ -54,7 +57,7 @@ LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueTy
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
-    return (_itemMap.count(key) > 0);
+    return _itemMap.contains(key);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -63,20 +66,9 @@ bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
 
     const auto it = _itemMap.find(key);
     if (it != _itemMap.end()) {
-        // @TODO (abock, 2020-08-14) Instead of removing the iterator from the previous
-        // position and then readding it at the front, it might make more sense to move
-        // them around?  That would prevent the dynamic memoray allocation that is
-        // happening here
-
-        // Found in cache
-        ValueType value = it->second->second;
-        // Remove from current position
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
         // Bump to front
-        _itemList.emplace_front(key, value);
-        _itemMap.emplace(key, _itemList.begin());
-
+        unlink(it->second);
+        link(it->second);
         return true;
     }
     else {
@@ -86,39 +78,36 @@ bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
-    return (_itemMap.size() == 0);
+    return _itemMap.empty();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 ValueType LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
     const auto it = _itemMap.find(key);
-    // Move list iterator pointing to value
-    _itemList.splice(_itemList.begin(), _itemList, it->second);
-    ValueType res = it->second->second;
-    return res;
+    ghoul_assert(it != _itemMap.end(), "Key must exist in the cache");
+
+    // Move the node to the front of the queue
+    unlink(it->second);
+    link(it->second);
+    return _nodes[it->second].item->second;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty");
+    ghoul_assert(_head != NoNode, "Cannot pop LRU cache. Ensure cache is not empty");
 
-    auto first_it = _itemList.begin();
-    _itemMap.erase(first_it->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.front();
-    _itemList.pop_front();
-    return toReturn;
+    const uint32_t node = _head;
+    _itemMap.erase(_nodes[node].item->first);
+    return release(node);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty");
+    ghoul_assert(_tail != NoNode, "Cannot pop LRU cache. Ensure cache is not empty");
 
-    auto lastIt = _itemList.end();
-    lastIt--;
-    _itemMap.erase(lastIt->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.back();
-    _itemList.pop_back();
-    return toReturn;
+    const uint32_t node = _tail;
+    _itemMap.erase(_nodes[node].item->first);
+    return release(node);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -137,20 +126,25 @@ void LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
 {
     const auto it = _itemMap.find(key);
     if (it != _itemMap.end()) {
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+        // Reuse the node of the existing item
+        unlink(it->second);
+        _nodes[it->second].item->second = std::move(value);
+        link(it->second);
+        return;
     }
-    _itemList.emplace_front(key, std::move(value));
-    _itemMap.emplace(std::move(key), _itemList.begin());
+
+    const uint32_t node = allocateNode();
+    _nodes[node].item.emplace(key, std::move(value));
+    link(node);
+    _itemMap.emplace(std::move(key), node);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clean() {
     while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        _itemList.pop_back();
+        const uint32_t node = _tail;
+        _itemMap.erase(_nodes[node].item->first);
+        release(node);
     }
 }
 
@@ -160,13 +154,68 @@ LRUCache<KeyType, ValueType, HasherType>::cleanAndFetchPopped()
 {
     std::vector<std::pair<KeyType, ValueType>> toReturn;
     while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        toReturn.push_back(_itemList.back());
-        _itemList.pop_back();
+        const uint32_t node = _tail;
+        _itemMap.erase(_nodes[node].item->first);
+        toReturn.push_back(release(node));
     }
     return toReturn;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+uint32_t LRUCache<KeyType, ValueType, HasherType>::allocateNode() {
+    if (!_freeNodes.empty()) {
+        const uint32_t node = _freeNodes.back();
+        _freeNodes.pop_back();
+        return node;
+    }
+    ghoul_assert(_nodes.size() < NoNode, "Too many items in the LRU cache");
+    _nodes.emplace_back();
+    return static_cast<uint32_t>(_nodes.size() - 1);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::link(uint32_t node) {
+    Node& n = _nodes[node];
+    n.prev = NoNode;
+    n.next = _head;
+    if (_head != NoNode) {
+        _nodes[_head].prev = node;
+    }
+    _head = node;
+    if (_tail == NoNode) {
+        _tail = node;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::unlink(uint32_t node) {
+    Node& n = _nodes[node];
+    if (n.prev != NoNode) {
+        _nodes[n.prev].next = n.next;
+    }
+    else {
+        _head = n.next;
+    }
+    if (n.next != NoNode) {
+        _nodes[n.next].prev = n.prev;
+    }
+    else {
+        _tail = n.prev;
+    }
+    n.prev = NoNode;
+    n.next = NoNode;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::release(
+                                                                            uint32_t node)
+{
+    unlink(node);
+    Node& n = _nodes[node];
+    Item item = std::move(*n.item);
+    n.item.reset();
+    _freeNodes.push_back(node);
+    return item;
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -260,6 +260,7 @@ void ImGUIModule::internalInitialize(const ghoul::Dictionary&) {
         global::navigationHandler,
         global::sessionRecording,
         global::timeManager,
+        global::scriptEngine,
         global::renderEngine,
         global::parallelPeer,
         global::luaConsole,
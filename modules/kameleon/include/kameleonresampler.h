@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_KAMELEON___KAMELEONRESAMPLER___H__
+#define __OPENSPACE_MODULE_KAMELEON___KAMELEONRESAMPLER___H__
+
+#include <ghoul/glm.h>
+#include <cstddef>
+
+namespace openspace::kameleon {
+
+struct ResamplingSettings {
+    /// The number of threads that sample the volume. If this is 0, the number of
+    /// hardware threads is used
+    unsigned int nThreads = 0;
+
+    /// The size of the bricks in which the volume is traversed. The z component is also
+    /// the thickness of the slabs that are handed out to the worker threads
+    glm::uvec3 brickSize = glm::uvec3(16);
+};
+
+/**
+ * Returns the number of workers that #resampleVolume will create for a volume of the
+ * provided \p dimensions. This is never larger than the number of z-slabs and always at
+ * least 1.
+ */
+size_t nResamplingWorkers(const glm::uvec3& dimensions,
+    const ResamplingSettings& settings = ResamplingSettings());
+
+/**
+ * Visits every voxel of a volume with the provided \p dimensions on multiple threads.
+ * The volume is cut into slabs along the z axis that the workers take turns to claim,
+ * and each slab is traversed brick by brick so that consecutive samples fall into the
+ * same or neighboring cells of the underlying model. Interpolators that remember the
+ * last cell they have found can therefore skip most of their cell searches.
+ *
+ * \param dimensions The number of voxels in each dimension
+ * \param createWorker Called with the index of the worker on the calling thread once
+ *        for each of the #nResamplingWorkers workers before any sampling starts. It has
+ *        to return a callable `void(const glm::uvec3& voxel, size_t index)` where
+ *        `index` is the linear index `x + y * dim.x + z * dim.x * dim.y` of the voxel.
+ *        Each returned callable is only ever invoked from one thread at a time, so it
+ *        may own state that is not thread-safe, such as a `ccmc::Interpolator` or a
+ *        partial histogram
+ * \param settings The number of threads and the brick size that are used
+ * \throw Rethrows the first exception that was thrown by any of the workers
+ */
+template <typename WorkerFactory>
+void resampleVolume(const glm::uvec3& dimensions, const WorkerFactory& createWorker,
+    const ResamplingSettings& settings = ResamplingSettings());
+
+} // namespace openspace::kameleon
+
+#include "kameleonresampler.inl"
+
+#endif // __OPENSPACE_MODULE_KAMELEON___KAMELEONRESAMPLER___H__
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <type_traits>
+#include <vector>
+
+namespace openspace::kameleon {
+
+template <typename WorkerFactory>
+void resampleVolume(const glm::uvec3& dimensions, const WorkerFactory& createWorker,
+                    const ResamplingSettings& settings)
+{
+    ZoneScoped;
+
+    ghoul_assert(
+        settings.brickSize.x > 0 && settings.brickSize.y > 0 && settings.brickSize.z > 0,
+        "Brick size must be positive"
+    );
+
+    const size_t nWorkers = nResamplingWorkers(dimensions, settings);
+    using Worker = std::invoke_result_t<const WorkerFactory&, size_t>;
+    std::vector<Worker> workers;
+    workers.reserve(nWorkers);
+    for (size_t i = 0; i < nWorkers; i++) {
+        workers.push_back(createWorker(i));
+    }
+
+    if (dimensions.x == 0 || dimensions.y == 0 || dimensions.z == 0) {
+        return;
+    }
+
+    const glm::uvec3 brick = settings.brickSize;
+    const unsigned int nSlabs = (dimensions.z + brick.z - 1) / brick.z;
+    const size_t sliceSize = static_cast<size_t>(dimensions.x) * dimensions.y;
+    std::atomic_uint nextSlab = 0;
+
+    auto run = [&](Worker& worker) {
+        for (unsigned int s = nextSlab++; s < nSlabs; s = nextSlab++) {
+            const unsigned int zBegin = s * brick.z;
+            const unsigned int zEnd = std::min(zBegin + brick.z, dimensions.z);
+            for (unsigned int by = 0; by < dimensions.y; by += brick.y) {
+                const unsigned int yEnd = std::min(by + brick.y, dimensions.y);
+                for (unsigned int bx = 0; bx < dimensions.x; bx += brick.x) {
+                    const unsigned int xEnd = std::min(bx + brick.x, dimensions.x);
+
+                    for (unsigned int z = zBegin; z < zEnd; z++) {
+                        for (unsigned int y = by; y < yEnd; y++) {
+                            size_t index = bx + y * dimensions.x + z * sliceSize;
+                            for (unsigned int x = bx; x < xEnd; x++) {
+                                worker(glm::uvec3(x, y, z), index);
+                                index++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    // The calling thread acts as the last worker
+    std::vector<std::future<void>> futures;
+    futures.reserve(nWorkers - 1);
+    for (size_t i = 0; i + 1 < nWorkers; i++) {
+        futures.push_back(std::async(std::launch::async, run, std::ref(workers[i])));
+    }
+    run(workers.back());
+    for (std::future<void>& future : futures) {
+        future.get();
+    }
+}
+
+} // namespace openspace::kameleon
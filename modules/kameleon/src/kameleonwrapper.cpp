@@ -24,6 +24,7 @@
 
 #include <modules/kameleon/include/kameleonwrapper.h>
 
+#include <modules/kameleon/include/kameleonresampler.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
@@ -32,6 +33,7 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/stringhelper.h>
 #include <filesystem>
+#include <memory>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -201,90 +203,105 @@ float* KameleonWrapper::uniformSampledValues(const std::string& var,
         return glm::clamp(izerotoone, 0, NBins - 1);
     };
 
-    // ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x + y * outDimensions.x +
-                                     z * outDimensions.x * outDimensions.y;
+    _model->loadVariable(var);
 
-                if (_gridType == GridType::Spherical) {
-                    // Put r in the [0..sqrt(3)] range
-                    const double rNorm = glm::root_three<double>() * x /
-                                         outDimensions.x - 1;
-
-                    // Put theta in the [0..PI] range
-                    const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
-
-                    // Put phi in the [0..2PI] range
-                    const double phiNorm = glm::two_pi<double>() * z /
-                                           outDimensions.z - 1;
-
-                    // Go to physical coordinates before sampling
-                    const double rPh = _min.x + rNorm * (_max.x - _min.x);
-                    const double thetaPh = thetaNorm;
-                    // phi range needs to be mapped to the slightly different model
-                    // range to avoid gaps in the data Subtract a small term to
-                    // avoid rounding errors when comparing to phiMax.
-                    const double phiPh = _min.z + phiNorm /
+    // Each worker samples with its own interpolator and fills its own histogram, which
+    // are summed up once all voxels have been sampled
+    const glm::uvec3 dimensions = glm::uvec3(outDimensions);
+    const size_t nWorkers = kameleon::nResamplingWorkers(dimensions);
+    std::vector<std::vector<int>> histograms(nWorkers, std::vector<int>(NBins, 0));
+
+    auto createWorker = [&](size_t worker) {
+        return [&, interpolator = std::unique_ptr<ccmc::Interpolator>(
+                       _model->createNewInterpolator()
+                   ), partial = histograms[worker].data()]
+            (const glm::uvec3& voxel, size_t index)
+        {
+            const size_t x = voxel.x;
+            const size_t y = voxel.y;
+            const size_t z = voxel.z;
+
+            if (_gridType == GridType::Spherical) {
+                // Put r in the [0..sqrt(3)] range
+                const double rNorm = glm::root_three<double>() * x / outDimensions.x - 1;
+
+                // Put theta in the [0..PI] range
+                const double thetaNorm = glm::pi<double>() * y / outDimensions.y - 1;
+
+                // Put phi in the [0..2PI] range
+                const double phiNorm = glm::two_pi<double>() * z / outDimensions.z - 1;
+
+                // Go to physical coordinates before sampling
+                const double rPh = _min.x + rNorm * (_max.x - _min.x);
+                const double thetaPh = thetaNorm;
+                // phi range needs to be mapped to the slightly different model
+                // range to avoid gaps in the data Subtract a small term to
+                // avoid rounding errors when comparing to phiMax.
+                const double phiPh = _min.z + phiNorm /
                                     glm::two_pi<double>() * (_max.z - _min.z - 0.000001);
 
-                    double value = 0.0;
-                    // See if sample point is inside domain
-                    if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
-                        thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
-                    {
-                        if (phiPh > _max.z) {
-                            LWARNING("Warning: There might be a gap in the data");
-                        }
-                        // Leave values at zero if outside domain
+                double value = 0.0;
+                // See if sample point is inside domain
+                if (rPh < _min.x || rPh > _max.x || thetaPh < _min.y ||
+                    thetaPh > _max.y || phiPh < _min.z || phiPh > _max.z)
+                {
+                    if (phiPh > _max.z) {
+                        LWARNING("Warning: There might be a gap in the data");
                     }
-                    else { // if inside
-                        // ENLIL CDF specific hacks!
-                        // Convert from meters to AU for interpolator
-                        const double localRPh = rPh / ccmc::constants::AU_in_meters;
-                        // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
-                        const double localThetaPh = -thetaPh * 180.f /
-                                                    glm::pi<double>() + 90.f;
-                        // Convert from [0, 2pi] rad to [0, 360] degrees
-                        const double localPhiPh = phiPh * 180.f / glm::pi<double>();
-                        // Sample
-                        value = _interpolator->interpolate(
-                            var,
-                            static_cast<float>(localRPh),
-                            static_cast<float>(localThetaPh),
-                            static_cast<float>(localPhiPh)
-                        );
-                    }
-
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
+                    // Leave values at zero if outside domain
                 }
-                else {
-                    // Assume cartesian for fallback purpose
-                    const double stepX = (_max.x - _min.x) /
-                                         (static_cast<double>(outDimensions.x));
-                    const double stepY = (_max.y - _min.y) /
-                                         (static_cast<double>(outDimensions.y));
-                    const double stepZ = (_max.z - _min.z) /
-                                         (static_cast<double>(outDimensions.z));
-
-                    const double xPos = _min.x + stepX * x;
-                    const double yPos = _min.y + stepY * y;
-                    const double zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    // swap yPos and zPos because model has Z as up
-                    double value = _interpolator->interpolate(
+                else { // if inside
+                    // ENLIL CDF specific hacks!
+                    // Convert from meters to AU for interpolator
+                    const double localRPh = rPh / ccmc::constants::AU_in_meters;
+                    // Convert from colatitude [0, pi] rad to latitude [-90, 90] deg
+                    const double localThetaPh = -thetaPh * 180.f /
+                                                glm::pi<double>() + 90.f;
+                    // Convert from [0, 2pi] rad to [0, 360] degrees
+                    const double localPhiPh = phiPh * 180.f / glm::pi<double>();
+                    // Sample
+                    value = interpolator->interpolate(
                         var,
-                        static_cast<float>(xPos),
-                        static_cast<float>(zPos),
-                        static_cast<float>(yPos)
+                        static_cast<float>(localRPh),
+                        static_cast<float>(localThetaPh),
+                        static_cast<float>(localPhiPh)
                     );
-                    doubleData[index] = value;
-                    histogram[mapToHistogram(value)]++;
                 }
+
+                doubleData[index] = value;
+                partial[mapToHistogram(value)]++;
+            }
+            else {
+                // Assume cartesian for fallback purpose
+                const double stepX = (_max.x - _min.x) /
+                                     (static_cast<double>(outDimensions.x));
+                const double stepY = (_max.y - _min.y) /
+                                     (static_cast<double>(outDimensions.y));
+                const double stepZ = (_max.z - _min.z) /
+                                     (static_cast<double>(outDimensions.z));
+
+                const double xPos = _min.x + stepX * x;
+                const double yPos = _min.y + stepY * y;
+                const double zPos = _min.z + stepZ * z;
+
+                // get interpolated data value for (xPos, yPos, zPos)
+                // swap yPos and zPos because model has Z as up
+                const double value = interpolator->interpolate(
+                    var,
+                    static_cast<float>(xPos),
+                    static_cast<float>(zPos),
+                    static_cast<float>(yPos)
+                );
+                doubleData[index] = value;
+                partial[mapToHistogram(value)]++;
             }
+        };
+    };
+    kameleon::resampleVolume(dimensions, createWorker);
+
+    for (const std::vector<int>& h : histograms) {
+        for (int i = 0; i < NBins; i++) {
+            histogram[i] += h[i];
         }
     }
 
@@ -484,42 +501,40 @@ float* KameleonWrapper::uniformSampledVectorValues(const std::string& xVar,
     //LDEBUG(zVar << "Min: " << varZMin);
     //LDEBUG(zVar << "Max: " << varZMax);
 
-    //ProgressBar pb(static_cast<int>(outDimensions.x));
-    for (size_t x = 0; x < outDimensions.x; ++x) {
-        //pb.print(x);
-        for (size_t y = 0; y < outDimensions.y; ++y) {
-            for (size_t z = 0; z < outDimensions.z; ++z) {
-                const size_t index = x * NumChannels + y * NumChannels * outDimensions.x +
-                                     z * NumChannels * outDimensions.x * outDimensions.y;
-
-                if (_gridType == GridType::Cartesian) {
-                    const float xPos = _min.x + stepX * x;
-                    const float yPos = _min.y + stepY * y;
-                    const float zPos = _min.z + stepZ * z;
-
-                    // get interpolated data value for (xPos, yPos, zPos)
-                    const float xVal = _interpolator->interpolate(xVar, xPos, yPos, zPos);
-                    const float yVal = _interpolator->interpolate(yVar, xPos, yPos, zPos);
-                    const float zVal = _interpolator->interpolate(zVar, xPos, yPos, zPos);
-
-                    // scale to [0,1]
-                    data[index]     = (xVal - varXMin) / (varXMax - varXMin); // R
-                    data[index + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
-                    data[index + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
-                    // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
-                    data[index + 3] = 1.f;
-                }
-                else {
-                    LERROR(
-                        "Only cartesian grid supported for "
-                        "uniformSampledVectorValues (for now)"
-                    );
-                    return data;
-                }
-            }
-        }
+    if (_gridType != GridType::Cartesian) {
+        LERROR("Only cartesian grid supported for uniformSampledVectorValues (for now)");
+        return data;
     }
 
+    _model->loadVariable(xVar);
+    _model->loadVariable(yVar);
+    _model->loadVariable(zVar);
+
+    auto createWorker = [&](size_t) {
+        return [&, interpolator = std::unique_ptr<ccmc::Interpolator>(
+                       _model->createNewInterpolator()
+                   )](const glm::uvec3& voxel, size_t index)
+        {
+            const float xPos = _min.x + stepX * voxel.x;
+            const float yPos = _min.y + stepY * voxel.y;
+            const float zPos = _min.z + stepZ * voxel.z;
+
+            // get interpolated data value for (xPos, yPos, zPos)
+            const float xVal = interpolator->interpolate(xVar, xPos, yPos, zPos);
+            const float yVal = interpolator->interpolate(yVar, xPos, yPos, zPos);
+            const float zVal = interpolator->interpolate(zVar, xPos, yPos, zPos);
+
+            // scale to [0,1]
+            const size_t i = index * NumChannels;
+            data[i]     = (xVal - varXMin) / (varXMax - varXMin); // R
+            data[i + 1] = (yVal - varYMin) / (varYMax - varYMin); // G
+            data[i + 2] = (zVal - varZMin) / (varZMax - varZMin); // B
+            // GL_RGB refuses to work. Workaround doing a GL_RGBA  hardcoded alpha
+            data[i + 3] = 1.f;
+        };
+    };
+    kameleon::resampleVolume(glm::uvec3(outDimensions), createWorker);
+
     return data;
 }
 
@@ -27,6 +27,7 @@
 #include <modules/kameleonvolume/rendering/renderablekameleonvolume.h>
 #include <modules/kameleonvolume/tasks/kameleonmetadatatojsontask.h>
 #include <modules/kameleonvolume/tasks/kameleondocumentationtask.h>
+#include <modules/kameleonvolume/tasks/kameleonresamplingbenchmarktask.h>
 #include <modules/kameleonvolume/tasks/kameleonvolumetorawtask.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/util/factorymanager.h>
@@ -50,12 +51,18 @@ void KameleonVolumeModule::internalInitialize(const ghoul::Dictionary&) {
     fTask->registerClass<KameleonMetadataToJsonTask>("KameleonMetadataToJsonTask");
     fTask->registerClass<KameleonDocumentationTask>("KameleonDocumentationTask");
     fTask->registerClass<KameleonVolumeToRawTask>("KameleonVolumeToRawTask");
+    fTask->registerClass<KameleonResamplingBenchmarkTask>(
+        "KameleonResamplingBenchmarkTask"
+    );
 }
 
 std::vector<documentation::Documentation> KameleonVolumeModule::documentations() const {
     using namespace kameleonvolume;
 
-    return { KameleonMetadataToJsonTask::documentation() };
+    return {
+        KameleonMetadataToJsonTask::documentation(),
+        KameleonResamplingBenchmarkTask::documentation()
+    };
 }
 
 } // namespace openspace
@@ -31,7 +31,10 @@
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/profiling.h>
 #include <filesystem>
+#include <limits>
+#include <vector>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -89,11 +92,6 @@ KameleonVolumeReader::KameleonVolumeReader(std::filesystem::path path)
             "Failed to open file '{}' with Kameleon", _path
         ));
     }
-
-    // Possibly use a kameleon interpolator instead of a model interpolator?
-    _interpolator = std::unique_ptr<ccmc::Interpolator>(
-        _kameleon->model->createNewInterpolator()
-    );
 }
 
 KameleonVolumeReader::~KameleonVolumeReader() {}
@@ -121,30 +119,54 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                               const glm::vec3& lowerBound,
                                                               const glm::vec3& upperBound,
                                                                           float& minValue,
-                                                                    float& maxValue) const
+                                                                          float& maxValue,
+                                       const kameleon::ResamplingSettings& settings) const
 {
-    minValue = std::numeric_limits<float>::max();
-    maxValue = -std::numeric_limits<float>::max();
+    ZoneScoped;
 
     auto volume = std::make_unique<volume::RawVolume<float>>(dimensions);
 
     const glm::vec3 dims = volume->dimensions();
     const glm::vec3 diff = upperBound - lowerBound;
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
-    };
+    // The variable has to be resident before the workers start interpolating it
+    _kameleon->loadVariable(variable);
+
+    // Every worker keeps track of the extent of the values it has sampled
+    const size_t nWorkers = kameleon::nResamplingWorkers(dimensions, settings);
+    std::vector<glm::vec2> ranges(
+        nWorkers,
+        glm::vec2(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max())
+    );
 
     float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); index++) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
-        const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+    auto createWorker = [&](size_t worker) {
+        return [&, interpolator = std::unique_ptr<ccmc::Interpolator>(
+                       _kameleon->model->createNewInterpolator()
+                   ), range = &ranges[worker]](const glm::uvec3& voxel, size_t index)
+        {
+            const glm::vec3 coordsZeroToOne = glm::vec3(voxel) / dims;
+            const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+
+            const float value = interpolator->interpolate(
+                variable,
+                volumeCoords.x,
+                volumeCoords.y,
+                volumeCoords.z
+            );
+            data[index] = value;
 
-        data[index] = interpolate(variable, volumeCoords);
+            range->x = glm::min(range->x, value);
+            range->y = glm::max(range->y, value);
+        };
+    };
+    kameleon::resampleVolume(dimensions, createWorker, settings);
 
-        minValue = glm::min(minValue, data[index]);
-        maxValue = glm::max(maxValue, data[index]);
+    minValue = std::numeric_limits<float>::max();
+    maxValue = -std::numeric_limits<float>::max();
+    for (const glm::vec2& range : ranges) {
+        minValue = glm::min(minValue, range.x);
+        maxValue = glm::max(maxValue, range.y);
     }
 
     return volume;
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMEREADER___H__
 #define __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMEREADER___H__
 
+#include <modules/kameleon/include/kameleonresampler.h>
 #include <ghoul/glm.h>
 #include <filesystem>
 #include <memory>
@@ -33,7 +34,6 @@
 
 namespace ccmc {
     class Attribute;
-    class Interpolator;
     class Kameleon;
 } // namespce ccmc
 
@@ -54,7 +54,7 @@ public:
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions, const std::string& variable,
         const glm::vec3& lowerBound, const glm::vec3& upperBound, float& minValue,
-        float& maxValue) const;
+        float& maxValue, const kameleon::ResamplingSettings& settings = {}) const;
 
     ghoul::Dictionary readMetaData() const;
 
@@ -78,7 +78,6 @@ private:
 
     std::filesystem::path _path;
     std::unique_ptr<ccmc::Kameleon> _kameleon;
-    std::unique_ptr<ccmc::Interpolator> _interpolator;
 };
 
 } // namespace openspace::kameleonvolume
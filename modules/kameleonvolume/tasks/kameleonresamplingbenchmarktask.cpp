@@ -0,0 +1,168 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/kameleonvolume/tasks/kameleonresamplingbenchmarktask.h>
+
+#include <modules/kameleonvolume/kameleonvolumereader.h>
+#include <modules/volume/rawvolume.h>
+#include <openspace/documentation/verifier.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <thread>
+
+namespace {
+    constexpr std::string_view _loggerCat = "KameleonResamplingBenchmarkTask";
+
+    // This task resamples a variable of a CDF file into a uniform volume, in the same
+    // way as the KameleonVolumeToRawTask does, once for each of the provided thread
+    // counts and reports the number of voxels per second that were sampled. Nothing is
+    // written to disk
+    struct [[codegen::Dictionary(KameleonResamplingBenchmarkTask)]] Parameters {
+        // The cdf file to extract data from
+        std::filesystem::path input;
+
+        // The variable name to read from the kameleon dataset
+        std::string variable [[codegen::annotation("A valid kameleon variable")]];
+
+        // A vector representing the number of cells in each dimension
+        glm::ivec3 dimensions;
+
+        // The numbers of threads that the resampling is benchmarked with. If this value
+        // is not specified, a single thread and all hardware threads are used
+        std::optional<std::vector<int>> threads;
+
+        // The number of times the volume is resampled for each thread count. The fastest
+        // of these is reported
+        std::optional<int> repetitions [[codegen::greater(0)]];
+    };
+#include "kameleonresamplingbenchmarktask_codegen.cpp"
+} // namespace
+
+namespace openspace::kameleonvolume {
+
+documentation::Documentation KameleonResamplingBenchmarkTask::documentation() {
+    return codegen::doc<Parameters>("kameleon_resampling_benchmark_task");
+}
+
+KameleonResamplingBenchmarkTask::KameleonResamplingBenchmarkTask(
+                                                     const ghoul::Dictionary& dictionary)
+{
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+
+    _inputPath = p.input;
+    _variable = p.variable;
+    _dimensions = p.dimensions;
+
+    const std::vector<int> threads = p.threads.value_or(std::vector<int>{
+        1,
+        static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u))
+    });
+    for (int t : threads) {
+        if (t <= 0) {
+            LWARNING(std::format("Skipping invalid thread count {}", t));
+            continue;
+        }
+        _nThreads.push_back(static_cast<unsigned int>(t));
+    }
+
+    _nRepetitions = p.repetitions.value_or(_nRepetitions);
+}
+
+std::string KameleonResamplingBenchmarkTask::description() {
+    return std::format(
+        "Resample variable '{}' of CDF file '{}' into a {}x{}x{} volume {} times with "
+        "each of {} thread counts and report the sampling throughput",
+        _variable, _inputPath, _dimensions.x, _dimensions.y, _dimensions.z,
+        _nRepetitions, _nThreads.size()
+    );
+}
+
+void KameleonResamplingBenchmarkTask::perform(
+                                           const Task::ProgressCallback& progressCallback)
+{
+    progressCallback(0.f);
+
+    KameleonVolumeReader reader = KameleonVolumeReader(_inputPath);
+
+    const std::array<std::string, 3> variables = reader.gridVariableNames();
+    const glm::vec3 lowerBound = glm::vec3(
+        reader.minValue(variables[0]),
+        reader.minValue(variables[1]),
+        reader.minValue(variables[2])
+    );
+    const glm::vec3 upperBound = glm::vec3(
+        reader.maxValue(variables[0]),
+        reader.maxValue(variables[1]),
+        reader.maxValue(variables[2])
+    );
+
+    const double nVoxels = static_cast<double>(_dimensions.x) * _dimensions.y *
+                           _dimensions.z;
+    double referenceSeconds = 0.0;
+    for (size_t i = 0; i < _nThreads.size(); i++) {
+        const kameleon::ResamplingSettings settings = { .nThreads = _nThreads[i] };
+
+        double bestSeconds = std::numeric_limits<double>::max();
+        for (int j = 0; j < _nRepetitions; j++) {
+            float minValue = 0.f;
+            float maxValue = 0.f;
+            const auto t0 = std::chrono::high_resolution_clock::now();
+            reader.readFloatVolume(
+                _dimensions,
+                _variable,
+                lowerBound,
+                upperBound,
+                minValue,
+                maxValue,
+                settings
+            );
+            const auto t1 = std::chrono::high_resolution_clock::now();
+
+            const double seconds = std::chrono::duration<double>(t1 - t0).count();
+            bestSeconds = std::min(bestSeconds, seconds);
+        }
+
+        if (i == 0) {
+            referenceSeconds = bestSeconds;
+        }
+        LINFO(std::format(
+            "{} threads: {:.3f} s ({:.0f} voxels/s, {:.2f}x)",
+            _nThreads[i], bestSeconds, nVoxels / bestSeconds,
+            referenceSeconds / bestSeconds
+        ));
+
+        progressCallback(
+            static_cast<float>(i + 1) / static_cast<float>(_nThreads.size())
+        );
+    }
+
+    progressCallback(1.f);
+}
+
+} // namespace openspace::kameleonvolume
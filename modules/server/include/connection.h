@@ -27,16 +27,15 @@
 
 #include <ghoul/misc/templatefactory.h>
 #include <openspace/json.h>
+#include <chrono>
 #include <memory>
 #include <string>
-#include <thread>
-
-namespace ghoul::io { class Socket; }
 
 namespace openspace {
 
 using TopicId = size_t;
 
+class ReactorSocket;
 class Topic;
 
 // @TODO (abock, 2022-05-06) This is not really elegant as there is no need for a
@@ -51,7 +50,15 @@ class Topic;
 // message doesn't go anywhere since noone is listening, but it's better than a crash.
 class Connection : public std::enable_shared_from_this<Connection> {
 public:
-    Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address,
+    /// The encodings in which messages can be sent to the client. Messages that are sent
+    /// by the client are always JSON
+    enum class Encoding {
+        Json = 0,
+        MessagePack,
+        Cbor
+    };
+
+    Connection(std::shared_ptr<ReactorSocket> s, std::string address,
         bool authorized = false, const std::string& password = "");
 
     void handleMessage(const std::string& message);
@@ -59,21 +66,37 @@ public:
     void handleJson(const nlohmann::json& json);
     void sendJson(const nlohmann::json& json);
     void setAuthorized(bool status);
+    void setEncoding(Encoding encoding);
 
     bool isAuthorized() const;
+    Encoding encoding() const;
 
-    ghoul::io::Socket* socket();
-    std::thread& thread();
-    void setThread(std::thread&& thread);
+    ReactorSocket* socket();
+
+    /**
+     * Serializes the \p json using the provided \p encoding.
+     *
+     * \param json The message that should be serialized
+     * \param encoding The encoding that is used
+     * \param result The string that will contain the serialized message. It is cleared
+     *        before the message is written, but its memory is reused
+     */
+    static void encode(const nlohmann::json& json, Encoding encoding,
+        std::string& result);
 
 private:
+    void putMessage(std::string_view message, bool isBinary);
+
     ghoul::TemplateFactory<Topic> _topicFactory;
     std::map<TopicId, std::unique_ptr<Topic>> _topics;
-    std::unique_ptr<ghoul::io::Socket> _socket;
-    std::thread _thread;
+    std::shared_ptr<ReactorSocket> _socket;
 
     std::string _address;
     bool _isAuthorized = false;
+    Encoding _encoding = Encoding::Json;
+    std::string _encodeBuffer;
+    // Whether the last message could not be sent because the client is too slow
+    bool _isDroppingMessages = false;
     std::map<TopicId, std::string> _messageQueue;
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
 };
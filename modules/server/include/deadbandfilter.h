@@ -0,0 +1,69 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___DEADBANDFILTER___H__
+#define __OPENSPACE_MODULE_SERVER___DEADBANDFILTER___H__
+
+#include <openspace/json.h>
+
+namespace openspace {
+
+/**
+ * Decides which values of a subscribed property are sent to a client. A value is only
+ * sent if it differs from the value that was sent last, and for numbers and lists of
+ * numbers, if at least one component differs by more than the deadband. A value that is
+ * suppressed by the deadband is kept as the trailing value, which has to be sent once the
+ * property stopped changing so that the client always ends up with the final value.
+ */
+class DeadbandFilter {
+public:
+    /**
+     * Passes a new \p value of the property through the filter.
+     *
+     * \param value The current value of the property
+     * \param deadband The amount by which a number has to change to be sent. A deadband
+     *        of 0 sends every value that differs from the last sent value
+     * \return `true` if the \p value should be sent to the client
+     */
+    bool update(const nlohmann::json& value, double deadband);
+
+    /**
+     * Returns `true` if a value was suppressed by the deadband and has not been sent.
+     */
+    bool hasTrailingValue() const;
+
+    /**
+     * Returns the value that was suppressed last and marks it as sent. Must only be
+     * called if #hasTrailingValue returns `true`.
+     */
+    nlohmann::json takeTrailingValue();
+
+private:
+    nlohmann::json _lastSentValue;
+    nlohmann::json _trailingValue;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___DEADBANDFILTER___H__
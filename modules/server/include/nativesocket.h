@@ -0,0 +1,142 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___NATIVESOCKET___H__
+#define __OPENSPACE_MODULE_SERVER___NATIVESOCKET___H__
+
+// This file wraps the differences between the BSD socket API and Winsock that are
+// relevant for the Reactor. As it includes the platform's socket headers, it should only
+// be included from source files
+
+#ifdef WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else // ^^^ WIN32 / !WIN32 vvv
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif // WIN32
+
+#include <string>
+
+namespace openspace::nativesocket {
+
+#ifdef WIN32
+using Handle = SOCKET;
+constexpr Handle InvalidHandle = INVALID_SOCKET;
+#else // ^^^ WIN32 / !WIN32 vvv
+using Handle = int;
+constexpr Handle InvalidHandle = -1;
+#endif // WIN32
+
+#ifdef __linux__
+// Prevents a SIGPIPE from terminating the application when writing to a closed socket
+constexpr int SendFlags = MSG_NOSIGNAL;
+#else // ^^^ __linux__ / !__linux__ vvv
+constexpr int SendFlags = 0;
+#endif // __linux__
+
+/**
+ * Initializes the socket library. Every call has to be matched by a call to
+ * #deinitialize.
+ */
+inline void initialize() {
+#ifdef WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif // WIN32
+}
+
+inline void deinitialize() {
+#ifdef WIN32
+    WSACleanup();
+#endif // WIN32
+}
+
+inline void close(Handle handle) {
+#ifdef WIN32
+    closesocket(handle);
+#else // ^^^ WIN32 / !WIN32 vvv
+    ::close(handle);
+#endif // WIN32
+}
+
+/**
+ * Configures a newly created socket: makes it non-blocking if \p isNonBlocking is `true`,
+ * disables Nagle's algorithm so that small messages are sent immediately, and disables
+ * the SIGPIPE signal on platforms that support it per socket.
+ */
+inline bool configure(Handle handle, bool isNonBlocking) {
+#ifdef WIN32
+    u_long mode = isNonBlocking ? 1 : 0;
+    if (ioctlsocket(handle, FIONBIO, &mode) != 0) {
+        return false;
+    }
+#else // ^^^ WIN32 / !WIN32 vvv
+    const int flags = fcntl(handle, F_GETFL, 0);
+    const int newFlags = isNonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (flags < 0 || fcntl(handle, F_SETFL, newFlags) != 0) {
+        return false;
+    }
+#endif // WIN32
+
+    int one = 1;
+    setsockopt(
+        handle,
+        IPPROTO_TCP,
+        TCP_NODELAY,
+        reinterpret_cast<const char*>(&one),
+        sizeof(one)
+    );
+#ifdef SO_NOSIGPIPE
+    setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif // SO_NOSIGPIPE
+    return true;
+}
+
+/**
+ * Returns `true` if the last failed socket operation failed only because it would have
+ * blocked.
+ */
+inline bool wouldBlock() {
+#ifdef WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else // ^^^ WIN32 / !WIN32 vvv
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif // WIN32
+}
+
+inline std::string address(const sockaddr_in& addr) {
+    char buffer[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &addr.sin_addr, buffer, sizeof(buffer));
+    return buffer;
+}
+
+} // namespace openspace::nativesocket
+
+#endif // __OPENSPACE_MODULE_SERVER___NATIVESOCKET___H__
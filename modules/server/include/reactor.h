@@ -0,0 +1,286 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___REACTOR___H__
+#define __OPENSPACE_MODULE_SERVER___REACTOR___H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+class Reactor;
+
+#ifdef WIN32
+using SocketHandle = uintptr_t;
+#else // ^^^ WIN32 / !WIN32 vvv
+using SocketHandle = int;
+#endif // WIN32
+
+/**
+ * A client connection that is served by a Reactor. Received messages are buffered until
+ * they are retrieved with #nextMessage and messages passed to #putMessage are queued
+ * until the Reactor's I/O thread can write them to the network. All public functions
+ * are thread-safe.
+ */
+class ReactorSocket : public std::enable_shared_from_this<ReactorSocket> {
+public:
+    enum class Protocol {
+        /// Messages are terminated by a newline character
+        Tcp,
+        /// Messages are sent as WebSocket text frames after an HTTP upgrade handshake
+        WebSocket
+    };
+
+    ReactorSocket(const ReactorSocket&) = delete;
+    ReactorSocket& operator=(const ReactorSocket&) = delete;
+
+    const std::string& address() const;
+    Protocol protocol() const;
+    bool isConnected() const;
+
+    /**
+     * Retrieves the oldest message that has been received on this socket and not been
+     * retrieved yet. Messages that were received before the socket was disconnected can
+     * still be retrieved afterwards.
+     *
+     * \param message The string that will contain the message
+     * \return `true` if a message was retrieved, `false` if no message was available
+     */
+    bool nextMessage(std::string& message);
+
+    enum class MessageType {
+        Text,
+        /// Binary messages are sent as WebSocket binary frames. On TCP connections they
+        /// are prefixed with their size as a 32-bit big-endian integer instead of being
+        /// terminated by a newline character
+        Binary
+    };
+
+    /**
+     * Queues the \p message to be sent to the client. If the socket's send queue does
+     * not have room for the message, because the client does not read its messages fast
+     * enough, the message is dropped.
+     *
+     * \param message The message that should be sent
+     * \param type The type of the message, which determines how it is framed
+     * \return `true` if the message was queued, `false` if it was dropped
+     */
+    bool putMessage(std::string_view message, MessageType type = MessageType::Text);
+
+    /**
+     * Returns the number of bytes that are queued to be sent.
+     */
+    size_t queuedBytes() const;
+
+    /**
+     * Returns whether more than half of the send queue's capacity is used. Producers of
+     * frequent updates should skip or coalesce their messages while this is the case
+     * rather than relying on #putMessage to drop them.
+     */
+    bool isCongested() const;
+
+    /**
+     * Closes the connection. Messages that have not been sent yet are discarded.
+     */
+    void disconnect();
+
+private:
+    friend class Reactor;
+
+    ReactorSocket(Reactor* reactor, SocketHandle handle, std::string address,
+        Protocol protocol, int listener);
+
+    const SocketHandle _handle;
+    const std::string _address;
+    const Protocol _protocol;
+    const int _listener;
+
+    // These members are shared between the I/O thread and the users of the socket
+    mutable std::mutex _mutex;
+    Reactor* _reactor = nullptr;
+    bool _isConnected = true;
+    bool _isReadPaused = false;
+    std::deque<std::string> _inbox;
+    std::string _sendBuffer;
+    size_t _sendOffset = 0;
+
+    // These members are only accessed by the I/O thread
+    std::string _readBuffer;
+    std::string _fragmentedMessage;
+    bool _hasCompletedHandshake = false;
+    bool _isReading = true;
+    bool _isWriting = false;
+    bool _shouldCloseAfterFlush = false;
+};
+
+/**
+ * An event-driven network server that serves all connections of all its listening ports
+ * from a single I/O thread. On Linux, the thread waits for socket events using `epoll`,
+ * on other platforms using `poll`.
+ *
+ * Each connection has a bounded send queue. If a client reads its messages too slowly,
+ * the queue fills up and further messages to it are dropped instead of letting the
+ * memory usage grow without bounds. In the other direction, the Reactor stops reading
+ * from a connection whose received messages are not retrieved quickly enough, which lets
+ * TCP's flow control slow down the client.
+ */
+class Reactor {
+public:
+    using ListenerId = int;
+
+    /**
+     * Creates a Reactor and starts its I/O thread.
+     *
+     * \param maxSendQueueSize The maximum number of bytes that can be queued for sending
+     *        on each connection
+     * \param maxInboxSize The number of received messages on a connection after which
+     *        the Reactor stops reading from it until some messages have been retrieved
+     */
+    explicit Reactor(size_t maxSendQueueSize = 16 * 1024 * 1024,
+        size_t maxInboxSize = 1024);
+
+    /**
+     * Stops the I/O thread and closes all connections and listening ports.
+     */
+    ~Reactor();
+
+    /**
+     * Starts listening for new connections on the provided \p port.
+     *
+     * \param port The port on which to listen. If it is 0, a free port is chosen
+     * \param protocol The protocol that is spoken by connections on this port
+     * \return The identifier of the listener
+     *
+     * \throw ghoul::RuntimeError If the port could not be opened
+     */
+    ListenerId listen(int port, ReactorSocket::Protocol protocol);
+
+    /**
+     * Stops listening on the port of the \p listener. Connections that have already been
+     * retrieved through #nextPendingSocket are not affected. When this function returns,
+     * the port is available again.
+     */
+    void close(ListenerId listener);
+
+    /**
+     * Returns whether the \p listener is open.
+     */
+    bool isListening(ListenerId listener) const;
+
+    /**
+     * Returns the port on which the \p listener accepts connections, or 0 if the listener
+     * does not exist.
+     */
+    int port(ListenerId listener) const;
+
+    /**
+     * Returns the next connection that has been accepted on the \p listener or `nullptr`
+     * if no new connection is available. For WebSocket listeners, connections are only
+     * returned after they have completed the handshake.
+     */
+    std::shared_ptr<ReactorSocket> nextPendingSocket(ListenerId listener);
+
+private:
+    friend class ReactorSocket;
+
+    struct Event {
+        SocketHandle handle;
+        bool isReadable = false;
+        bool isWritable = false;
+        bool hasError = false;
+    };
+
+    struct Listener {
+        SocketHandle handle;
+        ReactorSocket::Protocol protocol;
+        int port = 0;
+        std::deque<std::shared_ptr<ReactorSocket>> pendingSockets;
+    };
+
+    // Functions that are called by the sockets from any thread
+    void requestFlush(std::weak_ptr<ReactorSocket> socket);
+    void requestResume(std::weak_ptr<ReactorSocket> socket);
+    void requestClose(std::weak_ptr<ReactorSocket> socket);
+    void wake();
+
+    // Functions that are only called on the I/O thread
+    void run();
+    void waitForEvents(std::vector<Event>& events);
+    void drainWake();
+    void processRequests();
+    void accept(ListenerId id);
+    void read(const std::shared_ptr<ReactorSocket>& socket);
+    bool processTcp(ReactorSocket& socket, size_t searchOffset);
+    bool processWebSocket(ReactorSocket& socket);
+    bool processHandshake(ReactorSocket& socket);
+    void deliver(ReactorSocket& socket, std::string message);
+    void flush(const std::shared_ptr<ReactorSocket>& socket);
+    void updateInterest(const ReactorSocket& socket, bool isNew = false);
+    bool isRegistered(const std::shared_ptr<ReactorSocket>& socket) const;
+    void closeSocket(const std::shared_ptr<ReactorSocket>& socket);
+
+    const size_t _maxSendQueueSize;
+    const size_t _maxInboxSize;
+
+    std::thread _thread;
+    std::atomic_bool _shouldStop = false;
+
+    // The handles used to wake up the I/O thread. On Linux, this is a single eventfd,
+    // on other platforms a pair of connected sockets
+    SocketHandle _wakeRead;
+    SocketHandle _wakeWrite;
+    std::atomic_bool _isWakePending = false;
+
+#ifdef __linux__
+    int _epoll = -1;
+#endif // __linux__
+
+    // Protects the listeners and the request lists
+    mutable std::mutex _mutex;
+    std::map<ListenerId, Listener> _listeners;
+    ListenerId _nextListenerId = 0;
+    std::vector<SocketHandle> _closingListeners;
+    std::condition_variable _listenerClosed;
+    std::vector<std::weak_ptr<ReactorSocket>> _flushRequests;
+    std::vector<std::weak_ptr<ReactorSocket>> _resumeRequests;
+    std::vector<std::weak_ptr<ReactorSocket>> _closeRequests;
+
+    // The connected sockets, only accessed by the I/O thread
+    std::unordered_map<SocketHandle, std::shared_ptr<ReactorSocket>> _sockets;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___REACTOR___H__
@@ -25,23 +25,23 @@
 #ifndef __OPENSPACE_MODULE_SERVER___SERVERINTERFACE___H__
 #define __OPENSPACE_MODULE_SERVER___SERVERINTERFACE___H__
 
+#include <modules/server/include/reactor.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/list/stringlistproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
-
-namespace ghoul::io { class SocketServer; }
+#include <optional>
 
 namespace openspace {
 
 class ServerInterface : public properties::PropertyOwner {
 public:
     static std::unique_ptr<ServerInterface> createFromDictionary(
-        const ghoul::Dictionary& dictionary);
+        const ghoul::Dictionary& dictionary, Reactor& reactor);
 
-    ServerInterface(const ghoul::Dictionary& dictionary);
+    ServerInterface(const ghoul::Dictionary& dictionary, Reactor& reactor);
     virtual ~ServerInterface() override = default;
 
     void initialize();
@@ -53,7 +53,11 @@ public:
     bool clientHasAccessWithoutPassword(const std::string& address) const;
     bool clientIsBlocked(const std::string& address) const;
 
-    ghoul::io::SocketServer* server();
+    /**
+     * Returns the next connection that has been made to this interface or `nullptr` if
+     * there is no new connection.
+     */
+    std::shared_ptr<ReactorSocket> nextPendingSocket();
 
 private:
     enum class InterfaceType : int {
@@ -76,7 +80,8 @@ private:
     properties::OptionProperty _defaultAccess;
     properties::StringProperty _password;
 
-    std::unique_ptr<ghoul::io::SocketServer> _socketServer;
+    Reactor& _reactor;
+    std::optional<Reactor::ListenerId> _listener;
 };
 
 } // namespace openspace
@@ -27,10 +27,25 @@
 
 #include <modules/server/include/topics/topic.h>
 
+#include <modules/server/include/deadbandfilter.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace openspace::properties { class Property; }
 
 namespace openspace {
 
+/**
+ * Sends the values of one or more properties to the client whenever they change. If the
+ * client requests a maximum rate, changes are coalesced so that only the latest value of
+ * a property is sent at that rate, otherwise every change is sent immediately. If the
+ * client subscribes to a list of properties, the changed values of all of them are sent
+ * in a single message.
+ */
 class SubscriptionTopic : public Topic {
 public:
     SubscriptionTopic() = default;
@@ -40,15 +55,44 @@ public:
     bool isDone() const override;
 
 private:
-    void resetCallbacks();
+    static constexpr int UnsetCallbackHandle = -1;
+
+    struct Subscription {
+        std::string uri;
+        properties::Property* property = nullptr;
+        int onChangeHandle = UnsetCallbackHandle;
+        int onDeleteHandle = UnsetCallbackHandle;
+        bool isDirty = true;
+        DeadbandFilter filter;
+
+        /// The parsed JSON description of the property, which is only regenerated when
+        /// the property reports a new Property::jsonDescriptionVersion
+        nlohmann::json description;
+        std::optional<uint64_t> descriptionVersion;
+    };
+
+    /**
+     * Creates the same payload as the conversion of a property to JSON, but uses the
+     * \p value that has already been parsed and the cached description of the
+     * \p subscription instead of serializing the property again.
+     */
+    static nlohmann::json propertyPayload(Subscription& subscription,
+        nlohmann::json value);
 
-    const int UnsetCallbackHandle = -1;
+    void subscribe(const std::string& uri);
+    void unsubscribe(Subscription& subscription);
+    void flush(bool ignoreRateLimit);
 
-    bool _requestedResourceIsSubscribable = false;
-    bool _isSubscribedTo = false;
-    int _onChangeHandle = UnsetCallbackHandle;
-    int _onDeleteHandle = UnsetCallbackHandle;
-    properties::Property* _prop = nullptr;
+    // The subscriptions are stored as pointers as they are referenced by the callbacks
+    std::vector<std::unique_ptr<Subscription>> _subscriptions;
+    bool _isBatch = false;
+    // Changes are only coalesced if the client requested a maximum rate
+    bool _isThrottled = false;
+    std::chrono::steady_clock::duration _minUpdateInterval =
+        std::chrono::steady_clock::duration(0);
+    double _deadband = 0.0;
+    std::chrono::steady_clock::time_point _lastUpdateTime;
+    int _preSyncHandle = UnsetCallbackHandle;
 };
 
 } // namespace openspace
@@ -28,14 +28,15 @@
 #include <modules/server/include/serverinterface.h>
 #include <modules/server/include/connection.h>
 #include <modules/server/include/topics/topic.h>
+#include <modules/server/tasks/benchmarkserverencodingtask.h>
+#include <modules/server/tasks/serverloadtesttask.h>
+#include <openspace/documentation/documentation.h>
 #include <openspace/engine/globalscallbacks.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/format.h>
-#include <ghoul/io/socket/socket.h>
-#include <ghoul/io/socket/tcpsocketserver.h>
-#include <ghoul/io/socket/websocket.h>
-#include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/misc/templatefactory.h>
@@ -64,7 +65,6 @@ ServerModule::ServerModule()
 
 ServerModule::~ServerModule() {
     disconnectAll();
-    cleanUpFinishedThreads();
 }
 
 ServerInterface* ServerModule::serverInterfaceByIdentifier(const std::string& identifier)
@@ -87,6 +87,11 @@ int ServerModule::skyBrowserUpdateTime() const {
 }
 
 void ServerModule::internalInitialize(const ghoul::Dictionary& configuration) {
+    ghoul::TemplateFactory<Task>* fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "Task factory was not created");
+    fTask->registerClass<BenchmarkServerEncodingTask>("BenchmarkServerEncodingTask");
+    fTask->registerClass<ServerLoadTestTask>("ServerLoadTestTask");
+
     global::callback::preSync->emplace_back([this]() {
         ZoneScopedN("ServerModule");
 
@@ -112,7 +117,7 @@ void ServerModule::internalInitialize(const ghoul::Dictionary& configuration) {
         );
 
         std::unique_ptr<ServerInterface> serverInterface =
-            ServerInterface::createFromDictionary(interfaceDictionary);
+            ServerInterface::createFromDictionary(interfaceDictionary, _reactor);
 
         serverInterface->initialize();
 
@@ -136,29 +141,20 @@ void ServerModule::preSync() {
             continue;
         }
 
-        ghoul::io::SocketServer* socketServer = serverInterface->server();
-
-        if (!socketServer) {
-            continue;
-        }
-
-        std::unique_ptr<ghoul::io::Socket> socket;
-        while ((socket = socketServer->nextPendingSocket())) {
+        std::shared_ptr<ReactorSocket> socket;
+        while ((socket = serverInterface->nextPendingSocket())) {
             const std::string address = socket->address();
             if (serverInterface->clientIsBlocked(address)) {
                 // Drop connection if the address is blocked.
+                socket->disconnect();
                 continue;
             }
-            socket->startStreams();
             auto connection = std::make_shared<Connection>(
                 std::move(socket),
                 address,
                 false,
                 serverInterface->password()
             );
-            connection->setThread(std::thread(
-                [this, connection] () { handleConnection(connection); }
-            ));
             if (serverInterface->clientHasAccessWithoutPassword(address)) {
                 connection->setAuthorized(true);
             }
@@ -166,23 +162,19 @@ void ServerModule::preSync() {
         }
     }
 
-    // Consume all messages put into the message queue by the socket threads.
+    // Consume all messages that have been received by the reactor since the last frame
     consumeMessages();
 
-    // Join threads for sockets that disconnected.
-    cleanUpFinishedThreads();
+    removeDisconnectedConnections();
 }
 
-void ServerModule::cleanUpFinishedThreads() {
+void ServerModule::removeDisconnectedConnections() {
     ZoneScoped;
 
     for (ConnectionData& connectionData : _connections) {
         Connection& connection = *connectionData.connection;
         if (!connection.socket() || !connection.socket()->isConnected()) {
-            if (connection.thread().joinable()) {
-                connection.thread().join();
-                connectionData.isMarkedForRemoval = true;
-            }
+            connectionData.isMarkedForRemoval = true;
         }
     }
     _connections.erase(std::remove_if(
@@ -203,35 +195,25 @@ void ServerModule::disconnectAll() {
 
     for (const ConnectionData& connectionData : _connections) {
         Connection& connection = *connectionData.connection;
-        if (connection.socket() && connection.socket()->isConnected()) {
-            connection.socket()->disconnect(
-                static_cast<int>(ghoul::io::WebSocket::ClosingReason::ClosingAll)
-            );
+        if (connection.socket()) {
+            connection.socket()->disconnect();
         }
     }
-}
-
-void ServerModule::handleConnection(const std::shared_ptr<Connection>& connection) {
-    ZoneScoped;
-
-    std::string messageString;
-    messageString.reserve(256);
-    while (connection->socket()->getMessage(messageString)) {
-        const std::lock_guard lock(_messageQueueMutex);
-        _messageQueue.push_back({ connection, messageString });
-    }
+    _connections.clear();
 }
 
 void ServerModule::consumeMessages() {
     ZoneScoped;
 
-    const std::lock_guard lock(_messageQueueMutex);
-    while (!_messageQueue.empty()) {
-        const Message& m = _messageQueue.front();
-        if (const std::shared_ptr<Connection>& c = m.connection.lock()) {
-            c->handleMessage(m.messageString);
+    std::string message;
+    message.reserve(256);
+    for (const ConnectionData& connectionData : _connections) {
+        // Hold on to the connection as handling a message might disconnect it
+        const std::shared_ptr<Connection> connection = connectionData.connection;
+        ReactorSocket* socket = connection->socket();
+        while (socket && socket->nextMessage(message)) {
+            connection->handleMessage(message);
         }
-        _messageQueue.pop_front();
     }
 }
 
@@ -258,4 +240,11 @@ void ServerModule::removePreSyncCallback(CallbackHandle handle) {
     _preSyncCallbacks.erase(it);
 }
 
+std::vector<documentation::Documentation> ServerModule::documentations() const {
+    return {
+        BenchmarkServerEncodingTask::Documentation(),
+        ServerLoadTestTask::Documentation()
+    };
+}
+
 } // namespace openspace
@@ -27,25 +27,19 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <modules/server/include/reactor.h>
 #include <modules/server/include/serverinterface.h>
 
-#include <deque>
 #include <memory>
-#include <mutex>
 
 namespace openspace {
 
 constexpr int SOCKET_API_VERSION_MAJOR = 0;
-constexpr int SOCKET_API_VERSION_MINOR = 1;
+constexpr int SOCKET_API_VERSION_MINOR = 2;
 constexpr int SOCKET_API_VERSION_PATCH = 0;
 
 class Connection;
 
-struct Message {
-    std::weak_ptr<Connection> connection;
-    std::string messageString;
-};
-
 class ServerModule : public OpenSpaceModule {
 public:
     static constexpr const char* Name = "Server";
@@ -62,6 +56,8 @@ public:
     CallbackHandle addPreSyncCallback(CallbackFunction cb);
     void removePreSyncCallback(CallbackHandle handle);
 
+    std::vector<documentation::Documentation> documentations() const override;
+
 protected:
     void internalInitialize(const ghoul::Dictionary& configuration) override;
 
@@ -71,15 +67,14 @@ private:
         bool isMarkedForRemoval = false;
     };
 
-    void handleConnection(const std::shared_ptr<Connection>& connection);
-    void cleanUpFinishedThreads();
+    void removeDisconnectedConnections();
     void consumeMessages();
     void disconnectAll();
     void preSync();
 
-    std::mutex _messageQueueMutex;
-    std::deque<Message> _messageQueue;
-
+    // Serves all connections of all interfaces from a single I/O thread. It has to be
+    // declared before the interfaces as they keep a reference to it
+    Reactor _reactor;
     std::vector<ConnectionData> _connections;
     std::vector<std::unique_ptr<ServerInterface>> _interfaces;
     properties::PropertyOwner _interfaceOwner;
@@ -24,11 +24,13 @@
 
 #include <modules/server/include/connection.h>
 
+#include <modules/server/include/reactor.h>
 #include <modules/server/include/topics/authorizationtopic.h>
 #include <modules/server/include/topics/bouncetopic.h>
 #include <modules/server/include/topics/camerapathtopic.h>
 #include <modules/server/include/topics/cameratopic.h>
 #include <modules/server/include/topics/documentationtopic.h>
+#include <modules/server/include/topics/encodingtopic.h>
 #include <modules/server/include/topics/enginemodetopic.h>
 #include <modules/server/include/topics/eventtopic.h>
 #include <modules/server/include/topics/flightcontrollertopic.h>
@@ -48,9 +50,6 @@
 #include <openspace/engine/globals.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
-#include <ghoul/io/socket/socket.h>
-#include <ghoul/io/socket/tcpsocketserver.h>
-#include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/misc/profiling.h>
 
 namespace {
@@ -64,7 +63,7 @@ namespace {
 
 namespace openspace {
 
-Connection::Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address,
+Connection::Connection(std::shared_ptr<ReactorSocket> s, std::string address,
                        bool authorized, const std::string& password)
     : _socket(std::move(s))
     , _address(std::move(address))
@@ -103,6 +102,7 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s, std::string address
     _topicFactory.registerClass<CameraTopic>("camera");
     _topicFactory.registerClass<CameraPathTopic>("cameraPath");
     _topicFactory.registerClass<EventTopic>("event");
+    _topicFactory.registerClass<EncodingTopic>("encoding");
 }
 
 void Connection::handleMessage(const std::string& message) {
@@ -210,28 +210,59 @@ void Connection::handleJson(const nlohmann::json& json) {
 void Connection::sendMessage(const std::string& message) {
     ZoneScoped;
 
-    _socket->putMessage(message);
+    putMessage(message, false);
+}
+
+void Connection::putMessage(std::string_view message, bool isBinary) {
+    const bool success = _socket->putMessage(
+        message,
+        isBinary ? ReactorSocket::MessageType::Binary : ReactorSocket::MessageType::Text
+    );
+    if (!success && !_isDroppingMessages && _socket->isConnected()) {
+        LWARNING(std::format(
+            "Dropping messages to {} as it does not receive them fast enough", _address
+        ));
+    }
+    _isDroppingMessages = !success;
 }
 
 void Connection::sendJson(const nlohmann::json& json) {
     ZoneScoped;
 
-    sendMessage(json.dump());
+    encode(json, _encoding, _encodeBuffer);
+    putMessage(_encodeBuffer, _encoding != Encoding::Json);
 }
 
-bool Connection::isAuthorized() const {
-    return _isAuthorized;
+void Connection::encode(const nlohmann::json& json, Encoding encoding,
+                        std::string& result)
+{
+    ZoneScoped;
+
+    using Adapter = nlohmann::detail::output_adapter<char>;
+
+    result.clear();
+    switch (encoding) {
+        case Encoding::Json:
+            result = json.dump();
+            break;
+        case Encoding::MessagePack:
+            nlohmann::json::to_msgpack(json, Adapter(result));
+            break;
+        case Encoding::Cbor:
+            nlohmann::json::to_cbor(json, Adapter(result));
+            break;
+    }
 }
 
-void Connection::setThread(std::thread&& thread) {
-    _thread = std::move(thread);
+bool Connection::isAuthorized() const {
+    return _isAuthorized;
 }
 
-std::thread& Connection::thread() {
-    return _thread;
+Connection::Encoding Connection::encoding() const {
+    return _encoding;
 }
 
-ghoul::io::Socket* Connection::socket() {
+ReactorSocket* Connection::socket() {
     return _socket.get();
 }
 
@@ -239,4 +270,8 @@ void Connection::setAuthorized(bool status) {
     _isAuthorized = status;
 }
 
+void Connection::setEncoding(Encoding encoding) {
+    _encoding = encoding;
+}
+
 } // namespace openspace
@@ -0,0 +1,91 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/deadbandfilter.h>
+
+#include <ghoul/misc/assert.h>
+#include <cmath>
+
+namespace {
+    // Returns whether the difference between the \p value and the value that was last
+    // sent to the client is large enough to send it. Numbers and lists of numbers are
+    // compared component-wise against the \p deadband, other values have to differ
+    bool isSignificantChange(const nlohmann::json& lastValue,
+                             const nlohmann::json& value, double deadband)
+    {
+        if (lastValue.is_null()) {
+            return true;
+        }
+        if (deadband <= 0.0) {
+            return lastValue != value;
+        }
+
+        if (lastValue.is_number() && value.is_number()) {
+            return std::abs(value.get<double>() - lastValue.get<double>()) > deadband;
+        }
+        if (lastValue.is_array() && value.is_array() &&
+            lastValue.size() == value.size())
+        {
+            for (size_t i = 0; i < value.size(); i++) {
+                if (!lastValue[i].is_number() || !value[i].is_number()) {
+                    return lastValue != value;
+                }
+                const double diff = value[i].get<double>() - lastValue[i].get<double>();
+                if (std::abs(diff) > deadband) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        return lastValue != value;
+    }
+} // namespace
+
+namespace openspace {
+
+bool DeadbandFilter::update(const nlohmann::json& value, double deadband) {
+    if (isSignificantChange(_lastSentValue, value, deadband)) {
+        _lastSentValue = value;
+        _trailingValue = nullptr;
+        return true;
+    }
+
+    // Remember the suppressed value unless it is the value the client already has
+    _trailingValue = value != _lastSentValue ? value : nullptr;
+    return false;
+}
+
+bool DeadbandFilter::hasTrailingValue() const {
+    return !_trailingValue.is_null();
+}
+
+nlohmann::json DeadbandFilter::takeTrailingValue() {
+    ghoul_assert(hasTrailingValue(), "No trailing value");
+
+    _lastSentValue = std::move(_trailingValue);
+    _trailingValue = nullptr;
+    return _lastSentValue;
+}
+
+} // namespace openspace
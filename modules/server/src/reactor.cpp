@@ -0,0 +1,1090 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/reactor.h>
+
+#include <modules/server/include/nativesocket.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <limits>
+#include <optional>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif !defined(WIN32)
+#include <poll.h>
+#endif // __linux__
+
+namespace {
+    constexpr std::string_view _loggerCat = "Reactor";
+
+    // Connections that send a message larger than this are closed
+    constexpr size_t MaxMessageSize = 64 * 1024 * 1024;
+
+    // The maximum size of the HTTP request that initiates a WebSocket connection
+    constexpr size_t MaxHandshakeSize = 16 * 1024;
+
+    // The number of bytes that are read from a socket at a time
+    constexpr size_t ReadChunkSize = 64 * 1024;
+
+    // The upper bound of the size of a WebSocket frame header that is sent by the server
+    constexpr size_t MaxFrameHeaderSize = 10;
+
+    // The GUID that is appended to the client's key in the WebSocket handshake (RFC 6455)
+    constexpr std::string_view WebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    enum class OpCode : uint8_t {
+        Continuation = 0x0,
+        Text = 0x1,
+        Binary = 0x2,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA
+    };
+
+    std::array<uint8_t, 20> sha1(std::string_view data) {
+        std::array<uint32_t, 5> h = {
+            0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+        };
+
+        std::string message = std::string(data);
+        const uint64_t nBits = static_cast<uint64_t>(data.size()) * 8;
+        message += static_cast<char>(0x80);
+        while (message.size() % 64 != 56) {
+            message += '\0';
+        }
+        for (int i = 7; i >= 0; i--) {
+            message += static_cast<char>((nBits >> (i * 8)) & 0xFF);
+        }
+
+        auto rotate = [](uint32_t v, int n) { return (v << n) | (v >> (32 - n)); };
+        for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+            std::array<uint32_t, 80> w;
+            for (size_t i = 0; i < 16; i++) {
+                const size_t b = chunk + i * 4;
+                w[i] = static_cast<uint32_t>(static_cast<uint8_t>(message[b])) << 24 |
+                       static_cast<uint32_t>(static_cast<uint8_t>(message[b + 1])) << 16 |
+                       static_cast<uint32_t>(static_cast<uint8_t>(message[b + 2])) << 8 |
+                       static_cast<uint32_t>(static_cast<uint8_t>(message[b + 3]));
+            }
+            for (size_t i = 16; i < 80; i++) {
+                w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            }
+
+            uint32_t a = h[0];
+            uint32_t b = h[1];
+            uint32_t c = h[2];
+            uint32_t d = h[3];
+            uint32_t e = h[4];
+            for (size_t i = 0; i < 80; i++) {
+                uint32_t f = 0;
+                uint32_t k = 0;
+                if (i < 20) {
+                    f = (b & c) | (~b & d);
+                    k = 0x5A827999;
+                }
+                else if (i < 40) {
+                    f = b ^ c ^ d;
+                    k = 0x6ED9EBA1;
+                }
+                else if (i < 60) {
+                    f = (b & c) | (b & d) | (c & d);
+                    k = 0x8F1BBCDC;
+                }
+                else {
+                    f = b ^ c ^ d;
+                    k = 0xCA62C1D6;
+                }
+                const uint32_t temp = rotate(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotate(b, 30);
+                b = a;
+                a = temp;
+            }
+            h[0] += a;
+            h[1] += b;
+            h[2] += c;
+            h[3] += d;
+            h[4] += e;
+        }
+
+        std::array<uint8_t, 20> result;
+        for (size_t i = 0; i < 20; i++) {
+            result[i] = static_cast<uint8_t>((h[i / 4] >> (24 - (i % 4) * 8)) & 0xFF);
+        }
+        return result;
+    }
+
+    std::string base64(const uint8_t* data, size_t size) {
+        constexpr std::string_view Alphabet =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::string result;
+        result.reserve((size + 2) / 3 * 4);
+        for (size_t i = 0; i < size; i += 3) {
+            const uint32_t v = static_cast<uint32_t>(data[i]) << 16 |
+                (i + 1 < size ? static_cast<uint32_t>(data[i + 1]) << 8 : 0) |
+                (i + 2 < size ? static_cast<uint32_t>(data[i + 2]) : 0);
+            result += Alphabet[(v >> 18) & 0x3F];
+            result += Alphabet[(v >> 12) & 0x3F];
+            result += i + 1 < size ? Alphabet[(v >> 6) & 0x3F] : '=';
+            result += i + 2 < size ? Alphabet[v & 0x3F] : '=';
+        }
+        return result;
+    }
+
+    // Appends an unmasked WebSocket frame, as it is sent by a server, to the buffer
+    void appendFrame(std::string& buffer, OpCode opCode, std::string_view payload) {
+        buffer += static_cast<char>(0x80 | static_cast<uint8_t>(opCode));
+        const uint64_t size = payload.size();
+        if (size < 126) {
+            buffer += static_cast<char>(size);
+        }
+        else if (size <= std::numeric_limits<uint16_t>::max()) {
+            buffer += static_cast<char>(126);
+            buffer += static_cast<char>((size >> 8) & 0xFF);
+            buffer += static_cast<char>(size & 0xFF);
+        }
+        else {
+            buffer += static_cast<char>(127);
+            for (int i = 7; i >= 0; i--) {
+                buffer += static_cast<char>((size >> (i * 8)) & 0xFF);
+            }
+        }
+        buffer += payload;
+    }
+
+    std::string_view trim(std::string_view str) {
+        while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+            str.remove_suffix(1);
+        }
+        return str;
+    }
+
+    bool equalsIgnoringCase(std::string_view lhs, std::string_view rhs) {
+        return std::equal(
+            lhs.begin(), lhs.end(),
+            rhs.begin(), rhs.end(),
+            [](char l, char r) { return std::tolower(l) == std::tolower(r); }
+        );
+    }
+} // namespace
+
+namespace openspace {
+
+ReactorSocket::ReactorSocket(Reactor* reactor, SocketHandle handle, std::string address,
+                             Protocol protocol, int listener)
+    : _handle(handle)
+    , _address(std::move(address))
+    , _protocol(protocol)
+    , _listener(listener)
+    , _reactor(reactor)
+{}
+
+const std::string& ReactorSocket::address() const {
+    return _address;
+}
+
+ReactorSocket::Protocol ReactorSocket::protocol() const {
+    return _protocol;
+}
+
+bool ReactorSocket::isConnected() const {
+    const std::lock_guard lock(_mutex);
+    return _isConnected;
+}
+
+bool ReactorSocket::nextMessage(std::string& message) {
+    const std::lock_guard lock(_mutex);
+    if (_inbox.empty()) {
+        return false;
+    }
+
+    message = std::move(_inbox.front());
+    _inbox.pop_front();
+
+    if (_isReadPaused && _reactor && _inbox.size() <= _reactor->_maxInboxSize / 2) {
+        _isReadPaused = false;
+        _reactor->requestResume(weak_from_this());
+    }
+    return true;
+}
+
+bool ReactorSocket::putMessage(std::string_view message, MessageType type) {
+    const std::lock_guard lock(_mutex);
+    if (!_isConnected || !_reactor) {
+        return false;
+    }
+
+    const size_t nQueued = _sendBuffer.size() - _sendOffset;
+    if (nQueued + message.size() + MaxFrameHeaderSize > _reactor->_maxSendQueueSize) {
+        return false;
+    }
+
+    if (_protocol == Protocol::WebSocket) {
+        const OpCode opCode = type == MessageType::Text ? OpCode::Text : OpCode::Binary;
+        appendFrame(_sendBuffer, opCode, message);
+    }
+    else if (type == MessageType::Text) {
+        _sendBuffer += message;
+        _sendBuffer += '\n';
+    }
+    else {
+        const uint32_t size = static_cast<uint32_t>(message.size());
+        for (int i = 3; i >= 0; i--) {
+            _sendBuffer += static_cast<char>((size >> (i * 8)) & 0xFF);
+        }
+        _sendBuffer += message;
+    }
+
+    if (nQueued == 0) {
+        // If there were queued bytes, the I/O thread is already writing them
+        _reactor->requestFlush(weak_from_this());
+    }
+    return true;
+}
+
+size_t ReactorSocket::queuedBytes() const {
+    const std::lock_guard lock(_mutex);
+    return _sendBuffer.size() - _sendOffset;
+}
+
+bool ReactorSocket::isCongested() const {
+    const std::lock_guard lock(_mutex);
+    return _reactor &&
+           (_sendBuffer.size() - _sendOffset) > _reactor->_maxSendQueueSize / 2;
+}
+
+void ReactorSocket::disconnect() {
+    const std::lock_guard lock(_mutex);
+    if (!_isConnected || !_reactor) {
+        return;
+    }
+    _isConnected = false;
+    _reactor->requestClose(weak_from_this());
+}
+
+Reactor::Reactor(size_t maxSendQueueSize, size_t maxInboxSize)
+    : _maxSendQueueSize(maxSendQueueSize)
+    , _maxInboxSize(maxInboxSize)
+{
+    nativesocket::initialize();
+
+#ifdef __linux__
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _wakeRead = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _wakeWrite = _wakeRead;
+    if (_epoll < 0 || _wakeRead < 0) {
+        throw ghoul::RuntimeError("Error creating the event queue", "Reactor");
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = _wakeRead;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeRead, &event);
+#else // ^^^ __linux__ / !__linux__ vvv
+    // Create a pair of connected loopback sockets as not all platforms support pipes in
+    // their poll function
+    const nativesocket::Handle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    ::listen(listener, 1);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+    _wakeWrite = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    connect(_wakeWrite, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    _wakeRead = ::accept(listener, nullptr, nullptr);
+    nativesocket::close(listener);
+    if (_wakeRead == nativesocket::InvalidHandle ||
+        !nativesocket::configure(_wakeRead, true) ||
+        !nativesocket::configure(_wakeWrite, true))
+    {
+        throw ghoul::RuntimeError("Error creating the wake up sockets", "Reactor");
+    }
+#endif // __linux__
+
+    _thread = std::thread([this]() { run(); });
+}
+
+Reactor::~Reactor() {
+    _shouldStop = true;
+    _isWakePending = false;
+    wake();
+    _thread.join();
+
+    for (const auto& [handle, socket] : _sockets) {
+        {
+            const std::lock_guard lock(socket->_mutex);
+            socket->_isConnected = false;
+            socket->_reactor = nullptr;
+        }
+        nativesocket::close(handle);
+    }
+    _sockets.clear();
+
+    for (const auto& [id, listener] : _listeners) {
+        nativesocket::close(listener.handle);
+    }
+    _listeners.clear();
+
+#ifdef __linux__
+    ::close(_wakeRead);
+    ::close(_epoll);
+#else // ^^^ __linux__ / !__linux__ vvv
+    nativesocket::close(_wakeRead);
+    nativesocket::close(_wakeWrite);
+#endif // __linux__
+
+    nativesocket::deinitialize();
+}
+
+Reactor::ListenerId Reactor::listen(int port, ReactorSocket::Protocol protocol) {
+    ZoneScoped;
+
+    const nativesocket::Handle handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == nativesocket::InvalidHandle) {
+        throw ghoul::RuntimeError(
+            std::format("Could not create socket for port {}", port),
+            "Reactor"
+        );
+    }
+
+#ifndef WIN32
+    // On Windows, this option would allow other processes to take over the port
+    int one = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#endif // WIN32
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    const bool success =
+        bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+        ::listen(handle, SOMAXCONN) == 0 &&
+        nativesocket::configure(handle, true);
+    if (!success) {
+        nativesocket::close(handle);
+        throw ghoul::RuntimeError(
+            std::format("Could not listen on port {}", port),
+            "Reactor"
+        );
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(handle, reinterpret_cast<sockaddr*>(&address), &length);
+
+    const std::lock_guard lock(_mutex);
+    const ListenerId id = _nextListenerId;
+    _nextListenerId++;
+    _listeners[id] = {
+        .handle = handle,
+        .protocol = protocol,
+        .port = ntohs(address.sin_port)
+    };
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = handle;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, handle, &event);
+#endif // __linux__
+    wake();
+    return id;
+}
+
+void Reactor::close(ListenerId listener) {
+    ZoneScoped;
+
+    std::deque<std::shared_ptr<ReactorSocket>> pendingSockets;
+    {
+        std::unique_lock lock(_mutex);
+        auto it = _listeners.find(listener);
+        if (it == _listeners.end()) {
+            return;
+        }
+
+        const SocketHandle handle = it->second.handle;
+        pendingSockets = std::move(it->second.pendingSockets);
+        _listeners.erase(it);
+
+        // The handle is closed by the I/O thread as it might currently be using it
+        _closingListeners.push_back(handle);
+        wake();
+        _listenerClosed.wait(lock, [this, handle]() {
+            return std::find(_closingListeners.begin(), _closingListeners.end(), handle)
+                == _closingListeners.end();
+        });
+    }
+
+    for (const std::shared_ptr<ReactorSocket>& socket : pendingSockets) {
+        socket->disconnect();
+    }
+}
+
+bool Reactor::isListening(ListenerId listener) const {
+    const std::lock_guard lock(_mutex);
+    return _listeners.contains(listener);
+}
+
+int Reactor::port(ListenerId listener) const {
+    const std::lock_guard lock(_mutex);
+    auto it = _listeners.find(listener);
+    return it != _listeners.end() ? it->second.port : 0;
+}
+
+std::shared_ptr<ReactorSocket> Reactor::nextPendingSocket(ListenerId listener) {
+    const std::lock_guard lock(_mutex);
+    auto it = _listeners.find(listener);
+    if (it == _listeners.end() || it->second.pendingSockets.empty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<ReactorSocket> socket = std::move(it->second.pendingSockets.front());
+    it->second.pendingSockets.pop_front();
+    return socket;
+}
+
+void Reactor::requestFlush(std::weak_ptr<ReactorSocket> socket) {
+    const std::lock_guard lock(_mutex);
+    _flushRequests.push_back(std::move(socket));
+    wake();
+}
+
+void Reactor::requestResume(std::weak_ptr<ReactorSocket> socket) {
+    const std::lock_guard lock(_mutex);
+    _resumeRequests.push_back(std::move(socket));
+    wake();
+}
+
+void Reactor::requestClose(std::weak_ptr<ReactorSocket> socket) {
+    const std::lock_guard lock(_mutex);
+    _closeRequests.push_back(std::move(socket));
+    wake();
+}
+
+void Reactor::wake() {
+    if (_isWakePending.exchange(true)) {
+        // The I/O thread has already been woken up and has not processed the requests
+        return;
+    }
+
+#ifdef __linux__
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto res = ::write(_wakeWrite, &one, sizeof(one));
+#else // ^^^ __linux__ / !__linux__ vvv
+    const char byte = 0;
+    ::send(_wakeWrite, &byte, 1, 0);
+#endif // __linux__
+}
+
+void Reactor::drainWake() {
+#ifdef __linux__
+    uint64_t value = 0;
+    [[maybe_unused]] const auto res = ::read(_wakeRead, &value, sizeof(value));
+#else // ^^^ __linux__ / !__linux__ vvv
+    std::array<char, 64> buffer;
+    while (::recv(_wakeRead, buffer.data(), static_cast<int>(buffer.size()), 0) > 0) {}
+#endif // __linux__
+    _isWakePending = false;
+}
+
+void Reactor::run() {
+    std::vector<Event> events;
+    while (!_shouldStop) {
+        events.clear();
+        waitForEvents(events);
+
+        ZoneScopedN("Reactor Events");
+        for (const Event& event : events) {
+            if (event.handle == _wakeRead) {
+                drainWake();
+                continue;
+            }
+
+            std::optional<ListenerId> listener;
+            {
+                const std::lock_guard lock(_mutex);
+                for (const auto& [id, l] : _listeners) {
+                    if (l.handle == event.handle) {
+                        listener = id;
+                        break;
+                    }
+                }
+            }
+            if (listener.has_value()) {
+                accept(*listener);
+                continue;
+            }
+
+            auto it = _sockets.find(event.handle);
+            if (it == _sockets.end()) {
+                continue;
+            }
+            // Copy the pointer as the socket might be removed from the map while it is
+            // being processed
+            const std::shared_ptr<ReactorSocket> socket = it->second;
+            if (event.isWritable) {
+                flush(socket);
+            }
+            if ((event.isReadable || event.hasError) && isRegistered(socket)) {
+                read(socket);
+            }
+        }
+
+        processRequests();
+    }
+}
+
+void Reactor::waitForEvents(std::vector<Event>& events) {
+#ifdef __linux__
+    std::array<epoll_event, 64> epollEvents;
+    const int nEvents = epoll_wait(
+        _epoll,
+        epollEvents.data(),
+        static_cast<int>(epollEvents.size()),
+        -1
+    );
+    for (int i = 0; i < nEvents; i++) {
+        const uint32_t flags = epollEvents[i].events;
+        events.push_back({
+            .handle = epollEvents[i].data.fd,
+            .isReadable = (flags & EPOLLIN) != 0,
+            .isWritable = (flags & EPOLLOUT) != 0,
+            .hasError = (flags & (EPOLLERR | EPOLLHUP)) != 0
+        });
+    }
+#else // ^^^ __linux__ / !__linux__ vvv
+    std::vector<pollfd> fds;
+    fds.push_back({ .fd = _wakeRead, .events = POLLIN, .revents = 0 });
+    {
+        const std::lock_guard lock(_mutex);
+        for (const auto& [id, listener] : _listeners) {
+            fds.push_back({ .fd = listener.handle, .events = POLLIN, .revents = 0 });
+        }
+    }
+    for (const auto& [handle, socket] : _sockets) {
+        const short flags = static_cast<short>(
+            (socket->_isReading ? POLLIN : 0) | (socket->_isWriting ? POLLOUT : 0)
+        );
+        if (flags != 0) {
+            fds.push_back({ .fd = handle, .events = flags, .revents = 0 });
+        }
+    }
+
+#ifdef WIN32
+    const int nEvents = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), -1);
+#else // ^^^ WIN32 / !WIN32 vvv
+    const int nEvents = poll(fds.data(), static_cast<nfds_t>(fds.size()), -1);
+#endif // WIN32
+    if (nEvents <= 0) {
+        return;
+    }
+    for (const pollfd& fd : fds) {
+        if (fd.revents != 0) {
+            events.push_back({
+                .handle = static_cast<SocketHandle>(fd.fd),
+                .isReadable = (fd.revents & POLLIN) != 0,
+                .isWritable = (fd.revents & POLLOUT) != 0,
+                .hasError = (fd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0
+            });
+        }
+    }
+#endif // __linux__
+}
+
+void Reactor::processRequests() {
+    ZoneScoped;
+
+    std::vector<std::weak_ptr<ReactorSocket>> flushRequests;
+    std::vector<std::weak_ptr<ReactorSocket>> resumeRequests;
+    std::vector<std::weak_ptr<ReactorSocket>> closeRequests;
+    std::vector<SocketHandle> closingListeners;
+    {
+        const std::lock_guard lock(_mutex);
+        std::swap(flushRequests, _flushRequests);
+        std::swap(resumeRequests, _resumeRequests);
+        std::swap(closeRequests, _closeRequests);
+        closingListeners = _closingListeners;
+    }
+
+    for (const std::weak_ptr<ReactorSocket>& request : closeRequests) {
+        const std::shared_ptr<ReactorSocket> socket = request.lock();
+        if (!socket || !isRegistered(socket)) {
+            continue;
+        }
+
+        if (socket->_protocol == ReactorSocket::Protocol::WebSocket &&
+            socket->_hasCompletedHandshake)
+        {
+            // Let the client know that we are closing the connection (status code 1000)
+            std::string frame;
+            appendFrame(frame, OpCode::Close, std::string_view("\x03\xE8", 2));
+            ::send(
+                socket->_handle,
+                frame.data(),
+                static_cast<int>(frame.size()),
+                nativesocket::SendFlags
+            );
+        }
+        closeSocket(socket);
+    }
+
+    for (const std::weak_ptr<ReactorSocket>& request : resumeRequests) {
+        const std::shared_ptr<ReactorSocket> socket = request.lock();
+        if (socket && isRegistered(socket) && !socket->_isReading) {
+            socket->_isReading = true;
+            updateInterest(*socket);
+        }
+    }
+
+    for (const std::weak_ptr<ReactorSocket>& request : flushRequests) {
+        const std::shared_ptr<ReactorSocket> socket = request.lock();
+        if (socket && isRegistered(socket)) {
+            flush(socket);
+        }
+    }
+
+    if (!closingListeners.empty()) {
+        for (SocketHandle handle : closingListeners) {
+#ifdef __linux__
+            epoll_ctl(_epoll, EPOLL_CTL_DEL, handle, nullptr);
+#endif // __linux__
+            nativesocket::close(handle);
+        }
+
+        {
+            const std::lock_guard lock(_mutex);
+            std::erase_if(
+                _closingListeners,
+                [&closingListeners](SocketHandle handle) {
+                    return std::find(
+                        closingListeners.begin(),
+                        closingListeners.end(),
+                        handle
+                    ) != closingListeners.end();
+                }
+            );
+        }
+        _listenerClosed.notify_all();
+    }
+}
+
+void Reactor::accept(ListenerId id) {
+    ZoneScoped;
+
+    // Limit the number of connections accepted at once to not starve other connections
+    constexpr int MaxAcceptsPerEvent = 64;
+    for (int i = 0; i < MaxAcceptsPerEvent; i++) {
+        SocketHandle listenerHandle;
+        ReactorSocket::Protocol protocol;
+        {
+            const std::lock_guard lock(_mutex);
+            auto it = _listeners.find(id);
+            if (it == _listeners.end()) {
+                return;
+            }
+            listenerHandle = it->second.handle;
+            protocol = it->second.protocol;
+        }
+
+        sockaddr_in address = {};
+        socklen_t length = sizeof(address);
+        const nativesocket::Handle handle = ::accept(
+            listenerHandle,
+            reinterpret_cast<sockaddr*>(&address),
+            &length
+        );
+        if (handle == nativesocket::InvalidHandle) {
+            return;
+        }
+        if (!nativesocket::configure(handle, true)) {
+            nativesocket::close(handle);
+            continue;
+        }
+
+        std::shared_ptr<ReactorSocket> socket = std::shared_ptr<ReactorSocket>(
+            new ReactorSocket(this, handle, nativesocket::address(address), protocol, id)
+        );
+        _sockets[handle] = socket;
+        updateInterest(*socket, true);
+
+        if (protocol == ReactorSocket::Protocol::Tcp) {
+            const std::lock_guard lock(_mutex);
+            auto it = _listeners.find(id);
+            if (it != _listeners.end()) {
+                it->second.pendingSockets.push_back(std::move(socket));
+            }
+        }
+        // WebSocket connections are only handed out after the handshake is completed
+    }
+}
+
+void Reactor::read(const std::shared_ptr<ReactorSocket>& socket) {
+    ZoneScoped;
+
+    std::string& buffer = socket->_readBuffer;
+    const size_t previousSize = buffer.size();
+    bool isClosed = false;
+
+    // Limit the number of reads to not starve other connections. As the event queue is
+    // level-triggered, we will be notified again if there is more data available
+    constexpr int MaxReadsPerEvent = 4;
+    for (int i = 0; i < MaxReadsPerEvent; i++) {
+        const size_t offset = buffer.size();
+        buffer.resize(offset + ReadChunkSize);
+        const auto nBytes = ::recv(
+            socket->_handle,
+            buffer.data() + offset,
+            static_cast<int>(ReadChunkSize),
+            0
+        );
+        buffer.resize(offset + (nBytes > 0 ? static_cast<size_t>(nBytes) : 0));
+
+        if (nBytes > 0) {
+            if (static_cast<size_t>(nBytes) < ReadChunkSize) {
+                break;
+            }
+            continue;
+        }
+        if (nBytes == 0 || !nativesocket::wouldBlock()) {
+            // The client has closed the connection or an error occurred
+            isClosed = true;
+        }
+        break;
+    }
+
+    const bool isValid = socket->_protocol == ReactorSocket::Protocol::Tcp ?
+        processTcp(*socket, previousSize) :
+        processWebSocket(*socket);
+    if (!isValid) {
+        LWARNING(std::format(
+            "Closing connection to {} after receiving invalid data", socket->_address
+        ));
+    }
+    if (!isValid || isClosed) {
+        closeSocket(socket);
+        return;
+    }
+
+    // Processing the data might have queued responses, like the handshake or pongs
+    flush(socket);
+}
+
+bool Reactor::processTcp(ReactorSocket& socket, size_t searchOffset) {
+    std::string& buffer = socket._readBuffer;
+    size_t begin = 0;
+    size_t end = buffer.find('\n', searchOffset);
+    while (end != std::string::npos) {
+        deliver(socket, buffer.substr(begin, end - begin));
+        begin = end + 1;
+        end = buffer.find('\n', begin);
+    }
+    buffer.erase(0, begin);
+    return buffer.size() <= MaxMessageSize;
+}
+
+bool Reactor::processWebSocket(ReactorSocket& socket) {
+    if (!socket._hasCompletedHandshake) {
+        if (!processHandshake(socket)) {
+            return false;
+        }
+        if (!socket._hasCompletedHandshake) {
+            // Either the request is incomplete or it was rejected
+            return true;
+        }
+    }
+
+    std::string& buffer = socket._readBuffer;
+    size_t offset = 0;
+    bool isValid = true;
+    while (isValid && !socket._shouldCloseAfterFlush && buffer.size() - offset >= 2) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data() + offset);
+        const size_t available = buffer.size() - offset;
+
+        const bool isFinal = (data[0] & 0x80) != 0;
+        const OpCode opCode = static_cast<OpCode>(data[0] & 0x0F);
+        const bool isMasked = (data[1] & 0x80) != 0;
+        uint64_t length = data[1] & 0x7F;
+        size_t headerSize = 2;
+        if (length == 126) {
+            if (available < 4) {
+                break;
+            }
+            length = static_cast<uint64_t>(data[2]) << 8 | data[3];
+            headerSize = 4;
+        }
+        else if (length == 127) {
+            if (available < 10) {
+                break;
+            }
+            length = 0;
+            for (size_t i = 2; i < 10; i++) {
+                length = length << 8 | data[i];
+            }
+            headerSize = 10;
+        }
+
+        // Clients are required to mask all of their frames
+        if (!isMasked || length > MaxMessageSize) {
+            isValid = false;
+            break;
+        }
+        headerSize += 4;
+        if (available < headerSize + length) {
+            break;
+        }
+
+        const uint8_t* mask = data + headerSize - 4;
+        std::string payload = std::string(static_cast<size_t>(length), '\0');
+        for (size_t i = 0; i < length; i++) {
+            payload[i] = static_cast<char>(data[headerSize + i] ^ mask[i % 4]);
+        }
+        offset += headerSize + length;
+
+        switch (opCode) {
+            case OpCode::Continuation:
+                socket._fragmentedMessage += payload;
+                if (socket._fragmentedMessage.size() > MaxMessageSize) {
+                    isValid = false;
+                }
+                else if (isFinal) {
+                    deliver(socket, std::move(socket._fragmentedMessage));
+                    socket._fragmentedMessage.clear();
+                }
+                break;
+            case OpCode::Text:
+            case OpCode::Binary:
+                if (isFinal) {
+                    deliver(socket, std::move(payload));
+                }
+                else {
+                    socket._fragmentedMessage = std::move(payload);
+                }
+                break;
+            case OpCode::Close:
+            {
+                // Echo the status code of the client before closing the connection
+                const std::lock_guard lock(socket._mutex);
+                appendFrame(
+                    socket._sendBuffer,
+                    OpCode::Close,
+                    std::string_view(payload).substr(0, 2)
+                );
+                socket._shouldCloseAfterFlush = true;
+                break;
+            }
+            case OpCode::Ping:
+            {
+                const std::lock_guard lock(socket._mutex);
+                appendFrame(socket._sendBuffer, OpCode::Pong, payload);
+                break;
+            }
+            case OpCode::Pong:
+                break;
+            default:
+                isValid = false;
+                break;
+        }
+    }
+
+    buffer.erase(0, offset);
+    return isValid;
+}
+
+bool Reactor::processHandshake(ReactorSocket& socket) {
+    std::string& buffer = socket._readBuffer;
+    const size_t end = buffer.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        return buffer.size() <= MaxHandshakeSize;
+    }
+
+    const std::string_view request = std::string_view(buffer).substr(0, end);
+    const bool isGetRequest = request.starts_with("GET ");
+    std::string key;
+    size_t lineBegin = request.find("\r\n");
+    while (lineBegin != std::string_view::npos) {
+        lineBegin += 2;
+        const size_t lineEnd = request.find("\r\n", lineBegin);
+        const std::string_view line = request.substr(
+            lineBegin,
+            lineEnd == std::string_view::npos ? lineEnd : lineEnd - lineBegin
+        );
+        const size_t colon = line.find(':');
+        if (colon != std::string_view::npos &&
+            equalsIgnoringCase(trim(line.substr(0, colon)), "Sec-WebSocket-Key"))
+        {
+            key = trim(line.substr(colon + 1));
+        }
+        lineBegin = lineEnd;
+    }
+    buffer.erase(0, end + 4);
+
+    if (!isGetRequest || key.empty()) {
+        const std::lock_guard lock(socket._mutex);
+        socket._sendBuffer +=
+            "HTTP/1.1 400 Bad Request\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+        socket._shouldCloseAfterFlush = true;
+        return true;
+    }
+
+    const std::array<uint8_t, 20> hash = sha1(key + std::string(WebSocketGuid));
+    const std::string accept = base64(hash.data(), hash.size());
+    {
+        const std::lock_guard lock(socket._mutex);
+        socket._sendBuffer += std::format(
+            "HTTP/1.1 101 Switching Protocols\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: {}\r\n\r\n",
+            accept
+        );
+    }
+    socket._hasCompletedHandshake = true;
+
+    const std::lock_guard lock(_mutex);
+    auto it = _listeners.find(socket._listener);
+    if (it == _listeners.end()) {
+        // The listener was closed while the handshake was in progress
+        return false;
+    }
+    it->second.pendingSockets.push_back(socket.shared_from_this());
+    return true;
+}
+
+void Reactor::deliver(ReactorSocket& socket, std::string message) {
+    {
+        const std::lock_guard lock(socket._mutex);
+        socket._inbox.push_back(std::move(message));
+        if (socket._inbox.size() < _maxInboxSize || !socket._isReading) {
+            return;
+        }
+        socket._isReadPaused = true;
+    }
+
+    // The messages are not retrieved fast enough, so we stop reading from the socket
+    // until they are. This will eventually fill the TCP window, slowing down the client
+    socket._isReading = false;
+    updateInterest(socket);
+}
+
+void Reactor::flush(const std::shared_ptr<ReactorSocket>& socket) {
+    ZoneScoped;
+
+    bool hasFailed = false;
+    bool isEmpty = false;
+    {
+        const std::lock_guard lock(socket->_mutex);
+        std::string& buffer = socket->_sendBuffer;
+        size_t& offset = socket->_sendOffset;
+        while (offset < buffer.size()) {
+            const size_t remaining = std::min<size_t>(
+                buffer.size() - offset,
+                std::numeric_limits<int>::max()
+            );
+            const auto nBytes = ::send(
+                socket->_handle,
+                buffer.data() + offset,
+                static_cast<int>(remaining),
+                nativesocket::SendFlags
+            );
+            if (nBytes <= 0) {
+                hasFailed = !nativesocket::wouldBlock();
+                break;
+            }
+            offset += static_cast<size_t>(nBytes);
+        }
+
+        isEmpty = offset == buffer.size();
+        if (isEmpty) {
+            buffer.clear();
+            offset = 0;
+        }
+        else if (offset > buffer.size() / 2) {
+            buffer.erase(0, offset);
+            offset = 0;
+        }
+    }
+
+    if (hasFailed || (isEmpty && socket->_shouldCloseAfterFlush)) {
+        closeSocket(socket);
+        return;
+    }
+
+    // Only wait for the socket to become writable while there is data left to send
+    if (socket->_isWriting == isEmpty) {
+        socket->_isWriting = !isEmpty;
+        updateInterest(*socket);
+    }
+}
+
+void Reactor::updateInterest([[maybe_unused]] const ReactorSocket& socket,
+                             [[maybe_unused]] bool isNew)
+{
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = (socket._isReading ? EPOLLIN : 0) | (socket._isWriting ? EPOLLOUT : 0);
+    event.data.fd = socket._handle;
+    epoll_ctl(_epoll, isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, socket._handle, &event);
+#endif // __linux__
+    // The poll backend rebuilds its list of sockets in every iteration
+}
+
+bool Reactor::isRegistered(const std::shared_ptr<ReactorSocket>& socket) const {
+    auto it = _sockets.find(socket->_handle);
+    return it != _sockets.end() && it->second == socket;
+}
+
+void Reactor::closeSocket(const std::shared_ptr<ReactorSocket>& socket) {
+    ZoneScoped;
+
+    if (!isRegistered(socket)) {
+        return;
+    }
+
+#ifdef __linux__
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, socket->_handle, nullptr);
+#endif // __linux__
+    {
+        const std::lock_guard lock(socket->_mutex);
+        socket->_isConnected = false;
+        socket->_reactor = nullptr;
+        socket->_sendBuffer.clear();
+        socket->_sendOffset = 0;
+    }
+    nativesocket::close(socket->_handle);
+    _sockets.erase(socket->_handle);
+}
+
+} // namespace openspace
@@ -23,13 +23,15 @@
  ****************************************************************************************/
 
 #include <modules/server/include/serverinterface.h>
-#include <ghoul/io/socket/socketserver.h>
 
-#include <ghoul/io/socket/tcpsocketserver.h>
-#include <ghoul/io/socket/websocketserver.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <functional>
 
 namespace {
+    constexpr std::string_view _loggerCat = "ServerInterface";
+
     constexpr std::string_view KeyIdentifier = "Identifier";
     constexpr std::string_view TcpSocketType = "TcpSocket";
     constexpr std::string_view WebSocketType = "WebSocket";
@@ -99,14 +101,14 @@ namespace {
 namespace openspace {
 
 std::unique_ptr<ServerInterface> ServerInterface::createFromDictionary(
-                                                      const ghoul::Dictionary& dictionary)
+                                    const ghoul::Dictionary& dictionary, Reactor& reactor)
 {
     // TODO: Use documentation to verify dictionary
-    auto si = std::make_unique<ServerInterface>(dictionary);
+    auto si = std::make_unique<ServerInterface>(dictionary, reactor);
     return si;
 }
 
-ServerInterface::ServerInterface(const ghoul::Dictionary& dictionary)
+ServerInterface::ServerInterface(const ghoul::Dictionary& dictionary, Reactor& reactor)
     : properties::PropertyOwner({ "", "", "" })
     , _socketType(TypeInfo)
     , _port(PortInfo, 0)
@@ -116,6 +118,7 @@ ServerInterface::ServerInterface(const ghoul::Dictionary& dictionary)
     , _denyAddresses(DenyAddressesInfo)
     , _defaultAccess(DefaultAccessInfo)
     , _password(PasswordInfo)
+    , _reactor(reactor)
 {
 
     _socketType.addOption(
@@ -219,19 +222,23 @@ void ServerInterface::initialize() {
     if (!_enabled) {
         return;
     }
-    switch (static_cast<InterfaceType>(_socketType.value())) {
-        case InterfaceType::TcpSocket:
-            _socketServer = std::make_unique<ghoul::io::TcpSocketServer>();
-            break;
-        case InterfaceType::WebSocket:
-            _socketServer = std::make_unique<ghoul::io::WebSocketServer>();
-            break;
+    const ReactorSocket::Protocol protocol =
+        static_cast<InterfaceType>(_socketType.value()) == InterfaceType::WebSocket ?
+        ReactorSocket::Protocol::WebSocket :
+        ReactorSocket::Protocol::Tcp;
+    try {
+        _listener = _reactor.listen(_port, protocol);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(std::format("Error initializing '{}': {}", identifier(), e.message));
     }
-    _socketServer->listen(_port);
 }
 
 void ServerInterface::deinitialize() {
-    _socketServer->close();
+    if (_listener.has_value()) {
+        _reactor.close(*_listener);
+        _listener = std::nullopt;
+    }
 }
 
 bool ServerInterface::isEnabled() const {
@@ -239,7 +246,7 @@ bool ServerInterface::isEnabled() const {
 }
 
 bool ServerInterface::isActive() const {
-    return _socketServer->isListening();
+    return _listener.has_value() && _reactor.isListening(*_listener);
 }
 
 int ServerInterface::port() const {
@@ -293,8 +300,8 @@ bool ServerInterface::clientIsBlocked(const std::string& clientAddress) const {
     return false;
 }
 
-ghoul::io::SocketServer* ServerInterface::server() {
-    return _socketServer.get();
+std::shared_ptr<ReactorSocket> ServerInterface::nextPendingSocket() {
+    return _listener.has_value() ? _reactor.nextPendingSocket(*_listener) : nullptr;
 }
 
 } // namespace openspace
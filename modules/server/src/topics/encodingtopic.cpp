@@ -0,0 +1,72 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/include/topics/encodingtopic.h>
+
+#include <modules/server/include/connection.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+
+namespace {
+    constexpr std::string_view _loggerCat = "EncodingTopic";
+
+    constexpr std::string_view KeyEncoding = "encoding";
+    constexpr std::string_view Json = "json";
+    constexpr std::string_view MessagePack = "msgpack";
+    constexpr std::string_view Cbor = "cbor";
+} // namespace
+
+namespace openspace {
+
+bool EncodingTopic::isDone() const {
+    return true;
+}
+
+void EncodingTopic::handleJson(const nlohmann::json& json) {
+    const std::string encoding = json.at(KeyEncoding).get<std::string>();
+
+    Connection::Encoding newEncoding;
+    if (encoding == Json) {
+        newEncoding = Connection::Encoding::Json;
+    }
+    else if (encoding == MessagePack) {
+        newEncoding = Connection::Encoding::MessagePack;
+    }
+    else if (encoding == Cbor) {
+        newEncoding = Connection::Encoding::Cbor;
+    }
+    else {
+        LERROR(std::format("Unknown encoding '{}'", encoding));
+        _connection->sendJson(wrappedError(
+            std::format("Unknown encoding '{}'", encoding),
+            400
+        ));
+        return;
+    }
+
+    _connection->sendJson(wrappedPayload({ KeyEncoding, encoding }));
+    _connection->setEncoding(newEncoding);
+}
+
+} // namespace openspace
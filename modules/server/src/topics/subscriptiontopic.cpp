@@ -26,17 +26,29 @@
 
 #include <modules/server/include/connection.h>
 #include <modules/server/include/jsonconverters.h>
+#include <modules/server/include/reactor.h>
+#include <modules/server/servermodule.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/properties/property.h>
 #include <openspace/query/query.h>
 #include <openspace/util/timemanager.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
 
 namespace {
     constexpr std::string_view _loggerCat = "SubscriptionTopic";
 
     constexpr std::string_view StartSubscription = "start_subscription";
     constexpr std::string_view StopSubscription = "stop_subscription";
+
+    constexpr std::string_view KeyProperty = "property";
+    constexpr std::string_view KeyProperties = "properties";
+    constexpr std::string_view KeyMaxRate = "maxRate";
+    constexpr std::string_view KeyDeadband = "deadband";
+    constexpr std::string_view KeyValues = "values";
 } // namespace
 
 using nlohmann::json;
@@ -44,67 +56,227 @@ using nlohmann::json;
 namespace openspace {
 
 SubscriptionTopic::~SubscriptionTopic() {
-    resetCallbacks();
+    for (const std::unique_ptr<Subscription>& subscription : _subscriptions) {
+        unsubscribe(*subscription);
+    }
+
+    if (_preSyncHandle != UnsetCallbackHandle) {
+        ServerModule* module = global::moduleEngine->module<ServerModule>();
+        if (module) {
+            module->removePreSyncCallback(_preSyncHandle);
+        }
+    }
 }
 
 bool SubscriptionTopic::isDone() const {
-    return !_requestedResourceIsSubscribable || !_isSubscribedTo;
+    return std::none_of(
+        _subscriptions.begin(),
+        _subscriptions.end(),
+        [](const std::unique_ptr<Subscription>& s) { return s->property != nullptr; }
+    );
 }
 
-void SubscriptionTopic::resetCallbacks() {
-    if (!_prop) {
+void SubscriptionTopic::subscribe(const std::string& uri) {
+    properties::Property* prop = property(uri);
+    if (!prop) {
+        LWARNING(std::format("Could not subscribe. Property '{}' not found", uri));
         return;
     }
-    if (_onChangeHandle != UnsetCallbackHandle) {
-        _prop->removeOnChange(_onChangeHandle);
-        _onChangeHandle = UnsetCallbackHandle;
+
+    const bool isSubscribed = std::any_of(
+        _subscriptions.begin(),
+        _subscriptions.end(),
+        [prop](const std::unique_ptr<Subscription>& s) { return s->property == prop; }
+    );
+    if (isSubscribed) {
+        return;
     }
-    if (_onDeleteHandle != UnsetCallbackHandle) {
-        _prop->removeOnDelete(_onDeleteHandle);
-        _onDeleteHandle = UnsetCallbackHandle;
+
+    auto subscription = std::make_unique<Subscription>();
+    subscription->uri = uri;
+    subscription->property = prop;
+
+    // If the client requested a maximum rate, the values are only serialized when they
+    // are sent, so repeated changes between two updates only cost setting this flag
+    Subscription* s = subscription.get();
+    s->onChangeHandle = prop->onChange([this, s]() {
+        s->isDirty = true;
+        if (!_isThrottled) {
+            flush(true);
+        }
+    });
+    s->onDeleteHandle = prop->onDelete([s]() {
+        s->property = nullptr;
+        s->onChangeHandle = UnsetCallbackHandle;
+        s->onDeleteHandle = UnsetCallbackHandle;
+    });
+    _subscriptions.push_back(std::move(subscription));
+}
+
+void SubscriptionTopic::unsubscribe(Subscription& subscription) {
+    if (!subscription.property) {
+        return;
     }
+    if (subscription.onChangeHandle != UnsetCallbackHandle) {
+        subscription.property->removeOnChange(subscription.onChangeHandle);
+        subscription.onChangeHandle = UnsetCallbackHandle;
+    }
+    if (subscription.onDeleteHandle != UnsetCallbackHandle) {
+        subscription.property->removeOnDelete(subscription.onDeleteHandle);
+        subscription.onDeleteHandle = UnsetCallbackHandle;
+    }
+    subscription.property = nullptr;
 }
 
-void SubscriptionTopic::handleJson(const nlohmann::json& json) {
-    const std::string& event = json.at("event").get<std::string>();
+json SubscriptionTopic::propertyPayload(Subscription& subscription, json value) {
+    const properties::Property& property = *subscription.property;
+    const uint64_t version = property.jsonDescriptionVersion();
+    if (subscription.descriptionVersion != version) {
+        subscription.description = json::parse(property.generateJsonDescription());
+        subscription.description["description"] = property.description();
+        subscription.descriptionVersion = version;
+    }
 
-    if (event == StartSubscription) {
-        std::string key = json.at("property").get<std::string>();
+    return {
+        { "Description", subscription.description },
+        { "Value", std::move(value) }
+    };
+}
+
+void SubscriptionTopic::flush(bool ignoreRateLimit) {
+    ZoneScoped;
+
+    // Subscriptions whose property has been deleted are removed here rather than in the
+    // onDelete callback, which is stored in the subscription itself
+    std::erase_if(
+        _subscriptions,
+        [](const std::unique_ptr<Subscription>& s) { return s->property == nullptr; }
+    );
+
+    const bool hasChanges = std::any_of(
+        _subscriptions.begin(),
+        _subscriptions.end(),
+        [](const std::unique_ptr<Subscription>& s) {
+            return s->isDirty || s->filter.hasTrailingValue();
+        }
+    );
+    if (!hasChanges) {
+        return;
+    }
 
-        _prop = property(key);
-        resetCallbacks();
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!ignoreRateLimit) {
+        if (now - _lastUpdateTime < _minUpdateInterval) {
+            return;
+        }
 
-        if (_prop) {
-            _requestedResourceIsSubscribable = true;
-            _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                _connection->sendJson(wrappedPayload(_prop));
-            };
+        // If the client does not keep up with its messages, we keep the changes pending
+        // so that only the latest values are sent once it has caught up
+        const ReactorSocket* socket = _connection->socket();
+        if (socket && socket->isCongested()) {
+            return;
+        }
+    }
+    _lastUpdateTime = now;
 
-            _onChangeHandle = _prop->onChange(onChange);
-            _onDeleteHandle = _prop->onDelete([this]() {
-                _onChangeHandle = UnsetCallbackHandle;
-                _onDeleteHandle = UnsetCallbackHandle;
-                _isSubscribedTo = false;
-            });
+    json values = json::object();
+    auto send = [this, &values](Subscription& subscription, json value) {
+        if (_isBatch) {
+            values[subscription.uri] = std::move(value);
+        }
+        else {
+            _connection->sendJson(
+                wrappedPayload(propertyPayload(subscription, std::move(value)))
+            );
+        }
+    };
 
-            // immediately send the value
-            onChange();
+    for (const std::unique_ptr<Subscription>& subscription : _subscriptions) {
+        if (subscription->isDirty) {
+            subscription->isDirty = false;
+            json value = json::parse(subscription->property->jsonValue());
+            if (subscription->filter.update(value, _deadband)) {
+                send(*subscription, std::move(value));
+            }
+        }
+        else if (subscription->filter.hasTrailingValue()) {
+            // The property has not changed since the last update, so the value that was
+            // suppressed by the deadband is final and has to reach the client
+            send(*subscription, subscription->filter.takeTrailingValue());
+        }
+    }
+
+    if (_isBatch && !values.empty()) {
+        _connection->sendJson(wrappedPayload({ { KeyValues, std::move(values) } }));
+    }
+}
+
+void SubscriptionTopic::handleJson(const nlohmann::json& json) {
+    const std::string& event = json.at("event").get<std::string>();
+
+    if (event == StartSubscription) {
+        const auto maxRate = json.find(KeyMaxRate);
+        if (maxRate != json.end() && maxRate->is_number()) {
+            // A rate of 0 means that the values are sent once per frame if they changed
+            _isThrottled = true;
+            const double rate = maxRate->get<double>();
+            _minUpdateInterval = rate > 0.0 ?
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(1.0 / rate)
+                ) :
+                std::chrono::steady_clock::duration(0);
+        }
+        const auto deadband = json.find(KeyDeadband);
+        if (deadband != json.end() && deadband->is_number()) {
+            _deadband = deadband->get<double>();
+        }
+
+        const auto properties = json.find(KeyProperties);
+        if (properties != json.end() && properties->is_array()) {
+            _isBatch = true;
+            for (const nlohmann::json& uri : *properties) {
+                subscribe(uri.get<std::string>());
+            }
         }
         else {
-            LWARNING(std::format("Could not subscribe. Property '{}' not found", key));
+            // Subscribing to a single property replaces the previous subscription
+            _isBatch = false;
+            for (const std::unique_ptr<Subscription>& subscription : _subscriptions) {
+                unsubscribe(*subscription);
+            }
+            _subscriptions.clear();
+            subscribe(json.at(KeyProperty).get<std::string>());
+        }
+
+        if (!_subscriptions.empty() && _preSyncHandle == UnsetCallbackHandle) {
+            ServerModule* module = global::moduleEngine->module<ServerModule>();
+            _preSyncHandle = module->addPreSyncCallback([this]() { flush(false); });
         }
+
+        // Immediately send the values of the new subscriptions
+        flush(true);
     }
     if (event == StopSubscription) {
-        _isSubscribedTo = false;
-        if (_prop && _onChangeHandle != UnsetCallbackHandle) {
-            _prop->removeOnChange(_onChangeHandle);
-            _onChangeHandle = UnsetCallbackHandle;
+        const auto properties = json.find(KeyProperties);
+        if (properties != json.end() && properties->is_array()) {
+            for (const nlohmann::json& uri : *properties) {
+                const std::string u = uri.get<std::string>();
+                for (const std::unique_ptr<Subscription>& subscription : _subscriptions) {
+                    if (subscription->uri == u) {
+                        unsubscribe(*subscription);
+                    }
+                }
+            }
         }
-        if (_prop && !_onDeleteHandle) {
-            _prop->removeOnDelete(_onDeleteHandle);
-            _onDeleteHandle = UnsetCallbackHandle;
+        else {
+            for (const std::unique_ptr<Subscription>& subscription : _subscriptions) {
+                unsubscribe(*subscription);
+            }
         }
+        std::erase_if(
+            _subscriptions,
+            [](const std::unique_ptr<Subscription>& s) { return s->property == nullptr; }
+        );
     }
 }
 
@@ -0,0 +1,174 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/tasks/benchmarkserverencodingtask.h>
+
+#include <modules/server/include/connection.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <openspace/json.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <utility>
+
+namespace {
+    constexpr std::string_view _loggerCat = "BenchmarkServerEncodingTask";
+
+    using Encoding = openspace::Connection::Encoding;
+
+    constexpr std::array<std::pair<Encoding, std::string_view>, 3> Encodings = {
+        std::pair(Encoding::Json, "JSON"),
+        std::pair(Encoding::MessagePack, "MessagePack"),
+        std::pair(Encoding::Cbor, "CBOR")
+    };
+
+    // The messages resemble the ones sent by the CameraTopic, the TimeTopic, and the
+    // SubscriptionTopic with a batch of properties
+    nlohmann::json cameraMessage() {
+        return {
+            { "topic", 1 },
+            {
+                "payload",
+                {
+                    { "latitude", 59.3293235 },
+                    { "longitude", 18.0685808 },
+                    { "altitude", 1234.5678 },
+                    { "altitudeUnit", "km" }
+                }
+            }
+        };
+    }
+
+    nlohmann::json timeMessage() {
+        return {
+            { "topic", 2 },
+            {
+                "payload",
+                {
+                    { "time", "2024-03-21T12:34:56.789" },
+                    { "deltaTime", 3600.0 },
+                    { "targetDeltaTime", 3600.0 },
+                    { "isPaused", false },
+                    { "hasNextStep", true },
+                    { "hasPrevStep", true }
+                }
+            }
+        };
+    }
+
+    nlohmann::json propertiesMessage(int nProperties) {
+        nlohmann::json values = nlohmann::json::object();
+        for (int i = 0; i < nProperties; i++) {
+            const std::string uri = std::format("Scene.Node{}.Renderable.Opacity", i);
+            if (i % 2 == 0) {
+                values[uri] = 0.5 + i * 0.001;
+            }
+            else {
+                values[uri] = nlohmann::json::array({ 1.0 * i, 2.0 * i, 3.0 * i });
+            }
+        }
+        return {
+            { "topic", 3 },
+            { "payload", { { "values", std::move(values) } } }
+        };
+    }
+
+    struct [[codegen::Dictionary(BenchmarkServerEncodingTask)]] Parameters {
+        // The number of times each message is encoded
+        std::optional<int> iterations [[codegen::greater(0)]];
+
+        // The number of property values in the message that resembles a batch of
+        // property subscriptions
+        std::optional<int> properties [[codegen::greater(0)]];
+    };
+#include "benchmarkserverencodingtask_codegen.cpp"
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation BenchmarkServerEncodingTask::Documentation() {
+    return codegen::doc<Parameters>("server_benchmark_server_encoding_task");
+}
+
+BenchmarkServerEncodingTask::BenchmarkServerEncodingTask(
+                                                      const ghoul::Dictionary& dictionary)
+{
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+    _nIterations = p.iterations.value_or(_nIterations);
+    _nProperties = p.properties.value_or(_nProperties);
+}
+
+std::string BenchmarkServerEncodingTask::description() {
+    return std::format(
+        "Encode server messages {} times with each encoding and report size and time",
+        _nIterations
+    );
+}
+
+void BenchmarkServerEncodingTask::perform(const Task::ProgressCallback& onProgress) {
+    onProgress(0.f);
+
+    const std::array<std::pair<std::string_view, nlohmann::json>, 3> messages = {
+        std::pair("Camera", cameraMessage()),
+        std::pair("Time", timeMessage()),
+        std::pair("Properties", propertiesMessage(_nProperties))
+    };
+
+    std::string buffer;
+    for (size_t i = 0; i < messages.size(); i++) {
+        const auto& [name, message] = messages[i];
+
+        size_t jsonSize = 0;
+        double jsonNanoseconds = 0.0;
+        for (const auto& [encoding, encodingName] : Encodings) {
+            const auto t0 = std::chrono::high_resolution_clock::now();
+            for (int j = 0; j < _nIterations; j++) {
+                Connection::encode(message, encoding, buffer);
+            }
+            const auto t1 = std::chrono::high_resolution_clock::now();
+            const double nanoseconds =
+                std::chrono::duration<double, std::nano>(t1 - t0).count() / _nIterations;
+
+            if (encoding == Encoding::Json) {
+                jsonSize = buffer.size();
+                jsonNanoseconds = nanoseconds;
+            }
+            LINFO(std::format(
+                "{} message as {}: {} bytes ({:.0f}% of JSON), "
+                "{:.0f} ns per message ({:.0f}% of JSON)",
+                name, encodingName,
+                buffer.size(), 100.0 * buffer.size() / jsonSize,
+                nanoseconds, 100.0 * nanoseconds / jsonNanoseconds
+            ));
+        }
+
+        onProgress(static_cast<float>(i + 1) / static_cast<float>(messages.size()));
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,57 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___BENCHMARKSERVERENCODINGTASK___H__
+#define __OPENSPACE_MODULE_SERVER___BENCHMARKSERVERENCODINGTASK___H__
+
+#include <openspace/util/task.h>
+
+#include <string>
+
+namespace openspace {
+
+namespace documentation { struct Documentation; }
+
+/**
+ * Serializes messages that are typical for the frequently updated topics of the server
+ * module with each of the encodings supported by a Connection and reports the size and
+ * the time it takes to encode each message compared to JSON.
+ */
+class BenchmarkServerEncodingTask : public Task {
+public:
+    BenchmarkServerEncodingTask(const ghoul::Dictionary& dictionary);
+    ~BenchmarkServerEncodingTask() override = default;
+
+    std::string description() override;
+    void perform(const Task::ProgressCallback& onProgress) override;
+    static documentation::Documentation Documentation();
+
+private:
+    int _nIterations = 100000;
+    int _nProperties = 100;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___BENCHMARKSERVERENCODINGTASK___H__
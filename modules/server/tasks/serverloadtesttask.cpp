@@ -0,0 +1,344 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/server/tasks/serverloadtesttask.h>
+
+#include <modules/server/include/nativesocket.h>
+#include <modules/server/include/reactor.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <openspace/json.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr std::string_view _loggerCat = "ServerLoadTestTask";
+
+    using Clock = std::chrono::steady_clock;
+
+    // The topic id that is used by the clients to authorize themselves
+    constexpr int AuthorizationTopicId = 0;
+
+    // The topic id that is used by the clients to send the measured messages
+    constexpr int BounceTopicId = 1;
+
+    // A minimal blocking client that speaks the newline-delimited TCP protocol
+    class Client {
+    public:
+        Client() = default;
+        Client(const Client&) = delete;
+        ~Client() {
+            if (_handle != openspace::nativesocket::InvalidHandle) {
+                openspace::nativesocket::close(_handle);
+            }
+        }
+
+        bool connect(const std::string& address, int port) {
+            _handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (_handle == openspace::nativesocket::InvalidHandle) {
+                return false;
+            }
+
+            sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+                return false;
+            }
+            const sockaddr* a = reinterpret_cast<sockaddr*>(&addr);
+            return ::connect(_handle, a, sizeof(addr)) == 0 &&
+                   openspace::nativesocket::configure(_handle, false);
+        }
+
+        bool send(std::string message) {
+            message += '\n';
+            size_t offset = 0;
+            while (offset < message.size()) {
+                const auto n = ::send(
+                    _handle,
+                    message.data() + offset,
+                    static_cast<int>(message.size() - offset),
+                    openspace::nativesocket::SendFlags
+                );
+                if (n <= 0) {
+                    return false;
+                }
+                offset += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool receive(std::string& message) {
+            size_t end = _buffer.find('\n');
+            while (end == std::string::npos) {
+                std::array<char, 4096> chunk;
+                const auto n = ::recv(
+                    _handle,
+                    chunk.data(),
+                    static_cast<int>(chunk.size()),
+                    0
+                );
+                if (n <= 0) {
+                    return false;
+                }
+                const size_t previousSize = _buffer.size();
+                _buffer.append(chunk.data(), static_cast<size_t>(n));
+                end = _buffer.find('\n', previousSize);
+            }
+            message = _buffer.substr(0, end);
+            _buffer.erase(0, end + 1);
+            return true;
+        }
+
+    private:
+        openspace::nativesocket::Handle _handle = openspace::nativesocket::InvalidHandle;
+        std::string _buffer;
+    };
+
+    // Serves the clients from a Reactor in this process that echoes every message. This
+    // measures the networking layer in isolation from the rest of the engine
+    class EchoServer {
+    public:
+        EchoServer()
+            : _listener(_reactor.listen(0, openspace::ReactorSocket::Protocol::Tcp))
+            , _thread([this]() { run(); })
+        {}
+
+        ~EchoServer() {
+            _shouldStop = true;
+            _thread.join();
+        }
+
+        int port() const {
+            return _reactor.port(_listener);
+        }
+
+    private:
+        void run() {
+            std::vector<std::shared_ptr<openspace::ReactorSocket>> sockets;
+            std::string message;
+            while (!_shouldStop) {
+                while (auto socket = _reactor.nextPendingSocket(_listener)) {
+                    sockets.push_back(std::move(socket));
+                }
+
+                bool hasProcessedMessage = false;
+                for (const std::shared_ptr<openspace::ReactorSocket>& socket : sockets) {
+                    while (socket->nextMessage(message)) {
+                        socket->putMessage(message);
+                        hasProcessedMessage = true;
+                    }
+                }
+                std::erase_if(
+                    sockets,
+                    [](const std::shared_ptr<openspace::ReactorSocket>& socket) {
+                        return !socket->isConnected();
+                    }
+                );
+
+                // The engine polls its connections once per frame, so there is no
+                // notification when messages arrive that we could wait for
+                if (!hasProcessedMessage) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        openspace::Reactor _reactor;
+        const openspace::Reactor::ListenerId _listener;
+        std::atomic_bool _shouldStop = false;
+        std::thread _thread;
+    };
+
+    double percentile(const std::vector<double>& sortedValues, double p) {
+        if (sortedValues.empty()) {
+            return 0.0;
+        }
+        const size_t index = static_cast<size_t>(p * (sortedValues.size() - 1) + 0.5);
+        return sortedValues[std::min(index, sortedValues.size() - 1)];
+    }
+
+    // This task connects a number of concurrent clients to a TCP server interface and
+    // measures the round trip times of messages that are sent to the 'bounce' topic.
+    // Each client waits for the response to its message before sending the next one
+    struct [[codegen::Dictionary(ServerLoadTestTask)]] Parameters {
+        // The address of the server. Only IPv4 addresses are supported
+        std::optional<std::string> address;
+
+        // The port of a TCP server interface of a running instance. If this value is
+        // not specified, the clients connect to an echo server that is started by this
+        // task, which measures the networking layer without the rest of the engine
+        std::optional<int> port [[codegen::inrange(1, 65535)]];
+
+        // The number of clients that are connected concurrently
+        std::optional<int> clients [[codegen::greater(0)]];
+
+        // The number of messages that each client sends
+        std::optional<int> messagesPerClient [[codegen::greater(0)]];
+
+        // The password that is used to authorize the clients if the server interface
+        // requires it
+        std::optional<std::string> password;
+    };
+#include "serverloadtesttask_codegen.cpp"
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation ServerLoadTestTask::Documentation() {
+    return codegen::doc<Parameters>("server_load_test_task");
+}
+
+ServerLoadTestTask::ServerLoadTestTask(const ghoul::Dictionary& dictionary) {
+    const Parameters p = codegen::bake<Parameters>(dictionary);
+
+    _address = p.address.value_or("127.0.0.1");
+    _port = p.port;
+    _nClients = p.clients.value_or(_nClients);
+    _nMessagesPerClient = p.messagesPerClient.value_or(_nMessagesPerClient);
+    _password = p.password;
+}
+
+std::string ServerLoadTestTask::description() {
+    return std::format(
+        "Send {} messages from each of {} concurrent clients to {} and report the round "
+        "trip times",
+        _nMessagesPerClient, _nClients,
+        _port.has_value() ? std::format("{}:{}", _address, *_port) : "an echo server"
+    );
+}
+
+void ServerLoadTestTask::perform(const Task::ProgressCallback& onProgress) {
+    onProgress(0.f);
+
+    nativesocket::initialize();
+
+    std::unique_ptr<EchoServer> echoServer;
+    if (!_port.has_value()) {
+        echoServer = std::make_unique<EchoServer>();
+    }
+    const std::string address = echoServer ? "127.0.0.1" : _address;
+    const int port = echoServer ? echoServer->port() : *_port;
+
+    std::vector<std::vector<double>> latencies(_nClients);
+    std::atomic_int nFailedClients = 0;
+    std::atomic_int nFinishedMessages = 0;
+
+    auto runClient = [&](int clientIndex) {
+        Client client;
+        if (!client.connect(address, port)) {
+            nFailedClients++;
+            return;
+        }
+
+        std::string response;
+        if (_password.has_value()) {
+            const nlohmann::json authorization = {
+                { "topic", AuthorizationTopicId },
+                { "type", "authorize" },
+                { "payload", { { "key", *_password } } }
+            };
+            if (!client.send(authorization.dump()) || !client.receive(response)) {
+                nFailedClients++;
+                return;
+            }
+        }
+
+        std::vector<double>& result = latencies[clientIndex];
+        result.reserve(_nMessagesPerClient);
+        for (int i = 0; i < _nMessagesPerClient; i++) {
+            nlohmann::json message = {
+                { "topic", BounceTopicId },
+                { "payload", { { "client", clientIndex }, { "sequence", i } } }
+            };
+            if (i == 0) {
+                // The type is only needed when the topic is created
+                message["type"] = "bounce";
+            }
+
+            const Clock::time_point start = Clock::now();
+            if (!client.send(message.dump()) || !client.receive(response)) {
+                nFailedClients++;
+                return;
+            }
+            const Clock::time_point end = Clock::now();
+            const std::chrono::duration<double, std::milli> duration = end - start;
+            result.push_back(duration.count());
+            nFinishedMessages++;
+        }
+    };
+
+    const Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(_nClients);
+    for (int i = 0; i < _nClients; i++) {
+        threads.emplace_back(runClient, i);
+    }
+
+    const int nTotalMessages = _nClients * _nMessagesPerClient;
+    while (nFinishedMessages + nFailedClients * _nMessagesPerClient < nTotalMessages) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        onProgress(static_cast<float>(nFinishedMessages) / nTotalMessages);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    echoServer = nullptr;
+    nativesocket::deinitialize();
+
+    std::vector<double> all;
+    all.reserve(nTotalMessages);
+    for (const std::vector<double>& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    if (nFailedClients > 0) {
+        LWARNING(std::format(
+            "{} of {} clients lost their connection", nFailedClients.load(), _nClients
+        ));
+    }
+    LINFO(std::format(
+        "{} messages in {:.3f} s ({:.0f} messages/s)",
+        all.size(), seconds, all.size() / seconds
+    ));
+    LINFO(std::format(
+        "Round trip time: p50 {:.3f} ms, p90 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+        percentile(all, 0.5), percentile(all, 0.9), percentile(all, 0.99),
+        all.empty() ? 0.0 : all.back()
+    ));
+
+    onProgress(1.f);
+}
+
+} // namespace openspace
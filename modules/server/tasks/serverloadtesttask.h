@@ -0,0 +1,62 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SERVER___SERVERLOADTESTTASK___H__
+#define __OPENSPACE_MODULE_SERVER___SERVERLOADTESTTASK___H__
+
+#include <openspace/util/task.h>
+
+#include <optional>
+#include <string>
+
+namespace openspace {
+
+namespace documentation { struct Documentation; }
+
+/**
+ * Connects a number of concurrent clients to a TCP server interface and lets each of
+ * them send a sequence of messages to the `bounce` topic, each time waiting for the
+ * response before sending the next message. The throughput and the distribution of the
+ * round trip times are reported when all clients are finished.
+ */
+class ServerLoadTestTask : public Task {
+public:
+    ServerLoadTestTask(const ghoul::Dictionary& dictionary);
+    ~ServerLoadTestTask() override = default;
+
+    std::string description() override;
+    void perform(const Task::ProgressCallback& onProgress) override;
+    static documentation::Documentation Documentation();
+
+private:
+    std::string _address;
+    std::optional<int> _port;
+    int _nClients = 32;
+    int _nMessagesPerClient = 1000;
+    std::optional<std::string> _password;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SERVER___SERVERLOADTESTTASK___H__
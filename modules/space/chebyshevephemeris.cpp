@@ -0,0 +1,436 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/chebyshevephemeris.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numbers>
+
+namespace {
+    constexpr std::string_view _loggerCat = "ChebyshevEphemeris";
+
+    constexpr int8_t CurrentCacheVersion = 2;
+
+    // The number of points at which each segment is validated per sample node
+    constexpr int ValidationDensity = 2;
+
+    // Thrown from the sampled function to abort a fit on a background thread. This is
+    // deliberately not a ghoul::RuntimeError, which would only leave a gap
+    struct FitCancelled {};
+
+    // Evaluates the Chebyshev series with the n+1 coefficients c at x in [-1, 1] using
+    // Clenshaw's recurrence
+    double clenshaw(const double* c, int n, double x) {
+        double b1 = 0.0;
+        double b2 = 0.0;
+        for (int j = n; j >= 1; j--) {
+            const double b0 = 2.0 * x * b1 - b2 + c[j];
+            b2 = b1;
+            b1 = b0;
+        }
+        return x * b1 - b2 + c[0];
+    }
+
+    struct Fitter {
+        int nComponents = 0;
+        const openspace::ChebyshevEphemeris::FitSettings& settings;
+        const openspace::ChebyshevEphemeris::Function& function;
+
+        std::vector<double> segments;
+        std::vector<double> coefficients;
+        int nInaccurateSegments = 0;
+
+        // Returns false if the function could not be evaluated at the time
+        bool sample(double time, std::span<double> values) const {
+            try {
+                function(time, values);
+                return true;
+            }
+            catch (const ghoul::RuntimeError&) {
+                return false;
+            }
+        }
+
+        void fitSegment(double start, double end) {
+            const int degree = settings.degree;
+            const int nNodes = degree + 1;
+            const double mid = (start + end) / 2.0;
+            const double halfLength = (end - start) / 2.0;
+
+            // Sample the function at the Chebyshev nodes of the first kind
+            std::vector<double> values(static_cast<size_t>(nNodes * nComponents));
+            int nFailed = 0;
+            for (int k = 0; k < nNodes; k++) {
+                const double x = std::cos(std::numbers::pi * (k + 0.5) / nNodes);
+                std::span<double> v = std::span(values).subspan(
+                    static_cast<size_t>(k * nComponents),
+                    static_cast<size_t>(nComponents)
+                );
+                if (!sample(mid + halfLength * x, v)) {
+                    nFailed++;
+                }
+            }
+            if (nFailed == nNodes) {
+                // The function is not available anywhere in this segment, so we leave a
+                // gap instead of subdividing it over and over again
+                return;
+            }
+
+            std::vector<double> c(static_cast<size_t>(nNodes * nComponents), 0.0);
+            bool isAccurate = false;
+            if (nFailed == 0) {
+                for (int i = 0; i < nComponents; i++) {
+                    for (int j = 0; j < nNodes; j++) {
+                        double sum = 0.0;
+                        for (int k = 0; k < nNodes; k++) {
+                            sum += values[k * nComponents + i] *
+                                std::cos(std::numbers::pi * j * (k + 0.5) / nNodes);
+                        }
+                        c[i * nNodes + j] = 2.0 * sum / nNodes;
+                    }
+                    c[i * nNodes] /= 2.0;
+                }
+
+                // Validate on a grid that is denser than the sample nodes and includes
+                // the ends of the segment. The points are the extrema of a Chebyshev
+                // polynomial of a higher degree, so they lie in between the sample nodes
+                // and are denser towards the ends where the error tends to be largest
+                isAccurate = true;
+                std::vector<double> expected(static_cast<size_t>(nComponents));
+                const int nValidation = ValidationDensity * nNodes;
+                for (int k = 0; k <= nValidation && isAccurate; k++) {
+                    const double x = std::cos(std::numbers::pi * k / nValidation);
+                    if (!sample(mid + halfLength * x, expected)) {
+                        isAccurate = false;
+                        continue;
+                    }
+                    double error = 0.0;
+                    for (int i = 0; i < nComponents; i++) {
+                        const double approx = clenshaw(&c[i * nNodes], degree, x);
+                        error += (approx - expected[i]) * (approx - expected[i]);
+                    }
+                    isAccurate = std::sqrt(error) <= settings.accuracy;
+                }
+            }
+
+            if (!isAccurate && end - start >= 2.0 * settings.minimumSegmentLength) {
+                fitSegment(start, mid);
+                fitSegment(mid, end);
+                return;
+            }
+            if (nFailed > 0) {
+                // Partially covered segment that is too short to be subdivided further
+                return;
+            }
+
+            if (!isAccurate) {
+                nInaccurateSegments++;
+            }
+            segments.push_back(start);
+            segments.push_back(end);
+            coefficients.insert(coefficients.end(), c.begin(), c.end());
+        }
+    };
+} // namespace
+
+namespace openspace {
+
+ChebyshevEphemeris ChebyshevEphemeris::fit(int nComponents, const FitSettings& settings,
+                                           const Function& function)
+{
+    ZoneScoped;
+
+    ghoul_assert(nComponents > 0, "nComponents must be positive");
+    ghoul_assert(settings.start < settings.end, "Start must be before the end");
+    ghoul_assert(settings.degree > 0, "Degree must be positive");
+    ghoul_assert(settings.segmentLength > 0.0, "Segment length must be positive");
+
+    Fitter fitter = {
+        .nComponents = nComponents,
+        .settings = settings,
+        .function = function
+    };
+    for (double t = settings.start; t < settings.end; t += settings.segmentLength) {
+        fitter.fitSegment(t, std::min(t + settings.segmentLength, settings.end));
+    }
+
+    if (fitter.nInaccurateSegments > 0) {
+        LWARNING(std::format(
+            "{} segments did not reach the requested accuracy of {} with the minimum "
+            "segment length of {} seconds",
+            fitter.nInaccurateSegments, settings.accuracy, settings.minimumSegmentLength
+        ));
+    }
+
+    ChebyshevEphemeris res;
+    res._nComponents = nComponents;
+    res._degree = settings.degree;
+    res._segments.reserve(fitter.segments.size() / 2);
+    for (size_t i = 0; i < fitter.segments.size(); i += 2) {
+        res._segments.push_back({ fitter.segments[i], fitter.segments[i + 1] });
+    }
+    res._coefficients = std::move(fitter.coefficients);
+    return res;
+}
+
+std::filesystem::path ChebyshevEphemeris::cacheFile(std::string_view information,
+                                                   int nComponents,
+                                                   const FitSettings& settings)
+{
+    const std::string info = std::format(
+        "{}|{}|{}|{}|{}|{}|{}|{}",
+        information, nComponents, settings.start, settings.end, settings.degree,
+        settings.accuracy, settings.segmentLength, settings.minimumSegmentLength
+    );
+    return FileSys.cacheManager()->cachedFilename("ephemeris.bin", info);
+}
+
+ChebyshevEphemeris ChebyshevEphemeris::loadOrFit(std::string_view name,
+                                                 const std::filesystem::path& cacheFile,
+                                                 int nComponents,
+                                                 const FitSettings& settings,
+                                                 const Function& function)
+{
+    ZoneScoped;
+
+    if (std::filesystem::is_regular_file(cacheFile)) {
+        std::optional<ChebyshevEphemeris> ephemeris = load(cacheFile);
+        if (ephemeris.has_value()) {
+            return *std::move(ephemeris);
+        }
+        LWARNING(std::format("Ignoring invalid cached ephemeris '{}'", cacheFile));
+    }
+
+    LINFO(std::format("Sampling ephemeris for '{}'", name));
+    ChebyshevEphemeris ephemeris = fit(nComponents, settings, function);
+    ephemeris.save(cacheFile);
+    return ephemeris;
+}
+
+const ChebyshevEphemeris::Segment* ChebyshevEphemeris::segment(double time) const {
+    auto it = std::upper_bound(
+        _segments.begin(),
+        _segments.end(),
+        time,
+        [](double t, const Segment& s) { return t < s.start; }
+    );
+    if (it == _segments.begin()) {
+        return nullptr;
+    }
+    --it;
+    return time <= it->end ? &*it : nullptr;
+}
+
+bool ChebyshevEphemeris::covers(double time) const {
+    return segment(time) != nullptr;
+}
+
+bool ChebyshevEphemeris::evaluate(double time, std::span<double> values) const {
+    ghoul_assert(
+        values.size() >= static_cast<size_t>(_nComponents),
+        "Not enough room for the values"
+    );
+
+    const Segment* s = segment(time);
+    if (!s) {
+        return false;
+    }
+
+    const size_t index = static_cast<size_t>(s - _segments.data());
+    const size_t nCoefficients = static_cast<size_t>(_degree + 1);
+    const double* c = &_coefficients[index * _nComponents * nCoefficients];
+    const double x = (2.0 * time - s->start - s->end) / (s->end - s->start);
+    for (int i = 0; i < _nComponents; i++) {
+        values[i] = clenshaw(c + i * nCoefficients, _degree, x);
+    }
+    return true;
+}
+
+int ChebyshevEphemeris::nComponents() const {
+    return _nComponents;
+}
+
+size_t ChebyshevEphemeris::nSegments() const {
+    return _segments.size();
+}
+
+void ChebyshevEphemeris::save(const std::filesystem::path& file) const {
+    std::ofstream stream(file, std::ofstream::binary);
+    if (!stream.good()) {
+        LERROR(std::format("Error opening file '{}' for saving the ephemeris", file));
+        return;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+    const int32_t nComponents = _nComponents;
+    stream.write(reinterpret_cast<const char*>(&nComponents), sizeof(int32_t));
+    const int32_t degree = _degree;
+    stream.write(reinterpret_cast<const char*>(&degree), sizeof(int32_t));
+    const uint64_t nSegments = _segments.size();
+    stream.write(reinterpret_cast<const char*>(&nSegments), sizeof(uint64_t));
+    stream.write(
+        reinterpret_cast<const char*>(_segments.data()),
+        _segments.size() * sizeof(Segment)
+    );
+    stream.write(
+        reinterpret_cast<const char*>(_coefficients.data()),
+        _coefficients.size() * sizeof(double)
+    );
+}
+
+std::optional<ChebyshevEphemeris> ChebyshevEphemeris::load(
+                                                        const std::filesystem::path& file)
+{
+    std::ifstream stream(file, std::ifstream::binary);
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+
+    int8_t version = 0;
+    stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+    if (version != CurrentCacheVersion) {
+        return std::nullopt;
+    }
+
+    int32_t nComponents = 0;
+    stream.read(reinterpret_cast<char*>(&nComponents), sizeof(int32_t));
+    int32_t degree = 0;
+    stream.read(reinterpret_cast<char*>(&degree), sizeof(int32_t));
+    uint64_t nSegments = 0;
+    stream.read(reinterpret_cast<char*>(&nSegments), sizeof(uint64_t));
+    if (!stream.good() || nComponents <= 0 || degree <= 0) {
+        return std::nullopt;
+    }
+
+    // Guard against truncated files before allocating any memory
+    const uint64_t nCoefficients = nSegments * nComponents * (degree + 1);
+    const uint64_t expectedSize = sizeof(int8_t) + 2 * sizeof(int32_t) +
+        sizeof(uint64_t) + nSegments * sizeof(Segment) + nCoefficients * sizeof(double);
+    if (std::filesystem::file_size(file) != expectedSize) {
+        return std::nullopt;
+    }
+
+    ChebyshevEphemeris res;
+    res._nComponents = nComponents;
+    res._degree = degree;
+    res._segments.resize(nSegments);
+    stream.read(
+        reinterpret_cast<char*>(res._segments.data()),
+        nSegments * sizeof(Segment)
+    );
+    res._coefficients.resize(nCoefficients);
+    stream.read(
+        reinterpret_cast<char*>(res._coefficients.data()),
+        res._coefficients.size() * sizeof(double)
+    );
+    if (!stream.good()) {
+        return std::nullopt;
+    }
+    return res;
+}
+
+BackgroundEphemeris::~BackgroundEphemeris() {
+    reset();
+}
+
+void BackgroundEphemeris::start(std::string name, std::filesystem::path cacheFile,
+                                int nComponents, ChebyshevEphemeris::FitSettings settings,
+                                ChebyshevEphemeris::Function function)
+{
+    ghoul_assert(isIdle(), "Ephemeris is already available or being created");
+
+    _isCancelled = std::make_shared<std::atomic_bool>(false);
+    _pending = std::async(
+        std::launch::async,
+        [name = std::move(name), cacheFile = std::move(cacheFile), nComponents,
+         settings, function = std::move(function), isCancelled = _isCancelled]()
+        {
+            auto f = [&function, &isCancelled](double time, std::span<double> values) {
+                if (*isCancelled) {
+                    throw FitCancelled();
+                }
+                function(time, values);
+            };
+            return ChebyshevEphemeris::loadOrFit(
+                name,
+                cacheFile,
+                nComponents,
+                settings,
+                f
+            );
+        }
+    );
+}
+
+void BackgroundEphemeris::update() {
+    if (!_pending.valid() ||
+        _pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return;
+    }
+
+    try {
+        _ephemeris = _pending.get();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+        _hasFailed = true;
+    }
+    catch (const std::exception& e) {
+        LERROR(e.what());
+        _hasFailed = true;
+    }
+    _isCancelled = nullptr;
+}
+
+void BackgroundEphemeris::reset() {
+    if (_pending.valid()) {
+        // The destructor of the future waits for the thread, which stops at the next
+        // sample now
+        *_isCancelled = true;
+        _pending = std::future<ChebyshevEphemeris>();
+    }
+    _isCancelled = nullptr;
+    _ephemeris = std::nullopt;
+    _hasFailed = false;
+}
+
+bool BackgroundEphemeris::isIdle() const {
+    return !_ephemeris.has_value() && !_pending.valid() && !_hasFailed;
+}
+
+const ChebyshevEphemeris* BackgroundEphemeris::ephemeris() const {
+    return _ephemeris.has_value() ? &*_ephemeris : nullptr;
+}
+
+} // namespace openspace
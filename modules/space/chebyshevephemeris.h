@@ -0,0 +1,245 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___CHEBYSHEVEPHEMERIS___H__
+#define __OPENSPACE_MODULE_SPACE___CHEBYSHEVEPHEMERIS___H__
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A piecewise Chebyshev approximation of a vector-valued function of time, such as the
+ * position of a body or the elements of a rotation matrix. The covered time window is
+ * split into segments that are each approximated by a Chebyshev series of a fixed
+ * degree. Segments are subdivided until the approximation matches the sampled function
+ * within a requested accuracy, so that quickly changing phases, such as a spacecraft
+ * flyby, receive shorter segments than slow ones.
+ *
+ * Once created, an ephemeris is immutable and can be evaluated concurrently from any
+ * number of threads. Evaluating it does not call the function it was created from, which
+ * makes it possible to replace expensive and non-thread-safe SPICE calls in the frame
+ * loop.
+ */
+class ChebyshevEphemeris {
+public:
+    /**
+     * The function that is approximated. It is called with a time and has to write
+     * one value per component into the provided span. If the function cannot be
+     * evaluated at the requested time, it should throw a ghoul::RuntimeError, in which
+     * case the time is left uncovered by the ephemeris.
+     */
+    using Function = std::function<void(double time, std::span<double> values)>;
+
+    struct FitSettings {
+        /// The beginning of the time window that is covered
+        double start = 0.0;
+        /// The end of the time window that is covered
+        double end = 0.0;
+        /// The degree of the Chebyshev series used for each segment
+        int degree = 12;
+        /// The maximum allowed Euclidean distance between the approximation and the
+        /// function over all components
+        double accuracy = 1.0;
+        /// The length of the segments before they are subdivided
+        double segmentLength = 86400.0;
+        /// Segments are not subdivided further than this length
+        double minimumSegmentLength = 60.0;
+    };
+
+    /**
+     * Samples the \p function across the time window described by the \p settings and
+     * creates the approximation.
+     *
+     * \param nComponents The number of values that the \p function produces
+     * \param settings The time window and accuracy of the approximation
+     * \param function The function that is approximated
+     * \return The piecewise approximation of the \p function
+     *
+     * \pre \p nComponents must be positive
+     * \pre The `start` of the \p settings must be smaller than the `end`
+     * \pre The `degree` of the \p settings must be positive
+     */
+    static ChebyshevEphemeris fit(int nComponents, const FitSettings& settings,
+        const Function& function);
+
+    /**
+     * Returns the path of the file in which the ephemeris for the provided
+     * \p information and \p settings is cached. This function uses the cache manager
+     * and must only be called from the main thread.
+     *
+     * \param information Identifies the function in the cache and has to include
+     *        everything that changes the values of the function, for example the names
+     *        of the target and observer and the loaded kernels
+     * \param nComponents The number of values that the function produces
+     * \param settings The time window and accuracy of the approximation
+     * \return The path of the cache file, which might not exist yet
+     */
+    static std::filesystem::path cacheFile(std::string_view information, int nComponents,
+        const FitSettings& settings);
+
+    /**
+     * Returns the ephemeris stored in the \p cacheFile, or creates it using #fit and
+     * stores it in the \p cacheFile if there is none. This function can be called from
+     * any thread.
+     *
+     * \param name A human-readable name of the \p function used for logging
+     * \param cacheFile The file returned by #cacheFile for the \p function
+     * \param nComponents The number of values that the \p function produces
+     * \param settings The time window and accuracy of the approximation
+     * \param function The function that is approximated if no cached ephemeris exists
+     * \return The piecewise approximation of the \p function
+     */
+    static ChebyshevEphemeris loadOrFit(std::string_view name,
+        const std::filesystem::path& cacheFile, int nComponents,
+        const FitSettings& settings, const Function& function);
+
+    /**
+     * Returns `true` if the ephemeris contains a segment that covers the \p time.
+     */
+    bool covers(double time) const;
+
+    /**
+     * Evaluates the approximation at the provided \p time and stores one value per
+     * component in \p values.
+     *
+     * \param time The time at which the approximation is evaluated
+     * \param values The destination for the values, which must have room for one value
+     *        per component
+     * \return `true` if the \p time is covered by the ephemeris, `false` otherwise, in
+     *         which case \p values is not modified
+     */
+    bool evaluate(double time, std::span<double> values) const;
+
+    /**
+     * Returns the number of values that each evaluation produces.
+     */
+    int nComponents() const;
+
+    /**
+     * Returns the number of segments that cover the time window.
+     */
+    size_t nSegments() const;
+
+    /**
+     * Writes the ephemeris into the provided \p file.
+     */
+    void save(const std::filesystem::path& file) const;
+
+    /**
+     * Reads an ephemeris from the provided \p file that was previously written with
+     * #save.
+     *
+     * \return The ephemeris stored in the \p file, or `std::nullopt` if the \p file could
+     *         not be read or was written by a different version
+     */
+    static std::optional<ChebyshevEphemeris> load(const std::filesystem::path& file);
+
+private:
+    struct Segment {
+        double start = 0.0;
+        double end = 0.0;
+    };
+
+    /// Returns the segment that covers the \p time or `nullptr` if there is none
+    const Segment* segment(double time) const;
+
+    int _nComponents = 0;
+    int _degree = 0;
+    /// The sorted, non-overlapping segments. There might be gaps between segments if
+    /// the function could not be evaluated for a time
+    std::vector<Segment> _segments;
+    /// For each segment, the `_degree + 1` coefficients of each component
+    std::vector<double> _coefficients;
+};
+
+/**
+ * Creates a ChebyshevEphemeris on a background thread, so that sampling the function does
+ * not stall the frame in which the ephemeris is needed for the first time. Until the
+ * ephemeris is available, the function has to be evaluated directly instead.
+ */
+class BackgroundEphemeris {
+public:
+    BackgroundEphemeris() = default;
+    BackgroundEphemeris(const BackgroundEphemeris&) = delete;
+    BackgroundEphemeris& operator=(const BackgroundEphemeris&) = delete;
+
+    /**
+     * Cancels a fit that is still running and waits for its thread to finish.
+     */
+    ~BackgroundEphemeris();
+
+    /**
+     * Starts creating the ephemeris on a background thread using
+     * ChebyshevEphemeris::loadOrFit. The \p function is called from that thread, so it
+     * must not refer to any state that is changed elsewhere.
+     *
+     * \pre No ephemeris must be available or in the process of being created
+     */
+    void start(std::string name, std::filesystem::path cacheFile, int nComponents,
+        ChebyshevEphemeris::FitSettings settings, ChebyshevEphemeris::Function function);
+
+    /**
+     * Makes the ephemeris available if its creation has finished. Has to be called
+     * regularly, for example once per frame.
+     */
+    void update();
+
+    /**
+     * Discards the ephemeris or cancels its creation, for example because the function
+     * that is approximated has changed. Afterwards, #start can be called again.
+     */
+    void reset();
+
+    /**
+     * Returns `true` if the ephemeris is neither available nor being created.
+     */
+    bool isIdle() const;
+
+    /**
+     * Returns the ephemeris or `nullptr` if it is not available yet.
+     */
+    const ChebyshevEphemeris* ephemeris() const;
+
+private:
+    std::optional<ChebyshevEphemeris> _ephemeris;
+    std::future<ChebyshevEphemeris> _pending;
+    /// Set to cancel the pending fit, which is shared with its thread
+    std::shared_ptr<std::atomic_bool> _isCancelled;
+    /// Set if the creation failed, so that it is not restarted in every frame
+    bool _hasFailed = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___CHEBYSHEVEPHEMERIS___H__
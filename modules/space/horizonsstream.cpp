@@ -0,0 +1,326 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/horizonsstream.h>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+    constexpr int8_t CurrentFileVersion = 1;
+
+    // Keyframes are considered to be equally spaced if none of them deviates from the
+    // uniform grid by more than this fraction of the step
+    constexpr double UniformStepTolerance = 1e-6;
+} // namespace
+
+namespace openspace {
+
+void HorizonsStream::save(const std::filesystem::path& file,
+                          std::span<const Keyframe> keyframes)
+{
+    ZoneScoped;
+
+    ghoul_assert(keyframes.size() >= 2, "At least two keyframes are required");
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+    static_assert(std::is_trivially_copyable_v<Keyframe>);
+    static_assert(sizeof(Keyframe) == 4 * sizeof(double));
+
+    Header header = {
+        .version = CurrentFileVersion,
+        .nKeyframes = keyframes.size(),
+        .startTime = keyframes.front().timestamp
+    };
+
+    const double step = (keyframes.back().timestamp - keyframes.front().timestamp) /
+        static_cast<double>(keyframes.size() - 1);
+    bool isUniform = step > 0.0;
+    for (size_t i = 0; i < keyframes.size() && isUniform; i++) {
+        const double expected = header.startTime + static_cast<double>(i) * step;
+        isUniform = std::abs(keyframes[i].timestamp - expected) <=
+                    step * UniformStepTolerance;
+    }
+    header.step = isUniform ? step : 0.0;
+
+    std::ofstream stream(file, std::ofstream::binary);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    stream.write(
+        reinterpret_cast<const char*>(keyframes.data()),
+        keyframes.size() * sizeof(Keyframe)
+    );
+    if (!stream.good()) {
+        throw ghoul::RuntimeError(std::format("Error writing keyframes to '{}'", file));
+    }
+}
+
+std::unique_ptr<HorizonsStream> HorizonsStream::open(const std::filesystem::path& file,
+                                                     size_t windowSize)
+{
+    ghoul_assert(windowSize >= 4, "The window must contain at least 4 keyframes");
+
+    std::ifstream stream(file, std::ifstream::binary);
+    if (!stream.good()) {
+        return nullptr;
+    }
+
+    Header header;
+    stream.read(reinterpret_cast<char*>(&header), sizeof(Header));
+    if (!stream.good() || header.version != CurrentFileVersion ||
+        header.nKeyframes < 2 || !(header.step >= 0.0))
+    {
+        return nullptr;
+    }
+
+    // Every keyframe is accessed by its offset, so the file has to contain all of them
+    const uintmax_t size = std::filesystem::file_size(file);
+    if (size < sizeof(Header) ||
+        (size - sizeof(Header)) / sizeof(Keyframe) != header.nKeyframes ||
+        (size - sizeof(Header)) % sizeof(Keyframe) != 0)
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<HorizonsStream>(new HorizonsStream(file, header, windowSize));
+}
+
+HorizonsStream::HorizonsStream(std::filesystem::path file, const Header& header,
+                               size_t windowSize)
+    : _path(std::move(file))
+    , _header(header)
+    , _windowSize(std::min<size_t>(windowSize, header.nKeyframes))
+    , _lastTime(header.startTime)
+    , _file(_path, std::ifstream::binary)
+{
+    _window = readWindow(_path, 0, _windowSize);
+}
+
+HorizonsStream::~HorizonsStream() {
+    if (_prefetch.valid()) {
+        _prefetch.wait();
+    }
+}
+
+void HorizonsStream::update(double time) {
+    ZoneScoped;
+
+    const std::lock_guard lock(_mutex);
+
+    if (time != _lastTime) {
+        _isMovingForward = time > _lastTime;
+        _lastTime = time;
+    }
+
+    const size_t index = keyframeIndex(time);
+
+    // Switch to the prefetched window as soon as it is available. If time has already
+    // left the current window, waiting for it is still faster than reading it again
+    if (_prefetch.valid()) {
+        const bool isReady =
+            _prefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if (isReady || !contains(_window, index)) {
+            Window window = _prefetch.get();
+            if (contains(window, index)) {
+                _window = std::move(window);
+            }
+        }
+    }
+
+    // Three quarters of a new window lie in the direction in which time is moving
+    const size_t margin = _windowSize / 4;
+    size_t first = 0;
+    if (_isMovingForward) {
+        first = index > margin ? index - margin : 0;
+    }
+    else {
+        const size_t end = index + margin + 2;
+        first = end > _windowSize ? end - _windowSize : 0;
+    }
+    first = std::min(first, _header.nKeyframes - _windowSize);
+
+    if (!contains(_window, index)) {
+        // Time has jumped, for example by the user changing the simulation time
+        _window = readWindow(_path, first, _windowSize);
+        return;
+    }
+
+    if (!_prefetch.valid()) {
+        const size_t windowEnd = _window.first + _window.keyframes.size();
+        const bool isNearEnd = _isMovingForward ?
+            (index + margin >= windowEnd && windowEnd < _header.nKeyframes) :
+            (index < _window.first + margin && _window.first > 0);
+        if (isNearEnd) {
+            _prefetch = std::async(
+                std::launch::async,
+                &HorizonsStream::readWindow,
+                _path,
+                first,
+                _windowSize
+            );
+        }
+    }
+}
+
+glm::dvec3 HorizonsStream::position(double time) const {
+    const std::lock_guard lock(_mutex);
+
+    const size_t index = keyframeIndex(time);
+    const Keyframe before = keyframe(index);
+    const Keyframe after = keyframe(index + 1);
+
+    // Times outside of the trajectory are clamped to the first or last keyframe
+    const double t = std::clamp(
+        (time - before.timestamp) / (after.timestamp - before.timestamp),
+        0.0,
+        1.0
+    );
+    return glm::dvec3(
+        before.position[0] + (after.position[0] - before.position[0]) * t,
+        before.position[1] + (after.position[1] - before.position[1]) * t,
+        before.position[2] + (after.position[2] - before.position[2]) * t
+    );
+}
+
+bool HorizonsStream::isResident(double time) const {
+    const std::lock_guard lock(_mutex);
+    return contains(_window, keyframeIndex(time));
+}
+
+size_t HorizonsStream::nKeyframes() const {
+    return _header.nKeyframes;
+}
+
+double HorizonsStream::startTime() const {
+    return _header.startTime;
+}
+
+double HorizonsStream::endTime() const {
+    const std::lock_guard lock(_mutex);
+    return keyframe(_header.nKeyframes - 1).timestamp;
+}
+
+bool HorizonsStream::hasUniformStep() const {
+    return _header.step > 0.0;
+}
+
+HorizonsStream::Window HorizonsStream::readWindow(const std::filesystem::path& file,
+                                                  size_t first, size_t count)
+{
+    ZoneScoped;
+
+    Window window = { .first = first };
+    window.keyframes.resize(count);
+
+    std::ifstream stream(file, std::ifstream::binary);
+    stream.seekg(sizeof(Header) + first * sizeof(Keyframe));
+    stream.read(
+        reinterpret_cast<char*>(window.keyframes.data()),
+        count * sizeof(Keyframe)
+    );
+    if (!stream.good()) {
+        throw ghoul::RuntimeError(std::format("Error reading keyframes from '{}'", file));
+    }
+    return window;
+}
+
+HorizonsStream::Keyframe HorizonsStream::keyframe(size_t index) const {
+    ghoul_assert(index < _header.nKeyframes, "Index out of bounds");
+
+    if (index >= _window.first && index < _window.first + _window.keyframes.size()) {
+        return _window.keyframes[index - _window.first];
+    }
+
+    Keyframe result;
+    _file.clear();
+    _file.seekg(sizeof(Header) + index * sizeof(Keyframe));
+    _file.read(reinterpret_cast<char*>(&result), sizeof(Keyframe));
+    if (!_file.good()) {
+        throw ghoul::RuntimeError(std::format(
+            "Error reading keyframe {} from '{}'", index, _path
+        ));
+    }
+    return result;
+}
+
+size_t HorizonsStream::keyframeIndex(double time) const {
+    const size_t last = _header.nKeyframes - 2;
+    if (!(time > _header.startTime)) {
+        return 0;
+    }
+
+    if (_header.step > 0.0) {
+        const double offset = (time - _header.startTime) / _header.step;
+        size_t index = offset < static_cast<double>(last) ?
+            static_cast<size_t>(offset) :
+            last;
+
+        // The timestamps might deviate slightly from the uniform grid
+        if (index > 0 && keyframe(index).timestamp > time) {
+            index--;
+        }
+        else if (index < last && keyframe(index + 1).timestamp <= time) {
+            index++;
+        }
+        return index;
+    }
+
+    // Without a uniform step, the window is searched before falling back to a binary
+    // search that reads the keyframes from the file
+    const std::vector<Keyframe>& keyframes = _window.keyframes;
+    if (time >= keyframes.front().timestamp && time < keyframes.back().timestamp) {
+        auto it = std::upper_bound(
+            keyframes.begin(),
+            keyframes.end(),
+            time,
+            [](double t, const Keyframe& kf) { return t < kf.timestamp; }
+        );
+        const size_t offset = static_cast<size_t>(it - keyframes.begin()) - 1;
+        return std::min(_window.first + offset, last);
+    }
+
+    size_t low = 0;
+    size_t high = last;
+    while (low < high) {
+        const size_t mid = low + (high - low + 1) / 2;
+        if (keyframe(mid).timestamp <= time) {
+            low = mid;
+        }
+        else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+bool HorizonsStream::contains(const Window& window, size_t index) {
+    return index >= window.first && index + 1 < window.first + window.keyframes.size();
+}
+
+} // namespace openspace
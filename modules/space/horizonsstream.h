@@ -0,0 +1,169 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___HORIZONSSTREAM___H__
+#define __OPENSPACE_MODULE_SPACE___HORIZONSSTREAM___H__
+
+#include <ghoul/glm.h>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Provides the positions of a Horizons trajectory without loading all of its keyframes
+ * into memory. The keyframes are stored in a binary file with fixed-size records, so the
+ * location of every keyframe in the file can be computed from its index, and if the
+ * keyframes are equally spaced in time, the index of the keyframe before a time can be
+ * computed directly from the time.
+ *
+ * Only a window of keyframes around the time that was last passed to #update is kept in
+ * memory. Most of the window lies in the direction in which time is moving, and once
+ * time approaches the end of the window, the next window is read on a background thread.
+ * Positions for times outside of the window, for example when a trail samples the entire
+ * trajectory, are read directly from the file.
+ *
+ * All member functions can be called concurrently.
+ */
+class HorizonsStream {
+public:
+    struct Keyframe {
+        double timestamp = 0.0;
+        std::array<double, 3> position = {};
+    };
+
+    /**
+     * Writes the \p keyframes into a file that can be opened with #open.
+     *
+     * \param file The file that is written
+     * \param keyframes The keyframes of the trajectory, which have to be sorted by their
+     *        timestamps without duplicates
+     *
+     * \throw RuntimeError If the file could not be written
+     * \pre \p keyframes must contain at least two keyframes
+     */
+    static void save(const std::filesystem::path& file,
+        std::span<const Keyframe> keyframes);
+
+    /**
+     * Opens a file that was written with #save.
+     *
+     * \param file The file containing the keyframes
+     * \param windowSize The number of keyframes that are kept in memory
+     * \return The opened stream or `nullptr` if the \p file could not be read or was
+     *         written by a different version
+     *
+     * \pre \p windowSize must be at least 4
+     */
+    static std::unique_ptr<HorizonsStream> open(const std::filesystem::path& file,
+        size_t windowSize);
+
+    ~HorizonsStream();
+
+    /**
+     * Moves the window of keyframes that are kept in memory to the provided \p time and
+     * starts reading the next window if the \p time approaches the end of the current
+     * window in the direction in which time has been moving.
+     */
+    void update(double time);
+
+    /**
+     * Returns the position at the provided \p time, which is linearly interpolated
+     * between the two surrounding keyframes. Times outside of the trajectory return the
+     * position of the first or last keyframe.
+     */
+    glm::dvec3 position(double time) const;
+
+    /**
+     * Returns `true` if the keyframes surrounding the \p time are kept in memory.
+     */
+    bool isResident(double time) const;
+
+    size_t nKeyframes() const;
+    double startTime() const;
+    double endTime() const;
+
+    /**
+     * Returns `true` if all keyframes are equally spaced in time, in which case the
+     * keyframes for a time are found without any search.
+     */
+    bool hasUniformStep() const;
+
+private:
+    struct Header {
+        int8_t version = 0;
+        std::array<int8_t, 7> padding = {};
+        uint64_t nKeyframes = 0;
+        double startTime = 0.0;
+        /// The time between two keyframes or 0 if the keyframes are not equally spaced
+        double step = 0.0;
+    };
+
+    struct Window {
+        /// The index of the first keyframe in the window
+        size_t first = 0;
+        std::vector<Keyframe> keyframes;
+    };
+
+    HorizonsStream(std::filesystem::path file, const Header& header, size_t windowSize);
+
+    /// Reads the \p count keyframes starting at index \p first from the \p file
+    static Window readWindow(const std::filesystem::path& file, size_t first,
+        size_t count);
+
+    /// Returns the keyframe with the \p index. Requires `_mutex` to be locked
+    Keyframe keyframe(size_t index) const;
+
+    /// Returns the index of the last keyframe that is not after the \p time, clamped so
+    /// that there is always a following keyframe. Requires `_mutex` to be locked
+    size_t keyframeIndex(double time) const;
+
+    /// Returns `true` if the keyframes \p index and \p index + 1 are in the \p window
+    static bool contains(const Window& window, size_t index);
+
+    const std::filesystem::path _path;
+    const Header _header;
+    const size_t _windowSize;
+
+    mutable std::mutex _mutex;
+    Window _window;
+    std::future<Window> _prefetch;
+    /// The direction in which time moved during the last calls to #update
+    bool _isMovingForward = true;
+    double _lastTime = 0.0;
+
+    /// Used for keyframes outside of the window
+    mutable std::ifstream _file;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___HORIZONSSTREAM___H__
@@ -27,15 +27,30 @@
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/misc/stringhelper.h>
 #include <scn/scan.h>
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <optional>
 #include <sstream>
 
 namespace {
     constexpr std::string_view _loggerCat = "Kepler";
-    constexpr int8_t CurrentCacheVersion = 1;
+    constexpr int8_t CurrentCacheVersion = 2;
+
+    // The order in which the numerical values are stored in the cache file
+    constexpr std::array<double openspace::kepler::Parameters::*, 8> CacheColumns = {
+        &openspace::kepler::Parameters::inclination,
+        &openspace::kepler::Parameters::semiMajorAxis,
+        &openspace::kepler::Parameters::ascendingNode,
+        &openspace::kepler::Parameters::eccentricity,
+        &openspace::kepler::Parameters::argumentOfPeriapsis,
+        &openspace::kepler::Parameters::meanAnomaly,
+        &openspace::kepler::Parameters::epoch,
+        &openspace::kepler::Parameters::period
+    };
 
     // The list of leap years only goes until 2056 as we need to touch this file then
     // again anyway ;)
@@ -669,38 +684,80 @@ std::vector<Parameters> readSbdbFile(const std::filesystem::path& file) {
     return result;
 }
 
+// The cache stores the numerical values column by column and the names and ids in a
+// shared string pool, so that each of them can be read with a single read call instead of
+// parsing the values record by record:
+//   int8_t                  version
+//   uint32_t                number of objects (N)
+//   double[N] x 8           inclination, semi-major axis, ascending node, eccentricity,
+//                           argument of periapsis, mean anomaly, epoch, period
+//   uint32_t[N + 1]         offsets of the names into the string pool
+//   uint32_t[N + 1]         offsets of the ids into the string pool
+//   uint32_t                size of the string pool in bytes
+//   char[]                  string pool
 void saveCache(const std::vector<Parameters>& params, const std::filesystem::path& file) {
+    ZoneScoped;
+
     std::ofstream stream(file, std::ofstream::binary);
 
     stream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
 
-    uint32_t size = static_cast<uint32_t>(params.size());
+    const uint32_t size = static_cast<uint32_t>(params.size());
     stream.write(reinterpret_cast<const char*>(&size), sizeof(uint32_t));
-    for (const Parameters& param : params) {
-        uint32_t nameLength = static_cast<uint32_t>(param.name.size());
-        stream.write(reinterpret_cast<const char*>(&nameLength), sizeof(uint32_t));
-        stream.write(param.name.data(), nameLength * sizeof(char));
-
-        uint32_t idLength = static_cast<uint32_t>(param.id.size());
-        stream.write(reinterpret_cast<const char*>(&idLength), sizeof(uint32_t));
-        stream.write(param.id.data(), idLength * sizeof(char));
-
-        stream.write(reinterpret_cast<const char*>(&param.inclination), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.semiMajorAxis), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.ascendingNode), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.eccentricity), sizeof(double));
+
+    std::vector<double> column(size);
+    auto writeColumn = [&](double Parameters::* member) {
+        for (uint32_t i = 0; i < size; i++) {
+            column[i] = params[i].*member;
+        }
         stream.write(
-            reinterpret_cast<const char*>(&param.argumentOfPeriapsis),
-            sizeof(double)
+            reinterpret_cast<const char*>(column.data()),
+            column.size() * sizeof(double)
         );
-        stream.write(reinterpret_cast<const char*>(&param.meanAnomaly), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.epoch), sizeof(double));
-        stream.write(reinterpret_cast<const char*>(&param.period), sizeof(double));
+    };
+    for (double Parameters::* member : CacheColumns) {
+        writeColumn(member);
     }
+
+    std::string pool;
+    std::vector<uint32_t> nameOffsets;
+    nameOffsets.reserve(size + 1);
+    std::vector<uint32_t> idOffsets;
+    idOffsets.reserve(size + 1);
+    for (const Parameters& param : params) {
+        nameOffsets.push_back(static_cast<uint32_t>(pool.size()));
+        pool += param.name;
+    }
+    nameOffsets.push_back(static_cast<uint32_t>(pool.size()));
+    for (const Parameters& param : params) {
+        idOffsets.push_back(static_cast<uint32_t>(pool.size()));
+        pool += param.id;
+    }
+    idOffsets.push_back(static_cast<uint32_t>(pool.size()));
+
+    stream.write(
+        reinterpret_cast<const char*>(nameOffsets.data()),
+        nameOffsets.size() * sizeof(uint32_t)
+    );
+    stream.write(
+        reinterpret_cast<const char*>(idOffsets.data()),
+        idOffsets.size() * sizeof(uint32_t)
+    );
+    const uint32_t poolSize = static_cast<uint32_t>(pool.size());
+    stream.write(reinterpret_cast<const char*>(&poolSize), sizeof(uint32_t));
+    stream.write(pool.data(), pool.size());
 }
 
 std::optional<std::vector<Parameters>> loadCache(const std::filesystem::path& file) {
+    ZoneScoped;
+
+    std::error_code ec;
+    const uint64_t fileSize = std::filesystem::file_size(file, ec);
     std::ifstream stream(file, std::ifstream::binary);
+    if (ec || !stream.good()) {
+        LWARNING(std::format("Could not open cache file '{}'", file));
+        return std::nullopt;
+    }
 
     int8_t version = 0;
     stream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
@@ -711,31 +768,64 @@ std::optional<std::vector<Parameters>> loadCache(const std::filesystem::path& fi
 
     uint32_t size = 0;
     stream.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
-    std::vector<Parameters> res;
-    res.reserve(size);
+
+    // Make sure that the file is large enough for the number of objects it claims before
+    // anything is allocated
+    const uint64_t bytesPerObject =
+        CacheColumns.size() * sizeof(double) + 2 * sizeof(uint32_t);
+    const uint64_t minimumSize = sizeof(int8_t) + sizeof(uint32_t) +
+        size * bytesPerObject + 2 * sizeof(uint32_t) + sizeof(uint32_t);
+    if (!stream.good() || minimumSize > fileSize) {
+        LWARNING(std::format("Cache file '{}' is truncated or corrupted", file));
+        return std::nullopt;
+    }
+
+    std::vector<Parameters> res(size);
+
+    std::vector<double> column(size);
+    for (double Parameters::* member : CacheColumns) {
+        stream.read(reinterpret_cast<char*>(column.data()), size * sizeof(double));
+        for (uint32_t i = 0; i < size; i++) {
+            res[i].*member = column[i];
+        }
+    }
+
+    std::vector<uint32_t> nameOffsets(size + 1);
+    stream.read(
+        reinterpret_cast<char*>(nameOffsets.data()),
+        nameOffsets.size() * sizeof(uint32_t)
+    );
+    std::vector<uint32_t> idOffsets(size + 1);
+    stream.read(
+        reinterpret_cast<char*>(idOffsets.data()),
+        idOffsets.size() * sizeof(uint32_t)
+    );
+    uint32_t poolSize = 0;
+    stream.read(reinterpret_cast<char*>(&poolSize), sizeof(uint32_t));
+    if (!stream.good() || minimumSize + poolSize != fileSize) {
+        LWARNING(std::format("Cache file '{}' is truncated or corrupted", file));
+        return std::nullopt;
+    }
+    std::string pool;
+    pool.resize(poolSize);
+    stream.read(pool.data(), poolSize);
+
+    // Every name and id has to lie within the string pool
+    auto isValid = [poolSize](const std::vector<uint32_t>& offsets) {
+        return std::is_sorted(offsets.begin(), offsets.end()) &&
+            offsets.back() <= poolSize;
+    };
+    if (!stream.good() || !isValid(nameOffsets) || !isValid(idOffsets)) {
+        LWARNING(std::format("Cache file '{}' is truncated or corrupted", file));
+        return std::nullopt;
+    }
+
+    const std::string_view poolView = pool;
     for (uint32_t i = 0; i < size; i++) {
-        Parameters param;
-
-        uint32_t nameLength = 0;
-        stream.read(reinterpret_cast<char*>(&nameLength), sizeof(uint32_t));
-        param.name.resize(nameLength);
-        stream.read(param.name.data(), nameLength * sizeof(char));
-
-        uint32_t idLength = 0;
-        stream.read(reinterpret_cast<char*>(&idLength), sizeof(uint32_t));
-        param.id.resize(idLength);
-        stream.read(param.id.data(), idLength * sizeof(char));
-
-        stream.read(reinterpret_cast<char*>(&param.inclination), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.semiMajorAxis), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.ascendingNode), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.eccentricity), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.argumentOfPeriapsis), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.meanAnomaly), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.epoch), sizeof(double));
-        stream.read(reinterpret_cast<char*>(&param.period), sizeof(double));
-
-        res.push_back(std::move(param));
+        const uint32_t nameLength = nameOffsets[i + 1] - nameOffsets[i];
+        res[i].name = poolView.substr(nameOffsets[i], nameLength);
+        const uint32_t idLength = idOffsets[i + 1] - idOffsets[i];
+        res[i].id = poolView.substr(idOffsets[i], idLength);
     }
 
     return res;
@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_SPACE___KEPLER___H__
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -85,6 +86,24 @@ std::vector<Parameters> readOmmFile(const std::filesystem::path& file);
  */
 std::vector<Parameters> readSbdbFile(const std::filesystem::path& file);
 
+/**
+ * Writes the \p params into the binary cache \p file that is used by readFile to avoid
+ * parsing the same file again.
+ *
+ * \param params The objects that should be stored in the cache
+ * \param file The path of the cache file that is created or overwritten
+ */
+void saveCache(const std::vector<Parameters>& params, const std::filesystem::path& file);
+
+/**
+ * Reads the objects from the binary cache \p file that was written by saveCache.
+ *
+ * \param file The path of the cache file
+ * \return The objects stored in the cache, or `std::nullopt` if the cache has a different
+ *         version or is truncated or corrupt
+ */
+std::optional<std::vector<Parameters>> loadCache(const std::filesystem::path& file);
+
 /**
  * The different formats that the readFile function is capable of loading.
  */
@@ -0,0 +1,189 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/keplerpropagator.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // The maximum number of Newton iterations. Starting from Danby's initial guess, the
+    // solver converges in fewer iterations for all eccentricities in [0, 0.99]
+    constexpr int MaxIterations = 10;
+    constexpr double Tolerance = 1e-12;
+
+    glm::dmat3 orbitPlaneRotation(const openspace::kepler::Parameters& p) {
+        // This is the same rotation as in KeplerTranslation::computeOrbitPlane:
+        // 1. Around the z axis to place the location of the ascending node
+        // 2. Around the x axis (now aligned with the ascending node) to get the correct
+        //    inclination
+        // 3. Around the new z axis to place the closest approach to the correct location
+        const double asc = glm::radians(p.ascendingNode);
+        const double inc = glm::radians(p.inclination);
+        const double per = glm::radians(p.argumentOfPeriapsis);
+
+        return glm::dmat3(
+            glm::rotate(asc, glm::dvec3(0.0, 0.0, 1.0)) *
+            glm::rotate(inc, glm::dvec3(1.0, 0.0, 0.0)) *
+            glm::rotate(per, glm::dvec3(0.0, 0.0, 1.0))
+        );
+    }
+} // namespace
+
+namespace openspace::kepler {
+
+size_t OrbitBatch::size() const {
+    return eccentricity.size();
+}
+
+bool hasValidElements(const Parameters& parameters) {
+    auto isInRange = [](double val, double min, double max) {
+        return val >= min && val <= max;
+    };
+    return parameters.eccentricity >= 0.0 && parameters.eccentricity < 1.0 &&
+        isInRange(parameters.inclination, 0.0, 360.0) &&
+        isInRange(parameters.ascendingNode, 0.0, 360.0);
+}
+
+OrbitBatch createOrbitBatch(const std::vector<Parameters>& parameters) {
+    ZoneScoped;
+
+    OrbitBatch batch;
+    batch.eccentricity.reserve(parameters.size());
+    batch.semiMajorAxis.reserve(parameters.size());
+    batch.meanAnomalyAtEpoch.reserve(parameters.size());
+    batch.period.reserve(parameters.size());
+    batch.epoch.reserve(parameters.size());
+    batch.orbitPlane.reserve(parameters.size());
+
+    for (const Parameters& p : parameters) {
+        ghoul_assert(hasValidElements(p), "Orbit must have valid elements");
+
+        batch.eccentricity.push_back(p.eccentricity);
+        batch.semiMajorAxis.push_back(p.semiMajorAxis * 1000.0);
+        batch.meanAnomalyAtEpoch.push_back(glm::radians(p.meanAnomaly));
+        batch.period.push_back(p.period);
+        batch.epoch.push_back(p.epoch);
+        batch.orbitPlane.push_back(orbitPlaneRotation(p));
+    }
+    return batch;
+}
+
+void solveEccentricAnomalies(std::span<const double> meanAnomalies,
+                             std::span<const double> eccentricities,
+                             std::span<double> result)
+{
+    ghoul_assert(
+        meanAnomalies.size() == eccentricities.size(),
+        "Mean anomalies and eccentricities must have the same size"
+    );
+    ghoul_assert(
+        meanAnomalies.size() == result.size(),
+        "Mean anomalies and result must have the same size"
+    );
+
+    const size_t n = result.size();
+    const double* m = meanAnomalies.data();
+    const double* e = eccentricities.data();
+    double* ea = result.data();
+
+    // Reduce the mean anomaly to [-pi, pi] and use Danby's starting value, which
+    // converges for all elliptical orbits
+    for (size_t i = 0; i < n; i++) {
+        const double mi = std::remainder(m[i], glm::two_pi<double>());
+        ea[i] = mi + std::copysign(0.85 * e[i], mi);
+    }
+
+    for (int iteration = 0; iteration < MaxIterations; iteration++) {
+        double maxDelta = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            const double mi = std::remainder(m[i], glm::two_pi<double>());
+            const double f = ea[i] - e[i] * std::sin(ea[i]) - mi;
+            const double df = 1.0 - e[i] * std::cos(ea[i]);
+            const double delta = f / df;
+            ea[i] -= delta;
+            maxDelta = std::max(maxDelta, std::abs(delta));
+        }
+
+        if (maxDelta < Tolerance) {
+            break;
+        }
+    }
+
+    // The solution was computed for the reduced mean anomaly, so we have to add back
+    // the full revolutions that were removed
+    for (size_t i = 0; i < n; i++) {
+        ea[i] += m[i] - std::remainder(m[i], glm::two_pi<double>());
+    }
+}
+
+void sampleOrbit(const OrbitBatch& batch, size_t orbit, std::span<double> timeOffsets,
+                 std::span<glm::dvec3> positions)
+{
+    ghoul_assert(orbit < batch.size(), "Orbit index out of range");
+    ghoul_assert(
+        timeOffsets.size() == positions.size(),
+        "Time offsets and positions must have the same size"
+    );
+    ghoul_assert(positions.size() >= 2, "At least two samples are required");
+
+    // Scratch space that is reused between calls to avoid allocating for every orbit.
+    // This function is called concurrently from multiple threads, so each thread needs
+    // its own copy
+    thread_local std::vector<double> meanAnomalies;
+    thread_local std::vector<double> eccentricities;
+    thread_local std::vector<double> eccentricAnomalies;
+
+    const size_t n = positions.size();
+    meanAnomalies.resize(n);
+    eccentricities.resize(n);
+    eccentricAnomalies.resize(n);
+
+    const double ecc = batch.eccentricity[orbit];
+    const double period = batch.period[orbit];
+    const double meanMotion = glm::two_pi<double>() / period;
+    const double m0 = batch.meanAnomalyAtEpoch[orbit];
+    for (size_t i = 0; i < n; i++) {
+        const double t = period * static_cast<double>(i) / static_cast<double>(n - 1);
+        timeOffsets[i] = t;
+        meanAnomalies[i] = m0 + t * meanMotion;
+        eccentricities[i] = ecc;
+    }
+
+    solveEccentricAnomalies(meanAnomalies, eccentricities, eccentricAnomalies);
+
+    const double a = batch.semiMajorAxis[orbit];
+    const double b = a * std::sqrt(1.0 - ecc * ecc);
+    const glm::dmat3& rot = batch.orbitPlane[orbit];
+    for (size_t i = 0; i < n; i++) {
+        const double ea = eccentricAnomalies[i];
+        const glm::dvec3 p = glm::dvec3(a * (std::cos(ea) - ecc), b * std::sin(ea), 0.0);
+        positions[i] = rot * p;
+    }
+}
+
+} // namespace openspace::kepler
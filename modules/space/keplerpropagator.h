@@ -0,0 +1,113 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+
+#include <modules/space/kepler.h>
+#include <ghoul/glm.h>
+#include <span>
+#include <vector>
+
+namespace openspace::kepler {
+
+/**
+ * A structure-of-arrays representation of a list of orbits that is used to propagate
+ * many orbits at once. Each of the vectors contains one entry per orbit and all vectors
+ * have the same length. In contrast to the Parameters, all angles are stored in radians
+ * and the semi-major axis is stored in meters.
+ */
+struct OrbitBatch {
+    /// The eccentricity of each orbit in [0, 1)
+    std::vector<double> eccentricity;
+    /// The semi-major axis of each orbit in meters
+    std::vector<double> semiMajorAxis;
+    /// The mean anomaly at the epoch in radians
+    std::vector<double> meanAnomalyAtEpoch;
+    /// The orbital period in seconds
+    std::vector<double> period;
+    /// The epoch of each orbit in seconds past the J2000 epoch
+    std::vector<double> epoch;
+    /// The rotation matrix that transforms the orbital plane into the reference frame
+    std::vector<glm::dmat3> orbitPlane;
+
+    size_t size() const;
+};
+
+/**
+ * Returns whether the Keplerian elements in \p parameters describe an orbit that can be
+ * propagated. This requires an eccentricity in [0, 1) as well as an inclination and a
+ * longitude of the ascending node in [0, 360] degrees.
+ */
+bool hasValidElements(const Parameters& parameters);
+
+/**
+ * Converts the list of \p parameters into the structure-of-arrays representation that is
+ * used by the propagation functions. The orbit plane rotations are computed once per
+ * orbit in this step.
+ *
+ * \param parameters The list of Keplerian elements that should be converted
+ * \return The OrbitBatch containing the same orbits as \p parameters
+ *
+ * \pre All of the \p parameters must have valid elements (see hasValidElements)
+ */
+OrbitBatch createOrbitBatch(const std::vector<Parameters>& parameters);
+
+/**
+ * Solves Kepler's equation `M = E - e * sin(E)` for the eccentric anomaly `E` for each
+ * pair of mean anomaly and eccentricity. All lanes are solved with the same number of
+ * Newton iterations, which makes the inner loop free of branches so that the compiler
+ * can vectorize it. The iteration stops as soon as all lanes have converged.
+ *
+ * \param meanAnomalies The mean anomalies in radians
+ * \param eccentricities The eccentricities in [0, 1) for each mean anomaly
+ * \param result The destination for the eccentric anomalies in radians
+ *
+ * \pre \p meanAnomalies, \p eccentricities, and \p result must have the same size
+ */
+void solveEccentricAnomalies(std::span<const double> meanAnomalies,
+    std::span<const double> eccentricities, std::span<double> result);
+
+/**
+ * Samples the orbit with the index \p orbit in the \p batch at `positions.size()` evenly
+ * spaced points in time, starting at the epoch of the orbit and ending one full period
+ * later. The time offsets (in seconds relative to the epoch) of each sample are written
+ * to \p timeOffsets and the positions (in meters) are written to \p positions. The
+ * results are identical (up to the precision of the solver) to evaluating a
+ * KeplerTranslation with the same elements at the same points in time.
+ *
+ * \param batch The batch containing the orbit that should be sampled
+ * \param orbit The index of the orbit inside the \p batch
+ * \param timeOffsets The destination for the time offsets of each sample
+ * \param positions The destination for the position of each sample
+ *
+ * \pre \p orbit must be smaller than the size of the \p batch
+ * \pre \p timeOffsets and \p positions must have the same size, which is at least 2
+ */
+void sampleOrbit(const OrbitBatch& batch, size_t orbit, std::span<double> timeOffsets,
+    std::span<glm::dvec3> positions);
+
+} // namespace openspace::kepler
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
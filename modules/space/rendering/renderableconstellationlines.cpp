@@ -165,8 +165,10 @@ void RenderableConstellationLines::selectionPropertyHasChanged() {
             pair.second.isEnabled = isSelected;
 
             if (_hasLabels) {
-                for (dataloader::Labelset::Entry& e : _labels->labelSet().entries) {
-                    if (constellationFullName(e.identifier) == pair.second.name) {
+                dataloader::Labelset& labels = _labels->labelSet();
+                for (dataloader::Labelset::Entry& e : labels.entries) {
+                    const std::string identifier = std::string(labels.identifier(e));
+                    if (constellationFullName(identifier) == pair.second.name) {
                         e.isEnabled = isSelected;
                         break;
                     }
@@ -233,9 +235,17 @@ void RenderableConstellationLines::initializeGL() {
     ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
 
     createConstellations();
+
+    if (_hasLabels) {
+        _labels->initializeGL();
+    }
 }
 
 void RenderableConstellationLines::deinitializeGL() {
+    if (_hasLabels) {
+        _labels->deinitializeGL();
+    }
+
     using ConstellationKeyValuePair = std::pair<const int, ConstellationLine>;
     for (const ConstellationKeyValuePair& pair : _renderingConstellationsMap)
     {
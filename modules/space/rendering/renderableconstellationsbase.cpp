@@ -192,11 +192,13 @@ void RenderableConstellationsBase::initialize() {
 
     _labels->initialize();
 
-    for (dataloader::Labelset::Entry& entry : _labels->labelSet().entries) {
-        if (!entry.identifier.empty()) {
-            std::string fullName = constellationFullName(entry.identifier);
+    dataloader::Labelset& labels = _labels->labelSet();
+    for (dataloader::Labelset::Entry& entry : labels.entries) {
+        if (entry.identifierLength > 0) {
+            const std::string identifier = std::string(labels.identifier(entry));
+            const std::string fullName = constellationFullName(identifier);
             if (!fullName.empty()) {
-                entry.text = std::move(fullName);
+                labels.setText(entry, fullName);
             }
         }
     }
@@ -24,6 +24,7 @@
 
 #include <modules/space/rendering/renderableorbitalkepler.h>
 
+#include <modules/space/keplerpropagator.h>
 #include <modules/space/translation/keplertranslation.h>
 #include <modules/space/spacemodule.h>
 #include <openspace/engine/openspaceengine.h>
@@ -31,6 +32,7 @@
 #include <openspace/engine/globals.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -41,10 +43,16 @@
 #include <chrono>
 #include <cmath>
 #include <fstream>
+#include <future>
 #include <random>
 #include <vector>
 
 namespace {
+    constexpr std::string_view _loggerCat = "RenderableOrbitalKepler";
+
+    // The number of orbits that are computed by a single task before the results are
+    // handed to the main thread for uploading
+    constexpr int OrbitsPerChunk = 4096;
 
     // The possible values for the _renderingModes property
     enum RenderingMode {
@@ -647,6 +655,18 @@ void RenderableOrbitalKepler::updateBuffers() {
         );
     }
 
+    // Orbits that can't be propagated are skipped rather than failing the whole catalog
+    const size_t nInvalid = std::erase_if(
+        parameters,
+        [](const kepler::Parameters& p) { return !kepler::hasValidElements(p); }
+    );
+    if (nInvalid > 0) {
+        LWARNING(std::format(
+            "Skipped {} orbits with an eccentricity outside [0, 1) or an inclination or "
+            "ascending node outside [0, 360]", nInvalid
+        ));
+    }
+
     _segmentSize.clear();
     _startIndex.clear();
     _startIndex.push_back(0);
@@ -668,50 +688,17 @@ void RenderableOrbitalKepler::updateBuffers() {
     }
     _vertexBufferData.resize(nVerticesTotal);
 
-    size_t vertexBufIdx = 0;
-    KeplerTranslation keplerTranslator;
-    for (int orbitIdx = 0; orbitIdx < numOrbits; ++orbitIdx) {
-        const kepler::Parameters& orbit = parameters[orbitIdx];
-
-        keplerTranslator.setKeplerElements(
-            orbit.eccentricity,
-            orbit.semiMajorAxis,
-            orbit.inclination,
-            orbit.ascendingNode,
-            orbit.argumentOfPeriapsis,
-            orbit.meanAnomaly,
-            orbit.period,
-            orbit.epoch
-        );
-
-        for (GLint j = 0 ; j < (_segmentSize[orbitIdx]); j++) {
-            const double timeOffset = orbit.period *
-                static_cast<double>(j) / static_cast<double>(_segmentSize[orbitIdx] - 1);
-
-            const glm::dvec3 position = keplerTranslator.position({
-                {},
-                Time(timeOffset + orbit.epoch),
-                Time(0.0)
-            });
-
-            _vertexBufferData[vertexBufIdx].x = static_cast<float>(position.x);
-            _vertexBufferData[vertexBufIdx].y = static_cast<float>(position.y);
-            _vertexBufferData[vertexBufIdx].z = static_cast<float>(position.z);
-            _vertexBufferData[vertexBufIdx].time = static_cast<float>(timeOffset);
-            _vertexBufferData[vertexBufIdx].epoch = orbit.epoch;
-            _vertexBufferData[vertexBufIdx].period = orbit.period;
-
-            vertexBufIdx++;
-        }
-    }
+    const kepler::OrbitBatch batch = kepler::createOrbitBatch(parameters);
 
+    // Allocate the full buffer up front so that finished chunks can be uploaded while
+    // the remaining orbits are still being computed
     glBindVertexArray(_vertexArray);
 
     glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
     glBufferData(
         GL_ARRAY_BUFFER,
         _vertexBufferData.size() * sizeof(TrailVBOLayout),
-        _vertexBufferData.data(),
+        nullptr,
         GL_STATIC_DRAW
     );
 
@@ -728,8 +715,75 @@ void RenderableOrbitalKepler::updateBuffers() {
         reinterpret_cast<GLvoid*>(4 * sizeof(GL_FLOAT))
     );
 
+    // Each chunk of orbits is computed as a task of the TaskScheduler and uploaded as
+    // soon as it has finished, while the remaining chunks are still being computed
+    const int nChunks = (numOrbits + OrbitsPerChunk - 1) / OrbitsPerChunk;
+    std::vector<std::promise<void>> chunkPromises(nChunks);
+    std::vector<std::future<void>> chunkFutures;
+    chunkFutures.reserve(nChunks);
+    for (std::promise<void>& promise : chunkPromises) {
+        chunkFutures.push_back(promise.get_future());
+    }
+
+    auto computeChunk = [&](int chunk) {
+        try {
+            std::vector<double> timeOffsets;
+            std::vector<glm::dvec3> positions;
+            const int begin = chunk * OrbitsPerChunk;
+            const int end = std::min(begin + OrbitsPerChunk, numOrbits);
+            for (int orbitIdx = begin; orbitIdx < end; orbitIdx++) {
+                const int nSegments = _segmentSize[orbitIdx];
+                timeOffsets.resize(nSegments);
+                positions.resize(nSegments);
+                kepler::sampleOrbit(batch, orbitIdx, timeOffsets, positions);
+
+                const double epoch = batch.epoch[orbitIdx];
+                const double period = batch.period[orbitIdx];
+                TrailVBOLayout* v = &_vertexBufferData[_startIndex[orbitIdx]];
+                for (int j = 0; j < nSegments; j++) {
+                    v[j].x = static_cast<float>(positions[j].x);
+                    v[j].y = static_cast<float>(positions[j].y);
+                    v[j].z = static_cast<float>(positions[j].z);
+                    v[j].time = static_cast<float>(timeOffsets[j]);
+                    v[j].epoch = epoch;
+                    v[j].period = period;
+                }
+            }
+            chunkPromises[chunk].set_value();
+        }
+        catch (...) {
+            chunkPromises[chunk].set_exception(std::current_exception());
+        }
+    };
+
+    TaskScheduler::TaskGroup group(*global::taskScheduler);
+    for (int chunk = 0; chunk < nChunks; chunk++) {
+        group.run([&computeChunk, chunk]() { computeChunk(chunk); });
+    }
+
+    for (int chunk = 0; chunk < nChunks; chunk++) {
+        chunkFutures[chunk].wait();
+
+        const int begin = chunk * OrbitsPerChunk;
+        const int last = std::min(begin + OrbitsPerChunk, numOrbits) - 1;
+        const GLint firstVertex = _startIndex[begin];
+        const GLint nVertices = _startIndex[last] + _segmentSize[last] - firstVertex;
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            firstVertex * sizeof(TrailVBOLayout),
+            nVertices * sizeof(TrailVBOLayout),
+            &_vertexBufferData[firstVertex]
+        );
+    }
+    group.wait();
+
     glBindVertexArray(0);
 
+    // Rethrow the first error that occurred in any of the worker threads
+    for (std::future<void>& future : chunkFutures) {
+        future.get();
+    }
+
     double maxSemiMajorAxis = 0.0;
     for (const kepler::Parameters& kp : parameters) {
         if (kp.semiMajorAxis > maxSemiMajorAxis) {
@@ -743,7 +743,7 @@ void RenderableStars::loadPSFTexture() {
 }
 
 void RenderableStars::render(const RenderData& data, RendererTasks&) {
-    if (_dataset.entries.empty()) {
+    if (_dataset.nEntries() == 0) {
         return;
     }
 
@@ -838,7 +838,7 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
 
 
     glBindVertexArray(_vao);
-    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(_dataset.entries.size()));
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(_dataset.nEntries()));
     glBindVertexArray(0);
     _program->deactivate();
 
@@ -854,7 +854,7 @@ void RenderableStars::update(const UpdateData&) {
         _dataIsDirty = true;
     }
 
-    if (_dataset.entries.empty()) {
+    if (_dataset.nEntries() == 0) {
         return;
     }
 
@@ -877,7 +877,7 @@ void RenderableStars::update(const UpdateData&) {
         // in_bvLumAbsMag = bv color, luminosity, abs magnitude
         const GLint bvLumAbsMagAttrib = _program->attributeLocation("in_bvLumAbsMag");
 
-        const size_t nStars = _dataset.entries.size();
+        const size_t nStars = _dataset.nEntries();
         const size_t nValues = slice.size() / nStars;
 
         const GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * nValues);
@@ -1029,7 +1029,7 @@ void RenderableStars::loadData() {
     }
 
     _dataset = dataloader::data::loadFileWithCache(file);
-    if (_dataset.entries.empty()) {
+    if (_dataset.nEntries() == 0) {
         return;
     }
 
@@ -1064,9 +1064,10 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
 
     std::vector<float> result;
     // 6 for the default Color option of 3 positions + bv + lum + abs
-    result.reserve(_dataset.entries.size() * 6);
-    for (const dataloader::Dataset::Entry& e : _dataset.entries) {
-        glm::dvec3 position = glm::dvec3(e.position) * distanceconstants::Parsec;
+    const dataloader::DatasetView data = _dataset.view();
+    result.reserve(data.nEntries() * 6);
+    for (size_t i = 0; i < data.nEntries(); i++) {
+        glm::dvec3 position = glm::dvec3(data.positions[i]) * distanceconstants::Parsec;
         glm::vec3 pos = position;
         maxRadius = std::max(maxRadius, glm::length(position));
 
@@ -1080,9 +1081,9 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                 } layout;
 
                 layout.value.position = { pos.x, pos.y, pos.z };
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
+                layout.value.value = data.values[bvIdx][i];
+                layout.value.luminance = data.values[lumIdx][i];
+                layout.value.absoluteMagnitude = data.values[absMagIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -1095,13 +1096,13 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                 } layout;
 
                 layout.value.position = { pos.x, pos.y, pos.z };
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
+                layout.value.value = data.values[bvIdx][i];
+                layout.value.luminance = data.values[lumIdx][i];
+                layout.value.absoluteMagnitude = data.values[absMagIdx][i];
 
-                layout.value.vx = e.data[vxIdx];
-                layout.value.vy = e.data[vyIdx];
-                layout.value.vz = e.data[vzIdx];
+                layout.value.vx = data.values[vxIdx][i];
+                layout.value.vy = data.values[vyIdx][i];
+                layout.value.vz = data.values[vzIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -1114,10 +1115,10 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                 } layout;
 
                 layout.value.position = { pos.x, pos.y, pos.z };
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.speed = e.data[speedIdx];
+                layout.value.value = data.values[bvIdx][i];
+                layout.value.luminance = data.values[lumIdx][i];
+                layout.value.absoluteMagnitude = data.values[absMagIdx][i];
+                layout.value.speed = data.values[speedIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -1133,10 +1134,10 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
 
                 const int index = _otherDataOption.value();
                 // plus 3 because of the position
-                layout.value.value = e.data[index];
+                const float value = data.values[index][i];
+                layout.value.value = value;
 
-                if (_staticFilterValue.has_value() && e.data[index] == _staticFilterValue)
-                {
+                if (_staticFilterValue.has_value() && value == _staticFilterValue) {
                     layout.value.value = _staticFilterReplacementValue;
                 }
 
@@ -1147,8 +1148,8 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                 _otherDataRange.setMinValue(glm::vec2(range.x));
                 _otherDataRange.setMaxValue(glm::vec2(range.y));
 
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
+                layout.value.luminance = data.values[lumIdx][i];
+                layout.value.absoluteMagnitude = data.values[absMagIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -29,6 +29,10 @@
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
+#include <ghoul/format.h>
+#include <glm/gtx/orthonormalize.hpp>
+#include <algorithm>
+#include <filesystem>
 #include <optional>
 
 namespace {
@@ -80,6 +84,24 @@ namespace {
         // [[codegen::verbatim(FixedDateInfo.description)]]
         std::optional<std::string> fixedDate
             [[codegen::annotation("A time to lock the rotation to")]];
+
+        struct EphemerisCache {
+            // The beginning of the time window for which rotations are precomputed
+            std::string start [[codegen::annotation("A date in ISO 8601 format")]];
+
+            // The end of the time window for which rotations are precomputed
+            std::string end [[codegen::annotation("A date in ISO 8601 format")]];
+
+            // The maximum Euclidean distance between the nine elements of a
+            // precomputed rotation matrix and those of the matrix reported by SPICE,
+            // which roughly corresponds to an angle in radians. The default value is
+            // 1e-9
+            std::optional<double> accuracy [[codegen::greater(0.0)]];
+        };
+        // If this value is specified, SPICE is sampled once for the provided time window
+        // and rotations inside the window are interpolated from the samples, which
+        // avoids calling SPICE in every frame. See the SpiceTranslation for details
+        std::optional<EphemerisCache> ephemerisCache;
     };
 #include "spicerotation_codegen.cpp"
 } // namespace
@@ -124,8 +146,71 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     addProperty(_sourceFrame);
     addProperty(_destinationFrame);
 
-    _sourceFrame.onChange([this]() { requireUpdate(); });
-    _destinationFrame.onChange([this]() { requireUpdate(); });
+    _sourceFrame.onChange([this]() {
+        _ephemeris.reset();
+        requireUpdate();
+    });
+    _destinationFrame.onChange([this]() {
+        _ephemeris.reset();
+        requireUpdate();
+    });
+
+    if (p.ephemerisCache.has_value()) {
+        const Parameters::EphemerisCache& cache = *p.ephemerisCache;
+        _ephemerisSettings = ChebyshevEphemeris::FitSettings {
+            .start = SpiceManager::ref().ephemerisTimeFromDate(cache.start),
+            .end = SpiceManager::ref().ephemerisTimeFromDate(cache.end),
+            .accuracy = cache.accuracy.value_or(1e-9)
+        };
+        if (_ephemerisSettings->start >= _ephemerisSettings->end) {
+            throw ghoul::RuntimeError(
+                "The start of the ephemeris cache has to be before the end",
+                "SpiceRotation"
+            );
+        }
+    }
+}
+
+void SpiceRotation::update(const UpdateData& data) {
+    if (_ephemerisSettings.has_value()) {
+        // Rotations that were sampled before kernels were loaded or unloaded might be
+        // outdated, so they have to be sampled again
+        const uint64_t generation = SpiceManager::ref().kernelGeneration();
+        if (generation != _ephemerisKernelGeneration) {
+            _ephemeris.reset();
+            _ephemerisKernelGeneration = generation;
+        }
+
+        if (_ephemeris.isIdle()) {
+            const std::string source = _sourceFrame;
+            const std::string destination = _destinationFrame;
+
+            std::string information =
+                std::format("SpiceRotation|{}|{}", source, destination);
+            for (const std::filesystem::path& k : SpiceManager::ref().loadedKernels()) {
+                information += std::format("|{}", k);
+            }
+
+            // The names are copied as the function is called from a different thread
+            _ephemeris.start(
+                std::format("{} to {}", source, destination),
+                ChebyshevEphemeris::cacheFile(information, 9, *_ephemerisSettings),
+                9,
+                *_ephemerisSettings,
+                [source, destination](double time, std::span<double> values) {
+                    const glm::dmat3 m = SpiceManager::ref().positionTransformMatrix(
+                        source,
+                        destination,
+                        time
+                    );
+                    std::copy_n(&m[0][0], 9, values.begin());
+                }
+            );
+        }
+        _ephemeris.update();
+    }
+
+    Rotation::update(data);
 }
 
 glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
@@ -136,6 +221,14 @@ glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
     if (_fixedEphemerisTime.has_value()) {
         time = *_fixedEphemerisTime;
     }
+
+    glm::dmat3 res = glm::dmat3(1.0);
+    const ChebyshevEphemeris* ephemeris = _ephemeris.ephemeris();
+    if (ephemeris && ephemeris->evaluate(time, { &res[0][0], 9 })) {
+        // The interpolated elements are not exactly orthonormal anymore
+        return glm::orthonormalize(res);
+    }
+
     return SpiceManager::ref().positionTransformMatrix(
         _sourceFrame,
         _destinationFrame,
@@ -143,4 +236,25 @@ glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
     );
 }
 
+bool SpiceRotation::supportsParallelUpdate(const UpdateData& data) const {
+    // Starting to create the ephemeris or replacing an outdated one in the next update
+    // has to happen on the main thread
+    const bool isOutdated = _ephemerisSettings.has_value() &&
+        (_ephemeris.isIdle() ||
+         _ephemerisKernelGeneration != SpiceManager::ref().kernelGeneration());
+    if (isOutdated) {
+        return false;
+    }
+
+    if (_timeFrame && !_timeFrame->isActive(data.time)) {
+        return true;
+    }
+    const ChebyshevEphemeris* ephemeris = _ephemeris.ephemeris();
+    if (!ephemeris) {
+        return false;
+    }
+    const double time = _fixedEphemerisTime.value_or(data.time.j2000Seconds());
+    return ephemeris->covers(time);
+}
+
 } // namespace openspace
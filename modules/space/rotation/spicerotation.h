@@ -27,6 +27,7 @@
 
 #include <openspace/scene/rotation.h>
 
+#include <modules/space/chebyshevephemeris.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/scene/timeframe.h>
 #include <optional>
@@ -41,6 +42,8 @@ public:
 
     const glm::dmat3& matrix() const;
     glm::dmat3 matrix(const UpdateData& data) const override;
+    void update(const UpdateData& data) override;
+    bool supportsParallelUpdate(const UpdateData& data) const override;
 
     static documentation::Documentation Documentation();
 
@@ -51,6 +54,14 @@ private:
 
     ghoul::mm_unique_ptr<TimeFrame> _timeFrame;
     std::optional<double> _fixedEphemerisTime;
+
+    /// The time window and accuracy of the precomputed rotation matrices, if used
+    std::optional<ChebyshevEphemeris::FitSettings> _ephemerisSettings;
+    /// The precomputed matrix elements, which are recreated in the background whenever
+    /// a frame or the loaded kernels change
+    BackgroundEphemeris _ephemeris;
+    /// The SpiceManager::kernelGeneration for which the #_ephemeris was created
+    uint64_t _ephemerisKernelGeneration = 0;
 };
 
 } // namespace openspace
@@ -33,6 +33,8 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <type_traits>
@@ -54,6 +56,13 @@ namespace {
     struct [[codegen::Dictionary(HorizonsTranslation)]] Parameters {
         // [[codegen::verbatim(HorizonsTextFileInfo.description)]]
         std::variant<std::string, std::vector<std::string>> horizonsTextFile;
+
+        // If this value is specified, the keyframes are not loaded into memory all at
+        // once. Instead, they are converted into a cache file with fixed-size records
+        // and only about this many keyframes around the current time are kept in
+        // memory. This is useful for trajectories with a high sample rate that span a
+        // long time
+        std::optional<int> streamingWindowSize [[codegen::greaterequal(16)]];
     };
 #include "horizonstranslation_codegen.cpp"
 } // namespace
@@ -81,6 +90,11 @@ HorizonsTranslation::HorizonsTranslation(const ghoul::Dictionary& dictionary)
 {
     const Parameters p = codegen::bake<Parameters>(dictionary);
 
+    // Has to be set before the files, as setting them loads the data
+    if (p.streamingWindowSize.has_value()) {
+        _streamingWindowSize = static_cast<size_t>(*p.streamingWindowSize);
+    }
+
     if (std::holds_alternative<std::string>(p.horizonsTextFile)) {
         std::string file = std::get<std::string>(p.horizonsTextFile);
         if (!std::filesystem::is_regular_file(absPath(file))) {
@@ -111,7 +125,18 @@ HorizonsTranslation::HorizonsTranslation(const ghoul::Dictionary& dictionary)
     }
 }
 
+void HorizonsTranslation::update(const UpdateData& data) {
+    if (_stream) {
+        _stream->update(data.time.j2000Seconds());
+    }
+    Translation::update(data);
+}
+
 glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
+    if (_stream) {
+        return _stream->position(data.time.j2000Seconds());
+    }
+
     glm::dvec3 interpolatedPos = glm::dvec3(0.0);
 
     const Keyframe<glm::dvec3>* lastBefore =
@@ -140,7 +165,16 @@ glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
     return interpolatedPos;
 }
 
+bool HorizonsTranslation::supportsParallelUpdate(const UpdateData&) const {
+    return true;
+}
+
 void HorizonsTranslation::loadData() {
+    if (_streamingWindowSize > 0) {
+        loadStreamingData();
+        return;
+    }
+
     for (const std::string& filePath : _horizonsTextFiles.value()) {
         std::filesystem::path file = absPath(filePath);
         if (!std::filesystem::is_regular_file(file)) {
@@ -180,6 +214,96 @@ void HorizonsTranslation::loadData() {
     }
 }
 
+void HorizonsTranslation::loadStreamingData() {
+    ZoneScoped;
+
+    _stream = nullptr;
+
+    const std::vector<std::string>& files = _horizonsTextFiles.value();
+    if (files.empty()) {
+        return;
+    }
+
+    // All files are merged into a single stream that is cached for the first file
+    std::string information = "streaming";
+    for (const std::string& filePath : files) {
+        const std::filesystem::path file = absPath(filePath);
+        if (!std::filesystem::is_regular_file(file)) {
+            LWARNING(std::format("The Horizons text file '{}' could not be found", file));
+            return;
+        }
+        information += std::format("|{}", file);
+    }
+    const std::filesystem::path cachedFile = FileSys.cacheManager()->cachedFilename(
+        absPath(files.front()),
+        information
+    );
+
+    if (std::filesystem::is_regular_file(cachedFile)) {
+        _stream = HorizonsStream::open(cachedFile, _streamingWindowSize);
+        if (_stream) {
+            LINFO(std::format(
+                "Streaming cached file '{}' for Horizon file '{}'",
+                cachedFile, files.front()
+            ));
+            return;
+        }
+        FileSys.cacheManager()->removeCacheFile(cachedFile);
+    }
+
+    std::vector<HorizonsStream::Keyframe> keyframes;
+    for (const std::string& filePath : files) {
+        const std::filesystem::path file = absPath(filePath);
+        LINFO(std::format("Loading Horizon file '{}'", file));
+
+        HorizonsFile horizonsFile(file);
+        HorizonsResult result = readHorizonsFile(horizonsFile.file());
+        if (result.errorCode != HorizonsResultCode::Valid) {
+            horizonsFile.displayErrorMessage(result.errorCode);
+            LERROR(std::format("Could not read data from Horizons file '{}'", file));
+            return;
+        }
+
+        for (const HorizonsKeyframe& kf : result.data) {
+            keyframes.push_back({
+                .timestamp = kf.time,
+                .position = { kf.position.x, kf.position.y, kf.position.z }
+            });
+        }
+    }
+
+    // Keyframes that exist in multiple files are only used once, from the first file
+    std::stable_sort(
+        keyframes.begin(),
+        keyframes.end(),
+        [](const HorizonsStream::Keyframe& a, const HorizonsStream::Keyframe& b) {
+            return a.timestamp < b.timestamp;
+        }
+    );
+    auto last = std::unique(
+        keyframes.begin(),
+        keyframes.end(),
+        [](const HorizonsStream::Keyframe& a, const HorizonsStream::Keyframe& b) {
+            return a.timestamp == b.timestamp;
+        }
+    );
+    keyframes.erase(last, keyframes.end());
+    if (keyframes.size() < 2) {
+        LERROR(std::format(
+            "At least two keyframes are required for streaming '{}'", files.front()
+        ));
+        return;
+    }
+
+    LINFO("Saving cache");
+    HorizonsStream::save(cachedFile, keyframes);
+    keyframes = std::vector<HorizonsStream::Keyframe>();
+    _stream = HorizonsStream::open(cachedFile, _streamingWindowSize);
+    if (!_stream) {
+        LERROR(std::format("Could not open cache file '{}'", cachedFile));
+    }
+}
+
 bool HorizonsTranslation::readHorizonsTextFile(HorizonsFile& horizonsFile) {
     HorizonsResult result = readHorizonsFile(horizonsFile.file());
     if (result.errorCode != HorizonsResultCode::Valid) {
@@ -32,6 +32,7 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/lua/luastate.h>
 #include <modules/space/horizonsfile.h>
+#include <modules/space/horizonsstream.h>
 #include <memory>
 
 namespace openspace {
@@ -66,13 +67,18 @@ namespace documentation { struct Documentation; }
  *      "Observer range & range-rate" and "Galactic longitude & latitude"
  *   2. Change "Range units" to "kilometers (km)" instead of "astronomical units (au)"
  *   3. Check the "Suppress range-rate" option
+ *
+ * For long trajectories with many keyframes, the translation can stream the keyframes
+ * from a cache file instead of keeping all of them in memory (see HorizonsStream).
  */
 class HorizonsTranslation : public Translation {
 public:
     HorizonsTranslation();
     HorizonsTranslation(const ghoul::Dictionary& dictionary);
 
+    void update(const UpdateData& data) override;
     glm::dvec3 position(const UpdateData& data) const override;
+    bool supportsParallelUpdate(const UpdateData& data) const override;
 
     static documentation::Documentation Documentation();
 
@@ -83,6 +89,7 @@ private:
     };
 
     void loadData();
+    void loadStreamingData();
     bool readHorizonsTextFile(HorizonsFile& horizonsFile);
     bool loadCachedFile(const std::filesystem::path& file);
     void saveCachedFile(const std::filesystem::path& file) const;
@@ -90,6 +97,11 @@ private:
     properties::StringListProperty _horizonsTextFiles;
     ghoul::lua::LuaState _state;
     Timeline<glm::dvec3> _timeline;
+
+    /// The number of keyframes kept in memory in streaming mode, or 0 if all keyframes
+    /// are loaded into the `_timeline`
+    size_t _streamingWindowSize = 0;
+    std::unique_ptr<HorizonsStream> _stream;
 };
 
 } // namespace openspace
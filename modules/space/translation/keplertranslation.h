@@ -69,6 +69,7 @@ public:
     * \param data Provides information from the engine about, for example, the time
     */
     glm::dvec3 position(const UpdateData& data) const override;
+    bool supportsParallelUpdate(const UpdateData& data) const override;
 
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictionary
@@ -31,6 +31,7 @@
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
 #include <filesystem>
@@ -84,6 +85,24 @@ namespace {
 
         std::optional<std::string> fixedDate
             [[codegen::annotation("A date to lock the position to")]];
+
+        struct EphemerisCache {
+            // The beginning of the time window for which positions are precomputed
+            std::string start [[codegen::annotation("A date in ISO 8601 format")]];
+
+            // The end of the time window for which positions are precomputed
+            std::string end [[codegen::annotation("A date in ISO 8601 format")]];
+
+            // The maximum distance in meters between a precomputed position and the
+            // position reported by SPICE. The default value is 1 meter
+            std::optional<double> accuracy [[codegen::greater(0.0)]];
+        };
+        // If this value is specified, SPICE is sampled once for the provided time window
+        // and the positions inside the window are computed from a piecewise polynomial
+        // approximation instead. This avoids calling SPICE every frame and makes it
+        // possible to update the node in parallel with others. The approximation is
+        // stored in the cache and reused the next time the same positions are requested
+        std::optional<EphemerisCache> ephemerisCache;
     };
 #include "spicetranslation_codegen.cpp"
 } // namespace
@@ -105,6 +124,7 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
 
     _target.onChange([this]() {
         _cachedTarget = _target;
+        _ephemeris.reset();
         requireUpdate();
         notifyObservers();
     });
@@ -112,6 +132,7 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
 
     _observer.onChange([this]() {
         _cachedObserver = _observer;
+        _ephemeris.reset();
         requireUpdate();
         notifyObservers();
     });
@@ -119,6 +140,7 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
 
     _frame.onChange([this]() {
         _cachedFrame = _frame;
+        _ephemeris.reset();
         requireUpdate();
         notifyObservers();
     });
@@ -150,6 +172,67 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     }
 
     _frame = p.frame.value_or(_frame);
+
+    if (p.ephemerisCache.has_value()) {
+        const Parameters::EphemerisCache& cache = *p.ephemerisCache;
+        _ephemerisSettings = ChebyshevEphemeris::FitSettings {
+            .start = SpiceManager::ref().ephemerisTimeFromDate(cache.start),
+            .end = SpiceManager::ref().ephemerisTimeFromDate(cache.end),
+            .accuracy = cache.accuracy.value_or(1.0)
+        };
+        if (_ephemerisSettings->start >= _ephemerisSettings->end) {
+            throw ghoul::RuntimeError(
+                "The start of the ephemeris cache has to be before the end",
+                "SpiceTranslation"
+            );
+        }
+    }
+}
+
+void SpiceTranslation::update(const UpdateData& data) {
+    if (_ephemerisSettings.has_value()) {
+        // Positions that were sampled before kernels were loaded or unloaded might be
+        // outdated, so they have to be sampled again
+        const uint64_t generation = SpiceManager::ref().kernelGeneration();
+        if (generation != _ephemerisKernelGeneration) {
+            _ephemeris.reset();
+            _ephemerisKernelGeneration = generation;
+        }
+
+        if (_ephemeris.isIdle()) {
+            std::string information = std::format(
+                "SpiceTranslation|{}|{}|{}", _cachedTarget, _cachedObserver, _cachedFrame
+            );
+            for (const std::filesystem::path& k : SpiceManager::ref().loadedKernels()) {
+                information += std::format("|{}", k);
+            }
+
+            // The names are copied as the function is called from a different thread
+            _ephemeris.start(
+                std::format("{} relative to {}", _cachedTarget, _cachedObserver),
+                ChebyshevEphemeris::cacheFile(information, 3, *_ephemerisSettings),
+                3,
+                *_ephemerisSettings,
+                [target = _cachedTarget, observer = _cachedObserver,
+                 frame = _cachedFrame](double time, std::span<double> values)
+                {
+                    const glm::dvec3 p = SpiceManager::ref().targetPosition(
+                        target,
+                        observer,
+                        frame,
+                        {},
+                        time
+                    ) * 1000.0;
+                    values[0] = p.x;
+                    values[1] = p.y;
+                    values[2] = p.z;
+                }
+            );
+        }
+        _ephemeris.update();
+    }
+
+    Translation::update(data);
 }
 
 glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
@@ -159,6 +242,13 @@ glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     if (_fixedEphemerisTime.has_value()) {
         time = *_fixedEphemerisTime;
     }
+
+    glm::dvec3 res = glm::dvec3(0.0);
+    const ChebyshevEphemeris* ephemeris = _ephemeris.ephemeris();
+    if (ephemeris && ephemeris->evaluate(time, { &res.x, 3 })) {
+        return res;
+    }
+
     return SpiceManager::ref().targetPosition(
         _cachedTarget,
         _cachedObserver,
@@ -169,4 +259,16 @@ glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     ) * 1000.0;
 }
 
+bool SpiceTranslation::supportsParallelUpdate(const UpdateData& data) const {
+    // An outdated ephemeris is replaced in the next update, which has to call SPICE
+    const ChebyshevEphemeris* ephemeris = _ephemeris.ephemeris();
+    if (!ephemeris ||
+        _ephemerisKernelGeneration != SpiceManager::ref().kernelGeneration())
+    {
+        return false;
+    }
+    const double time = _fixedEphemerisTime.value_or(data.time.j2000Seconds());
+    return ephemeris->covers(time);
+}
+
 } // namespace openspace
@@ -27,6 +27,7 @@
 
 #include <openspace/scene/translation.h>
 
+#include <modules/space/chebyshevephemeris.h>
 #include <openspace/properties/stringproperty.h>
 #include <optional>
 
@@ -36,7 +37,9 @@ class SpiceTranslation : public Translation {
 public:
     SpiceTranslation(const ghoul::Dictionary& dictionary);
 
+    void update(const UpdateData& data) override;
     glm::dvec3 position(const UpdateData& data) const override;
+    bool supportsParallelUpdate(const UpdateData& data) const override;
 
     static documentation::Documentation Documentation();
 
@@ -55,6 +58,14 @@ private:
     std::string _cachedFrame;
     std::optional<double> _fixedEphemerisTime;
 
+    /// The time window and accuracy of the precomputed positions, if they are used
+    std::optional<ChebyshevEphemeris::FitSettings> _ephemerisSettings;
+    /// The precomputed positions, which are recreated in the background whenever the
+    /// target, observer, frame, or loaded kernels change
+    BackgroundEphemeris _ephemeris;
+    /// The SpiceManager::kernelGeneration for which the #_ephemeris was created
+    uint64_t _ephemerisKernelGeneration = 0;
+
     glm::dvec3 _position = glm::dvec3(0.0);
 };
 
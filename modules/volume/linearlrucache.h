@@ -43,7 +43,12 @@ public:
     ValueType& get(size_t key);
 
     void evict();
+    void remove(size_t key);
     size_t capacity() const;
+    size_t size() const;
+
+    /// Returns the keys of all entries, starting with the least recently used one
+    const std::list<size_t>& keys() const;
 
 private:
     void insert(size_t key, const ValueType& value);
@@ -38,7 +38,7 @@ bool LinearLruCache<ValueType>::has(size_t key) const {
 
 template <typename ValueType>
 void LinearLruCache<ValueType>::set(size_t key, ValueType value) {
-    auto prev = _cache[key];
+    auto& prev = _cache[key];
     if (prev.first != nullptr) {
         prev.first = value;
         const std::list<size_t>::iterator trackerIter = prev.second;
@@ -68,11 +68,28 @@ void LinearLruCache<ValueType>::evict() {
     _tracker.pop_front();
 }
 
+template <typename ValueType>
+void LinearLruCache<ValueType>::remove(size_t key) {
+    auto& pair = _cache[key];
+    _tracker.erase(pair.second);
+    pair = make_pair(nullptr, _tracker.end());
+}
+
 template <typename ValueType>
 size_t LinearLruCache<ValueType>::capacity() const {
     return _capacity;
 }
 
+template <typename ValueType>
+size_t LinearLruCache<ValueType>::size() const {
+    return _tracker.size();
+}
+
+template <typename ValueType>
+const std::list<size_t>& LinearLruCache<ValueType>::keys() const {
+    return _tracker;
+}
+
 template <typename ValueType>
 void LinearLruCache<ValueType>::insert(size_t key, const ValueType& value) {
     if (_tracker.size() == _capacity) {
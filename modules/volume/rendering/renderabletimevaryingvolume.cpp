@@ -27,15 +27,16 @@
 #include <modules/volume/rendering/basicvolumeraycaster.h>
 #include <modules/volume/rendering/volumeclipplanes.h>
 #include <modules/volume/transferfunctionhandler.h>
+#include <modules/volume/linearlrucache.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
+#include <modules/volume/timestepstreamer.h>
 #include <modules/volume/volumegridtype.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/raycastermanager.h>
 #include <openspace/rendering/renderengine.h>
-#include <openspace/util/histogram.h>
 #include <openspace/rendering/transferfunction.h>
 #include <openspace/util/time.h>
 #include <openspace/util/timemanager.h>
@@ -43,7 +44,9 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 
@@ -157,8 +160,48 @@ namespace {
 
         // @TODO Missing documentation
         std::optional<ghoul::Dictionary> clipPlanes;
+
+        // The maximum number of timesteps that are kept in memory at the same time. The
+        // timesteps are loaded in the background when they are needed
+        std::optional<int> timestepsInMemory [[codegen::greaterequal(2)]];
+
+        // The maximum number of timesteps that are kept on the GPU at the same time
+        std::optional<int> timestepsOnGpu [[codegen::greaterequal(2)]];
+
+        // The number of timesteps in the direction of playback that are loaded before
+        // they are needed. This value has to be smaller than `TimestepsInMemory`
+        std::optional<int> prefetchedTimesteps [[codegen::greaterequal(0)]];
     };
 #include "renderabletimevaryingvolume_codegen.cpp"
+
+    // Reads a timestep and normalizes its values into the range [0, 1]. This function is
+    // called on a background thread
+    std::shared_ptr<openspace::volume::RawVolume<float>> readTimestep(
+                                     const std::filesystem::path& path,
+                                     const openspace::volume::RawVolumeMetadata& metadata,
+                                     bool invertZ)
+    {
+        ZoneScoped;
+
+        std::shared_ptr<openspace::volume::RawVolume<float>> volume;
+        try {
+            openspace::volume::RawVolumeReader<float> reader(path, metadata.dimensions);
+            volume = reader.read(invertZ);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, std::format("{}: '{}'", e.message, path));
+            return nullptr;
+        }
+
+        // TODO: handle normalization properly for different timesteps + transfer function
+        const float min = metadata.minValue;
+        const float diff = metadata.maxValue - metadata.minValue;
+        float* data = volume->data();
+        for (size_t i = 0; i < volume->nCells(); i++) {
+            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
+        }
+        return volume;
+    }
 } // namespace
 
 namespace openspace::volume {
@@ -216,6 +259,23 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
         _gridType = static_cast<std::underlying_type_t<VolumeGridType>>(gridType);
     }
 
+    if (p.timestepsInMemory.has_value()) {
+        _nTimestepsInMemory = static_cast<size_t>(*p.timestepsInMemory);
+    }
+    if (p.timestepsOnGpu.has_value()) {
+        _nTimestepsOnGpu = static_cast<size_t>(*p.timestepsOnGpu);
+    }
+    if (p.prefetchedTimesteps.has_value()) {
+        _nPrefetchedTimesteps = static_cast<size_t>(*p.prefetchedTimesteps);
+    }
+    if (_nPrefetchedTimesteps >= _nTimestepsInMemory) {
+        LWARNING(std::format(
+            "Only {} timesteps fit into memory, limiting the prefetched timesteps",
+            _nTimestepsInMemory
+        ));
+        _nPrefetchedTimesteps = _nTimestepsInMemory - 1;
+    }
+
     addProperty(_brightness);
     addProperty(Fadeable::_opacity);
 }
@@ -237,43 +297,43 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        const std::string path = std::format(
-            "{}/{}.rawvolume", _sourceDirectory.value(), t.baseName
-        );
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read(_invertDataAtZ);
-
-        const float min = t.metadata.minValue;
-        const float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); i++) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
+    // Of multiple timesteps with the same time, the one that was found last is used
+    std::stable_sort(
+        _volumeTimesteps.begin(),
+        _volumeTimesteps.end(),
+        [](const Timestep& lhs, const Timestep& rhs) {
+            return lhs.metadata.time < rhs.metadata.time;
         }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (size_t i = 0; i < t.rawVolume->nCells(); i++) {
-            t.histogram->add(data[i]);
+    );
+    auto unique = std::unique(
+        _volumeTimesteps.rbegin(),
+        _volumeTimesteps.rend(),
+        [](const Timestep& lhs, const Timestep& rhs) {
+            return lhs.metadata.time == rhs.metadata.time;
         }
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            GL_TEXTURE_3D,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
+    );
+    _volumeTimesteps.erase(_volumeTimesteps.begin(), unique.base());
+
+    // Only the metadata is read here, the volumes are streamed in while rendering
+    if (!_volumeTimesteps.empty()) {
+        _streamer = std::make_unique<TimestepStreamer<RawVolume<float>>>(
+            *global::taskScheduler,
+            _volumeTimesteps.size(),
+            _nTimestepsInMemory,
+            _nPrefetchedTimesteps,
+            [timesteps = _volumeTimesteps, directory = _sourceDirectory.value(),
+             invertZ = _invertDataAtZ](size_t index)
+            {
+                const Timestep& t = timesteps[index];
+                const std::string path = std::format(
+                    "{}/{}.rawvolume", directory, t.baseName
+                );
+                return readTimestep(path, t.metadata, invertZ);
+            }
         );
-        t.texture->uploadTexture();
+        _textures = std::make_unique<
+            LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>>
+        >(_nTimestepsOnGpu, _volumeTimesteps.size());
     }
 
     _clipPlanes->initialize();
@@ -347,10 +407,42 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::filesystem::pa
     Timestep t;
     t.metadata = metadata;
     t.baseName = path.stem();
-    t.inRam = false;
-    t.onGpu = false;
+    _volumeTimesteps.push_back(std::move(t));
+}
+
+std::shared_ptr<ghoul::opengl::Texture> RenderableTimeVaryingVolume::timestepTexture(
+                                                                             size_t index)
+{
+    if (_textures->has(index)) {
+        return _textures->use(index);
+    }
+
+    std::shared_ptr<RawVolume<float>> volume = _streamer->timestep(index);
+    if (!volume) {
+        return nullptr;
+    }
+
+    ZoneScopedN("Upload");
+
+    auto texture = std::make_shared<ghoul::opengl::Texture>(
+        _volumeTimesteps[index].metadata.dimensions,
+        GL_TEXTURE_3D,
+        ghoul::opengl::Texture::Format::Red,
+        GL_RED,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Clamp
+    );
+    texture->setPixelData(
+        reinterpret_cast<void*>(volume->data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    texture->uploadTexture();
+    // The volume might be evicted from memory while the texture is still in use
+    texture->purgeFromRAM();
 
-    _volumeTimesteps[t.metadata.time] = std::move(t);
+    _textures->set(index, texture);
+    return texture;
 }
 
 RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimestep() {
@@ -360,10 +452,15 @@ RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimes
     const double currentTime = global::timeManager->time().j2000Seconds();
 
     // Get the first item with time > currentTime
-    auto currentTimestepIt = _volumeTimesteps.upper_bound(currentTime);
+    auto currentTimestepIt = std::upper_bound(
+        _volumeTimesteps.begin(),
+        _volumeTimesteps.end(),
+        currentTime,
+        [](double time, const Timestep& t) { return time < t.metadata.time; }
+    );
     if (currentTimestepIt == _volumeTimesteps.end()) {
         // No such timestep was found: show last timestep if it is within the time margin.
-        Timestep* lastTimestep = &(_volumeTimesteps.rbegin()->second);
+        Timestep* lastTimestep = &_volumeTimesteps.back();
         const double threshold =
             lastTimestep->metadata.time + static_cast<double>(_secondsAfter);
         return currentTime < threshold ? lastTimestep : nullptr;
@@ -371,7 +468,7 @@ RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimes
 
     if (currentTimestepIt == _volumeTimesteps.begin()) {
         // No such timestep was found: show first timestep if it is within the time margin
-        Timestep* firstTimestep = &(_volumeTimesteps.begin()->second);
+        Timestep* firstTimestep = &_volumeTimesteps.front();
         const double threshold =
             firstTimestep->metadata.time - static_cast<double>(_secondsBefore);
         return currentTime >= threshold ? firstTimestep : nullptr;
@@ -379,7 +476,7 @@ RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimes
 
     // Get the last item with time <= currentTime
     currentTimestepIt--;
-    return &(currentTimestepIt->second);
+    return &(*currentTimestepIt);
 }
 
 int RenderableTimeVaryingVolume::timestepIndex(
@@ -388,14 +485,7 @@ int RenderableTimeVaryingVolume::timestepIndex(
     if (!t) {
         return -1;
     }
-    int index = 0;
-    for (const std::pair<const double, Timestep>& it : _volumeTimesteps) {
-        if (&(it.second) == t) {
-            return index;
-        }
-        index++;
-    }
-    return -1;
+    return static_cast<int>(t - _volumeTimesteps.data());
 }
 
 // @TODO Can this be turned into a const ref?
@@ -405,14 +495,10 @@ RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::timestepFrom
     if (target < 0) {
         target = 0;
     }
-    int index = 0;
-    for (std::pair<const double, Timestep>& it : _volumeTimesteps) {
-        if (index == target) {
-            return &(it.second);
-        }
-        index++;
+    if (static_cast<size_t>(target) >= _volumeTimesteps.size()) {
+        return nullptr;
     }
-    return nullptr;
+    return &_volumeTimesteps[target];
 }
 
 void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
@@ -422,21 +508,50 @@ void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
     }
 }
 
-void RenderableTimeVaryingVolume::update(const UpdateData&) {
+void RenderableTimeVaryingVolume::update(const UpdateData& data) {
     _transferFunction->update();
 
     if (_raycaster) {
-        Timestep* t = currentTimestep();
+        const Timestep* t = currentTimestep();
+        if (!t) {
+            _shownTimestep = nullptr;
+        }
+        else if (_streamer) {
+            const double time = data.time.j2000Seconds();
+            if (time != _lastTime) {
+                _isMovingForward = time > _lastTime;
+                _lastTime = time;
+            }
+
+            const size_t index = static_cast<size_t>(timestepIndex(t));
+            _streamer->update(index, _isMovingForward);
+
+            // Until the current timestep has been loaded, the previous one is shown
+            std::shared_ptr<ghoul::opengl::Texture> texture = timestepTexture(index);
+            if (texture) {
+                _shownTimestep = t;
+                _raycaster->setVolumeTexture(std::move(texture));
+            }
+
+            // Upload the next timestep ahead of time, if it has already been loaded
+            const bool hasNext = _isMovingForward ?
+                index + 1 < _volumeTimesteps.size() :
+                index > 0;
+            if (hasNext) {
+                timestepTexture(_isMovingForward ? index + 1 : index - 1);
+            }
+        }
 
         // Set scale and translation matrices:
         // The original data cube is a unit cube centered in 0
         // ie with lower bound from (-0.5, -0.5, -0.5) and upper bound (0.5, 0.5, 0.5)
-        if (t && t->texture) {
+        if (_shownTimestep) {
+            const RawVolumeMetadata& metadata = _shownTimestep->metadata;
             if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
                 const glm::dvec3 scale =
-                    t->metadata.upperDomainBound - t->metadata.lowerDomainBound;
+                    metadata.upperDomainBound - metadata.lowerDomainBound;
                 const glm::dvec3 translation =
-                    (t->metadata.lowerDomainBound + t->metadata.upperDomainBound) * 0.5f;
+                    (metadata.lowerDomainBound + metadata.upperDomainBound) * 0.5f;
 
                 glm::dmat4 modelTransform = glm::translate(glm::dmat4(1.0), translation);
                 const glm::dmat4 scaleMatrix = glm::scale(glm::dmat4(1.0), scale);
@@ -449,11 +564,10 @@ void RenderableTimeVaryingVolume::update(const UpdateData&) {
                 _raycaster->setModelTransform(
                     glm::scale(
                         glm::dmat4(1.0),
-                        glm::dvec3(2.0 * t->metadata.upperDomainBound[0])
+                        glm::dvec3(2.0 * metadata.upperDomainBound[0])
                     )
                 );
             }
-            _raycaster->setVolumeTexture(t->texture);
         }
         else {
             _raycaster->setVolumeTexture(nullptr);
@@ -480,6 +594,9 @@ void RenderableTimeVaryingVolume::deinitializeGL() {
         global::raycasterManager->detachRaycaster(*_raycaster);
         _raycaster = nullptr;
     }
+    _shownTimestep = nullptr;
+    _textures = nullptr;
+    _streamer = nullptr;
 }
 
 } // namespace openspace::volume
@@ -34,16 +34,21 @@
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/triggerproperty.h>
 #include <openspace/rendering/transferfunction.h>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class Texture; }
 
 namespace openspace {
-    class Histogram;
     struct RenderData;
 } // namespace openspace
 
 namespace openspace::volume {
 
 class BasicVolumeRaycaster;
+template <typename T> class LinearLruCache;
 template <typename T> class RawVolume;
+template <typename T> class TimestepStreamer;
 class VolumeClipPlanes;
 
 class RenderableTimeVaryingVolume : public Renderable {
@@ -62,12 +67,7 @@ public:
 private:
     struct Timestep {
         std::filesystem::path baseName;
-        bool inRam;
-        bool onGpu;
         RawVolumeMetadata metadata;
-        std::shared_ptr<RawVolume<float>> rawVolume;
-        std::shared_ptr<ghoul::opengl::Texture> texture;
-        std::shared_ptr<Histogram> histogram;
     };
 
     Timestep* currentTimestep();
@@ -77,6 +77,13 @@ private:
 
     void loadTimestepMetadata(const std::filesystem::path& path);
 
+    /**
+     * Returns the texture for the timestep with the provided \p index, uploading it if
+     * the timestep is in memory but not on the GPU yet, or `nullptr` if the timestep has
+     * not been loaded yet.
+     */
+    std::shared_ptr<ghoul::opengl::Texture> timestepTexture(size_t index);
+
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
 
@@ -92,10 +99,22 @@ private:
     properties::TriggerProperty _triggerTimeJump;
     properties::IntProperty _jumpToTimestep;
 
-    std::map<double, Timestep> _volumeTimesteps;
+    /// Sorted by time
+    std::vector<Timestep> _volumeTimesteps;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
     bool _invertDataAtZ;
 
+    size_t _nTimestepsInMemory = 8;
+    size_t _nTimestepsOnGpu = 3;
+    size_t _nPrefetchedTimesteps = 3;
+    std::unique_ptr<TimestepStreamer<RawVolume<float>>> _streamer;
+    std::unique_ptr<LinearLruCache<std::shared_ptr<ghoul::opengl::Texture>>> _textures;
+    /// The timestep whose texture is shown, which might lag behind the current timestep
+    /// while it is being loaded
+    const Timestep* _shownTimestep = nullptr;
+    bool _isMovingForward = true;
+    double _lastTime = 0.0;
+
     std::shared_ptr<openspace::TransferFunction> _transferFunction;
 };
 
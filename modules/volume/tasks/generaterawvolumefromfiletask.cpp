@@ -106,17 +106,16 @@ void GenerateRawVolumeFromFileTask::perform(const Task::ProgressCallback& progre
     }
 
     // Get min/max x, y, z position - ie. domain bounds of the volume
-    for (const dataloader::Dataset::Entry& p : data.entries)
-    {
+    for (const glm::vec3& p : data.positions) {
         _lowerDomainBound = glm::vec3(
-            std::min(_lowerDomainBound.x, p.position.x),
-            std::min(_lowerDomainBound.y, p.position.y),
-            std::min(_lowerDomainBound.z, p.position.z)
+            std::min(_lowerDomainBound.x, p.x),
+            std::min(_lowerDomainBound.y, p.y),
+            std::min(_lowerDomainBound.z, p.z)
         );
         _upperDomainBound = glm::vec3(
-            std::max(_upperDomainBound.x, p.position.x),
-            std::max(_upperDomainBound.y, p.position.y),
-            std::max(_upperDomainBound.z, p.position.z)
+            std::max(_upperDomainBound.x, p.x),
+            std::max(_upperDomainBound.y, p.y),
+            std::max(_upperDomainBound.z, p.z)
         );
     }
     progressCallback(0.4f);
@@ -144,9 +143,9 @@ void GenerateRawVolumeFromFileTask::perform(const Task::ProgressCallback& progre
 
     // Write data into volume data structure
     int k = 0;
-    for (auto& entry : data.entries) {
+    for (size_t i = 0; i < data.nEntries(); i++) {
         // Get the closest i, j , k voxel that should contain this data
-        glm::vec3 normalizedPos{ (entry.position - _lowerDomainBound) /
+        glm::vec3 normalizedPos{ (data.positions[i] - _lowerDomainBound) /
             (_upperDomainBound - _lowerDomainBound) };
 
         glm::uvec3 cell{
@@ -158,7 +157,7 @@ void GenerateRawVolumeFromFileTask::perform(const Task::ProgressCallback& progre
             )
         };
 
-        const float value = entry.data[dataIndex->index];
+        const float value = data.values[dataIndex->index][i];
         minVal = std::min(minVal, value);
         maxVal = std::max(maxVal, value);
 
@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_VOLUME___TIMESTEPSTREAMER___H__
+#define __OPENSPACE_MODULE_VOLUME___TIMESTEPSTREAMER___H__
+
+#include <modules/volume/linearlrucache.h>
+#include <openspace/util/taskscheduler.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace openspace::volume {
+
+/**
+ * Keeps a limited number of the timesteps of a time-varying dataset in memory. The
+ * timesteps are loaded as tasks of a TaskScheduler, starting with the current timestep
+ * and followed by the next timesteps in the direction of playback, so that they are
+ * available by the time they are needed. These timesteps form the window of the
+ * streamer. Once more timesteps are loaded than fit into memory, the least recently used
+ * timestep outside of the window is evicted.
+ *
+ * The timesteps that are in memory and the timesteps that are loading never exceed the
+ * capacity together. Loads that finish after the window has moved past their timestep
+ * are discarded rather than evicting timesteps that are still needed.
+ *
+ * The TimestepStreamer itself must only be used from a single thread.
+ */
+template <typename T>
+class TimestepStreamer {
+public:
+    /**
+     * Loads the timestep with the provided index. It is called on a worker thread and
+     * must not throw. If a timestep could not be loaded, `nullptr` should be returned, in
+     * which case the timestep is not requested again.
+     */
+    using Loader = std::function<std::shared_ptr<T>(size_t timestep)>;
+
+    /**
+     * Creates a streamer without any timesteps in memory.
+     *
+     * \param scheduler The TaskScheduler on which the timesteps are loaded
+     * \param nTimesteps The total number of timesteps in the dataset
+     * \param capacity The maximum number of timesteps that are kept in memory
+     * \param nPrefetch The number of timesteps following the current timestep that are
+     *        loaded ahead of time. Has to be smaller than the \p capacity, as prefetched
+     *        timesteps would otherwise evict each other
+     * \param loader The function that loads a single timestep
+     *
+     * \pre \p capacity must be positive
+     * \pre \p nPrefetch must be smaller than \p capacity
+     */
+    TimestepStreamer(TaskScheduler& scheduler, size_t nTimesteps, size_t capacity,
+        size_t nPrefetch, Loader loader);
+
+    /**
+     * Waits for all timesteps that are currently loading.
+     */
+    ~TimestepStreamer();
+
+    /**
+     * Moves the finished timesteps that are inside the window into memory and starts
+     * loading the \p current timestep and the prefetched timesteps that are neither in
+     * memory nor loading, as long as there is room for them.
+     *
+     * \param current The index of the timestep that is currently shown
+     * \param isMovingForward Whether time is moving forwards, which determines whether
+     *        the following or the preceding timesteps are prefetched
+     */
+    void update(size_t current, bool isMovingForward);
+
+    /**
+     * Returns the timestep with the provided \p index if it is in memory and `nullptr`
+     * otherwise.
+     */
+    std::shared_ptr<T> timestep(size_t index);
+
+    /**
+     * Returns the timestep with the provided \p index, waiting for it to finish loading
+     * if necessary. If the timestep is neither in memory nor loading, it is loaded.
+     */
+    std::shared_ptr<T> waitForTimestep(size_t index);
+
+    /**
+     * Returns the number of timesteps that are currently loading.
+     */
+    size_t nLoading() const;
+
+private:
+    struct Load {
+        explicit Load(TaskScheduler& scheduler);
+
+        std::shared_ptr<T> value;
+        std::atomic_bool isFinished = false;
+        /// Declared last so that it waits for the task before the value is destroyed
+        TaskScheduler::TaskGroup group;
+    };
+
+    bool isInWindow(size_t index) const;
+
+    /// Evicts the least recently used timestep outside of the window and returns whether
+    /// there was one
+    bool evictOutsideWindow();
+
+    /// Starts loading the timestep if it is neither in memory nor loading. Unless
+    /// \p force is `true`, this only happens if it fits into memory
+    void request(size_t index, bool force);
+    void finishLoading(size_t index, std::shared_ptr<T> value);
+
+    TaskScheduler& _scheduler;
+    const size_t _nTimesteps;
+    const size_t _nPrefetch;
+    Loader _loader;
+
+    /// The timestep that was passed to the last call of update, or `_nTimesteps` before
+    size_t _current;
+    bool _isMovingForward = true;
+
+    LinearLruCache<std::shared_ptr<T>> _cache;
+    std::map<size_t, std::unique_ptr<Load>> _loading;
+    /// Timesteps that could not be loaded are not requested again
+    std::vector<bool> _hasFailed;
+};
+
+} // namespace openspace::volume
+
+#include "timestepstreamer.inl"
+
+#endif // __OPENSPACE_MODULE_VOLUME___TIMESTEPSTREAMER___H__
@@ -0,0 +1,176 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+
+namespace openspace::volume {
+
+template <typename T>
+TimestepStreamer<T>::Load::Load(TaskScheduler& scheduler)
+    : group(scheduler)
+{}
+
+template <typename T>
+TimestepStreamer<T>::TimestepStreamer(TaskScheduler& scheduler, size_t nTimesteps,
+                                      size_t capacity, size_t nPrefetch, Loader loader)
+    : _scheduler(scheduler)
+    , _nTimesteps(nTimesteps)
+    , _nPrefetch(nPrefetch)
+    , _loader(std::move(loader))
+    , _current(nTimesteps)
+    , _cache(capacity, nTimesteps)
+    , _hasFailed(nTimesteps, false)
+{
+    ghoul_assert(capacity > 0, "Capacity must be positive");
+    ghoul_assert(nPrefetch < capacity, "Prefetched timesteps must fit into memory");
+}
+
+template <typename T>
+TimestepStreamer<T>::~TimestepStreamer() {
+    // The task groups wait for their tasks when they are destroyed
+    _loading.clear();
+}
+
+template <typename T>
+void TimestepStreamer<T>::update(size_t current, bool isMovingForward) {
+    ZoneScoped;
+
+    ghoul_assert(current < _nTimesteps, "Timestep out of bounds");
+
+    _current = current;
+    _isMovingForward = isMovingForward;
+
+    for (auto it = _loading.begin(); it != _loading.end();) {
+        if (it->second->isFinished) {
+            it->second->group.wait();
+            // Timesteps that are no longer needed would only evict the ones that are
+            if (isInWindow(it->first)) {
+                finishLoading(it->first, std::move(it->second->value));
+            }
+            it = _loading.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+
+    // The current timestep is used every frame, which prevents it from being evicted by
+    // the prefetched timesteps
+    if (_cache.has(current)) {
+        _cache.use(current);
+    }
+    request(current, false);
+    for (size_t i = 1; i <= _nPrefetch; i++) {
+        if (isMovingForward && current + i < _nTimesteps) {
+            request(current + i, false);
+        }
+        else if (!isMovingForward && current >= i) {
+            request(current - i, false);
+        }
+    }
+}
+
+template <typename T>
+std::shared_ptr<T> TimestepStreamer<T>::timestep(size_t index) {
+    ghoul_assert(index < _nTimesteps, "Timestep out of bounds");
+    return _cache.has(index) ? _cache.use(index) : nullptr;
+}
+
+template <typename T>
+std::shared_ptr<T> TimestepStreamer<T>::waitForTimestep(size_t index) {
+    ghoul_assert(index < _nTimesteps, "Timestep out of bounds");
+
+    request(index, true);
+    auto it = _loading.find(index);
+    if (it != _loading.end()) {
+        it->second->group.wait();
+        finishLoading(index, std::move(it->second->value));
+        _loading.erase(it);
+    }
+    return timestep(index);
+}
+
+template <typename T>
+size_t TimestepStreamer<T>::nLoading() const {
+    return _loading.size();
+}
+
+template <typename T>
+bool TimestepStreamer<T>::isInWindow(size_t index) const {
+    if (_current == _nTimesteps) {
+        return false;
+    }
+    return _isMovingForward ?
+        index >= _current && index - _current <= _nPrefetch :
+        index <= _current && _current - index <= _nPrefetch;
+}
+
+template <typename T>
+bool TimestepStreamer<T>::evictOutsideWindow() {
+    for (size_t key : _cache.keys()) {
+        if (!isInWindow(key)) {
+            _cache.remove(key);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+void TimestepStreamer<T>::request(size_t index, bool force) {
+    if (_cache.has(index) || _hasFailed[index] || _loading.contains(index)) {
+        return;
+    }
+
+    if (_cache.size() + _loading.size() >= _cache.capacity() &&
+        !evictOutsideWindow() && !force)
+    {
+        // Loads of timesteps that have left the window occupy the remaining memory. They
+        // are discarded once they finish, at which point this timestep is requested again
+        return;
+    }
+
+    auto load = std::make_unique<Load>(_scheduler);
+    load->group.run([this, index, l = load.get()]() {
+        l->value = _loader(index);
+        l->isFinished = true;
+    });
+    _loading[index] = std::move(load);
+}
+
+template <typename T>
+void TimestepStreamer<T>::finishLoading(size_t index, std::shared_ptr<T> value) {
+    if (value) {
+        if (_cache.size() == _cache.capacity()) {
+            evictOutsideWindow();
+        }
+        _cache.set(index, std::move(value));
+    }
+    else {
+        _hasFailed[index] = true;
+    }
+}
+
+} // namespace openspace::volume
@@ -0,0 +1,79 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#version __CONTEXT__
+
+#include "PowerScaling/powerScaling_vs.hglsl"
+
+// One instance per glyph. The rectangle of the glyph is relative to the anchor of the
+// label and measured in pixels of the font
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in int in_label;
+layout(location = 2) in vec4 in_rectangle;
+layout(location = 3) in vec4 in_texCoords;
+layout(location = 4) in vec4 in_outlineTexCoords;
+
+out vec2 vs_st;
+out vec2 vs_outlineSt;
+out float vs_depth;
+
+uniform dmat4 modelViewProjection;
+uniform float scale;
+uniform bool faceCamera;
+uniform vec3 orthoRight;
+uniform vec3 orthoUp;
+uniform dvec3 cameraPosition;
+uniform dvec3 cameraLookUp;
+// Contains 1 for every label that is visible and 0 for the labels that were culled
+uniform samplerBuffer labelVisibility;
+
+
+void main() {
+  if (texelFetch(labelVisibility, in_label).r == 0.0) {
+    // Collapse the glyphs of culled labels into a point outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    vs_depth = 1.0;
+    return;
+  }
+
+  // The corners of the triangle strip are (0,0), (1,0), (0,1), (1,1)
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  vec2 offset = mix(in_rectangle.xy, in_rectangle.zw, corner);
+  vs_st = mix(in_texCoords.xy, in_texCoords.zw, corner);
+  vs_outlineSt = mix(in_outlineTexCoords.xy, in_outlineTexCoords.zw, corner);
+
+  vec3 right = orthoRight;
+  vec3 up = orthoUp;
+  if (!faceCamera) {
+    dvec3 normal = normalize(cameraPosition - dvec3(in_position));
+    right = vec3(normalize(cross(cameraLookUp, normal)));
+    up = vec3(cross(normal, dvec3(right)));
+  }
+
+  dvec3 position = dvec3(in_position) + dvec3((offset.x * right + offset.y * up) * scale);
+  vec4 positionClipSpace = vec4(modelViewProjection * dvec4(position, 1.0));
+  vec4 positionScreenSpace = z_normalization(positionClipSpace);
+  gl_Position = positionScreenSpace;
+  vs_depth = positionScreenSpace.w;
+}
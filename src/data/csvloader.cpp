@@ -25,7 +25,9 @@
 #include <openspace/data/csvloader.h>
 
 #include <openspace/data/datamapping.h>
+#include <openspace/engine/globals.h>
 #include <openspace/util/progressbar.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -33,44 +35,48 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/misc/stringhelper.h>
 #include <algorithm>
+#include <cerrno>
 #include <cmath>
-#include <cctype>
+#include <cstdlib>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
 
 namespace {
     constexpr std::string_view _loggerCat = "DataLoader: CSV";
+
+    // Number of rows that are converted in one task
+    constexpr size_t RowsPerChunk = 16384;
+
+    float readFloatData(const std::string& str) {
+        // Same semantics as std::stof (leading whitespace, hexadecimal values, inf and
+        // nan), but without the cost of an exception for every non-numeric value
+        char* end = nullptr;
+        errno = 0;
+        const float result = std::strtof(str.c_str(), &end);
+        if (end == str.c_str()) {
+            return std::numeric_limits<float>::quiet_NaN();
+        }
+        if (errno == ERANGE) {
+            throw std::out_of_range(std::format("Value '{}' is out of range", str));
+        }
+        return std::isfinite(result) ? result : std::numeric_limits<float>::quiet_NaN();
+    }
 } // namespace
 
 namespace openspace::dataloader::csv {
 
 Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> specs) {
-    ghoul_assert(std::filesystem::exists(filePath), "File must exist");
+    ZoneScoped;
 
-    auto readFloatData = [](const std::string& str) -> float {
-        float result = 0.f;
-#ifdef WIN32
-        auto [p, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
-        if (ec == std::errc() && std::isfinite(result)) {
-            return result;
-        }
-        return std::numeric_limits<float>::quiet_NaN();
-#else // ^^^^ WIN32 // !WIN32 vvvv
-        // clang is missing float support for std::from_chars
-        try {
-            result = std::stof(str, nullptr);
-            if (std::isfinite(result)) {
-                return result;
-            }
-        }
-        catch (const std::invalid_argument&) {}
-        return NAN;
-#endif // WIN32
-    };
+    ghoul_assert(std::filesystem::exists(filePath), "File must exist");
 
     LDEBUG("Parsing CSV file");
 
@@ -83,7 +89,6 @@ Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> s
     }
 
     Dataset res;
-    res.entries.reserve(rows.size() - 1);
 
     // First row is the column names
     const std::vector<std::string>& columns = rows.front();
@@ -174,61 +179,124 @@ Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> s
     LINFO(std::format("Loading {} rows with {} columns", rows.size(), columns.size()));
     ProgressBar progress = ProgressBar(static_cast<int>(rows.size()));
 
-    std::set<int> uniqueTextureIndicesInData;
-
+    // The rows are converted in chunks in parallel and then merged in order
+    struct Chunk {
+        size_t begin = 0;
+        size_t end = 0;
+        // Only the columns of this dataset are used
+        Dataset entries;
+        float maxPositionComponent = 0.f;
+        std::set<int> uniqueTextureIndices;
+    };
+    std::vector<Chunk> chunks;
     // Skip first row (column names)
-    for (size_t rowIdx = 1; rowIdx < rows.size(); ++rowIdx) {
-        const std::vector<std::string>& row = rows[rowIdx];
-
-        Dataset::Entry entry;
-        entry.data.reserve(nDataColumns);
-
-        for (size_t i = 0; i < row.size(); i++) {
-            // Check if column should be exluded. Note that list of indices is sorted
-            // so we can do a binary search
-            if (hasExcludeColumns &&
-                std::binary_search(skipColumns.begin(), skipColumns.end(), i))
-            {
-                continue;
-            }
+    for (size_t i = 1; i < rows.size(); i += RowsPerChunk) {
+        chunks.push_back({ .begin = i, .end = std::min(i + RowsPerChunk, rows.size()) });
+    }
 
-            const std::string& strValue = row[i];
+    std::mutex progressMutex;
+    int nProcessedRows = 1;
+    auto convert = [&](Chunk& chunk) {
+        ZoneScopedN("Convert rows");
 
-            // For now, all values are converted to float
-            const float value = readFloatData(strValue);
+        // The values of the current row, which are reused between rows
+        std::vector<float> data;
+        data.reserve(nDataColumns);
 
-            if (i == xColumn) {
-                entry.position.x = value;
-            }
-            else if (i == yColumn) {
-                entry.position.y = value;
-            }
-            else if (i == zColumn) {
-                entry.position.z = value;
-            }
-            else if (i == nameColumn) {
-                // Note that were we use the original stirng value, rather than the
-                // converted one
-                entry.comment = strValue;
-            }
-            else {
-                entry.data.push_back(value);
+        const size_t nRows = chunk.end - chunk.begin;
+        chunk.entries.positions.reserve(nRows);
+        chunk.entries.values.resize(nDataColumns);
+        for (std::vector<float>& column : chunk.entries.values) {
+            column.reserve(nRows);
+        }
+        for (size_t rowIdx = chunk.begin; rowIdx < chunk.end; ++rowIdx) {
+            const std::vector<std::string>& row = rows[rowIdx];
+
+            glm::vec3 position = glm::vec3(0.f);
+            std::optional<std::string_view> comment;
+            data.clear();
+
+            for (size_t i = 0; i < row.size(); i++) {
+                // Check if column should be exluded. Note that list of indices is sorted
+                // so we can do a binary search
+                if (hasExcludeColumns &&
+                    std::binary_search(skipColumns.begin(), skipColumns.end(), i))
+                {
+                    continue;
+                }
+
+                const std::string& strValue = row[i];
+
+                // For now, all values are converted to float
+                const float value = readFloatData(strValue);
+
+                if (i == xColumn) {
+                    position.x = value;
+                }
+                else if (i == yColumn) {
+                    position.y = value;
+                }
+                else if (i == zColumn) {
+                    position.z = value;
+                }
+                else if (i == nameColumn) {
+                    // Note that were we use the original stirng value, rather than the
+                    // converted one
+                    comment = strValue;
+                }
+                else {
+                    data.push_back(value);
+                }
+
+                if (i == textureColumn) {
+                    chunk.uniqueTextureIndices.emplace(static_cast<int>(value));
+                }
             }
 
-            if (i == textureColumn) {
-                uniqueTextureIndicesInData.emplace(static_cast<int>(value));
+            const glm::vec3 positive = glm::abs(position);
+            const float max = glm::compMax(positive);
+            if (max > chunk.maxPositionComponent) {
+                chunk.maxPositionComponent = max;
             }
-        }
 
-        const glm::vec3 positive = glm::abs(entry.position);
-        const float max = glm::compMax(positive);
-        if (max > res.maxPositionComponent) {
-            res.maxPositionComponent = max;
+            // Rows with a different number of values than the header are padded or cut
+            // so that all columns have the same length
+            data.resize(nDataColumns, 0.f);
+            chunk.entries.addEntry(position, data, comment);
         }
 
-        res.entries.push_back(entry);
+        const std::lock_guard lock(progressMutex);
+        nProcessedRows += static_cast<int>(chunk.end - chunk.begin);
+        progress.print(nProcessedRows);
+    };
+
+    if (chunks.size() <= 1) {
+        for (Chunk& chunk : chunks) {
+            convert(chunk);
+        }
+    }
+    else {
+        TaskScheduler::TaskGroup group(*global::taskScheduler);
+        for (Chunk& chunk : chunks) {
+            group.run([&convert, &chunk]() { convert(chunk); });
+        }
+        group.wait();
+    }
 
-        progress.print(static_cast<int>(rowIdx + 1));
+    std::set<int> uniqueTextureIndicesInData;
+    res.positions.reserve(rows.size() - 1);
+    res.values.resize(nDataColumns);
+    for (std::vector<float>& column : res.values) {
+        column.reserve(rows.size() - 1);
+    }
+    for (Chunk& chunk : chunks) {
+        res.append(chunk.entries);
+        chunk.entries = Dataset();
+        res.maxPositionComponent = std::max(
+            res.maxPositionComponent,
+            chunk.maxPositionComponent
+        );
+        uniqueTextureIndicesInData.merge(chunk.uniqueTextureIndices);
     }
 
     // Load the textures. Skip textures that are not included in the dataset
@@ -34,14 +34,18 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/exception.h>
 #include <ghoul/misc/stringhelper.h>
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <span>
 #include <string_view>
 
 namespace {
-    constexpr int8_t DataCacheFileVersion = 13;
-    constexpr int8_t LabelCacheFileVersion = 11;
+    constexpr int8_t DataCacheFileVersion = 14;
+    constexpr int8_t LabelCacheFileVersion = 13;
     constexpr int8_t ColorCacheFileVersion = 11;
 
     template <typename T, typename U>
@@ -51,6 +55,166 @@ namespace {
         }
     }
 
+    // Every section of columnar data in a data cache file starts at a multiple of this
+    // value, measured from the beginning of the file, so that the sections can be used
+    // in-place after reading or mapping the file
+    constexpr size_t CacheSectionAlignment = 16;
+
+    size_t alignedCacheOffset(size_t offset) {
+        return (offset + CacheSectionAlignment - 1) & ~(CacheSectionAlignment - 1);
+    }
+
+    void alignCacheSection(std::ofstream& file) {
+        const size_t offset = static_cast<size_t>(file.tellp());
+        constexpr std::array<char, CacheSectionAlignment> Padding = {};
+        file.write(Padding.data(), alignedCacheOffset(offset) - offset);
+    }
+
+    void writeCacheSection(std::ofstream& file, const void* data, size_t size) {
+        alignCacheSection(file);
+        file.write(reinterpret_cast<const char*>(data), size);
+    }
+
+    // Sequentially reads values out of the memory of a data cache file. Reading past the
+    // end of the memory marks the reader as invalid and returns zero-initialized values
+    struct CacheReader {
+        std::span<const std::byte> memory;
+        size_t offset = 0;
+        bool isValid = true;
+
+        template <typename T>
+        void read(T& value) {
+            if (offset + sizeof(T) > memory.size()) {
+                isValid = false;
+                value = T();
+                return;
+            }
+            std::memcpy(&value, memory.data() + offset, sizeof(T));
+            offset += sizeof(T);
+        }
+
+        std::string readString(size_t length) {
+            if (offset + length > memory.size()) {
+                isValid = false;
+                return std::string();
+            }
+            const char* begin = reinterpret_cast<const char*>(memory.data() + offset);
+            offset += length;
+            return std::string(begin, length);
+        }
+
+        std::span<const std::byte> section(uint64_t size) {
+            const size_t begin = alignedCacheOffset(offset);
+            if (begin > memory.size() || size > memory.size() - begin) {
+                isValid = false;
+                return std::span<const std::byte>();
+            }
+            offset = begin + size;
+            return memory.subspan(begin, size);
+        }
+    };
+
+    // Reads a section of `count` values that was written with writeCacheSection. Returns
+    // false if the section does not fit in the remaining memory
+    template <typename T>
+    bool readCacheSection(CacheReader& reader, uint64_t count, T& result) {
+        using Value = typename T::value_type;
+        static_assert(std::is_trivially_copyable_v<Value>);
+
+        if (count > reader.memory.size() / sizeof(Value)) {
+            reader.isValid = false;
+            return false;
+        }
+        std::span<const std::byte> section = reader.section(count * sizeof(Value));
+        if (!reader.isValid) {
+            return false;
+        }
+        result.resize(count);
+        std::memcpy(result.data(), section.data(), section.size());
+        return true;
+    }
+
+    // Sequentially reads values out of a data cache file. Reading past the end of the
+    // file marks the reader as invalid and returns zero-initialized values
+    struct CacheFileReader {
+        std::ifstream& file;
+        size_t fileSize = 0;
+        bool isValid = true;
+
+        template <typename T>
+        void read(T& value) {
+            file.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!file.good()) {
+                isValid = false;
+                value = T();
+            }
+        }
+
+        std::string readString(size_t length) {
+            const size_t offset = static_cast<size_t>(file.tellg());
+            if (!isValid || !file.good() || length > fileSize - offset) {
+                isValid = false;
+                return std::string();
+            }
+            std::string result;
+            result.resize(length);
+            file.read(result.data(), length);
+            isValid = file.good();
+            return result;
+        }
+
+        // Reads a section of `count` values that was written with writeCacheSection.
+        // Returns false if the section does not fit in the remainder of the file
+        template <typename T>
+        bool readSection(uint64_t count, T& result) {
+            using Value = typename T::value_type;
+            static_assert(std::is_trivially_copyable_v<Value>);
+
+            if (!isValid || !file.good() || count > fileSize / sizeof(Value)) {
+                isValid = false;
+                return false;
+            }
+            const size_t size = count * sizeof(Value);
+            const size_t begin = alignedCacheOffset(static_cast<size_t>(file.tellg()));
+            if (begin > fileSize || size > fileSize - begin) {
+                isValid = false;
+                return false;
+            }
+            file.seekg(begin);
+            result.resize(count);
+            file.read(reinterpret_cast<char*>(result.data()), size);
+            isValid = file.good();
+            return isValid;
+        }
+    };
+
+    // Appends the identifier and text of a label to the strings of a Labelset and points
+    // the entry to them
+    void appendLabelStrings(std::string& strings,
+                            openspace::dataloader::Labelset::Entry& e,
+                            std::string_view identifier, std::string_view text)
+    {
+        if (identifier.size() > std::numeric_limits<uint16_t>::max()) {
+            throw ghoul::RuntimeError(std::format(
+                "Label identifier '{}...' is too long", identifier.substr(0, 32)
+            ));
+        }
+        if (text.size() > std::numeric_limits<uint16_t>::max()) {
+            throw ghoul::RuntimeError(std::format(
+                "Label text '{}...' is too long", text.substr(0, 32)
+            ));
+        }
+        if (strings.size() > std::numeric_limits<uint32_t>::max()) {
+            throw ghoul::RuntimeError("Too many characters in labelset");
+        }
+
+        e.offset = static_cast<uint32_t>(strings.size());
+        e.identifierLength = static_cast<uint16_t>(identifier.size());
+        e.textLength = static_cast<uint16_t>(text.size());
+        strings.append(identifier);
+        strings.append(text);
+    }
+
     template <typename T>
     using LoadCacheFunc = std::function<std::optional<T>(std::filesystem::path)>;
 
@@ -105,7 +269,15 @@ namespace {
         LINFOC("DataLoader", std::format("Loading file '{}'", filePath));
         T dataset = loadFunction(filePath, specs);
 
-        if (!dataset.entries.empty()) {
+        bool hasEntries = false;
+        if constexpr (std::is_same_v<T, openspace::dataloader::Dataset>) {
+            hasEntries = !dataset.positions.empty();
+        }
+        else {
+            hasEntries = !dataset.entries.empty();
+        }
+
+        if (hasEntries) {
             LINFOC("DataLoader", "Saving cache");
             saveCacheFunction(dataset, cached);
         }
@@ -150,152 +322,124 @@ Dataset loadFile(std::filesystem::path path, std::optional<DataMapping> specs) {
 std::optional<Dataset> loadCachedFile(const std::filesystem::path& path) {
     ZoneScoped;
 
-    std::ifstream file = std::ifstream(path, std::ios::binary);
+    std::ifstream file = std::ifstream(path, std::ios::binary | std::ios::ate);
     if (!file.good()) {
         return std::nullopt;
     }
+    const std::streamoff fileSize = file.tellg();
+    if (fileSize <= 0) {
+        return std::nullopt;
+    }
+    file.seekg(0);
 
-    Dataset result;
+    // The file is read in a single pass and each section is read straight into the
+    // column of the dataset that it belongs to
+    CacheFileReader reader = { file, static_cast<size_t>(fileSize) };
 
     int8_t fileVersion = 0;
-    file.read(reinterpret_cast<char*>(&fileVersion), sizeof(int8_t));
+    reader.read(fileVersion);
     if (fileVersion != DataCacheFileVersion) {
         // Incompatible version and we won't be able to read the file
         return std::nullopt;
     }
 
+    Dataset result;
+
     //
     // Read variables
     uint16_t nVariables = 0;
-    file.read(reinterpret_cast<char*>(&nVariables), sizeof(uint16_t));
+    reader.read(nVariables);
     result.variables.resize(nVariables);
-    for (int i = 0; i < nVariables; i += 1) {
-        ZoneScopedN("Variable");
-
-        Dataset::Variable var;
-
+    for (Dataset::Variable& var : result.variables) {
         int16_t idx = 0;
-        file.read(reinterpret_cast<char*>(&idx), sizeof(int16_t));
+        reader.read(idx);
         var.index = idx;
 
         uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        var.name.resize(len);
-        file.read(var.name.data(), len);
-
-        result.variables[i] = std::move(var);
+        reader.read(len);
+        var.name = reader.readString(len);
     }
 
     //
     // Read textures
     uint16_t nTextures = 0;
-    file.read(reinterpret_cast<char*>(&nTextures), sizeof(uint16_t));
+    reader.read(nTextures);
     result.textures.resize(nTextures);
-    for (int i = 0; i < nTextures; i += 1) {
-        ZoneScopedN("Texture");
-
-        Dataset::Texture tex;
-
+    for (Dataset::Texture& tex : result.textures) {
         int16_t idx = 0;
-        file.read(reinterpret_cast<char*>(&idx), sizeof(int16_t));
+        reader.read(idx);
         tex.index = idx;
 
         uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        tex.file.resize(len);
-        file.read(tex.file.data(), len);
-
-        result.textures[i] = std::move(tex);
+        reader.read(len);
+        tex.file = reader.readString(len);
     }
 
     //
     // Read indices
     int16_t texDataIdx = 0;
-    file.read(reinterpret_cast<char*>(&texDataIdx), sizeof(int16_t));
+    reader.read(texDataIdx);
     result.textureDataIndex = texDataIdx;
 
     int16_t oriDataIdx = 0;
-    file.read(reinterpret_cast<char*>(&oriDataIdx), sizeof(int16_t));
+    reader.read(oriDataIdx);
     result.orientationDataIndex = oriDataIdx;
 
     //
-    // Read entries
-    uint64_t nEntries = 0;
-    file.read(reinterpret_cast<char*>(&nEntries), sizeof(uint64_t));
-    result.entries.reserve(nEntries);
-    for (uint64_t i = 0; i < nEntries; i += 1) {
-        Dataset::Entry e;
-        file.read(reinterpret_cast<char*>(&e.position.x), 3 * sizeof(float));
-
-        // For now we just store the length of the comment. Since the comments are stored
-        // in one block after the data entries, we can use the length later to extract the
-        // contents of this entries comment out of the big block
-        uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        if (len > 0) {
-            // If there is a comment, we already allocate the space for it here. This way
-            // we don't need to separately store the length of it, but can use the size of
-            // the vector instead
-            std::string comment;
-            comment.resize(len);
-            e.comment = std::move(comment);
-        }
-
-        result.entries.push_back(std::move(e));
-    }
+    // Read max data point variable
+    reader.read(result.maxPositionComponent);
 
     //
-    // Read the data values next
+    // Read the sizes of the columnar sections
+    uint64_t nEntries = 0;
+    reader.read(nEntries);
     uint16_t nValues = 0;
-    file.read(reinterpret_cast<char*>(&nValues), sizeof(uint16_t));
-    std::vector<float> entriesBuffer;
-    entriesBuffer.resize(nEntries * nValues);
-    file.read(
-        reinterpret_cast<char*>(entriesBuffer.data()),
-        nEntries * nValues * sizeof(float)
-    );
+    reader.read(nValues);
+    uint64_t commentPoolSize = 0;
+    reader.read(commentPoolSize);
 
-    //
-    // Read comments in one block and then assign them to the data entries
-    uint64_t totalCommentLength = 0;
-    file.read(reinterpret_cast<char*>(&totalCommentLength), sizeof(uint64_t));
-    std::vector<char> commentBuffer;
-    commentBuffer.resize(totalCommentLength);
-    file.read(commentBuffer.data(), totalCommentLength);
+    // Every entry needs at least the space for its position, so this check prevents
+    // allocating memory based on a corrupted number of entries
+    if (!reader.isValid || nEntries > reader.fileSize / sizeof(glm::vec3)) {
+        return std::nullopt;
+    }
 
     //
-    // Now we have the comments and the data values, we need to implant them into the
-    // data entries
-
-    // commentIdx is the running index into the total comment buffer
-    int commentIdx = 0;
-    int valuesIdx = 0;
-    for (Dataset::Entry& e : result.entries) {
-        e.data.resize(nValues);
-        std::memcpy(
-            e.data.data(),
-            entriesBuffer.data() + valuesIdx,
-            nValues * sizeof(float)
-        );
-        valuesIdx += nValues;
-
-        if (e.comment.has_value()) {
-            ghoul_assert(commentIdx < commentBuffer.size(), "Index too large");
-
-            // If we have a comment, we need to extract its length's worth of characters
-            // from the buffer
-            std::memcpy(e.comment->data(), &commentBuffer[commentIdx], e.comment->size());
+    // Read positions
+    if (!reader.readSection(nEntries, result.positions)) {
+        return std::nullopt;
+    }
 
-            // and then advance the index
-            commentIdx += static_cast<int>(e.comment->size());
+    //
+    // Read the data values. Each column is stored contiguously
+    result.values.resize(nValues);
+    for (std::vector<float>& column : result.values) {
+        if (!reader.readSection(nEntries, column)) {
+            return std::nullopt;
         }
     }
 
     //
-    // Read max data point variable
-    float max = 0.f;
-    file.read(reinterpret_cast<char*>(&max), sizeof(float));
-    result.maxPositionComponent = max;
+    // Read the comment offsets and the pool of all comments
+    if (!reader.readSection(nEntries + 1, result.commentOffsets) ||
+        !reader.readSection(commentPoolSize, result.comments))
+    {
+        return std::nullopt;
+    }
+    if (result.commentOffsets.front() != 0 ||
+        result.commentOffsets.back() != commentPoolSize)
+    {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < nEntries; i += 1) {
+        if (result.commentOffsets[i] > result.commentOffsets[i + 1]) {
+            return std::nullopt;
+        }
+    }
+    if (commentPoolSize == 0) {
+        // None of the entries has a comment
+        result.commentOffsets = std::vector<uint64_t>();
+    }
 
     return result;
 }
@@ -351,59 +495,55 @@ void saveCachedFile(const Dataset& dataset, const std::filesystem::path& path) {
     file.write(reinterpret_cast<const char*>(&orientationIdx), sizeof(int16_t));
 
     //
-    // Store entries
-    checkSize<uint64_t>(dataset.entries.size(), "Too many entries");
-    uint64_t nEntries = static_cast<uint64_t>(dataset.entries.size());
-    file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
-
-    // We assume the number of values for each dataset to be the same, so we can store
-    // them upfront
-    size_t nValuesF = dataset.entries.empty() ? 0 : dataset.entries[0].data.size();
-    checkSize<uint16_t>(nValuesF, "Too many data variables");
-    uint16_t nValues = static_cast<uint16_t>(nValuesF);
-    std::vector<float> valuesBuffer;
-    valuesBuffer.reserve(dataset.entries.size() * nValues);
+    // Store max data point variable
+    file.write(
+        reinterpret_cast<const char*>(&dataset.maxPositionComponent),
+        sizeof(float)
+    );
 
-    uint64_t totalCommentLength = 0;
-    for (const Dataset::Entry& e : dataset.entries) {
-        file.write(reinterpret_cast<const char*>(&e.position.x), 3 * sizeof(float));
+    //
+    // Store the sizes of the columnar sections
+    const size_t nEntriesF = dataset.nEntries();
+    checkSize<uint64_t>(nEntriesF, "Too many entries");
+    uint64_t nEntries = static_cast<uint64_t>(nEntriesF);
+    file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
 
-        valuesBuffer.insert(valuesBuffer.end(), e.data.begin(), e.data.end());
+    checkSize<uint16_t>(dataset.values.size(), "Too many data variables");
+    uint16_t nValues = static_cast<uint16_t>(dataset.values.size());
+    file.write(reinterpret_cast<const char*>(&nValues), sizeof(uint16_t));
 
-        if (e.comment.has_value()) {
-            checkSize<uint16_t>(e.comment->size(), "Comment too long");
-        }
-        uint16_t commentLen = e.comment.has_value() ?
-            static_cast<uint16_t>(e.comment->size()) :
-            0;
-        file.write(reinterpret_cast<const char*>(&commentLen), sizeof(uint16_t));
-        totalCommentLength += commentLen;
-    }
+    uint64_t commentPoolSize = static_cast<uint64_t>(dataset.comments.size());
+    file.write(reinterpret_cast<const char*>(&commentPoolSize), sizeof(uint64_t));
 
-    // Write all of the datavalues next
-    file.write(reinterpret_cast<const char*>(&nValues), sizeof(uint16_t));
-    file.write(
-        reinterpret_cast<const char*>(valuesBuffer.data()),
-        valuesBuffer.size() * sizeof(float)
+    //
+    // Store positions
+    writeCacheSection(
+        file,
+        dataset.positions.data(),
+        dataset.positions.size() * sizeof(glm::vec3)
     );
 
     //
-    // Write all of the comments next. We don't have to store the individual comment
-    // lengths as the data values written before already have those stored. And since we
-    // are reading the comments in the same order as the dataset entries, we're good
-    file.write(reinterpret_cast<const char*>(&totalCommentLength), sizeof(uint64_t));
-    for (const Dataset::Entry& e : dataset.entries) {
-        if (e.comment.has_value()) {
-            file.write(e.comment->data(), e.comment->size());
-        }
+    // Store the data values, one contiguous column per value
+    for (const std::vector<float>& column : dataset.values) {
+        ghoul_assert(column.size() == nEntries, "Wrong number of values");
+        writeCacheSection(file, column.data(), column.size() * sizeof(float));
     }
 
     //
-    // Store max data point variable
-    file.write(
-        reinterpret_cast<const char*>(&dataset.maxPositionComponent),
-        sizeof(float)
-    );
+    // Store the comments. The offsets are always stored, even if there are no comments
+    if (dataset.commentOffsets.empty()) {
+        const std::vector<uint64_t> offsets = std::vector<uint64_t>(nEntries + 1, 0);
+        writeCacheSection(file, offsets.data(), offsets.size() * sizeof(uint64_t));
+    }
+    else {
+        writeCacheSection(
+            file,
+            dataset.commentOffsets.data(),
+            dataset.commentOffsets.size() * sizeof(uint64_t)
+        );
+    }
+    writeCacheSection(file, dataset.comments.data(), dataset.comments.size());
 }
 
 Dataset loadFileWithCache(std::filesystem::path path, std::optional<DataMapping> specs) {
@@ -447,13 +587,29 @@ Labelset loadFile(std::filesystem::path path, std::optional<DataMapping>) {
 }
 
 std::optional<Labelset> loadCachedFile(const std::filesystem::path& path) {
-    std::ifstream file(path, std::ios::binary);
+    ZoneScoped;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
     if (!file.good()) {
         return std::nullopt;
     }
 
+    // Read the entire file in one go and copy each section into its vector afterwards
+    const std::streamoff fileSize = file.tellg();
+    if (fileSize <= 0) {
+        return std::nullopt;
+    }
+    std::vector<std::byte> storage(static_cast<size_t>(fileSize));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(storage.data()), fileSize);
+    if (!file.good()) {
+        return std::nullopt;
+    }
+
+    CacheReader reader = { storage };
+
     int8_t fileVersion = 0;
-    file.read(reinterpret_cast<char*>(&fileVersion), sizeof(int8_t));
+    reader.read(fileVersion);
     if (fileVersion != LabelCacheFileVersion) {
         // Incompatible version and we won't be able to read the file
         return std::nullopt;
@@ -462,37 +618,103 @@ std::optional<Labelset> loadCachedFile(const std::filesystem::path& path) {
     Labelset result;
 
     int16_t textColorIdx = 0;
-    file.read(reinterpret_cast<char*>(&textColorIdx), sizeof(int16_t));
+    reader.read(textColorIdx);
     result.textColorIndex = textColorIdx;
 
-    uint32_t nEntries = 0;
-    file.read(reinterpret_cast<char*>(&nEntries), sizeof(uint32_t));
-    result.entries.reserve(nEntries);
-    for (unsigned int i = 0; i < nEntries; i += 1) {
-        Labelset::Entry e;
-        file.read(reinterpret_cast<char*>(&e.position.x), sizeof(float));
-        file.read(reinterpret_cast<char*>(&e.position.y), sizeof(float));
-        file.read(reinterpret_cast<char*>(&e.position.z), sizeof(float));
-
-        // Identifier
-        uint8_t idLen = 0;
-        file.read(reinterpret_cast<char*>(&idLen), sizeof(uint8_t));
-        e.identifier.resize(idLen);
-        file.read(e.identifier.data(), idLen);
-
-        // Text
-        uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        e.text.resize(len);
-        file.read(e.text.data(), len);
+    uint64_t nEntries = 0;
+    reader.read(nEntries);
+    uint64_t stringsSize = 0;
+    reader.read(stringsSize);
+    uint8_t hasLayout = 0;
+    reader.read(hasLayout);
+
+    // Every entry needs at least the space for its position, so this check prevents
+    // allocating memory based on a corrupted number of entries
+    if (!reader.isValid || nEntries > storage.size() / sizeof(glm::vec3)) {
+        return std::nullopt;
+    }
+
+    //
+    // Read the entries, one section per field, and the strings that they refer to
+    std::vector<float> positions;
+    std::vector<uint32_t> offsets;
+    std::vector<uint16_t> identifierLengths;
+    std::vector<uint16_t> textLengths;
+    const bool hasEntries =
+        readCacheSection(reader, 3 * nEntries, positions) &&
+        readCacheSection(reader, nEntries, offsets) &&
+        readCacheSection(reader, nEntries, identifierLengths) &&
+        readCacheSection(reader, nEntries, textLengths) &&
+        readCacheSection(reader, stringsSize, result.strings);
+    if (!hasEntries) {
+        return std::nullopt;
+    }
+    result.entries.resize(nEntries);
+    for (size_t i = 0; i < nEntries; i += 1) {
+        Labelset::Entry& e = result.entries[i];
+        e.position = glm::vec3(
+            positions[3 * i],
+            positions[3 * i + 1],
+            positions[3 * i + 2]
+        );
+        e.offset = offsets[i];
+        e.identifierLength = identifierLengths[i];
+        e.textLength = textLengths[i];
+
+        const uint64_t end =
+            static_cast<uint64_t>(e.offset) + e.identifierLength + e.textLength;
+        if (end > result.strings.size()) {
+            return std::nullopt;
+        }
+    }
 
-        result.entries.push_back(e);
+    if (hasLayout != 0) {
+        Labelset::TextLayout layout;
+        uint16_t fontLength = 0;
+        reader.read(fontLength);
+        layout.font = reader.readString(fontLength);
+        uint64_t nGlyphs = 0;
+        reader.read(nGlyphs);
+
+        std::vector<float> rectangles;
+        std::vector<uint32_t> characters;
+        std::vector<float> sizes;
+        const bool success =
+            nGlyphs <= storage.size() / sizeof(glm::vec4) &&
+            readCacheSection(reader, 4 * nGlyphs, rectangles) &&
+            readCacheSection(reader, nGlyphs, characters) &&
+            readCacheSection(reader, nEntries + 1, layout.glyphOffsets) &&
+            readCacheSection(reader, 2 * nEntries, sizes);
+        if (!success || !reader.isValid || layout.glyphOffsets.front() != 0 ||
+            layout.glyphOffsets.back() != nGlyphs ||
+            !std::is_sorted(layout.glyphOffsets.begin(), layout.glyphOffsets.end()))
+        {
+            return std::nullopt;
+        }
+
+        layout.glyphs.resize(nGlyphs);
+        for (size_t i = 0; i < nGlyphs; i += 1) {
+            layout.glyphs[i].rectangle = glm::vec4(
+                rectangles[4 * i],
+                rectangles[4 * i + 1],
+                rectangles[4 * i + 2],
+                rectangles[4 * i + 3]
+            );
+            layout.glyphs[i].character = characters[i];
+        }
+        layout.sizes.resize(nEntries);
+        for (size_t i = 0; i < nEntries; i += 1) {
+            layout.sizes[i] = glm::vec2(sizes[2 * i], sizes[2 * i + 1]);
+        }
+        result.layout = std::move(layout);
     }
 
     return result;
 }
 
 void saveCachedFile(const Labelset& labelset, const std::filesystem::path& path) {
+    ZoneScoped;
+
     std::ofstream file = std::ofstream(path, std::ofstream::binary);
 
     file.write(reinterpret_cast<const char*>(&LabelCacheFileVersion), sizeof(int8_t));
@@ -504,26 +726,84 @@ void saveCachedFile(const Labelset& labelset, const std::filesystem::path& path)
     file.write(reinterpret_cast<const char*>(&textColorIdx), sizeof(int16_t));
 
     //
-    // Storage text lines
-    checkSize<uint32_t>(labelset.entries.size(), "Too many entries");
-    uint32_t nEntries = static_cast<uint32_t>(labelset.entries.size());
-    file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint32_t));
+    // Storage sizes
+    const uint64_t nEntries = labelset.entries.size();
+    file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    const uint64_t stringsSize = labelset.strings.size();
+    file.write(reinterpret_cast<const char*>(&stringsSize), sizeof(uint64_t));
+    const uint8_t hasLayout = labelset.layout.has_value() ? 1 : 0;
+    file.write(reinterpret_cast<const char*>(&hasLayout), sizeof(uint8_t));
+
+    //
+    // Storage entries, one section per field, and the strings that they refer to
+    std::vector<float> positions;
+    positions.reserve(3 * nEntries);
+    std::vector<uint32_t> offsets;
+    offsets.reserve(nEntries);
+    std::vector<uint16_t> identifierLengths;
+    identifierLengths.reserve(nEntries);
+    std::vector<uint16_t> textLengths;
+    textLengths.reserve(nEntries);
     for (const Labelset::Entry& e : labelset.entries) {
-        file.write(reinterpret_cast<const char*>(&e.position.x), sizeof(float));
-        file.write(reinterpret_cast<const char*>(&e.position.y), sizeof(float));
-        file.write(reinterpret_cast<const char*>(&e.position.z), sizeof(float));
-
-        // Identifier
-        checkSize<uint8_t>(e.identifier.size(), "Identifier too long");
-        uint8_t idLen = static_cast<uint8_t>(e.identifier.size());
-        file.write(reinterpret_cast<const char*>(&idLen), sizeof(uint8_t));
-        file.write(e.identifier.data(), idLen);
-
-        // Text
-        checkSize<uint16_t>(e.text.size(), "Text too long");
-        uint16_t len = static_cast<uint16_t>(e.text.size());
-        file.write(reinterpret_cast<const char*>(&len), sizeof(uint16_t));
-        file.write(e.text.data(), len);
+        positions.push_back(e.position.x);
+        positions.push_back(e.position.y);
+        positions.push_back(e.position.z);
+        offsets.push_back(e.offset);
+        identifierLengths.push_back(e.identifierLength);
+        textLengths.push_back(e.textLength);
+    }
+    writeCacheSection(file, positions.data(), positions.size() * sizeof(float));
+    writeCacheSection(file, offsets.data(), offsets.size() * sizeof(uint32_t));
+    writeCacheSection(
+        file,
+        identifierLengths.data(),
+        identifierLengths.size() * sizeof(uint16_t)
+    );
+    writeCacheSection(file, textLengths.data(), textLengths.size() * sizeof(uint16_t));
+    writeCacheSection(file, labelset.strings.data(), labelset.strings.size());
+
+    //
+    // Storage text layout
+    if (hasLayout) {
+        const Labelset::TextLayout& layout = *labelset.layout;
+        ghoul_assert(
+            layout.glyphOffsets.size() == nEntries + 1 &&
+            layout.sizes.size() == nEntries,
+            "Layout does not match the entries"
+        );
+
+        checkSize<uint16_t>(layout.font.size(), "Font description too long");
+        const uint16_t fontLength = static_cast<uint16_t>(layout.font.size());
+        file.write(reinterpret_cast<const char*>(&fontLength), sizeof(uint16_t));
+        file.write(layout.font.data(), fontLength);
+        const uint64_t nGlyphs = layout.glyphs.size();
+        file.write(reinterpret_cast<const char*>(&nGlyphs), sizeof(uint64_t));
+
+        std::vector<float> rectangles;
+        rectangles.reserve(4 * nGlyphs);
+        std::vector<uint32_t> characters;
+        characters.reserve(nGlyphs);
+        for (const Labelset::TextLayout::Glyph& glyph : layout.glyphs) {
+            rectangles.push_back(glyph.rectangle.x);
+            rectangles.push_back(glyph.rectangle.y);
+            rectangles.push_back(glyph.rectangle.z);
+            rectangles.push_back(glyph.rectangle.w);
+            characters.push_back(glyph.character);
+        }
+        std::vector<float> sizes;
+        sizes.reserve(2 * nEntries);
+        for (const glm::vec2& size : layout.sizes) {
+            sizes.push_back(size.x);
+            sizes.push_back(size.y);
+        }
+        writeCacheSection(file, rectangles.data(), rectangles.size() * sizeof(float));
+        writeCacheSection(file, characters.data(), characters.size() * sizeof(uint32_t));
+        writeCacheSection(
+            file,
+            layout.glyphOffsets.data(),
+            layout.glyphOffsets.size() * sizeof(uint32_t)
+        );
+        writeCacheSection(file, sizes.data(), sizes.size() * sizeof(float));
     }
 }
 
@@ -537,18 +817,41 @@ Labelset loadFileWithCache(std::filesystem::path path) {
     );
 }
 
+std::future<void> updateCachedFile(Labelset labelset,
+                                   const std::filesystem::path& path)
+{
+    // The cache manager is not thread-safe, so the filename is resolved on this thread
+    std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(path, "");
+    return std::async(
+        std::launch::async,
+        [labelset = std::move(labelset), cached = std::move(cached)]() {
+            saveCachedFile(labelset, cached);
+        }
+    );
+}
+
 Labelset loadFromDataset(const Dataset& dataset) {
+    ZoneScoped;
+
+    constexpr std::string_view MissingLabel = "MISSING LABEL";
+    // @TODO: make is possible to configure this identifier?
+    constexpr std::string_view Identifier = "Point-0";
+
+    const size_t nEntries = dataset.nEntries();
+
     Labelset res;
-    res.entries.reserve(dataset.entries.size());
+    res.entries.reserve(nEntries);
+    size_t stringsSize = 0;
+    for (size_t i = 0; i < nEntries; i++) {
+        const std::optional<std::string_view> comment = dataset.comment(i);
+        stringsSize += Identifier.size();
+        stringsSize += comment.has_value() ? comment->size() : MissingLabel.size();
+    }
+    res.strings.reserve(stringsSize);
 
-    int count = 0;
-    for (const Dataset::Entry& entry : dataset.entries) {
-        Labelset::Entry label;
-        label.position = entry.position;
-        label.text = entry.comment.value_or("MISSING LABEL");
-        // @TODO: make is possible to configure this identifier?
-        label.identifier = std::format("Point-{}", count);
-        res.entries.push_back(std::move(label));
+    for (size_t i = 0; i < nEntries; i++) {
+        const std::string_view text = dataset.comment(i).value_or(MissingLabel);
+        res.addEntry(dataset.positions[i], Identifier, text);
     }
 
     return res;
@@ -698,8 +1001,158 @@ ColorMap loadFileWithCache(std::filesystem::path path) {
 
 } // namespace color
 
+std::string_view Labelset::identifier(const Entry& entry) const {
+    return std::string_view(strings).substr(entry.offset, entry.identifierLength);
+}
+
+std::string_view Labelset::text(const Entry& entry) const {
+    return std::string_view(strings).substr(
+        entry.offset + entry.identifierLength,
+        entry.textLength
+    );
+}
+
+void Labelset::addEntry(const glm::vec3& position, std::string_view identifier,
+                        std::string_view text)
+{
+    Entry entry = { .position = position };
+    appendLabelStrings(strings, entry, identifier, text);
+    entries.push_back(entry);
+}
+
+void Labelset::setText(Entry& entry, std::string_view text) {
+    ghoul_assert(
+        !entries.empty() && &entry >= &entries.front() && &entry <= &entries.back(),
+        "Entry must be part of the labelset"
+    );
+
+    // Appending to the strings might invalidate the views
+    const std::string id = std::string(identifier(entry));
+    const std::string t = std::string(text);
+    appendLabelStrings(strings, entry, id, t);
+    layout = std::nullopt;
+}
+
+size_t DatasetView::nEntries() const {
+    return positions.size();
+}
+
+std::optional<std::string_view> DatasetView::comment(size_t index) const {
+    ghoul_assert(index < nEntries(), "Index out of range");
+
+    if (commentOffsets.empty()) {
+        return std::nullopt;
+    }
+    const uint64_t begin = commentOffsets[index];
+    const uint64_t end = commentOffsets[index + 1];
+    if (begin == end) {
+        return std::nullopt;
+    }
+    return comments.substr(begin, end - begin);
+}
+
 bool Dataset::isEmpty() const {
-    return variables.empty() || entries.empty();
+    return variables.empty() || positions.empty();
+}
+
+size_t Dataset::nEntries() const {
+    return positions.size();
+}
+
+std::optional<std::string_view> Dataset::comment(size_t index) const {
+    return view().comment(index);
+}
+
+DatasetView Dataset::view() const {
+    DatasetView res = {
+        .positions = positions,
+        .comments = comments,
+        .commentOffsets = commentOffsets
+    };
+    res.values.reserve(values.size());
+    for (const std::vector<float>& column : values) {
+        res.values.emplace_back(column);
+    }
+    return res;
+}
+
+void Dataset::addEntry(const glm::vec3& position, std::span<const float> data,
+                       std::optional<std::string_view> comment)
+{
+    if (positions.empty() && values.empty()) {
+        // The first entry determines the number of data columns
+        values.resize(data.size());
+    }
+    ghoul_assert(data.size() == values.size(), "Wrong number of values");
+
+    positions.push_back(position);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i].push_back(data[i]);
+    }
+
+    if (comment.has_value() && commentOffsets.empty()) {
+        // This is the first comment, so none of the previous entries has a comment
+        commentOffsets.assign(positions.size(), 0);
+    }
+    if (!commentOffsets.empty()) {
+        if (comment.has_value()) {
+            comments.append(*comment);
+        }
+        commentOffsets.push_back(comments.size());
+    }
+}
+
+void Dataset::append(const Dataset& other) {
+    if (other.positions.empty()) {
+        return;
+    }
+
+    if (positions.empty() && values.empty()) {
+        values.resize(other.values.size());
+    }
+    ghoul_assert(other.values.size() == values.size(), "Wrong number of columns");
+
+    if (!other.commentOffsets.empty() && commentOffsets.empty()) {
+        // None of the entries that are already in this dataset has a comment
+        commentOffsets.assign(positions.size() + 1, 0);
+    }
+
+    positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i].insert(values[i].end(), other.values[i].begin(), other.values[i].end());
+    }
+
+    if (!commentOffsets.empty()) {
+        const uint64_t offset = comments.size();
+        if (other.commentOffsets.empty()) {
+            commentOffsets.insert(commentOffsets.end(), other.positions.size(), offset);
+        }
+        else {
+            comments.append(other.comments);
+            for (size_t i = 1; i < other.commentOffsets.size(); i++) {
+                commentOffsets.push_back(offset + other.commentOffsets[i]);
+            }
+        }
+    }
+}
+
+void Dataset::removeEntry(size_t index) {
+    ghoul_assert(index < positions.size(), "Index out of range");
+
+    positions.erase(positions.begin() + index);
+    for (std::vector<float>& column : values) {
+        column.erase(column.begin() + index);
+    }
+
+    if (!commentOffsets.empty()) {
+        const uint64_t begin = commentOffsets[index];
+        const uint64_t length = commentOffsets[index + 1] - begin;
+        comments.erase(begin, length);
+        commentOffsets.erase(commentOffsets.begin() + index);
+        for (size_t i = index; i < commentOffsets.size(); i++) {
+            commentOffsets[i] -= length;
+        }
+    }
 }
 
 int Dataset::index(std::string_view variableName) const {
@@ -721,8 +1174,7 @@ bool Dataset::normalizeVariable(std::string_view variableName) {
 
     float minValue = std::numeric_limits<float>::max();
     float maxValue = -std::numeric_limits<float>::max();
-    for (Dataset::Entry& e : entries) {
-        const float value = e.data[idx];
+    for (const float value : values[idx]) {
         if (std::isnan(value)) {
             continue;
         }
@@ -730,43 +1182,35 @@ bool Dataset::normalizeVariable(std::string_view variableName) {
         maxValue = std::max(maxValue, value);
     }
 
-    for (Dataset::Entry& e : entries) {
-        const float value = e.data[idx];
+    for (float& value : values[idx]) {
         if (std::isnan(value)) {
             continue;
         }
-        e.data[idx] = (value - minValue) / (maxValue - minValue);
+        value = (value - minValue) / (maxValue - minValue);
     }
 
     return true;
 }
 
 glm::vec2 Dataset::findValueRange(int variableIndex) const {
-    if (entries.empty()) {
+    if (positions.empty()) {
         // Can't find range if there are no entries
         return glm::vec2(0.f);
     }
 
-    if (variableIndex >= entries[0].data.size()) {
+    if (variableIndex < 0 || variableIndex >= static_cast<int>(values.size())) {
         // The index is not a valid variable index
         return glm::vec2(0.f);
     }
 
     float minValue = std::numeric_limits<float>::max();
     float maxValue = -std::numeric_limits<float>::max();
-    for (const Dataset::Entry& e : entries) {
-        if (!e.data.empty()) {
-            const float value = e.data[variableIndex];
-            if (std::isnan(value)) {
-                continue;
-            }
-            minValue = std::min(value, minValue);
-            maxValue = std::max(value, maxValue);
-        }
-        else {
-            minValue = 0.f;
-            maxValue = 0.f;
+    for (const float value : values[variableIndex]) {
+        if (std::isnan(value)) {
+            continue;
         }
+        minValue = std::min(value, minValue);
+        maxValue = std::max(value, maxValue);
     }
 
     return glm::vec2(minValue, maxValue);
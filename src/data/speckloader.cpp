@@ -24,19 +24,28 @@
 
 #include <openspace/data/speckloader.h>
 
+#include <openspace/engine/globals.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/misc/stringhelper.h>
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <sstream>
 #include <string_view>
-
+#include <thread>
 
 namespace {
     bool startsWith(std::string lhs, std::string_view rhs) noexcept {
@@ -67,6 +76,227 @@ namespace {
         }
     }
 
+    std::string_view stripped(std::string_view line) noexcept {
+        // Same as `strip`, but without modifying the line
+        while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+            line.remove_prefix(1);
+        }
+        if (!line.empty() && line.front() == '#') {
+            line.remove_prefix(1);
+        }
+        while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+            line.remove_prefix(1);
+        }
+        while (!line.empty() && (line.back() == ' ' || line.back() == '\t')) {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    // Data sections smaller than this are parsed on the calling thread, as the overhead
+    // of starting the worker threads would outweigh the gain
+    constexpr size_t MinChunkSize = 1024 * 1024;
+
+    bool isDigit(char c) noexcept {
+        return std::isdigit(static_cast<unsigned char>(c));
+    }
+
+    bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+    const char* skipSpaces(const char* begin, const char* end) noexcept {
+        while (begin != end && isSpace(*begin)) {
+            begin++;
+        }
+        return begin;
+    }
+
+    /**
+     * Parses a floating point value from the beginning of [begin, end) and returns the
+     * end of the parsed value, or `nullptr` if no value could be parsed. This accepts the
+     * same inputs as the `operator>>` of a stream that was used previously; in particular
+     * neither 'inf', 'nan', nor hexadecimal values are accepted. The range has to be
+     * followed by a whitespace or a null terminator.
+     */
+    const char* parseFloat(const char* begin, const char* end, float& value) {
+        // Streams accept a leading '+', std::from_chars does not
+        if (begin != end && *begin == '+') {
+            begin++;
+            if (begin != end && *begin == '-') {
+                return nullptr;
+            }
+        }
+        const char* number = (begin != end && *begin == '-') ? begin + 1 : begin;
+        if (number == end || !(isDigit(*number) || *number == '.')) {
+            return nullptr;
+        }
+
+#ifdef __cpp_lib_to_chars
+        const std::from_chars_result res = std::from_chars(begin, end, value);
+        if (res.ptr != end && (*res.ptr == 'e' || *res.ptr == 'E')) {
+            // An exponent without any digits, which is accepted by std::from_chars, but
+            // not by streams
+            return nullptr;
+        }
+        if (res.ec == std::errc()) {
+            return res.ptr;
+        }
+        if (res.ec != std::errc::result_out_of_range) {
+            return nullptr;
+        }
+        // Streams only fail for values that overflow, values that underflow are accepted
+        // and rounded to the closest representable value
+        const std::string str = std::string(begin, res.ptr);
+        value = std::strtof(str.c_str(), nullptr);
+        return std::isfinite(value) ? res.ptr : nullptr;
+#else // ^^^^ __cpp_lib_to_chars // !__cpp_lib_to_chars vvvv
+        // Not all standard libraries support std::from_chars for floating point values.
+        // strtof stops at the whitespace or null terminator following the range
+        char* ptr = nullptr;
+        value = std::strtof(begin, &ptr);
+        if (ptr == begin || !std::isfinite(value) || *ptr == 'e' || *ptr == 'E') {
+            return nullptr;
+        }
+        return ptr;
+#endif // __cpp_lib_to_chars
+    }
+
+    // A part of the data section of a SPECK file that consists of complete lines
+    struct DataChunk {
+        enum class Error {
+            None = 0,
+            HeaderIntermixed,
+            Position,
+            Value
+        };
+
+        std::string_view text;
+        // The entries of this chunk. Only the columns of this dataset are used
+        openspace::dataloader::Dataset entries;
+        float maxPositionComponent = 0.f;
+
+        // The number of lines in this chunk that have been parsed
+        int nLines = 0;
+
+        // The first error in this chunk. The line number is relative to the chunk
+        Error error = Error::None;
+        int errorLine = 0;
+        int errorValue = 0;
+        std::exception_ptr exception;
+    };
+
+    void parseDataChunk(DataChunk& chunk, int nDataValues,
+                        std::optional<float> missingDataValue)
+    {
+        ZoneScoped;
+
+        using namespace openspace::dataloader;
+
+        // The values of the current line, which are reused between lines
+        std::vector<float> data = std::vector<float>(nDataValues);
+
+        std::string_view text = chunk.text;
+        while (!text.empty()) {
+            const size_t lineEnd = text.find('\n');
+            std::string_view line = text.substr(0, lineEnd);
+            text.remove_prefix(
+                lineEnd == std::string_view::npos ? text.size() : lineEnd + 1
+            );
+            chunk.nLines++;
+
+            // Ignore empty line or commented-out lines
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            // Guard against wrong line endings (copying files from Windows to Mac) causes
+            // lines to have a final \r
+            if (line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+
+            line = stripped(line);
+
+            if (line.empty()) {
+                continue;
+            }
+
+            if (!isDigit(line[0]) && line[0] != '-') {
+                chunk.error = DataChunk::Error::HeaderIntermixed;
+                chunk.errorLine = chunk.nLines - 1;
+                return;
+            }
+
+            bool allZero = true;
+
+            // For SPECK we know that the first 3 values are the position, so no need to
+            // check agains data mapping
+            glm::vec3 position = glm::vec3(0.f);
+            const char* p = line.data();
+            const char* end = line.data() + line.size();
+            for (int i = 0; i < 3 && p; i += 1) {
+                p = parseFloat(skipSpaces(p, end), end, position[i]);
+            }
+            allZero &= (position == glm::vec3(0.0));
+
+            const glm::vec3 positive = glm::abs(position);
+            const float max = glm::compMax(positive);
+            if (max > chunk.maxPositionComponent) {
+                chunk.maxPositionComponent = max;
+            }
+
+            // The stream that was used previously also reported an error if the position
+            // was the last thing on a line, which is kept for compatibility
+            if (!p || p == end) {
+                chunk.error = DataChunk::Error::Position;
+                chunk.errorLine = chunk.nLines - 1;
+                return;
+            }
+
+            for (int i = 0; i < nDataValues; i += 1) {
+                const char* valueBegin = skipSpaces(p, end);
+                p = std::find_if(valueBegin, end, isSpace);
+                const std::string_view value = std::string_view(valueBegin, p);
+
+                if (value == "nan" || value == "NaN") {
+                    data[i] = std::numeric_limits<float>::quiet_NaN();
+                }
+                else {
+                    // Only the beginning of the value has to be a number
+                    if (!parseFloat(valueBegin, p, data[i])) {
+                        chunk.error = DataChunk::Error::Value;
+                        chunk.errorLine = chunk.nLines - 1;
+                        chunk.errorValue = i;
+                        return;
+                    }
+
+                    // Check if value corresponds to a missing value
+                    if (missingDataValue.has_value()) {
+                        const float diff = std::abs(data[i] - *missingDataValue);
+                        if (diff < std::numeric_limits<float>::epsilon()) {
+                            data[i] = std::numeric_limits<float>::quiet_NaN();
+                        }
+                    }
+
+                    allZero &= (data[i] == 0.0);
+                }
+            }
+
+            if (allZero) {
+                continue;
+            }
+
+            std::optional<std::string_view> comment;
+            std::string_view rest = std::string_view(p, end);
+            if (!rest.empty()) {
+                comment = stripped(rest);
+            }
+
+            chunk.entries.addEntry(position, data, comment);
+        }
+    }
+
 } // namespace
 
 namespace openspace::dataloader::speck {
@@ -247,125 +477,132 @@ Dataset loadSpeckFile(std::filesystem::path path, std::optional<DataMapping> spe
         }
     );
 
-    // For the first line, we already loaded it and rejected it above, so if we do another
-    // ghoul::getline, we'd miss the first data value line
-    bool isFirst = true;
-    while (isFirst || ghoul::getline(file, line)) {
-        currentLineNumber++;
-        isFirst = false;
-
-        // Ignore empty line or commented-out lines
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
+    //
+    // Second phase: Loading the data values. The data section is read into memory in
+    // one go, split into chunks of complete lines, and the chunks are parsed in parallel
+    std::string buffer;
+    if (file.good()) {
+        ZoneScopedN("Read data");
+
+        const std::streampos begin = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::streampos end = file.tellg();
+        file.seekg(begin);
+        buffer.resize(static_cast<size_t>(end - begin));
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        // In text mode the number of read characters can be smaller than the file size
+        buffer.resize(static_cast<size_t>(file.gcount()));
+    }
 
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
+    // We already loaded the first data line above, so it becomes a chunk of its own
+    std::vector<DataChunk> chunks;
+    chunks.push_back({ .text = line });
 
-        strip(line);
+    const size_t nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t nChunks = std::clamp<size_t>(
+        buffer.size() / MinChunkSize,
+        1,
+        4 * nThreads
+    );
+    size_t chunkBegin = 0;
+    for (size_t i = 1; i <= nChunks && chunkBegin < buffer.size(); i += 1) {
+        size_t chunkEnd = buffer.size();
+        if (i < nChunks) {
+            const size_t target = std::max(chunkBegin, i * buffer.size() / nChunks);
+            chunkEnd = buffer.find('\n', target);
+            chunkEnd = (chunkEnd == std::string::npos) ? buffer.size() : chunkEnd + 1;
+        }
+        chunks.push_back({
+            .text = std::string_view(buffer).substr(chunkBegin, chunkEnd - chunkBegin)
+        });
+        chunkBegin = chunkEnd;
+    }
 
-        if (line.empty()) {
-            continue;
+    std::optional<float> missingDataValue;
+    if (specs.has_value()) {
+        missingDataValue = specs->missingDataValue;
+    }
+    auto parse = [nDataValues, missingDataValue](DataChunk& chunk) {
+        try {
+            parseDataChunk(chunk, nDataValues, missingDataValue);
         }
-
-        // If the first character is a digit, we have left the preamble and are in the
-        // data section of the file
-        if (!std::isdigit(line[0]) && line[0] != '-') {
-            throw ghoul::RuntimeError(std::format(
-                "Error loading speck file '{}': Header information and datasegment "
-                "intermixed", path
-            ));
+        catch (...) {
+            chunk.exception = std::current_exception();
         }
+    };
 
-        bool allZero = true;
-
-        // For SPECK we know that the first 3 values are the position, so no need to
-        // check agains data mapping
-        std::stringstream str(line);
-        Dataset::Entry entry;
-        str >> entry.position.x >> entry.position.y >> entry.position.z;
-        allZero &= (entry.position == glm::vec3(0.0));
-
-        const glm::vec3 positive = glm::abs(entry.position);
-        const float max = glm::compMax(positive);
-        if (max > res.maxPositionComponent) {
-            res.maxPositionComponent = max;
+    if (chunks.size() <= 2) {
+        for (DataChunk& chunk : chunks) {
+            parse(chunk);
         }
-
-        if (!str.good()) {
-            // Need to subtract one of the line number here as we increase the current
-            // line count in the beginning of the while loop we are currently in
-            throw ghoul::RuntimeError(std::format(
-                "Error loading position information out of data line {} in file '{}'. "
-                "Value was not a number",
-                currentLineNumber - 1, path
-            ));
+    }
+    else {
+        TaskScheduler::TaskGroup group(*global::taskScheduler);
+        for (DataChunk& chunk : chunks) {
+            group.run([&parse, &chunk]() { parse(chunk); });
         }
+        group.wait();
+    }
 
-        entry.data.resize(nDataValues);
-        std::stringstream valueStream;
-        for (int i = 0; i < nDataValues; i += 1) {
-            std::string value;
-            str >> value;
-            if (value == "nan" || value == "NaN") {
-                entry.data[i] = std::numeric_limits<float>::quiet_NaN();
-            }
-            else {
-                valueStream.clear();
-                valueStream.str(value);
-                valueStream >> entry.data[i];
-
-                // Check if value corresponds to a missing value
-                if (specs.has_value() && specs->missingDataValue.has_value()) {
-                    const float missingDataValue = specs->missingDataValue.value();
-                    const float diff = std::abs(entry.data[i] - missingDataValue);
-                    if (diff < std::numeric_limits<float>::epsilon()) {
-                        entry.data[i] = std::numeric_limits<float>::quiet_NaN();
-                    }
-                }
-
-                allZero &= (entry.data[i] == 0.0);
-                if (valueStream.fail()) {
-                    // Need to subtract one of the line number here as we increase the
-                    // current line count in the beginning of the while loop we are
-                    // currently in
-                    throw ghoul::RuntimeError(std::format(
-                        "Error loading data value {} out of data line {} in file '{}'. "
-                        "Value was not a number",
-                        i, currentLineNumber - 1, path
-                    ));
-                }
-            }
+    //
+    // Merge the chunks in file order. Errors are reported for the first failing line
+    size_t nEntries = 0;
+    for (const DataChunk& chunk : chunks) {
+        if (chunk.exception) {
+            std::rethrow_exception(chunk.exception);
         }
 
-        if (allZero) {
-            continue;
+        const int lineNumber = currentLineNumber + chunk.errorLine;
+        switch (chunk.error) {
+            case DataChunk::Error::None:
+                break;
+            case DataChunk::Error::HeaderIntermixed:
+                throw ghoul::RuntimeError(std::format(
+                    "Error loading speck file '{}': Header information and datasegment "
+                    "intermixed", path
+                ));
+            case DataChunk::Error::Position:
+                throw ghoul::RuntimeError(std::format(
+                    "Error loading position information out of data line {} in file "
+                    "'{}'. Value was not a number",
+                    lineNumber, path
+                ));
+            case DataChunk::Error::Value:
+                throw ghoul::RuntimeError(std::format(
+                    "Error loading data value {} out of data line {} in file '{}'. "
+                    "Value was not a number",
+                    chunk.errorValue, lineNumber, path
+                ));
         }
 
-        std::string rest;
-        ghoul::getline(str, rest);
-        if (!rest.empty()) {
-
-            strip(rest);
-            entry.comment = rest;
-        }
+        currentLineNumber += chunk.nLines;
+        nEntries += chunk.entries.nEntries();
+    }
 
-        res.entries.push_back(std::move(entry));
+    res.positions.reserve(nEntries);
+    res.values.resize(nDataValues);
+    for (std::vector<float>& column : res.values) {
+        column.reserve(nEntries);
+    }
+    for (DataChunk& chunk : chunks) {
+        res.append(chunk.entries);
+        chunk.entries = Dataset();
+        res.maxPositionComponent = std::max(
+            res.maxPositionComponent,
+            chunk.maxPositionComponent
+        );
     }
 
 #ifdef _DEBUG
-    if (!res.entries.empty()) {
-        size_t nValues = res.entries[0].data.size();
-        ghoul_assert(nDataValues == nValues, "nDataValues calculation went wrong");
-        for (const Dataset::Entry& e : res.entries) {
-            ghoul_assert(
-                e.data.size() == nDataValues,
-                "Row had different number of data values"
-            );
-        }
+    ghoul_assert(
+        res.values.size() == static_cast<size_t>(nDataValues),
+        "nDataValues calculation went wrong"
+    );
+    for (const std::vector<float>& column : res.values) {
+        ghoul_assert(
+            column.size() == res.nEntries(),
+            "Column had different number of data values"
+        );
     }
 #endif
 
@@ -460,19 +697,21 @@ Labelset loadLabelFile(std::filesystem::path path) {
         // so we want to get the position, remove the 'text' text and the potential
         // comment at the end
         std::stringstream str(line);
-        Labelset::Entry entry;
-        str >> entry.position.x >> entry.position.y >> entry.position.z;
+        glm::vec3 position = glm::vec3(0.f);
+        str >> position.x >> position.y >> position.z;
 
         std::string rest;
         ghoul::getline(str, rest);
         strip(rest);
 
+        std::string identifier;
+
         if (startsWith(rest, "id")) {
             // optional arument with identifier
             // Remove the 'id' text
             rest = rest.substr(std::string_view("id ").size());
             const size_t index = rest.find("text");
-            entry.identifier = rest.substr(0, index - 1);
+            identifier = rest.substr(0, index - 1);
 
             // update the rest, remove the identifier
             rest = rest.substr(index);
@@ -497,9 +736,8 @@ Labelset loadLabelFile(std::filesystem::path path) {
 
         strip(rest);
 
-        entry.text = rest;
         if (!rest.empty()) {
-            res.entries.push_back(std::move(entry));
+            res.addEntry(position, identifier, rest);
         }
     }
 
@@ -52,6 +52,7 @@
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
 #include <openspace/util/memorymanager.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/versionchecker.h>
 #include <ghoul/misc/assert.h>
@@ -72,6 +73,7 @@ namespace {
 #ifdef WIN32
     constexpr int TotalSize =
         sizeof(MemoryManager) +
+        sizeof(TaskScheduler) +
         sizeof(EventEngine) +
         sizeof(ghoul::fontrendering::FontManager) +
         sizeof(Dashboard) +
@@ -129,6 +131,14 @@ void create() {
     memoryManager = new MemoryManager;
 #endif // WIN32
 
+#ifdef WIN32
+    taskScheduler = new (currentPos) TaskScheduler;
+    ghoul_assert(taskScheduler, "No taskScheduler");
+    currentPos += sizeof(TaskScheduler);
+#else // ^^^ WIN32 / !WIN32 vvv
+    taskScheduler = new TaskScheduler;
+#endif // WIN32
+
 #ifdef WIN32
     eventEngine = new (currentPos) EventEngine;
     ghoul_assert(eventEngine, "No eventEngine");
@@ -391,6 +401,7 @@ void initialize() {
     rootPropertyOwner->addPropertySubOwner(global::sessionRecording);
     rootPropertyOwner->addPropertySubOwner(global::timeManager);
     rootPropertyOwner->addPropertySubOwner(global::scriptScheduler);
+    rootPropertyOwner->addPropertySubOwner(global::scriptEngine);
 
     rootPropertyOwner->addPropertySubOwner(global::renderEngine);
     rootPropertyOwner->addPropertySubOwner(global::screenSpaceRootPropertyOwner);
@@ -620,6 +631,13 @@ void destroy() {
     delete eventEngine;
 #endif // WIN32
 
+    LDEBUGC("Globals", "Destroying 'TaskScheduler'");
+#ifdef WIN32
+    taskScheduler->~TaskScheduler();
+#else // ^^^ WIN32 / !WIN32 vvv
+    delete taskScheduler;
+#endif // WIN32
+
     LDEBUGC("Globals", "Destroying 'MemoryManager'");
 #ifdef WIN32
     memoryManager->~MemoryManager();
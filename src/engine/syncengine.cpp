@@ -25,37 +25,128 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/profiling.h>
 #include <algorithm>
 
+namespace {
+    constexpr std::string_view _loggerCat = "SyncEngine";
+
+    enum class FrameType : uint8_t {
+        Keyframe = 0,
+        Delta = 1
+    };
+} // namespace
+
 namespace openspace {
 
-SyncEngine::SyncEngine(unsigned int syncBufferSize)
+SyncEngine::SyncEngine(unsigned int syncBufferSize, unsigned int keyframeInterval)
     : _syncBuffer(syncBufferSize)
+    , _keyframeInterval(keyframeInterval)
 {
     ghoul_assert(syncBufferSize > 0, "syncBufferSize must be bigger than 0");
+    ghoul_assert(keyframeInterval > 0, "keyframeInterval must be bigger than 0");
 }
 
 // Should be called on sgct master
 std::vector<std::byte> SyncEngine::encodeSyncables() {
-    for (Syncable* syncable : _syncables) {
-        syncable->encode(&_syncBuffer);
+    ZoneScoped;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const bool isKeyframe = _forceKeyframe || _framesSinceKeyframe >= _keyframeInterval;
+    if (isKeyframe) {
+        _forceKeyframe = false;
+        _framesSinceKeyframe = 1;
+    }
+    else {
+        _framesSinceKeyframe++;
+    }
+
+    std::vector<size_t> indices;
+    indices.reserve(_syncables.size());
+    for (size_t i = 0; i < _syncables.size(); i++) {
+        if (isKeyframe || _syncables[i]->isDirty()) {
+            indices.push_back(i);
+        }
+    }
+
+    // Each frame starts with its type and the number of registered Syncables so that a
+    // client can detect a mismatch, followed by the encoded Syncables, each of which is
+    // prefixed with the difference between its index and that of the previous one
+    _syncBuffer.encode(isKeyframe ? FrameType::Keyframe : FrameType::Delta);
+    _syncBuffer.encodeVarint(_syncables.size());
+    _syncBuffer.encodeVarint(indices.size());
+    size_t previousIndex = 0;
+    for (size_t index : indices) {
+        _syncBuffer.encodeVarint(index - previousIndex);
+        _syncables[index]->encode(&_syncBuffer);
+        previousIndex = index;
     }
 
     std::vector<std::byte> data = _syncBuffer.data();
     _syncBuffer.reset();
+
+    _lastFrameStatistics = {
+        .isKeyframe = isKeyframe,
+        .nEncodedSyncables = indices.size(),
+        .nSyncables = _syncables.size(),
+        .nBytes = data.size(),
+        .duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start
+        )
+    };
+#ifdef TRACY_ENABLE
+    TracyPlot("SyncEngine Frame Size", static_cast<int64_t>(data.size()));
+    TracyPlot("SyncEngine Encoded Syncables", static_cast<int64_t>(indices.size()));
+#endif // TRACY_ENABLE
+
     return data;
 }
 
 // Should be called on sgct clients
 void SyncEngine::decodeSyncables(std::vector<std::byte> data) {
+    ZoneScoped;
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t nBytes = data.size();
+
     _syncBuffer.setData(std::move(data));
-    for (Syncable* syncable : _syncables) {
-        syncable->decode(&_syncBuffer);
+    const FrameType type = _syncBuffer.decode<FrameType>();
+    const size_t nSyncables = static_cast<size_t>(_syncBuffer.decodeVarint());
+    if (nSyncables != _syncables.size()) {
+        LWARNING(std::format(
+            "Skipping synchronization frame for {} Syncables as {} are registered",
+            nSyncables, _syncables.size()
+        ));
+        _syncBuffer.reset();
+        return;
+    }
+
+    const size_t nEncoded = static_cast<size_t>(_syncBuffer.decodeVarint());
+    size_t index = 0;
+    for (size_t i = 0; i < nEncoded; i++) {
+        index += static_cast<size_t>(_syncBuffer.decodeVarint());
+        ghoul_assert(index < _syncables.size(), "Invalid Syncable index");
+        _syncables[index]->decode(&_syncBuffer);
     }
 
     _syncBuffer.reset();
+
+    _lastFrameStatistics = {
+        .isKeyframe = type == FrameType::Keyframe,
+        .nEncodedSyncables = nEncoded,
+        .nSyncables = nSyncables,
+        .nBytes = nBytes,
+        .duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start
+        )
+    };
+#ifdef TRACY_ENABLE
+    TracyPlot("SyncEngine Frame Size", static_cast<int64_t>(nBytes));
+#endif // TRACY_ENABLE
 }
 
 void SyncEngine::preSynchronization(IsMaster isMaster) {
@@ -82,6 +173,7 @@ void SyncEngine::addSyncable(Syncable* syncable) {
     ghoul_assert(syncable, "Syncable must not be nullptr");
 
     _syncables.push_back(syncable);
+    _forceKeyframe = true;
 }
 
 void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
@@ -96,6 +188,7 @@ void SyncEngine::removeSyncable(Syncable* syncable) {
         std::remove(_syncables.begin(), _syncables.end(), syncable),
         _syncables.end()
     );
+    _forceKeyframe = true;
 }
 
 void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
@@ -104,4 +197,8 @@ void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
     }
 }
 
+const SyncEngine::FrameStatistics& SyncEngine::lastFrameStatistics() const {
+    return _lastFrameStatistics;
+}
+
 } // namespace openspace
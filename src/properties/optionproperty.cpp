@@ -73,6 +73,7 @@ void OptionProperty::addOption(int value, std::string desc) {
         }
     }
     _options.push_back(std::move(option));
+    invalidateJsonDescription();
     // Set default value to option added first
     NumericalProperty::setValue(_options[0].value);
 }
@@ -92,6 +93,7 @@ void OptionProperty::addOptions(std::vector<std::string> options) {
 void OptionProperty::clearOptions() {
     _options.clear();
     _value = 0;
+    invalidateJsonDescription();
 }
 
 void OptionProperty::setValue(int value) {
@@ -119,6 +119,7 @@ const std::string& Property::description() const {
 
 void Property::setGroupIdentifier(std::string groupId) {
     _metaData.setValue(std::string(MetaDataKeyGroup), std::move(groupId));
+    invalidateJsonDescription();
 }
 
 std::string Property::groupIdentifier() const {
@@ -135,6 +136,7 @@ void Property::setVisibility(Visibility visibility) {
         std::string(MetaDataKeyVisibility),
         static_cast<std::underlying_type_t<Visibility>>(visibility)
     );
+    invalidateJsonDescription();
 }
 
 Property::Visibility Property::visibility() const {
@@ -145,16 +147,19 @@ Property::Visibility Property::visibility() const {
 
 void Property::setReadOnly(bool state) {
     _metaData.setValue(std::string(MetaDataKeyReadOnly), state);
+    invalidateJsonDescription();
 }
 
 void Property::setNeedsConfirmation(bool state) {
     _metaData.setValue(std::string(MetaDataKeyNeedsConfirmation), state);
+    invalidateJsonDescription();
 }
 
 void Property::setViewOption(std::string option, bool value) {
     ghoul::Dictionary d;
     d.setValue(std::move(option), value);
     _metaData.setValue(std::string(MetaDataKeyViewOptions), d);
+    invalidateJsonDescription();
 }
 
 bool Property::viewOption(const std::string& option, bool defaultValue) const {
@@ -240,6 +245,8 @@ PropertyOwner* Property::owner() const {
 
 void Property::setPropertyOwner(PropertyOwner* owner) {
     _owner = owner;
+    // The owner is part of the URI that is included in the description
+    invalidateJsonDescription();
 }
 
 void Property::notifyChangeListeners() {
@@ -248,6 +255,10 @@ void Property::notifyChangeListeners() {
     }
 }
 
+void Property::invalidateJsonDescription() {
+    _jsonDescriptionVersion++;
+}
+
 void Property::notifyDeleteListeners() {
     for (const std::pair<OnDeleteHandle, std::function<void()>>& p : _onDeleteCallbacks) {
         p.second();
@@ -278,6 +289,10 @@ std::string Property::generateJsonDescription() const {
     );
 }
 
+uint64_t Property::jsonDescriptionVersion() const {
+    return _jsonDescriptionVersion;
+}
+
 std::string Property::generateMetaDataJsonDescription() const {
     static const std::map<Visibility, std::string> VisibilityConverter = {
         { Visibility::Always, "Always" },
@@ -0,0 +1,351 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/properties/propertyindex.h>
+
+#include <openspace/properties/property.h>
+#include <openspace/properties/propertyowner.h>
+#include <ghoul/format.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+
+namespace {
+    struct Query {
+        std::string nodeName;
+        std::string propertyName;
+        bool isLiteral = false;
+    };
+
+    Query parseQuery(const std::string& regex, bool isGroupMode) {
+        Query query;
+
+        // Extract the property and node name to be searched for from regex
+        const size_t wildPos = regex.find_first_of('*');
+        if (wildPos != std::string::npos) {
+            query.nodeName = regex.substr(0, wildPos);
+            query.propertyName = regex.substr(wildPos + 1, regex.length());
+
+            // If none then malformed regular expression
+            if (query.propertyName.empty() && query.nodeName.empty()) {
+                throw ghoul::RuntimeError(std::format(
+                    "Malformed regular expression: '{}': Empty both before and after '*'",
+                    regex
+                ));
+            }
+
+            // Currently do not support several wildcards
+            if (regex.find_first_of('*', wildPos + 1) != std::string::npos) {
+                throw ghoul::RuntimeError(std::format(
+                    "Malformed regular expression: '{}': Currently only one '*' is "
+                    "supported", regex
+                ));
+            }
+        }
+        // Literal or tag
+        else {
+            query.propertyName = regex;
+            query.isLiteral = !isGroupMode;
+        }
+        return query;
+    }
+
+    // Returns whether the provided uri matches the (non-literal) query. The tag of the
+    // query is handled separately through the candidates that are passed into this test
+    bool matchesQuery(const std::string& id, const Query& query, bool isGroupMode) {
+        if (!query.propertyName.empty()) {
+            const size_t propertyPos = id.find(query.propertyName);
+            if (propertyPos == std::string::npos) {
+                return false;
+            }
+
+            // Check that the propertyName fully matches the property in id
+            if ((propertyPos + query.propertyName.length() + 1) < id.length()) {
+                return false;
+            }
+
+            // Match node name
+            return query.nodeName.empty() || id.find(query.nodeName) != std::string::npos;
+        }
+        else {
+            const size_t nodePos = id.find(query.nodeName);
+            if (nodePos == std::string::npos) {
+                return false;
+            }
+
+            // Check that the nodeName fully matches the node in id
+            return isGroupMode || nodePos == 0;
+        }
+    }
+} // namespace
+
+namespace openspace::properties {
+
+Property* PropertyIndex::property(const PropertyOwner& root, std::string_view uri) {
+    rebuildIfNeeded(root);
+
+    auto it = _entriesByUri.find(uri);
+    return it != _entriesByUri.end() ? _entries[it->second].property : nullptr;
+}
+
+std::vector<Property*> PropertyIndex::matchingProperties(const PropertyOwner& root,
+                                                                 const std::string& regex,
+                                                             const std::string& groupName)
+{
+    ZoneScoped;
+
+    rebuildIfNeeded(root);
+
+    const std::string key = std::format("{{{}}}{}", groupName, regex);
+    auto cached = _queryCache.find(key);
+    if (cached != _queryCache.end()) {
+        return cached->second;
+    }
+
+    const bool isGroupMode = !groupName.empty();
+    const Query query = parseQuery(regex, isGroupMode);
+
+    std::vector<Property*> result;
+    if (query.isLiteral) {
+        auto it = _entriesByUri.find(query.propertyName);
+        if (it != _entriesByUri.end()) {
+            result.push_back(_entries[it->second].property);
+        }
+        _queryCache[key] = result;
+        return result;
+    }
+
+    // Collect the indices of the entries that can potentially match the query. If the
+    // query is restricted to a tag, only the subtrees of the tagged owners have to be
+    // considered. Otherwise, the sorted lookup tables are used to narrow down the search
+    std::vector<Range> ranges;
+    std::vector<size_t> candidates;
+    bool useCandidates = false;
+    if (isGroupMode) {
+        ranges = rangesForTag(groupName);
+    }
+    else {
+        ranges.emplace_back(0, _entries.size());
+    }
+
+    const size_t lastSeparator = query.propertyName.rfind(PropertyOwner::URISeparator);
+    if (!query.propertyName.empty() && lastSeparator != std::string::npos) {
+        // A match requires the property part to end at most one character before the
+        // end of the URI, which means that the identifier of the matching Property has
+        // to start with everything behind the last separator of the property part
+        const std::string_view tail =
+            std::string_view(query.propertyName).substr(lastSeparator + 1);
+        auto it = std::lower_bound(
+            _entriesByIdentifier.begin(),
+            _entriesByIdentifier.end(),
+            tail,
+            [](const std::pair<std::string_view, size_t>& e, std::string_view v) {
+                return e.first < v;
+            }
+        );
+        while (it != _entriesByIdentifier.end() && it->first.starts_with(tail)) {
+            if (it->first.size() <= tail.size() + 1) {
+                candidates.push_back(it->second);
+            }
+            it++;
+        }
+        useCandidates = true;
+    }
+    else if (query.propertyName.empty() && !isGroupMode) {
+        // Without a tag, the node part has to be a prefix of the URI
+        auto it = std::lower_bound(
+            _entriesSortedByUri.begin(),
+            _entriesSortedByUri.end(),
+            query.nodeName,
+            [this](size_t i, const std::string& v) { return _entries[i].uri < v; }
+        );
+        while (it != _entriesSortedByUri.end() &&
+               _entries[*it].uri.starts_with(query.nodeName))
+        {
+            candidates.push_back(*it);
+            it++;
+        }
+        useCandidates = true;
+    }
+
+    auto isInRanges = [&ranges](size_t i) {
+        return std::any_of(
+            ranges.begin(),
+            ranges.end(),
+            [i](const Range& r) { return i >= r.first && i < r.second; }
+        );
+    };
+
+    if (useCandidates) {
+        // Preserve the depth-first order of the property tree in the result
+        std::sort(candidates.begin(), candidates.end());
+        for (size_t i : candidates) {
+            const Entry& e = _entries[i];
+            if (isInRanges(i) && matchesQuery(e.uri, query, isGroupMode)) {
+                result.push_back(e.property);
+            }
+        }
+    }
+    else {
+        for (const Range& r : ranges) {
+            for (size_t i = r.first; i < r.second; i++) {
+                const Entry& e = _entries[i];
+                if (matchesQuery(e.uri, query, isGroupMode)) {
+                    result.push_back(e.property);
+                }
+            }
+        }
+    }
+
+    _queryCache[key] = result;
+    return result;
+}
+
+const std::vector<PropertyOwner*>& PropertyIndex::ownersWithTag(const PropertyOwner& root,
+                                                                   const std::string& tag)
+{
+    rebuildIfNeeded(root);
+
+    static const std::vector<PropertyOwner*> Empty;
+    auto it = _ownersByTag.find(tag);
+    return it != _ownersByTag.end() ? it->second.owners : Empty;
+}
+
+const std::string& PropertyIndex::uri(const PropertyOwner& root, const Property* prop) {
+    rebuildIfNeeded(root);
+
+    static const std::string Empty;
+    auto it = _entriesByProperty.find(prop);
+    return it != _entriesByProperty.end() ? _entries[it->second].uri : Empty;
+}
+
+void PropertyIndex::invalidate() {
+    _isValid = false;
+}
+
+void PropertyIndex::rebuildIfNeeded(const PropertyOwner& root) {
+    const uint64_t generation = PropertyOwner::structureGeneration();
+    if (_isValid && _root == &root && _generation == generation) {
+        return;
+    }
+
+    ZoneScoped;
+
+    _entries.clear();
+    _entriesByUri.clear();
+    _entriesByProperty.clear();
+    _entriesByIdentifier.clear();
+    _entriesSortedByUri.clear();
+    _ownersByTag.clear();
+    _queryCache.clear();
+
+    addOwner(root, "", true);
+
+    // The lookup tables are only created after all entries have been added as they
+    // reference the strings stored in the entries
+    _entriesByUri.reserve(_entries.size());
+    _entriesByProperty.reserve(_entries.size());
+    _entriesByIdentifier.reserve(_entries.size());
+    _entriesSortedByUri.reserve(_entries.size());
+    for (size_t i = 0; i < _entries.size(); i++) {
+        const Entry& e = _entries[i];
+        _entriesByUri.emplace(e.uri, i);
+        _entriesByProperty.emplace(e.property, i);
+        _entriesByIdentifier.emplace_back(e.property->identifier(), i);
+        _entriesSortedByUri.push_back(i);
+    }
+    std::sort(_entriesByIdentifier.begin(), _entriesByIdentifier.end());
+    std::sort(
+        _entriesSortedByUri.begin(),
+        _entriesSortedByUri.end(),
+        [this](size_t lhs, size_t rhs) { return _entries[lhs].uri < _entries[rhs].uri; }
+    );
+
+    _root = &root;
+    _generation = generation;
+    _isValid = true;
+}
+
+void PropertyIndex::addOwner(const PropertyOwner& owner, const std::string& prefix,
+                             bool isRoot)
+{
+    // The URIs created here have to be identical to the ones created by Property::uri
+    // and PropertyOwner::uri, which skip the root owner and all owners with an empty
+    // identifier. Propertys whose owner has an empty URI do not have a valid URI
+    std::string ownerUri;
+    if (!isRoot) {
+        constexpr char Sep = PropertyOwner::URISeparator;
+        ownerUri = prefix.empty() ?
+            owner.identifier() :
+            std::format("{}{}{}", prefix, Sep, owner.identifier());
+    }
+
+    const size_t begin = _entries.size();
+    if (!ownerUri.empty()) {
+        for (Property* p : owner.properties()) {
+            std::string uri = std::format(
+                "{}{}{}", ownerUri, PropertyOwner::URISeparator, p->identifier()
+            );
+            _entries.push_back({ std::move(uri), p });
+        }
+    }
+
+    const std::string& childPrefix =
+        (isRoot || owner.identifier().empty()) ? prefix : ownerUri;
+    for (const PropertyOwner* subOwner : owner.propertySubOwners()) {
+        addOwner(*subOwner, childPrefix, false);
+    }
+
+    for (const std::string& tag : owner.tags()) {
+        TagEntry& entry = _ownersByTag[tag];
+        entry.owners.push_back(const_cast<PropertyOwner*>(&owner));
+        entry.ranges.emplace_back(begin, _entries.size());
+    }
+}
+
+std::vector<PropertyIndex::Range> PropertyIndex::rangesForTag(
+                                                             const std::string& tag) const
+{
+    auto it = _ownersByTag.find(tag);
+    if (it == _ownersByTag.end()) {
+        return {};
+    }
+
+    // Owners with the same tag can be nested, so we merge overlapping ranges to avoid
+    // reporting the same Property multiple times
+    std::vector<Range> ranges = it->second.ranges;
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<Range> result;
+    for (const Range& r : ranges) {
+        if (!result.empty() && r.first < result.back().second) {
+            result.back().second = std::max(result.back().second, r.second);
+        }
+        else if (r.first < r.second) {
+            result.push_back(r);
+        }
+    }
+    return result;
+}
+
+} // namespace openspace::properties
@@ -34,12 +34,21 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/invariants.h>
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 namespace {
     constexpr std::string_view _loggerCat = "PropertyOwner";
     using namespace openspace;
 
+    // Incremented on every structural change to any property tree. Properties can be
+    // added from worker threads while assets are initialized, so this has to be atomic
+    std::atomic<uint64_t> StructureGeneration = 1;
+
+    void bumpStructureGeneration() {
+        StructureGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+
     // The URIs have to be validated because it is not known in what order things are
     // constructed. For example, a SceneGraphNode can be created before its Renderable,
     // and vice versa. Invalid URIs are empty. The reason this works even though we don't
@@ -79,6 +88,7 @@ PropertyOwner::PropertyOwner(PropertyOwnerInfo info)
 PropertyOwner::~PropertyOwner() {
     _properties.clear();
     _subOwners.clear();
+    bumpStructureGeneration();
 }
 
 const std::vector<Property*>& PropertyOwner::properties() const {
@@ -259,6 +269,7 @@ void PropertyOwner::addProperty(Property* prop) {
         else {
             _properties.push_back(prop);
             prop->setPropertyOwner(this);
+            bumpStructureGeneration();
 
             // Notify change so we can update the UI
             publishPropertyTreeUpdatedEvent(prop->uri());
@@ -309,6 +320,7 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
         else {
             _subOwners.push_back(owner);
             owner->setPropertyOwner(this);
+            bumpStructureGeneration();
 
             // Notify change so UI gets updated
             publishPropertyTreeUpdatedEvent(owner->uri());
@@ -337,6 +349,7 @@ void PropertyOwner::removeProperty(Property* prop) {
 
         (*it)->setPropertyOwner(nullptr);
         _properties.erase(it);
+        bumpStructureGeneration();
     }
     else {
         LERROR(std::format(
@@ -366,6 +379,7 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
         // Notify the change so the UI can update
         publishPropertyTreePrunedEvent(owner->uri());
         _subOwners.erase(it);
+        bumpStructureGeneration();
     }
     else {
         LERROR(std::format(
@@ -383,6 +397,7 @@ void PropertyOwner::setIdentifier(std::string identifier) {
         throw ghoul::RuntimeError("Identifier must not contain any dots or whitespaces");
     }
     _identifier = std::move(identifier);
+    bumpStructureGeneration();
 }
 
 const std::string& PropertyOwner::identifier() const {
@@ -415,10 +430,16 @@ const std::vector<std::string>& PropertyOwner::tags() const {
 
 void PropertyOwner::addTag(std::string tag) {
     _tags.push_back(std::move(tag));
+    bumpStructureGeneration();
 }
 
 void PropertyOwner::removeTag(const std::string& tag) {
     _tags.erase(std::remove(_tags.begin(), _tags.end(), tag), _tags.end());
+    bumpStructureGeneration();
+}
+
+uint64_t PropertyOwner::structureGeneration() {
+    return StructureGeneration.load(std::memory_order_relaxed);
 }
 
 } // namespace openspace::properties
@@ -97,6 +97,7 @@ void SelectionProperty::setOptions(const std::vector<std::string>& keys) {
     }
     _options.shrink_to_fit();
     sortOptions();
+    invalidateJsonDescription();
 
     // In case we have a selection, remove non-existing options
     const bool changed = removeInvalidKeys(_value);
@@ -115,6 +116,7 @@ void SelectionProperty::addOption(const std::string& key) {
 
     _options.push_back(key);
     sortOptions();
+    invalidateJsonDescription();
     notifyChangeListeners();
 }
 
@@ -126,6 +128,7 @@ void SelectionProperty::clearSelection() {
 
 void SelectionProperty::clearOptions() {
     _options.clear();
+    invalidateJsonDescription();
     clearSelection();
 }
 
@@ -25,9 +25,14 @@
 #include <openspace/query/query.h>
 
 #include <openspace/engine/globals.h>
+#include <openspace/properties/propertyindex.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
 
+namespace {
+    openspace::properties::PropertyIndex Index;
+} // namespace
+
 namespace openspace {
 
 Scene* sceneGraph() {
@@ -64,4 +69,14 @@ std::vector<properties::Property*> allProperties() {
     return global::rootPropertyOwner->propertiesRecursive();
 }
 
+std::vector<properties::Property*> matchingProperties(const std::string& regex,
+                                                      const std::string& groupName)
+{
+    return Index.matchingProperties(
+        *global::rootPropertyOwner,
+        regex,
+        groupName
+    );
+}
+
 }  // namespace openspace
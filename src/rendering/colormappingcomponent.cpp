@@ -458,7 +458,7 @@ void ColorMappingComponent::initializeParameterData(const dataloader::Dataset& d
     int indexOfProvidedOption = -1;
 
     // If no options were added, add each dataset parameter and its range as options
-    if (dataColumn.options().empty() && !dataset.entries.empty()) {
+    if (dataColumn.options().empty() && dataset.nEntries() > 0) {
         int i = 0;
         _colorRangeData.reserve(dataset.variables.size());
         for (const dataloader::Dataset::Variable& v : dataset.variables) {
@@ -27,17 +27,39 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/documentation/documentation.h>
+#include <openspace/rendering/renderengine.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/font/font.h>
 #include <ghoul/font/fontmanager.h>
-#include <ghoul/font/fontrenderer.h>
+#include <ghoul/opengl/openglstatecache.h>
+#include <ghoul/opengl/programobject.h>
+#include <ghoul/opengl/texture.h>
+#include <ghoul/opengl/textureatlas.h>
+#include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <optional>
 
 namespace {
     constexpr std::string_view _loggerCat = "LabelsComponent";
 
-    constexpr int RenderOptionFaceCamera = 0;
-    constexpr int RenderOptionPositionNormal = 1;
+    constexpr std::string_view FontName = "Mono";
+
+    // The glyphs of all labels are stored in a single vertex buffer with one instance
+    // per glyph, which is drawn as a quad
+    struct GlyphInstance {
+        glm::vec3 position;
+        GLint label;
+        glm::vec4 rectangle;
+        glm::vec4 texCoords;
+        glm::vec4 outlineTexCoords;
+    };
+
+    // The program is shared between all labels components and created by the first one
+    std::unique_ptr<ghoul::opengl::ProgramObject> Program;
+    int NProgramUsers = 0;
 
     constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
         "Enabled",
@@ -221,6 +243,9 @@ LabelsComponent::LabelsComponent(const ghoul::Dictionary& dictionary)
 }
 
 dataloader::Labelset& LabelsComponent::labelSet() {
+    // The labels might be modified through the returned reference
+    _layoutIsDirty = true;
+    _labelsetIsModified = true;
     return _labelset;
 }
 
@@ -232,13 +257,116 @@ void LabelsComponent::initialize() {
     ZoneScoped;
 
     _font = global::fontManager->font(
-        "Mono",
+        FontName,
         _fontSize,
         ghoul::fontrendering::FontManager::Outline::Yes,
         ghoul::fontrendering::FontManager::LoadGlyphs::No
     );
 
     loadLabels();
+    _layoutIsDirty = true;
+}
+
+void LabelsComponent::initializeGL() {
+    ZoneScoped;
+
+    if (!Program) {
+        Program = global::renderEngine->buildRenderProgram(
+            "Labels",
+            absPath("${SHADERS}/core/labels_vs.glsl"),
+            absPath("${SHADERS}/core/labels_fs.glsl")
+        );
+    }
+    NProgramUsers++;
+    _program = Program.get();
+    ghoul::opengl::updateUniformLocations(*_program, _uniformCache);
+
+    glGenVertexArrays(1, &_vao);
+    glGenBuffers(1, &_vbo);
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(GlyphInstance),
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, position))
+    );
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(
+        1,
+        1,
+        GL_INT,
+        sizeof(GlyphInstance),
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, label))
+    );
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(
+        2,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(GlyphInstance),
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, rectangle))
+    );
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(
+        3,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(GlyphInstance),
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, texCoords))
+    );
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(
+        4,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(GlyphInstance),
+        reinterpret_cast<GLvoid*>(offsetof(GlyphInstance, outlineTexCoords))
+    );
+    for (GLuint i = 0; i < 5; i++) {
+        glVertexAttribDivisor(i, 1);
+    }
+    glBindVertexArray(0);
+
+    // The visibility of each label is read from a buffer texture in the vertex shader
+    glGenBuffers(1, &_visibilityBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, _visibilityBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(float), nullptr, GL_STREAM_DRAW);
+    glGenTextures(1, &_visibilityTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, _visibilityTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, _visibilityBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    _layoutIsDirty = true;
+}
+
+void LabelsComponent::deinitializeGL() {
+    glDeleteTextures(1, &_visibilityTexture);
+    _visibilityTexture = 0;
+    glDeleteBuffers(1, &_visibilityBuffer);
+    _visibilityBuffer = 0;
+    glDeleteBuffers(1, &_vbo);
+    _vbo = 0;
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+    _nGlyphs = 0;
+
+    if (_program) {
+        _program = nullptr;
+        NProgramUsers--;
+        if (NProgramUsers == 0) {
+            global::renderEngine->removeRenderProgram(Program.get());
+            Program = nullptr;
+        }
+    }
 }
 
 void LabelsComponent::loadLabelsFromDataset(const dataloader::Dataset& dataset,
@@ -257,6 +385,8 @@ void LabelsComponent::loadLabelsFromDataset(const dataloader::Dataset& dataset,
     _labelset = dataloader::label::loadFromDataset(dataset);
 
     _createdFromDataset = true;
+    _labelsetIsModified = false;
+    _layoutIsDirty = true;
 }
 
 void LabelsComponent::loadLabels() {
@@ -275,6 +405,8 @@ void LabelsComponent::loadLabels() {
     else {
         _labelset = dataloader::label::loadFile(_labelFile);
     }
+    _layoutIsDirty = true;
+    _labelsetIsModified = false;
 }
 
 bool LabelsComponent::isReady() const {
@@ -285,53 +417,269 @@ bool LabelsComponent::enabled() const {
     return _enabled;
 }
 
-void LabelsComponent::render(const RenderData& data,
-                             const glm::dmat4& modelViewProjectionMatrix,
-                             const glm::vec3& orthoRight, const glm::vec3& orthoUp,
-                             float fadeInVariable)
-{
-    if (!_enabled) {
-        return;
+void LabelsComponent::createTextLayout() {
+    ZoneScoped;
+
+    using Glyph = ghoul::fontrendering::Font::Glyph;
+
+    const float lineHeight = _font->height();
+
+    dataloader::Labelset::TextLayout layout = { .font = fontDescription() };
+    layout.glyphs.reserve(_labelset.strings.size());
+    layout.glyphOffsets.reserve(_labelset.entries.size() + 1);
+    layout.sizes.reserve(_labelset.entries.size());
+    layout.glyphOffsets.push_back(0);
+    for (const dataloader::Labelset::Entry& e : _labelset.entries) {
+        const std::string_view text = _labelset.text(e);
+
+        glm::vec2 pen = glm::vec2(0.f);
+        float width = 0.f;
+        for (size_t i = 0; i < text.size(); i++) {
+            const wchar_t character = static_cast<unsigned char>(text[i]);
+            if (character == L'\n') {
+                pen = glm::vec2(0.f, pen.y - lineHeight);
+                continue;
+            }
+
+            const Glyph* glyph = _font->glyph(character);
+            if (!glyph) {
+                continue;
+            }
+            if (i > 0) {
+                pen.x += glyph->kerning(static_cast<unsigned char>(text[i - 1]));
+            }
+
+            const float x0 = pen.x + glyph->leftBearing;
+            const float y0 = pen.y + glyph->topBearing;
+            layout.glyphs.push_back({
+                .rectangle = glm::vec4(x0, y0, x0 + glyph->width, y0 - glyph->height),
+                .character = static_cast<uint32_t>(character)
+            });
+
+            pen.x += glyph->horizontalAdvance;
+            width = std::max(width, pen.x);
+        }
+        layout.glyphOffsets.push_back(static_cast<uint32_t>(layout.glyphs.size()));
+        layout.sizes.emplace_back(width, lineHeight - pen.y);
     }
-    const float scale = static_cast<float>(toMeter(_unit));
+    _labelset.layout = std::move(layout);
 
-    const int renderOption =
-        _faceCamera ? RenderOptionFaceCamera : RenderOptionPositionNormal;
+    if (_useCache && !_createdFromDataset && !_labelsetIsModified) {
+        // Store the layout so that the next time these labels are loaded with the same
+        // font, they don't have to be measured again. Only one file is written at a time
+        if (_cacheWrite.valid()) {
+            _cacheWrite.wait();
+        }
+        _cacheWrite = dataloader::label::updateCachedFile(_labelset, _labelFile);
+    }
+}
 
-    ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
-    labelInfo.orthoRight = orthoRight;
-    labelInfo.orthoUp = orthoUp;
-    labelInfo.minSize = _minMaxSize.value().x;
-    labelInfo.maxSize = _minMaxSize.value().y;
-    labelInfo.cameraPos = data.camera.positionVec3();
-    labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
-    labelInfo.renderType = renderOption;
-    labelInfo.mvpMatrix = modelViewProjectionMatrix;
-    labelInfo.scale = pow(10.f, _size);
-    labelInfo.enableDepth = true;
-    labelInfo.enableFalseDepth = false;
+void LabelsComponent::updateLayout() {
+    ZoneScoped;
 
-    const glm::vec4 textColor = glm::vec4(glm::vec3(_color), opacity() * fadeInVariable);
+    using Glyph = ghoul::fontrendering::Font::Glyph;
 
-    for (const dataloader::Labelset::Entry& e : _labelset.entries) {
-        if (!e.isEnabled) {
-            continue;
+    if (!_labelset.layout.has_value() || _labelset.layout->font != fontDescription()) {
+        createTextLayout();
+    }
+    const dataloader::Labelset::TextLayout& layout = *_labelset.layout;
+
+    // The layout only stores the characters, so the location of each glyph in the font
+    // atlas is looked up once per distinct character
+    std::array<const Glyph*, 256> atlasGlyphs = {};
+    for (const dataloader::Labelset::TextLayout::Glyph& g : layout.glyphs) {
+        const uint8_t c = static_cast<uint8_t>(g.character);
+        if (!atlasGlyphs[c]) {
+            atlasGlyphs[c] = _font->glyph(static_cast<wchar_t>(c));
         }
+    }
+
+    const float scale = static_cast<float>(toMeter(_unit));
 
+    std::vector<GlyphInstance> glyphs;
+    glyphs.reserve(layout.glyphs.size());
+    _labelPositions.clear();
+    _labelPositions.reserve(_labelset.entries.size());
+    for (size_t i = 0; i < _labelset.entries.size(); i++) {
         // Transform and scale the labels
         const glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(e.position, 1.0)
+            _transformationMatrix * glm::dvec4(_labelset.entries[i].position, 1.0)
         );
-        const glm::vec3 scaledPos = glm::vec3(transformedPos * scale);
-
-        ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
-            *_font,
-            scaledPos,
-            e.text,
-            textColor,
-            labelInfo
+        const glm::vec3 position = transformedPos * scale;
+        _labelPositions.push_back(position);
+
+        for (uint32_t j = layout.glyphOffsets[i]; j < layout.glyphOffsets[i + 1]; j++) {
+            const dataloader::Labelset::TextLayout::Glyph& g = layout.glyphs[j];
+            const Glyph* glyph = atlasGlyphs[static_cast<uint8_t>(g.character)];
+            if (!glyph) {
+                continue;
+            }
+
+            glyphs.push_back({
+                .position = position,
+                .label = static_cast<GLint>(i),
+                .rectangle = g.rectangle,
+                .texCoords = glm::vec4(glyph->topLeft, glyph->bottomRight),
+                .outlineTexCoords = glm::vec4(
+                    glyph->outlineTopLeft,
+                    glyph->outlineBottomRight
+                )
+            });
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        glyphs.size() * sizeof(GlyphInstance),
+        glyphs.data(),
+        GL_STATIC_DRAW
+    );
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _nGlyphs = static_cast<GLsizei>(glyphs.size());
+
+    _labelVisibility.assign(_labelPositions.size(), 0.f);
+}
+
+std::string LabelsComponent::fontDescription() const {
+    return std::format("{}|{}", FontName, _fontSize.value());
+}
+
+size_t LabelsComponent::updateVisibility(const RenderData& data,
+                                         const glm::dmat4& modelViewProjectionMatrix,
+                                         const glm::vec3& orthoUp)
+{
+    ZoneScoped;
+
+    const glm::dvec2 halfResolution =
+        glm::dvec2(global::renderEngine->renderingResolution()) * 0.5;
+    const double lineHeight = _font->height() * std::pow(10.0, _size.value());
+    const glm::dvec2 minMaxSize = glm::dvec2(_minMaxSize.value());
+    const glm::dvec3 cameraPosition = data.camera.positionVec3();
+    const glm::dvec3 cameraLookUp = data.camera.lookUpVectorWorldSpace();
+    const std::vector<glm::vec2>& labelSizes = _labelset.layout->sizes;
+
+    size_t nVisible = 0;
+    for (size_t i = 0; i < _labelPositions.size(); i++) {
+        _labelVisibility[i] = 0.f;
+        if (!_labelset.entries[i].isEnabled) {
+            continue;
+        }
+
+        const glm::dvec3 anchor = glm::dvec3(_labelPositions[i]);
+        glm::dvec3 up = glm::dvec3(orthoUp);
+        if (!_faceCamera) {
+            // Has to match the orientation that is computed in the vertex shader
+            const glm::dvec3 normal = glm::normalize(cameraPosition - anchor);
+            const glm::dvec3 right = glm::normalize(glm::cross(cameraLookUp, normal));
+            up = glm::cross(normal, right);
+        }
+
+        const glm::dvec4 anchorClip = modelViewProjectionMatrix * glm::dvec4(anchor, 1.0);
+        const glm::dvec4 topClip =
+            modelViewProjectionMatrix * glm::dvec4(anchor + up * lineHeight, 1.0);
+        if (anchorClip.w <= 0.0 || topClip.w <= 0.0) {
+            // The label is behind the camera
+            continue;
+        }
+        const glm::dvec2 anchorNdc = glm::dvec2(anchorClip) / anchorClip.w;
+        const glm::dvec2 topNdc = glm::dvec2(topClip) / topClip.w;
+
+        // Labels outside of the size range are not shown at all
+        const double height = glm::length((topNdc - anchorNdc) * halfResolution);
+        if (height < minMaxSize.x || height > minMaxSize.y) {
+            continue;
+        }
+
+        // Conservatively estimate the extent of the label on screen from its size
+        const double extent = glm::length(topNdc - anchorNdc) *
+            std::max(labelSizes[i].x, labelSizes[i].y) / _font->height();
+        const bool isOutside =
+            anchorNdc.x - extent > 1.0 || anchorNdc.x + extent < -1.0 ||
+            anchorNdc.y - extent > 1.0 || anchorNdc.y + extent < -1.0;
+        if (isOutside) {
+            continue;
+        }
+
+        _labelVisibility[i] = 1.f;
+        nVisible++;
+    }
+
+    if (nVisible > 0) {
+        glBindBuffer(GL_TEXTURE_BUFFER, _visibilityBuffer);
+        glBufferData(
+            GL_TEXTURE_BUFFER,
+            _labelVisibility.size() * sizeof(float),
+            _labelVisibility.data(),
+            GL_STREAM_DRAW
         );
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
     }
+    return nVisible;
+}
+
+void LabelsComponent::render(const RenderData& data,
+                             const glm::dmat4& modelViewProjectionMatrix,
+                             const glm::vec3& orthoRight, const glm::vec3& orthoUp,
+                             float fadeInVariable)
+{
+    if (!_enabled || !_program || !_font) {
+        return;
+    }
+
+    if (_layoutIsDirty) {
+        updateLayout();
+        _layoutIsDirty = false;
+    }
+
+    // The visibility and size of the labels is determined on the CPU so that all
+    // glyphs of all labels can be drawn with a single instanced draw call
+    const size_t nVisible =
+        updateVisibility(data, modelViewProjectionMatrix, orthoUp);
+    if (nVisible == 0) {
+        return;
+    }
+
+    _program->activate();
+
+    _program->setUniform(_uniformCache.modelViewProjection, modelViewProjectionMatrix);
+    _program->setUniform(_uniformCache.scale, std::pow(10.f, _size.value()));
+    _program->setUniform(_uniformCache.faceCamera, _faceCamera.value());
+    _program->setUniform(_uniformCache.orthoRight, orthoRight);
+    _program->setUniform(_uniformCache.orthoUp, orthoUp);
+    _program->setUniform(_uniformCache.cameraPosition, data.camera.positionVec3());
+    _program->setUniform(
+        _uniformCache.cameraLookUp,
+        data.camera.lookUpVectorWorldSpace()
+    );
+
+    const float alpha = opacity() * fadeInVariable;
+    _program->setUniform(_uniformCache.color, glm::vec4(glm::vec3(_color), alpha));
+    _program->setUniform(_uniformCache.outlineColor, glm::vec4(glm::vec3(0.f), alpha));
+
+    ghoul::opengl::TextureUnit atlasUnit;
+    atlasUnit.activate();
+    _font->atlas().texture().bind();
+    _program->setUniform(_uniformCache.atlas, atlasUnit);
+
+    ghoul::opengl::TextureUnit visibilityUnit;
+    visibilityUnit.activate();
+    glBindTexture(GL_TEXTURE_BUFFER, _visibilityTexture);
+    _program->setUniform(_uniformCache.labelVisibility, visibilityUnit);
+
+    glEnablei(GL_BLEND, 0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(false);
+
+    glBindVertexArray(_vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, _nGlyphs);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    _program->deactivate();
+
+    global::renderEngine->openglStateCache().resetBlendState();
+    global::renderEngine->openglStateCache().resetDepthState();
 }
 
 } // namespace openspace
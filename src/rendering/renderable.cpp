@@ -145,6 +145,7 @@ Renderable::Renderable(const ghoul::Dictionary& dictionary, RenderableSettings s
     , _renderableType(RenderableTypeInfo, "Renderable")
     , _dimInAtmosphere(DimInAtmosphereInfo, false)
     , _shouldUpdateIfDisabled(settings.shouldUpdateIfDisabled)
+    , _supportsParallelUpdate(settings.supportsParallelUpdate)
     , _automaticallyUpdateRenderBin(settings.automaticallyUpdateRenderBin)
 {
     ZoneScoped;
@@ -286,6 +287,10 @@ bool Renderable::shouldUpdateIfDisabled() const noexcept {
     return _shouldUpdateIfDisabled;
 }
 
+bool Renderable::supportsParallelUpdate() const noexcept {
+    return _supportsParallelUpdate;
+}
+
 void Renderable::onEnabledChange(std::function<void(bool)> callback) {
     _enabled.onChange([this, c = std::move(callback)]() {
         c(isEnabled());
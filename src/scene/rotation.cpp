@@ -92,4 +92,8 @@ void Rotation::update(const UpdateData& data) {
     _needsUpdate = false;
 }
 
+bool Rotation::supportsParallelUpdate(const UpdateData&) const {
+    return false;
+}
+
 } // namespace openspace
@@ -93,4 +93,8 @@ void Scale::update(const UpdateData& data) {
     _needsUpdate = false;
 }
 
+bool Scale::supportsParallelUpdate(const UpdateData&) const {
+    return false;
+}
+
 } // namespace openspace
@@ -41,6 +41,7 @@
 #include <openspace/scene/sceneinitializer.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/scripting/scriptengine.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
@@ -51,6 +52,7 @@
 #include <ghoul/misc/profiling.h>
 #include <ghoul/misc/stringhelper.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <algorithm>
 #include <string>
 #include <stack>
 
@@ -62,6 +64,29 @@ namespace {
     constexpr std::string_view KeyParent = "Parent";
     constexpr const char* RootNodeIdentifier = "Root";
 
+    // The number of nodes that are updated in a single task. Most node updates are far
+    // too cheap to be worth a task each
+    constexpr size_t NodesPerUpdateTask = 64;
+
+    constexpr openspace::properties::Property::PropertyInfo ParallelUpdateInfo = {
+        "ParallelUpdate",
+        "Parallel Update",
+        "If this value is enabled, scene graph nodes that do not depend on each other "
+        "are updated concurrently on multiple threads. Nodes whose transformations or "
+        "renderable are not safe to update on a different thread are still updated on "
+        "the main thread.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MeasureUpdateTimesInfo = {
+        "MeasureUpdateTimes",
+        "Measure Update Times",
+        "If this value is enabled, the time each scene graph node takes to update is "
+        "recorded every frame. The results can be queried with the "
+        "'openspace.nodeUpdateTimes' function.",
+        openspace::properties::Property::Visibility::Developer
+    };
+
 #ifdef TRACY_ENABLE
     constexpr const char* renderBinToString(int renderBin) {
         // Synced with Renderable::RenderBin
@@ -113,12 +138,18 @@ Scene::Scene(std::unique_ptr<SceneInitializer> initializer)
     : properties::PropertyOwner({"Scene", "Scene"})
     , _camera(std::make_unique<Camera>())
     , _initializer(std::move(initializer))
+    , _parallelUpdate(ParallelUpdateInfo, false)
+    , _measureUpdateTimes(MeasureUpdateTimesInfo, false)
 {
     _rootNode.setIdentifier(RootNodeIdentifier);
     _rootNode.setScene(this);
     _rootNode.setGuiHintHidden(true);
 
     _camera->setParent(&_rootNode);
+
+    addProperty(_parallelUpdate);
+    _measureUpdateTimes.onChange([this]() { _nodeUpdateTimes.clear(); });
+    addProperty(_measureUpdateTimes);
 }
 
 Scene::~Scene() {
@@ -165,6 +196,7 @@ void Scene::registerNode(SceneGraphNode* node) {
     _topologicallySortedNodes.push_back(node);
     _nodesByIdentifier[node->identifier()] = node;
     addPropertySubOwner(node);
+    _nodeUpdateTimes.clear();
     _dirtyNodeRegistry = true;
 }
 
@@ -184,6 +216,7 @@ void Scene::unregisterNode(SceneGraphNode* node) {
         removePropertyInterpolation(p);
     }
     removePropertySubOwner(node);
+    _nodeUpdateTimes.clear();
     _dirtyNodeRegistry = true;
 }
 
@@ -195,6 +228,7 @@ void Scene::updateNodeRegistry() {
     ZoneScoped;
 
     sortTopologically();
+    computeUpdateLevels();
     _dirtyNodeRegistry = false;
 }
 
@@ -273,6 +307,50 @@ void Scene::sortTopologically() {
     _topologicallySortedNodes = nodes;
 }
 
+void Scene::computeUpdateLevels() {
+    ZoneScoped;
+
+    std::unordered_map<const SceneGraphNode*, size_t> indices;
+    indices.reserve(_topologicallySortedNodes.size());
+    for (size_t i = 0; i < _topologicallySortedNodes.size(); i++) {
+        indices[_topologicallySortedNodes[i]] = i;
+    }
+
+    std::vector<std::vector<size_t>> predecessors(_topologicallySortedNodes.size());
+    for (size_t i = 0; i < _topologicallySortedNodes.size(); i++) {
+        const SceneGraphNode* node = _topologicallySortedNodes[i];
+        if (node->parent()) {
+            predecessors[i].push_back(indices[node->parent()]);
+        }
+        for (const SceneGraphNode* dependency : node->dependencies()) {
+            predecessors[i].push_back(indices[dependency]);
+        }
+    }
+    _updateLevels = groupIntoUpdateLevels(predecessors);
+}
+
+std::vector<std::vector<size_t>> Scene::groupIntoUpdateLevels(
+                                     const std::vector<std::vector<size_t>>& predecessors)
+{
+    std::vector<size_t> levels(predecessors.size(), 0);
+    std::vector<std::vector<size_t>> result;
+    for (size_t i = 0; i < predecessors.size(); i++) {
+        // As the nodes are sorted, all predecessors already have a level
+        size_t level = 0;
+        for (size_t predecessor : predecessors[i]) {
+            ghoul_assert(predecessor < i, "Nodes must be sorted topologically");
+            level = std::max(level, levels[predecessor] + 1);
+        }
+        levels[i] = level;
+
+        if (level >= result.size()) {
+            result.resize(level + 1);
+        }
+        result[level].push_back(i);
+    }
+    return result;
+}
+
 void Scene::initializeNode(SceneGraphNode* node) {
     ghoul_assert(node, "Node must not be nullptr");
 
@@ -299,16 +377,110 @@ void Scene::update(const UpdateData& data) {
         updateNodeRegistry();
     }
     _camera->setAtmosphereDimmingFactor(1.f);
-    for (SceneGraphNode* node : _topologicallySortedNodes) {
-        try {
-            node->update(data);
+
+    const bool measure = _measureUpdateTimes;
+    if (measure) {
+        _nodeUpdateTimes.assign(
+            _topologicallySortedNodes.size(),
+            std::chrono::nanoseconds(0)
+        );
+    }
+
+    if (!_parallelUpdate) {
+        for (size_t i = 0; i < _topologicallySortedNodes.size(); i++) {
+            updateNode(i, data, measure);
         }
-        catch (const ghoul::RuntimeError& e) {
-            LERRORC(e.component, e.what());
+        return;
+    }
+
+    // All nodes of one level only depend on nodes of previous levels, so they can be
+    // updated in any order. Whether a node is safe to update from a worker thread can
+    // depend on the time, so the nodes are partitioned anew every frame. The nodes that
+    // are not safe are updated on this thread while the workers handle the rest
+    for (const std::vector<size_t>& level : _updateLevels) {
+        _parallelNodes.clear();
+        _serialNodes.clear();
+        for (size_t i : level) {
+            if (_topologicallySortedNodes[i]->supportsParallelUpdate(data)) {
+                _parallelNodes.push_back(i);
+            }
+            else {
+                _serialNodes.push_back(i);
+            }
+        }
+
+        TaskScheduler::TaskGroup group(*global::taskScheduler);
+        const bool useTasks = _parallelNodes.size() > NodesPerUpdateTask;
+        if (useTasks) {
+            const std::vector<size_t>& parallel = _parallelNodes;
+            for (size_t begin = 0; begin < parallel.size(); begin += NodesPerUpdateTask) {
+                const size_t end = std::min(begin + NodesPerUpdateTask, parallel.size());
+                group.run([this, &parallel, &data, measure, begin, end]() {
+                    for (size_t i = begin; i < end; i++) {
+                        updateNode(parallel[i], data, measure);
+                    }
+                });
+            }
+        }
+        else {
+            for (size_t i : _parallelNodes) {
+                updateNode(i, data, measure);
+            }
+        }
+
+        for (size_t i : _serialNodes) {
+            updateNode(i, data, measure);
+        }
+
+        if (useTasks) {
+            group.wait();
         }
     }
 }
 
+void Scene::updateNode(size_t index, const UpdateData& data, bool measure) {
+    SceneGraphNode* node = _topologicallySortedNodes[index];
+    const auto begin = measure ?
+        std::chrono::steady_clock::now() :
+        std::chrono::steady_clock::time_point();
+
+    try {
+        node->update(data);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.what());
+    }
+
+    if (measure) {
+        _nodeUpdateTimes[index] = std::chrono::steady_clock::now() - begin;
+    }
+}
+
+std::vector<std::pair<SceneGraphNode*, std::chrono::nanoseconds>>
+Scene::nodeUpdateTimes() const
+{
+    std::vector<std::pair<SceneGraphNode*, std::chrono::nanoseconds>> res;
+    if (_nodeUpdateTimes.size() != _topologicallySortedNodes.size()) {
+        // Nodes were added or removed since the last measurement
+        return res;
+    }
+
+    res.reserve(_nodeUpdateTimes.size());
+    for (size_t i = 0; i < _nodeUpdateTimes.size(); i++) {
+        res.emplace_back(_topologicallySortedNodes[i], _nodeUpdateTimes[i]);
+    }
+    std::sort(
+        res.begin(),
+        res.end(),
+        [](const std::pair<SceneGraphNode*, std::chrono::nanoseconds>& lhs,
+           const std::pair<SceneGraphNode*, std::chrono::nanoseconds>& rhs)
+        {
+            return lhs.second > rhs.second;
+        }
+    );
+    return res;
+}
+
 void Scene::render(const RenderData& data, RendererTasks& tasks) {
     ZoneScoped;
     ZoneText(
@@ -601,7 +773,6 @@ void Scene::setPropertiesFromProfile(const Profile& p) {
         applyRegularExpression(
             L,
             uriOrRegex,
-            allProperties(),
             0.0,
             groupName,
             ghoul::EasingFunction::Linear,
@@ -776,7 +947,7 @@ PropertyValueType Scene::propertyValueType(const std::string& value) {
 std::vector<properties::Property*> Scene::propertiesMatchingRegex(
                                                         const std::string& propertyString)
 {
-    return findMatchesInAllProperties(propertyString, allProperties(), "");
+    return findMatchesInAllProperties(propertyString, "");
 }
 
 std::vector<std::string> Scene::allTags() {
@@ -877,7 +1048,8 @@ scripting::LuaLibrary Scene::luaLibrary() {
             codegen::lua::SetParent,
             codegen::lua::BoundingSphere,
             codegen::lua::InteractionSphere,
-            codegen::lua::MakeIdentifier
+            codegen::lua::MakeIdentifier,
+            codegen::lua::NodeUpdateTimes
         }
     };
 }
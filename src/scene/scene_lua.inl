@@ -54,151 +54,26 @@
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/screenspacerenderable.h>
+#include <ghoul/misc/exception.h>
 #include <algorithm>
 #include <cctype>
 
 namespace {
 
-template <class T>
-openspace::properties::PropertyOwner* findPropertyOwnerWithMatchingGroupTag(T* prop,
-                                                            const std::string& tagToMatch)
-{
-    using namespace openspace;
-
-    properties::PropertyOwner* tagMatchOwner = nullptr;
-    properties::PropertyOwner* owner = prop->owner();
-
-    if (owner) {
-        const std::vector<std::string>& tags = owner->tags();
-        for (const std::string& currTag : tags) {
-            if (tagToMatch == currTag) {
-                tagMatchOwner = owner;
-                break;
-            }
-        }
-
-        // Call recursively until we find an owner with matching tag or the top of the
-        // ownership list
-        if (tagMatchOwner == nullptr) {
-            tagMatchOwner = findPropertyOwnerWithMatchingGroupTag(owner, tagToMatch);
-        }
-    }
-    return tagMatchOwner;
-}
-
 std::vector<openspace::properties::Property*> findMatchesInAllProperties(
                                                                 const std::string& regex,
-                         const std::vector<openspace::properties::Property*>& properties,
                                                             const std::string& groupName)
 {
-    using namespace openspace;
-
-    std::vector<properties::Property*> matches;
-    const bool isGroupMode = !groupName.empty();
-    bool isLiteral = false;
-
-    // Extract the property and node name to be searched for from regex
-    std::string propertyName;
-    std::string nodeName;
-    size_t wildPos = regex.find_first_of("*");
-    if (wildPos != std::string::npos) {
-        nodeName = regex.substr(0, wildPos);
-        propertyName = regex.substr(wildPos + 1, regex.length());
-
-        // If none then malformed regular expression
-        if (propertyName.empty() && nodeName.empty()) {
-            LERRORC(
-                "findMatchesInAllProperties",
-                std::format(
-                    "Malformed regular expression: '{}': Empty both before and after '*'",
-                    regex
-                )
-            );
-            return matches;
-        }
-
-        // Currently do not support several wildcards
-        if (regex.find_first_of("*", wildPos + 1) != std::string::npos) {
-            LERRORC(
-                "findMatchesInAllProperties",
-                std::format(
-                    "Malformed regular expression: '{}': Currently only one '*' is "
-                    "supported", regex
-                )
-            );
-            return matches;
-        }
-    }
-    // Literal or tag
-    else {
-        propertyName = regex;
-        if (!isGroupMode) {
-            isLiteral = true;
-        }
+    try {
+        return openspace::matchingProperties(regex, groupName);
     }
-
-    // Stores whether we found at least one matching property. If this is false at the end
-    // of the loop, the property name regex was probably misspelled.
-    for (properties::Property* prop : properties) {
-        // Check the regular expression for all properties
-        const std::string id = prop->uri();
-
-        if (isLiteral && id != propertyName) {
-            continue;
-        }
-        else if (!propertyName.empty()) {
-            size_t propertyPos = id.find(propertyName);
-            if (propertyPos != std::string::npos) {
-                // Check that the propertyName fully matches the property in id
-                if ((propertyPos + propertyName.length() + 1) < id.length()) {
-                    continue;
-                }
-
-                // Match node name
-                if (!nodeName.empty() && id.find(nodeName) == std::string::npos) {
-                    continue;
-                }
-
-                // Check tag
-                if (isGroupMode) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        else if (!nodeName.empty()) {
-            size_t nodePos = id.find(nodeName);
-            if (nodePos != std::string::npos) {
-                // Check tag
-                if (isGroupMode) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-                // Check that the nodeName fully matches the node in id
-                else if (nodePos != 0) {
-                    continue;
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        matches.push_back(prop);
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC("findMatchesInAllProperties", e.message);
+        return std::vector<openspace::properties::Property*>();
     }
-    return matches;
 }
 
 void applyRegularExpression(lua_State* L, const std::string& regex,
-                          const std::vector<openspace::properties::Property*>& properties,
                                                              double interpolationDuration,
                                                              const std::string& groupName,
                                                      ghoul::EasingFunction easingFunction,
@@ -212,7 +87,6 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
 
     std::vector<properties::Property*> matchingProps = findMatchesInAllProperties(
         regex,
-        properties,
         groupName
     );
 
@@ -441,7 +315,6 @@ int propertySetValue(lua_State* L) {
         applyRegularExpression(
             L,
             uriOrRegex,
-            allProperties(),
             interpolationDuration,
             groupName,
             easingMethod,
@@ -506,99 +379,20 @@ namespace {
         regex = removeGroupNameFromUri(regex);
     }
 
-    // Extract the property and node name to be searched for from regex
-    bool isLiteral = false;
-    std::string propertyName;
-    std::string nodeName;
-    size_t wildPos = regex.find_first_of("*");
-    if (wildPos != std::string::npos) {
-        nodeName = regex.substr(0, wildPos);
-        propertyName = regex.substr(wildPos + 1, regex.length());
-
-        // If none then malformed regular expression
-        if (propertyName.empty() && nodeName.empty()) {
-            throw ghoul::lua::LuaError(std::format(
-                "Malformed regular expression: '{}': Empty both before and after '*'",
-                regex
-            ));
-        }
-
-        // Currently do not support several wildcards
-        if (regex.find_first_of("*", wildPos + 1) != std::string::npos) {
-            throw ghoul::lua::LuaError(std::format(
-                "Malformed regular expression: '{}': Currently only one '*' is supported",
-                regex
-            ));
-        }
+    std::vector<properties::Property*> props;
+    try {
+        props = matchingProperties(regex, groupName);
     }
-    // Literal or tag
-    else {
-        propertyName = regex;
-        if (groupName.empty()) {
-            isLiteral = true;
-        }
+    catch (const ghoul::RuntimeError& e) {
+        throw ghoul::lua::LuaError(e.message);
     }
 
     // Get all matching property uris and save to res
-    std::vector<properties::Property*> props = allProperties();
     std::vector<std::string> res;
+    res.reserve(props.size());
     for (properties::Property* prop : props) {
-        // Check the regular expression for all properties
-        const std::string& id = prop->uri();
-
-        if (isLiteral && id != propertyName) {
-            continue;
-        }
-        else if (!propertyName.empty()) {
-            size_t propertyPos = id.find(propertyName);
-            if (propertyPos != std::string::npos) {
-                // Check that the propertyName fully matches the property in id
-                if ((propertyPos + propertyName.length() + 1) < id.length()) {
-                    continue;
-                }
-
-                // Match node name
-                if (!nodeName.empty() && id.find(nodeName) == std::string::npos) {
-                    continue;
-                }
-
-                // Check tag
-                if (!groupName.empty()) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-            }
-            else {
-                continue;
-            }
-        }
-        else if (!nodeName.empty()) {
-            size_t nodePos = id.find(nodeName);
-            if (nodePos != std::string::npos) {
-                // Check tag
-                if (!groupName.empty()) {
-                    properties::PropertyOwner* matchingTaggedOwner =
-                        findPropertyOwnerWithMatchingGroupTag(prop, groupName);
-                    if (!matchingTaggedOwner) {
-                        continue;
-                    }
-                }
-                // Check that the nodeName fully matches the node in id
-                else if (nodePos != 0) {
-                    continue;
-                }
-            }
-            else {
-                continue;
-            }
-        }
-
-        res.push_back(id);
+        res.push_back(prop->uri());
     }
-
     return res;
 }
 
@@ -1226,6 +1020,29 @@ enum class [[codegen::enum]] CustomPropertyType {
     }
 }
 
+/**
+ * Returns the time that each scene graph node spent in its update during the last frame,
+ * sorted from the slowest to the fastest node. Each entry is a table with the
+ * `Identifier` of the node and the `Time` in milliseconds. The list is empty unless the
+ * `Scene.MeasureUpdateTimes` property is enabled.
+ */
+[[codegen::luawrap]] std::vector<ghoul::Dictionary> nodeUpdateTimes() {
+    using namespace openspace;
+
+    std::vector<ghoul::Dictionary> res;
+    using Entry = std::pair<SceneGraphNode*, std::chrono::nanoseconds>;
+    for (const Entry& e : global::renderEngine->scene()->nodeUpdateTimes()) {
+        ghoul::Dictionary d;
+        d.setValue("Identifier", e.first->identifier());
+        d.setValue(
+            "Time",
+            std::chrono::duration<double, std::milli>(e.second).count()
+        );
+        res.push_back(std::move(d));
+    }
+    return res;
+}
+
 /**
  * Create a valid identifier from the provided input string. Will replace invalid
  * characters like whitespaces and some punctuation marks with valid alternatives
@@ -1303,6 +1303,24 @@ bool SceneGraphNode::supportsDirectInteraction() const {
     return _supportsDirectInteraction;
 }
 
+bool SceneGraphNode::supportsParallelUpdate(const UpdateData& data) const {
+    // Observers of the translation are not required to be thread-safe, so they are only
+    // notified from the main thread
+    if (_transform.translation &&
+        (_transform.translation->hasObservers() ||
+         !_transform.translation->supportsParallelUpdate(data)))
+    {
+        return false;
+    }
+    if (_transform.rotation && !_transform.rotation->supportsParallelUpdate(data)) {
+        return false;
+    }
+    if (_transform.scale && !_transform.scale->supportsParallelUpdate(data)) {
+        return false;
+    }
+    return !_renderable || _renderable->supportsParallelUpdate();
+}
+
 const Renderable* SceneGraphNode::renderable() const {
     return _renderable.get();
 }
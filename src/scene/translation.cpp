@@ -87,6 +87,10 @@ void Translation::update(const UpdateData& data) {
     }
 }
 
+bool Translation::supportsParallelUpdate(const UpdateData&) const {
+    return false;
+}
+
 glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
@@ -105,4 +109,8 @@ void Translation::onParameterChange(std::function<void()> callback) {
     _onParameterChangeCallback = std::move(callback);
 }
 
+bool Translation::hasObservers() const {
+    return static_cast<bool>(_onParameterChangeCallback);
+}
+
 } // namespace openspace
@@ -0,0 +1,345 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scripting/scriptcache.h>
+
+#include <ghoul/format.h>
+#include <ghoul/lua/ghoul_lua.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+
+namespace {
+    // The maximum number of parameters in a template. The parameters are local variables
+    // of the chunk, of which Lua allows at most 200
+    constexpr size_t MaxParameters = 64;
+
+    // A cached template is shared by all scripts that only differ in their literals, so
+    // the text of the script that happened to be compiled first must not be used as the
+    // name of the chunk in error messages
+    constexpr const char* TemplateChunkName = "=[templated script]";
+
+    constexpr std::array<std::string_view, 22> Keywords = {
+        "and", "break", "do", "else", "elseif", "end", "false", "for", "function", "goto",
+        "if", "in", "local", "nil", "not", "or", "repeat", "return", "then", "true",
+        "until", "while"
+    };
+
+    bool isNameStart(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    bool isHexDigit(char c) {
+        return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // Returns the end of the number literal starting at `begin` or std::string_view::npos
+    // if the literal is malformed
+    size_t scanNumber(std::string_view script, size_t begin) {
+        size_t i = begin;
+        const bool isHex = script[i] == '0' && i + 1 < script.size() &&
+                           (script[i + 1] == 'x' || script[i + 1] == 'X');
+        if (isHex) {
+            i += 2;
+        }
+
+        int nDots = 0;
+        while (i < script.size() &&
+               (script[i] == '.' || (isHex ? isHexDigit(script[i]) : isDigit(script[i]))))
+        {
+            nDots += script[i] == '.' ? 1 : 0;
+            i++;
+        }
+        if (nDots > 1) {
+            // Either a malformed number or a number followed by a concatenation
+            return std::string_view::npos;
+        }
+
+        if (i < script.size() && (isHex ?
+            (script[i] == 'p' || script[i] == 'P') :
+            (script[i] == 'e' || script[i] == 'E')))
+        {
+            i++;
+            if (i < script.size() && (script[i] == '+' || script[i] == '-')) {
+                i++;
+            }
+            while (i < script.size() && isDigit(script[i])) {
+                i++;
+            }
+        }
+
+        if (i < script.size() && (isNameStart(script[i]) || isDigit(script[i]))) {
+            return std::string_view::npos;
+        }
+        return i;
+    }
+
+    std::string popError(lua_State* state) {
+        const char* message = lua_tostring(state, -1);
+        std::string error = message ? message : "Unknown error";
+        lua_pop(state, 1);
+        return error;
+    }
+
+    void compile(lua_State* state, const std::string& script, const char* name) {
+        const int status = luaL_loadbuffer(state, script.data(), script.size(), name);
+        if (status != LUA_OK) {
+            throw ghoul::lua::LuaLoadingException(popError(state));
+        }
+    }
+} // namespace
+
+namespace openspace::scripting {
+
+std::optional<ScriptCache::Template> ScriptCache::createTemplate(std::string_view script)
+{
+    ZoneScoped;
+
+    if (script.find(ParameterPrefix) != std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    Template res;
+    std::string body;
+    body.reserve(script.size());
+
+    // The kind of the previous token is needed to detect function calls that use the
+    // string call syntax, like `f"a"`, in which the literal can't be replaced
+    enum class Token {
+        Name,
+        Closing,
+        Literal,
+        Other
+    };
+    Token previous = Token::Other;
+
+    size_t i = 0;
+    while (i < script.size()) {
+        const char c = script[i];
+        const char next = i + 1 < script.size() ? script[i + 1] : '\0';
+
+        if (isSpace(c)) {
+            body += c;
+            i++;
+        }
+        else if (isNameStart(c)) {
+            size_t end = i + 1;
+            while (end < script.size() &&
+                   (isNameStart(script[end]) || isDigit(script[end])))
+            {
+                end++;
+            }
+            const std::string_view name = script.substr(i, end - i);
+            const bool isKeyword =
+                std::find(Keywords.begin(), Keywords.end(), name) != Keywords.end();
+            previous = isKeyword ? Token::Other : Token::Name;
+            body += name;
+            i = end;
+        }
+        else if ((c == '-' && next == '-') || (c == '[' && (next == '[' || next == '=')))
+        {
+            // Comments and long strings are not supported
+            return std::nullopt;
+        }
+        else if (c == '"' || c == '\'') {
+            if (previous != Token::Other) {
+                return std::nullopt;
+            }
+
+            size_t end = i + 1;
+            while (end < script.size() && script[end] != c) {
+                if (script[end] == '\\' || script[end] == '\n') {
+                    // Escape sequences would have to be resolved
+                    return std::nullopt;
+                }
+                end++;
+            }
+            if (end == script.size()) {
+                return std::nullopt;
+            }
+
+            res.parameters.push_back({
+                .type = Template::Parameter::Type::String,
+                .value = script.substr(i + 1, end - i - 1)
+            });
+            body += std::format("{}{}", ParameterPrefix, res.parameters.size());
+            previous = Token::Literal;
+            i = end + 1;
+        }
+        else if (isDigit(c) || (c == '.' && isDigit(next))) {
+            if (previous == Token::Literal) {
+                return std::nullopt;
+            }
+
+            const size_t end = scanNumber(script, i);
+            if (end == std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            res.parameters.push_back({
+                .type = Template::Parameter::Type::Number,
+                .value = script.substr(i, end - i)
+            });
+            body += std::format("{}{}", ParameterPrefix, res.parameters.size());
+            previous = Token::Literal;
+            i = end;
+        }
+        else if (c == '.') {
+            // The '.', '..', and '...' operators
+            size_t end = i;
+            while (end < script.size() && script[end] == '.') {
+                end++;
+            }
+            body += script.substr(i, end - i);
+            previous = Token::Other;
+            i = end;
+        }
+        else {
+            body += c;
+            const bool isClosing = c == ')' || c == ']' || c == '}';
+            previous = isClosing ? Token::Closing : Token::Other;
+            i++;
+        }
+
+        if (res.parameters.size() > MaxParameters) {
+            return std::nullopt;
+        }
+    }
+
+    if (res.parameters.empty()) {
+        res.text = std::move(body);
+        return res;
+    }
+
+    // The parameters are declared on the same line as the script so that line numbers
+    // in error messages are unchanged
+    res.text = "local ";
+    for (size_t p = 1; p <= res.parameters.size(); p++) {
+        res.text += std::format("{}{}{}", p > 1 ? "," : "", ParameterPrefix, p);
+    }
+    res.text += "=...;";
+    res.text += body;
+    return res;
+}
+
+ScriptCache::ScriptCache(size_t capacity)
+    : _capacity(capacity)
+{}
+
+int ScriptCache::load(lua_State* state, const std::string& script) {
+    ZoneScoped;
+
+    if (_capacity == 0) {
+        compile(state, script, script.c_str());
+        return 0;
+    }
+
+    std::optional<Template> t = createTemplate(script);
+    const std::string& key = t.has_value() ? t->text : script;
+
+    const int top = lua_gettop(state);
+    auto it = _lookup.find(key);
+    if (it != _lookup.end()) {
+        _nHits++;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        lua_rawgeti(state, LUA_REGISTRYINDEX, it->second->reference);
+    }
+    else {
+        _nMisses++;
+        const bool isTemplate = t.has_value() && !t->parameters.empty();
+        const char* name = isTemplate ? TemplateChunkName : script.c_str();
+        const int status = luaL_loadbuffer(state, key.data(), key.size(), name);
+        if (status != LUA_OK) {
+            lua_pop(state, 1);
+            // Compiling the original script results in the correct error message, or
+            // succeeds if the template exceeded one of Lua's limits
+            compile(state, script, script.c_str());
+            return 0;
+        }
+
+        lua_pushvalue(state, -1);
+        const int reference = luaL_ref(state, LUA_REGISTRYINDEX);
+        _entries.push_front({ .key = key, .reference = reference });
+        _lookup[_entries.front().key] = _entries.begin();
+        evict(state, _capacity);
+    }
+
+    if (!t.has_value()) {
+        return 0;
+    }
+
+    for (const Template::Parameter& p : t->parameters) {
+        if (p.type == Template::Parameter::Type::String) {
+            lua_pushlstring(state, p.value.data(), p.value.size());
+        }
+        else if (lua_stringtonumber(state, std::string(p.value).c_str()) == 0) {
+            // The literal is not a valid number, so the script has to be compiled as-is
+            lua_settop(state, top);
+            compile(state, script, script.c_str());
+            return 0;
+        }
+    }
+    return static_cast<int>(t->parameters.size());
+}
+
+void ScriptCache::setCapacity(lua_State* state, size_t capacity) {
+    _capacity = capacity;
+    evict(state, _capacity);
+}
+
+void ScriptCache::clear(lua_State* state) {
+    evict(state, 0);
+}
+
+size_t ScriptCache::nHits() const {
+    return _nHits;
+}
+
+size_t ScriptCache::nMisses() const {
+    return _nMisses;
+}
+
+size_t ScriptCache::size() const {
+    return _entries.size();
+}
+
+void ScriptCache::evict(lua_State* state, size_t capacity) {
+    while (_entries.size() > capacity) {
+        const Entry& entry = _entries.back();
+        luaL_unref(state, LUA_REGISTRYINDEX, entry.reference);
+        _lookup.erase(entry.key);
+        _entries.pop_back();
+    }
+}
+
+} // namespace openspace::scripting
@@ -37,8 +37,10 @@
 #include <ghoul/lua/lua_helper.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/ext/assimp/contrib/zip/src/zip.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include "scriptengine_lua.inl"
 
 namespace {
@@ -46,6 +48,31 @@ namespace {
 
     constexpr int TableOffset = -3; // top-first argument-second argument
 
+    constexpr openspace::properties::Property::PropertyInfo ScriptCacheSizeInfo = {
+        "ScriptCacheSize",
+        "Script Cache Size",
+        "The maximum number of compiled scripts that are kept in the script cache. "
+        "Scripts that only differ in their number and string arguments share a single "
+        "entry. If this value is 0, every script is compiled when it is executed.",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ScriptCacheHitsInfo = {
+        "ScriptCacheHits",
+        "Script Cache Hits",
+        "The number of executed scripts whose compiled version was found in the script "
+        "cache.",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ScriptCacheMissesInfo = {
+        "ScriptCacheMisses",
+        "Script Cache Misses",
+        "The number of executed scripts that had to be compiled as they were not in the "
+        "script cache.",
+        openspace::properties::Property::Visibility::Developer
+    };
+
     struct [[codegen::Dictionary(Documentation)]] Parameters {
         std::string name;
         std::vector<std::vector<std::string>> arguments;
@@ -88,7 +115,24 @@ namespace {
 
 namespace openspace::scripting {
 
-ScriptEngine::ScriptEngine() {}
+ScriptEngine::ScriptEngine()
+    : properties::PropertyOwner({ "ScriptEngine", "Script Engine" })
+    , _scriptCache(256)
+    , _scriptCacheSize(ScriptCacheSizeInfo, 256, 0, 4096)
+    , _scriptCacheHits(ScriptCacheHitsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _scriptCacheMisses(ScriptCacheMissesInfo, 0, 0, std::numeric_limits<int>::max())
+{
+    _scriptCacheSize.onChange([this]() {
+        _scriptCache.setCapacity(_state, static_cast<size_t>(_scriptCacheSize.value()));
+    });
+    addProperty(_scriptCacheSize);
+
+    _scriptCacheHits.setReadOnly(true);
+    addProperty(_scriptCacheHits);
+
+    _scriptCacheMisses.setReadOnly(true);
+    addProperty(_scriptCacheMisses);
+}
 
 void ScriptEngine::initialize() {
     ZoneScoped;
@@ -103,6 +147,7 @@ void ScriptEngine::initialize() {
 void ScriptEngine::deinitialize() {
     ZoneScoped;
 
+    _scriptCache.clear(_state);
     _registeredLibraries.clear();
 }
 
@@ -176,14 +221,11 @@ bool ScriptEngine::runScript(const std::string& script, const ScriptCallback& ca
     }
 
     try {
+        const bool returnValues = static_cast<bool>(callback);
+        ghoul::Dictionary returnValue = executeScript(script, returnValues);
         if (callback) {
-            ghoul::Dictionary returnValue =
-                ghoul::lua::loadArrayDictionaryFromString(script, _state);
             callback(std::move(returnValue));
         }
-        else {
-            ghoul::lua::runScript(_state, script);
-        }
     }
     catch (const ghoul::lua::LuaLoadingException& e) {
         LERRORC(e.component, e.message);
@@ -218,6 +260,45 @@ bool ScriptEngine::runScript(const std::string& script, const ScriptCallback& ca
     return true;
 }
 
+ghoul::Dictionary ScriptEngine::executeScript(const std::string& script,
+                                              bool returnValues)
+{
+    ZoneScoped;
+
+    const int top = lua_gettop(_state);
+    try {
+        const int nParameters = _scriptCache.load(_state, script);
+        const int nResults = returnValues ? LUA_MULTRET : 0;
+        if (lua_pcall(_state, nParameters, nResults, 0) != LUA_OK) {
+            // The chunk might be a cached template that is shared with other scripts,
+            // so the error message has to name the script that was executed
+            const char* message = lua_tostring(_state, -1);
+            throw ghoul::lua::LuaExecutionException(std::format(
+                "{} in script '{}'", message ? message : "Unknown error", script
+            ));
+        }
+
+        ghoul::Dictionary result;
+        if (returnValues) {
+            // Collect all returned values into a table so that they can be converted
+            // into an array dictionary
+            const int nReturned = lua_gettop(_state) - top;
+            lua_createtable(_state, nReturned, 0);
+            lua_insert(_state, top + 1);
+            for (int i = nReturned; i >= 1; i--) {
+                lua_rawseti(_state, top + 1, i);
+            }
+            result = ghoul::lua::luaDictionaryFromState(_state);
+        }
+        lua_settop(_state, top);
+        return result;
+    }
+    catch (...) {
+        lua_settop(_state, top);
+        throw;
+    }
+}
+
 bool ScriptEngine::runScriptFile(const std::filesystem::path& filename) {
     ZoneScoped;
 
@@ -512,8 +593,7 @@ void ScriptEngine::preSync(bool isMaster) {
 void ScriptEngine::encode(SyncBuffer* syncBuffer) {
     ZoneScoped;
 
-    size_t nScripts = _scriptsToSync.size();
-    syncBuffer->encode(nScripts);
+    syncBuffer->encodeVarint(_scriptsToSync.size());
     for (const std::string& s : _scriptsToSync) {
         syncBuffer->encode(s);
     }
@@ -524,8 +604,7 @@ void ScriptEngine::decode(SyncBuffer* syncBuffer) {
     ZoneScoped;
 
     std::lock_guard guard(_clientScriptsMutex);
-    size_t nScripts;
-    syncBuffer->decode(nScripts);
+    const size_t nScripts = static_cast<size_t>(syncBuffer->decodeVarint());
 
     for (size_t i = 0; i < nScripts; ++i) {
         std::string script;
@@ -534,6 +613,12 @@ void ScriptEngine::decode(SyncBuffer* syncBuffer) {
     }
 }
 
+bool ScriptEngine::isDirty() const {
+    // Scripts are only sent once, so there is nothing to synchronize if no new scripts
+    // have been queued since the last frame
+    return !_scriptsToSync.empty();
+}
+
 void ScriptEngine::postSync(bool isMaster) {
     ZoneScoped;
 
@@ -563,6 +648,13 @@ void ScriptEngine::postSync(bool isMaster) {
             }
         }
     }
+
+    _scriptCacheHits = static_cast<int>(
+        std::min<size_t>(_scriptCache.nHits(), std::numeric_limits<int>::max())
+    );
+    _scriptCacheMisses = static_cast<int>(
+        std::min<size_t>(_scriptCache.nMisses(), std::numeric_limits<int>::max())
+    );
 }
 
 void ScriptEngine::queueScript(std::string script,
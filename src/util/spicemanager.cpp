@@ -45,6 +45,10 @@ namespace {
     // as the maximum message length
     constexpr unsigned SpiceErrorBufferSize = 1841;
 
+    // SPICE keeps its kernel pool and error state in global variables, so all calls have
+    // to be serialized. The mutex is recursive as the functions call each other
+    std::recursive_mutex SpiceMutex;
+
     const char* toString(openspace::SpiceManager::FieldOfViewMethod m) {
         using SM = openspace::SpiceManager;
         switch (m) {
@@ -199,6 +203,10 @@ SpiceManager& SpiceManager::ref() {
     return *_instance;
 }
 
+std::recursive_mutex& SpiceManager::mutex() {
+    return SpiceMutex;
+}
+
 // This method checks if one of the previous SPICE methods has failed. If it has, an
 // exception with the SPICE error message is thrown
 // If an error occurred, true is returned, otherwise, false
@@ -216,6 +224,7 @@ void throwSpiceError(const std::string& errorMessage) {
 }
 
 SpiceManager::KernelHandle SpiceManager::loadKernel(std::filesystem::path filePath) {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!filePath.empty(), "Empty file path");
     ghoul_assert(
         std::filesystem::is_regular_file(filePath),
@@ -276,6 +285,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::filesystem::path filePa
             findSpkCoverage(filePath); // spk kernel
     }
 
+    _kernelGeneration++;
     const KernelHandle kernelId = ++_lastAssignedKernel;
     ghoul_assert(kernelId != 0, "Kernel Handle wrapped around to 0");
     _loadedKernels.push_back({ std::move(filePath), kernelId, 1 });
@@ -283,6 +293,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::filesystem::path filePa
 }
 
 void SpiceManager::unloadKernel(KernelHandle kernelId) {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
@@ -300,6 +311,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             const std::string p = it->path.string();
             unload_c(p.c_str());
             _loadedKernels.erase(it);
+            _kernelGeneration++;
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -310,6 +322,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 }
 
 void SpiceManager::unloadKernel(std::filesystem::path filePath) {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!filePath.empty(), "Empty filename");
 
     const auto it = std::find_if(
@@ -335,6 +348,7 @@ void SpiceManager::unloadKernel(std::filesystem::path filePath) {
             const std::string p = filePath.string();
             unload_c(p.c_str());
             _loadedKernels.erase(it);
+            _kernelGeneration++;
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -345,6 +359,7 @@ void SpiceManager::unloadKernel(std::filesystem::path filePath) {
 }
 
 std::vector<std::filesystem::path> SpiceManager::loadedKernels() const {
+    const std::lock_guard lock(SpiceMutex);
     std::vector<std::filesystem::path> res;
     res.reserve(_loadedKernels.size());
     for (const KernelInformation& info : _loadedKernels) {
@@ -353,7 +368,13 @@ std::vector<std::filesystem::path> SpiceManager::loadedKernels() const {
     return res;
 }
 
+uint64_t SpiceManager::kernelGeneration() const {
+    const std::lock_guard lock(SpiceMutex);
+    return _kernelGeneration;
+}
+
 bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
@@ -377,6 +398,7 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
 std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
                                                           const std::string& target) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
@@ -392,6 +414,7 @@ std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
 
 
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!frame.empty(), "Empty target");
 
     const int id = frameId(frame);
@@ -410,6 +433,7 @@ bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
 std::vector<std::pair<double, double>> SpiceManager::ckCoverage(
                                                           const std::string& target) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     int id = naifId(target);
@@ -433,6 +457,7 @@ std::vector<std::pair<double, double>> SpiceManager::ckCoverage(
 std::vector<std::pair<int, std::string>> SpiceManager::spiceBodies(
                                                                  bool builtInFrames) const
 {
+    const std::lock_guard lock(SpiceMutex);
     std::vector<std::pair<int, std::string>> bodies;
 
     static std::array<SpiceInt, SPICE_CELL_CTRLSZ + 8192> idsetBuffer;
@@ -485,10 +510,12 @@ std::vector<std::pair<int, std::string>> SpiceManager::spiceBodies(
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    const std::lock_guard lock(SpiceMutex);
     return bodfnd_c(naifId, item.c_str());
 }
 
 bool SpiceManager::hasValue(const std::string& body, const std::string& item) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!body.empty(), "Empty body");
     ghoul_assert(!item.empty(), "Empty item");
 
@@ -497,6 +524,7 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 }
 
 int SpiceManager::naifId(const std::string& body) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!body.empty(), "Empty body");
 
     SpiceBoolean success = SPICEFALSE;
@@ -509,6 +537,7 @@ int SpiceManager::naifId(const std::string& body) const {
 }
 
 bool SpiceManager::hasNaifId(const std::string& body) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!body.empty(), "Empty body");
 
     SpiceBoolean success = SPICEFALSE;
@@ -519,6 +548,7 @@ bool SpiceManager::hasNaifId(const std::string& body) const {
 }
 
 int SpiceManager::frameId(const std::string& frame) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!frame.empty(), "Empty frame");
 
     SpiceInt id = 0;
@@ -530,6 +560,7 @@ int SpiceManager::frameId(const std::string& frame) const {
 }
 
 bool SpiceManager::hasFrameId(const std::string& frame) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!frame.empty(), "Empty frame");
 
     SpiceInt id = 0;
@@ -557,30 +588,35 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    const std::lock_guard lock(SpiceMutex);
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    const std::lock_guard lock(SpiceMutex);
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    const std::lock_guard lock(SpiceMutex);
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    const std::lock_guard lock(SpiceMutex);
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             std::vector<double>& v) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
@@ -589,6 +625,7 @@ void SpiceManager::getValue(const std::string& body, const std::string& value,
 double SpiceManager::spacecraftClockToET(const std::string& craft,
                                          double craftTicks) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!craft.empty(), "Empty craft");
 
     const int craftId = naifId(craft);
@@ -603,12 +640,14 @@ double SpiceManager::spacecraftClockToET(const std::string& craft,
 }
 
 double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!timeString.empty(), "Empty timeString");
 
     return ephemerisTimeFromDate(timeString.c_str());
 }
 
 double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
+    const std::lock_guard lock(SpiceMutex);
     double et = 0.0;
     str2et_c(timeString, &et);
     if (failed_c()) {
@@ -619,6 +658,7 @@ double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
 
 std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime, const char* format)
 {
+    const std::lock_guard lock(SpiceMutex);
     constexpr int BufferSize = 128;
     std::array<char, BufferSize> Buffer;
     std::memset(Buffer.data(), char(0), BufferSize);
@@ -646,6 +686,7 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         AberrationCorrection aberrationCorrection,
                                         double ephemerisTime, double& lightTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Target is not empty");
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
@@ -716,6 +757,7 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         AberrationCorrection aberrationCorrection,
                                         double ephemerisTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     double unused = 0.0;
     return targetPosition(
         target,
@@ -731,6 +773,7 @@ glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
                                                    const std::string& to,
                                                    double ephemerisTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
@@ -765,6 +808,7 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
                                                                      double ephemerisTime,
                                                   const glm::dvec3& directionVector) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -811,6 +855,7 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
                                          AberrationCorrection aberrationCorrection,
                                          double& ephemerisTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -845,6 +890,7 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
                                                 AberrationCorrection aberrationCorrection,
                                                                double ephemerisTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
@@ -882,6 +928,7 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
                                                       const std::string& destinationFrame,
                                                                double ephemerisTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
@@ -906,6 +953,7 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  const std::string& destinationFrame,
                                                  double ephemerisTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -938,6 +986,7 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  double ephemerisTimeFrom,
                                                  double ephemerisTimeTo) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -968,6 +1017,7 @@ SpiceManager::fieldOfView(const std::string& instrument) const
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    const std::lock_guard lock(SpiceMutex);
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -1023,6 +1073,7 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
                                                                      double ephemerisTime,
                                                              int numberOfTerminatorPoints)
 {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!frame.empty(), "Frame must not be empty");
@@ -1058,6 +1109,7 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
 }
 
 void SpiceManager::findCkCoverage(const std::filesystem::path& path) {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!path.empty(), "Empty file path");
     ghoul_assert(
         std::filesystem::is_regular_file(path),
@@ -1119,6 +1171,7 @@ void SpiceManager::findCkCoverage(const std::filesystem::path& path) {
 }
 
 void SpiceManager::findSpkCoverage(const std::filesystem::path &path) {
+    const std::lock_guard lock(SpiceMutex);
     ghoul_assert(!path.empty(), "Empty file path");
     ghoul_assert(
         std::filesystem::is_regular_file(path),
@@ -1187,6 +1240,7 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
                                               double ephemerisTime,
                                               double& lightTime) const
 {
+    const std::lock_guard lock(SpiceMutex);
     ZoneScoped;
 
     ghoul_assert(!target.empty(), "Target must not be empty");
@@ -1299,6 +1353,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
                                                      const std::string& toFrame,
                                                      double time) const
 {
+    const std::lock_guard lock(SpiceMutex);
     glm::dmat3 result = glm::dmat3(1.0);
     const int idFrame = frameId(fromFrame);
 
@@ -1388,6 +1443,7 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
 }
 
 void SpiceManager::loadLeapSecondsSpiceKernel() {
+    const std::lock_guard lock(SpiceMutex);
     constexpr std::string_view Naif00012tlsSource = R"(
 KPL/LSK
 
@@ -1553,6 +1609,7 @@ const std::filesystem::path path = std::filesystem::temp_directory_path();
 }
 
 void SpiceManager::loadGeophysicalConstantsKernel() {
+    const std::lock_guard lock(SpiceMutex);
     constexpr std::string_view GeoPhysicalConstantsKernelSource = R"(
 KPL/PCK
 
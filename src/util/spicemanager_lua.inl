@@ -145,6 +145,8 @@ namespace {
                                          std::filesystem::path spk,
                                          int elementToExtract = 0)
 {
+    const std::lock_guard lock(SpiceMutex);
+
     // Code adopted from
     // https://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/getelm_c.html
     SpiceInt n = 0;
@@ -24,7 +24,9 @@
 
 #include <openspace/util/syncbuffer.h>
 
+#include <ghoul/misc/assert.h>
 #include <ghoul/misc/profiling.h>
+#include <cstring>
 
 namespace openspace {
 
@@ -37,42 +39,59 @@ SyncBuffer::SyncBuffer(size_t n)
 void SyncBuffer::encode(const std::string& s) {
     ZoneScoped;
 
-    const int32_t anticpatedBufferSize = static_cast<int32_t>(
-        _encodeOffset + (sizeof(char) * s.size()) + sizeof(int32_t)
-    );
-    if (anticpatedBufferSize >= static_cast<int32_t>(_n)) {
-        _dataStream.resize(anticpatedBufferSize);
+    encodeVarint(s.size());
+
+    const size_t anticipatedBufferSize = _encodeOffset + s.size();
+    if (anticipatedBufferSize > _dataStream.size()) {
+        _dataStream.resize(anticipatedBufferSize);
+    }
+    std::memcpy(_dataStream.data() + _encodeOffset, s.data(), s.size());
+    _encodeOffset += s.size();
+}
+
+void SyncBuffer::encodeVarint(uint64_t value) {
+    // A 64 bit value requires at most 10 bytes with 7 bits of payload each
+    constexpr size_t MaxVarintSize = 10;
+    if (_encodeOffset + MaxVarintSize > _dataStream.size()) {
+        _dataStream.resize(_encodeOffset + MaxVarintSize);
     }
 
-    int32_t length = static_cast<int32_t>(s.size() * sizeof(char));
-    memcpy(
-        _dataStream.data() + _encodeOffset,
-        reinterpret_cast<const char*>(&length),
-        sizeof(int32_t)
-    );
-    _encodeOffset += sizeof(int32_t);
-    memcpy(_dataStream.data() + _encodeOffset, s.c_str(), length);
-    _encodeOffset += length;
+    while (value >= 0x80) {
+        _dataStream[_encodeOffset] = static_cast<std::byte>((value & 0x7F) | 0x80);
+        _encodeOffset++;
+        value >>= 7;
+    }
+    _dataStream[_encodeOffset] = static_cast<std::byte>(value);
+    _encodeOffset++;
 }
 
 std::string SyncBuffer::decode() {
     ZoneScoped;
 
-    int32_t length = 0;
-    std::memcpy(
-        reinterpret_cast<char*>(&length),
-        _dataStream.data() + _decodeOffset,
-        sizeof(int32_t)
+    const size_t length = static_cast<size_t>(decodeVarint());
+    ghoul_assert(_decodeOffset + length <= _dataStream.size(), "Reading past the end");
+    std::string ret = std::string(
+        reinterpret_cast<const char*>(_dataStream.data() + _decodeOffset),
+        length
     );
-    std::vector<char> tmp(length + 1);
-    _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
     _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
     return ret;
 }
 
+uint64_t SyncBuffer::decodeVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        ghoul_assert(_decodeOffset < _dataStream.size(), "Reading past the end");
+        const uint8_t byte = static_cast<uint8_t>(_dataStream[_decodeOffset]);
+        _decodeOffset++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
 void SyncBuffer::decode(std::string& s) {
     s = decode();
 }
@@ -115,6 +134,10 @@ std::vector<std::byte> SyncBuffer::data() {
     return _dataStream;
 }
 
+size_t SyncBuffer::encodedSize() const {
+    return _encodeOffset;
+}
+
 void SyncBuffer::reset() {
     _dataStream.resize(_n);
     _encodeOffset = 0;
@@ -0,0 +1,405 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/taskscheduler.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <utility>
+
+namespace {
+    constexpr std::string_view _loggerCat = "TaskScheduler";
+
+    // The scheduler and worker index that the current thread belongs to, if any
+    thread_local const openspace::TaskScheduler* CurrentScheduler = nullptr;
+    thread_local size_t CurrentWorkerIndex = 0;
+} // namespace
+
+namespace openspace {
+
+TaskScheduler::TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : _scheduler(scheduler)
+    , _state(std::make_shared<State>())
+{}
+
+TaskScheduler::TaskGroup::~TaskGroup() {
+    waitForTasks();
+}
+
+void TaskScheduler::TaskGroup::run(std::function<void()> task, Priority priority) {
+    _state->nPending++;
+    _scheduler.submit(new Task{ std::move(task), _state, priority });
+}
+
+void TaskScheduler::TaskGroup::wait() {
+    waitForTasks();
+
+    std::exception_ptr exception;
+    {
+        const std::lock_guard lock(_state->exceptionMutex);
+        exception = std::exchange(_state->exception, nullptr);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskScheduler::TaskGroup::waitForTasks() {
+    ZoneScoped;
+
+    const size_t worker = _scheduler.currentWorker();
+    while (true) {
+        const uint32_t nPending = _state->nPending.load();
+        if (nPending == 0) {
+            return;
+        }
+
+        // Help out with executing the tasks of this group instead of blocking. Tasks of
+        // other groups are left alone as they might take much longer than this group's.
+        // If there is nothing to do, the remaining tasks of the group are currently
+        // being executed by other threads
+        if (!_scheduler.runGroupTask(worker, *_state)) {
+            _state->nPending.wait(nPending);
+        }
+    }
+}
+
+TaskScheduler::TaskScheduler(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    _workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // Only start the threads after all workers exist as they steal from each other
+    for (size_t i = 0; i < numThreads; i++) {
+        _workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    _stop = true;
+    wakeWorkers(true);
+    for (const std::unique_ptr<Worker>& w : _workers) {
+        w->thread.join();
+    }
+    clearTasks();
+}
+
+void TaskScheduler::enqueue(std::function<void()> task, Priority priority) {
+    submit(new Task{ std::move(task), nullptr, priority });
+}
+
+void TaskScheduler::clearTasks() {
+    std::vector<Task*> tasks;
+    for (const std::unique_ptr<Worker>& w : _workers) {
+        const std::lock_guard lock(w->mutex);
+        for (std::deque<Task*>& queue : w->tasks) {
+            tasks.insert(tasks.end(), queue.begin(), queue.end());
+            queue.clear();
+        }
+    }
+    Task* submitted = _submitted.exchange(nullptr, std::memory_order_acquire);
+    while (submitted) {
+        tasks.push_back(submitted);
+        submitted = submitted->next;
+    }
+
+    for (Task* task : tasks) {
+        _nOutstanding--;
+        finishTask(task);
+    }
+}
+
+bool TaskScheduler::hasOutstandingTasks() const {
+    return _nOutstanding > 0;
+}
+
+size_t TaskScheduler::numThreads() const {
+    return _workers.size();
+}
+
+void TaskScheduler::submit(Task* task) {
+    _nOutstanding++;
+
+    const size_t worker = currentWorker();
+    if (worker != NoWorker) {
+        // Tasks created by a task go into the local queue of the worker to keep the data
+        // they operate on in the same cache
+        Worker& w = *_workers[worker];
+        const std::lock_guard lock(w.mutex);
+        w.tasks[static_cast<size_t>(task->priority)].push_back(task);
+    }
+    else {
+        Task* head = _submitted.load(std::memory_order_relaxed);
+        do {
+            task->next = head;
+        } while (!_submitted.compare_exchange_weak(
+            head,
+            task,
+            std::memory_order_release,
+            std::memory_order_relaxed
+        ));
+    }
+
+    wakeWorkers(false);
+}
+
+void TaskScheduler::wakeWorkers(bool all) {
+    _wakeEpoch.fetch_add(1, std::memory_order_release);
+    if (all) {
+        _wakeEpoch.notify_all();
+    }
+    else {
+        _wakeEpoch.notify_one();
+    }
+}
+
+bool TaskScheduler::runOneTask(size_t worker) {
+    Task* task = nullptr;
+    if (worker != NoWorker) {
+        task = popLocal(worker);
+    }
+    if (!task) {
+        task = popSubmitted(worker);
+    }
+    if (!task) {
+        task = steal(worker);
+    }
+
+    if (task) {
+        runTask(task);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+bool TaskScheduler::runGroupTask(size_t worker, const TaskGroup::State& group) {
+    Task* task = popGroupTask(worker, group);
+    if (task) {
+        runTask(task);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+void TaskScheduler::runTask(Task* task) {
+    _nOutstanding--;
+    try {
+        task->function();
+    }
+    catch (...) {
+        if (task->group) {
+            // The thread waiting for the group decides what to do with the exception
+            const std::lock_guard lock(task->group->exceptionMutex);
+            if (!task->group->exception) {
+                task->group->exception = std::current_exception();
+            }
+        }
+        else {
+            try {
+                throw;
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.message);
+            }
+            catch (const std::exception& e) {
+                LERROR(e.what());
+            }
+            catch (...) {
+                LERROR("Unknown exception in task");
+            }
+        }
+    }
+    finishTask(task);
+}
+
+void TaskScheduler::finishTask(Task* task) {
+    std::shared_ptr<TaskGroup::State> group = std::move(task->group);
+    delete task;
+
+    if (group && group->nPending.fetch_sub(1) == 1) {
+        group->nPending.notify_all();
+    }
+}
+
+TaskScheduler::Task* TaskScheduler::popLocal(size_t worker) {
+    Worker& w = *_workers[worker];
+    const std::lock_guard lock(w.mutex);
+    for (std::deque<Task*>& queue : w.tasks) {
+        if (!queue.empty()) {
+            Task* task = queue.back();
+            queue.pop_back();
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+TaskScheduler::Task* TaskScheduler::popSubmitted(size_t worker) {
+    Task* list = takeSubmitted();
+    if (!list) {
+        return nullptr;
+    }
+
+    // Select the highest priority task to run and distribute the rest to the worker
+    // queues so that they can be stolen by the other workers
+    Task* best = list;
+    for (Task* t = list->next; t; t = t->next) {
+        if (t->priority < best->priority) {
+            best = t;
+        }
+    }
+    distribute(list, best, worker);
+    return best;
+}
+
+TaskScheduler::Task* TaskScheduler::popGroupTask(size_t worker,
+                                                 const TaskGroup::State& group)
+{
+    // The submission list can only be taken as a whole, so its tasks are moved into the
+    // worker queues first where the tasks of the group can be picked out individually
+    if (Task* list = takeSubmitted()) {
+        distribute(list, nullptr, worker);
+    }
+
+    const size_t n = _workers.size();
+    const size_t start = worker != NoWorker ? worker : 0;
+    for (size_t priority = 0; priority < NPriorities; priority++) {
+        for (size_t i = 0; i < n; i++) {
+            Worker& w = *_workers[(start + i) % n];
+            const std::lock_guard lock(w.mutex);
+            std::deque<Task*>& queue = w.tasks[priority];
+            const auto it = std::find_if(
+                queue.begin(),
+                queue.end(),
+                [&group](const Task* task) { return task->group.get() == &group; }
+            );
+            if (it != queue.end()) {
+                Task* task = *it;
+                queue.erase(it);
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+TaskScheduler::Task* TaskScheduler::takeSubmitted() {
+    if (!_submitted.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    // Take the entire list at once, which avoids the ABA problem of popping individual
+    // nodes. The list is in reverse submission order, so we restore the order here
+    Task* list = _submitted.exchange(nullptr, std::memory_order_acquire);
+    Task* reversed = nullptr;
+    while (list) {
+        Task* next = list->next;
+        list->next = reversed;
+        reversed = list;
+        list = next;
+    }
+    return reversed;
+}
+
+void TaskScheduler::distribute(Task* list, const Task* skip, size_t worker) {
+    // A worker keeps the tasks in its own queue, while a thread outside of the scheduler
+    // spreads them over all workers
+    bool hasRemaining = false;
+    Task* t = list;
+    while (t) {
+        Task* next = t->next;
+        t->next = nullptr;
+        if (t != skip) {
+            const size_t target =
+                worker != NoWorker ? worker : _nextWorker++ % _workers.size();
+            Worker& w = *_workers[target];
+            const std::lock_guard lock(w.mutex);
+            // Pushing to the front means that the owner will execute the tasks in
+            // submission order, while thieves take them from the back
+            w.tasks[static_cast<size_t>(t->priority)].push_front(t);
+            hasRemaining = true;
+        }
+        t = next;
+    }
+    if (hasRemaining) {
+        wakeWorkers(true);
+    }
+}
+
+TaskScheduler::Task* TaskScheduler::steal(size_t thief) {
+    const size_t n = _workers.size();
+    const size_t start = thief != NoWorker ? thief + 1 : 0;
+    for (size_t priority = 0; priority < NPriorities; priority++) {
+        for (size_t i = 0; i < n; i++) {
+            const size_t victim = (start + i) % n;
+            if (victim == thief) {
+                continue;
+            }
+
+            Worker& w = *_workers[victim];
+            const std::lock_guard lock(w.mutex);
+            std::deque<Task*>& queue = w.tasks[priority];
+            if (!queue.empty()) {
+                Task* task = queue.front();
+                queue.pop_front();
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void TaskScheduler::workerLoop(size_t worker) {
+    CurrentScheduler = this;
+    CurrentWorkerIndex = worker;
+
+    while (!_stop) {
+        // Read the epoch before looking for work so that a task that is submitted after
+        // we failed to find one is guaranteed to wake us up again
+        const uint32_t epoch = _wakeEpoch.load(std::memory_order_acquire);
+        if (runOneTask(worker)) {
+            continue;
+        }
+        if (_stop) {
+            return;
+        }
+        _wakeEpoch.wait(epoch, std::memory_order_acquire);
+    }
+}
+
+size_t TaskScheduler::currentWorker() const {
+    return CurrentScheduler == this ? CurrentWorkerIndex : NoWorker;
+}
+
+} // namespace openspace
@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/properties/propertyindex.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <ghoul/misc/exception.h>
+
+namespace {
+    using namespace openspace::properties;
+
+    struct Tree {
+        Tree() {
+            root.addPropertySubOwner(scene);
+            scene.addPropertySubOwner(earth);
+            scene.addPropertySubOwner(moon);
+            earth.addPropertySubOwner(earthRenderable);
+            moon.addPropertySubOwner(moonRenderable);
+            earth.addTag("planet");
+            earthRenderable.addProperty(earthOpacity);
+            moonRenderable.addProperty(moonOpacity);
+            moonRenderable.addProperty(moonFade);
+        }
+
+        FloatProperty earthOpacity = FloatProperty({ "Opacity", "Opacity", "" });
+        FloatProperty moonOpacity = FloatProperty({ "Opacity", "Opacity", "" });
+        FloatProperty moonFade = FloatProperty({ "Fade", "Fade", "" });
+
+        PropertyOwner root = PropertyOwner({ "" });
+        PropertyOwner scene = PropertyOwner({ "Scene" });
+        PropertyOwner earth = PropertyOwner({ "Earth" });
+        PropertyOwner moon = PropertyOwner({ "Moon" });
+        PropertyOwner earthRenderable = PropertyOwner({ "Renderable" });
+        PropertyOwner moonRenderable = PropertyOwner({ "Renderable" });
+    };
+} // namespace
+
+TEST_CASE("PropertyIndex: Literal", "[propertyindex]") {
+    Tree t;
+    PropertyIndex index;
+
+    CHECK(index.property(t.root, "Scene.Earth.Renderable.Opacity") == &t.earthOpacity);
+    CHECK(index.property(t.root, "Scene.Moon.Renderable.Fade") == &t.moonFade);
+    CHECK(index.property(t.root, "Scene.Mars.Renderable.Fade") == nullptr);
+
+    const std::vector<Property*> m =
+        index.matchingProperties(t.root, "Scene.Moon.Renderable.Opacity", "");
+    REQUIRE(m.size() == 1);
+    CHECK(m[0] == &t.moonOpacity);
+}
+
+TEST_CASE("PropertyIndex: Wildcard", "[propertyindex]") {
+    Tree t;
+    PropertyIndex index;
+
+    const std::vector<Property*> opacity =
+        index.matchingProperties(t.root, "Scene.*.Renderable.Opacity", "");
+    REQUIRE(opacity.size() == 2);
+    CHECK(opacity[0] == &t.earthOpacity);
+    CHECK(opacity[1] == &t.moonOpacity);
+
+    const std::vector<Property*> moon =
+        index.matchingProperties(t.root, "Scene.Moon*", "");
+    REQUIRE(moon.size() == 2);
+    CHECK(moon[0] == &t.moonOpacity);
+    CHECK(moon[1] == &t.moonFade);
+
+    CHECK_THROWS_AS(
+        index.matchingProperties(t.root, "*", ""),
+        ghoul::RuntimeError
+    );
+    CHECK_THROWS_AS(
+        index.matchingProperties(t.root, "Scene.*.Renderable.*", ""),
+        ghoul::RuntimeError
+    );
+}
+
+TEST_CASE("PropertyIndex: Tag", "[propertyindex]") {
+    Tree t;
+    PropertyIndex index;
+
+    const std::vector<Property*> m =
+        index.matchingProperties(t.root, ".Renderable.Opacity", "planet");
+    REQUIRE(m.size() == 1);
+    CHECK(m[0] == &t.earthOpacity);
+
+    const std::vector<PropertyOwner*>& owners = index.ownersWithTag(t.root, "planet");
+    REQUIRE(owners.size() == 1);
+    CHECK(owners[0] == &t.earth);
+
+    CHECK(index.matchingProperties(t.root, ".Renderable.Opacity", "moon").empty());
+}
+
+TEST_CASE("PropertyIndex: Invalidation", "[propertyindex]") {
+    Tree t;
+    PropertyIndex index;
+
+    CHECK(index.matchingProperties(t.root, "Scene.*.Renderable.Opacity", "").size() == 2);
+
+    t.moonRenderable.removeProperty(t.moonOpacity);
+    const std::vector<Property*> removed =
+        index.matchingProperties(t.root, "Scene.*.Renderable.Opacity", "");
+    REQUIRE(removed.size() == 1);
+    CHECK(removed[0] == &t.earthOpacity);
+
+    t.moon.addTag("planet");
+    CHECK(index.matchingProperties(t.root, ".Renderable.Fade", "planet").size() == 1);
+}
@@ -0,0 +1,246 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/chebyshevephemeris.h>
+#include <ghoul/misc/exception.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <thread>
+
+namespace {
+    constexpr double Radius = 1.5e11;
+    constexpr double Period = 365.25 * 86400.0;
+
+    void circularOrbit(double time, std::span<double> values) {
+        const double angle = 2.0 * std::numbers::pi * time / Period;
+        values[0] = Radius * std::cos(angle);
+        values[1] = Radius * std::sin(angle);
+        values[2] = 0.0;
+    }
+
+    double distanceToOrbit(const openspace::ChebyshevEphemeris& ephemeris, double time) {
+        std::array<double, 3> approx = {};
+        if (!ephemeris.evaluate(time, approx)) {
+            return -1.0;
+        }
+        std::array<double, 3> exact = {};
+        circularOrbit(time, exact);
+        return std::hypot(
+            approx[0] - exact[0],
+            approx[1] - exact[1],
+            approx[2] - exact[2]
+        );
+    }
+} // namespace
+
+TEST_CASE("ChebyshevEphemeris: Accuracy", "[chebyshevephemeris]") {
+    using namespace openspace;
+
+    const ChebyshevEphemeris::FitSettings settings = {
+        .start = 0.0,
+        .end = Period,
+        .degree = 4,
+        .accuracy = 1.0,
+        .segmentLength = 30.0 * 86400.0
+    };
+    const ChebyshevEphemeris ephemeris =
+        ChebyshevEphemeris::fit(3, settings, circularOrbit);
+
+    CHECK(ephemeris.nComponents() == 3);
+    // A month is too long for a single segment of that low degree at this accuracy
+    CHECK(ephemeris.nSegments() > 13);
+
+    for (int i = 0; i <= 10000; i++) {
+        const double time = Period * i / 10000.0;
+        const double error = distanceToOrbit(ephemeris, time);
+        REQUIRE(error >= 0.0);
+        CHECK(error <= settings.accuracy);
+    }
+
+    CHECK_FALSE(ephemeris.covers(-1.0));
+    CHECK_FALSE(ephemeris.covers(Period + 1.0));
+}
+
+TEST_CASE("ChebyshevEphemeris: Flyby", "[chebyshevephemeris]") {
+    using namespace openspace;
+
+    // A straight flyby at a distance of 10000 km with the closest approach at noon
+    auto flyby = [](double time, std::span<double> values) {
+        const double d = (time - 43200.0) / 600.0;
+        values[0] = 1e7 * d / std::sqrt(1.0 + d * d);
+        values[1] = 1e7 / std::sqrt(1.0 + d * d);
+        values[2] = 0.0;
+    };
+
+    const ChebyshevEphemeris::FitSettings settings = {
+        .start = 0.0,
+        .end = 86400.0,
+        .degree = 8,
+        .accuracy = 1.0,
+        .minimumSegmentLength = 1.0
+    };
+    const ChebyshevEphemeris ephemeris = ChebyshevEphemeris::fit(3, settings, flyby);
+
+    // The segments around the closest approach have to be subdivided
+    CHECK(ephemeris.nSegments() > 1);
+
+    for (int i = 0; i <= 100000; i++) {
+        const double time = settings.end * i / 100000.0;
+        std::array<double, 3> approx = {};
+        REQUIRE(ephemeris.evaluate(time, approx));
+        std::array<double, 3> exact = {};
+        flyby(time, exact);
+        const double error = std::hypot(
+            approx[0] - exact[0],
+            approx[1] - exact[1],
+            approx[2] - exact[2]
+        );
+        CHECK(error <= settings.accuracy);
+    }
+}
+
+TEST_CASE("ChebyshevEphemeris: Gaps", "[chebyshevephemeris]") {
+    using namespace openspace;
+
+    // The function is not available in the second of ten days
+    auto function = [](double time, std::span<double> values) {
+        if (time > 86400.0 && time < 2.0 * 86400.0) {
+            throw ghoul::RuntimeError("No coverage");
+        }
+        circularOrbit(time, values);
+    };
+
+    const ChebyshevEphemeris::FitSettings settings = {
+        .start = 0.0,
+        .end = 10.0 * 86400.0,
+        .accuracy = 1.0,
+        .segmentLength = 86400.0 / 2.0
+    };
+    const ChebyshevEphemeris ephemeris = ChebyshevEphemeris::fit(3, settings, function);
+
+    CHECK(ephemeris.covers(0.5 * 86400.0));
+    CHECK_FALSE(ephemeris.covers(1.5 * 86400.0));
+    CHECK(ephemeris.covers(2.5 * 86400.0));
+
+    std::array<double, 3> values = { 1.0, 2.0, 3.0 };
+    CHECK_FALSE(ephemeris.evaluate(1.5 * 86400.0, values));
+    CHECK(values[0] == 1.0);
+    CHECK(values[1] == 2.0);
+    CHECK(values[2] == 3.0);
+    CHECK(distanceToOrbit(ephemeris, 5.0 * 86400.0) <= settings.accuracy);
+}
+
+TEST_CASE("ChebyshevEphemeris: Save and Load", "[chebyshevephemeris]") {
+    using namespace openspace;
+
+    const ChebyshevEphemeris::FitSettings settings = {
+        .start = 0.0,
+        .end = 90.0 * 86400.0,
+        .accuracy = 10.0
+    };
+    const ChebyshevEphemeris ephemeris =
+        ChebyshevEphemeris::fit(3, settings, circularOrbit);
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_chebyshevephemeris.bin";
+    ephemeris.save(file);
+
+    std::optional<ChebyshevEphemeris> loaded = ChebyshevEphemeris::load(file);
+    REQUIRE(loaded.has_value());
+    CHECK(loaded->nComponents() == ephemeris.nComponents());
+    CHECK(loaded->nSegments() == ephemeris.nSegments());
+    for (int i = 0; i < 100; i++) {
+        const double time = settings.end * i / 100.0;
+        std::array<double, 3> a = {};
+        std::array<double, 3> b = {};
+        CHECK(ephemeris.evaluate(time, a));
+        CHECK(loaded->evaluate(time, b));
+        CHECK(a == b);
+    }
+
+    // A truncated file must be rejected
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 8);
+    CHECK_FALSE(ChebyshevEphemeris::load(file).has_value());
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("ChebyshevEphemeris: Background", "[chebyshevephemeris]") {
+    using namespace openspace;
+
+    const ChebyshevEphemeris::FitSettings settings = {
+        .start = 0.0,
+        .end = 30.0 * 86400.0,
+        .accuracy = 1.0
+    };
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_chebyshevephemeris_bg.bin";
+    std::filesystem::remove(file);
+
+    BackgroundEphemeris background;
+    CHECK(background.isIdle());
+    CHECK(background.ephemeris() == nullptr);
+
+    background.start("Orbit", file, 3, settings, circularOrbit);
+    CHECK_FALSE(background.isIdle());
+    while (!background.ephemeris()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        background.update();
+    }
+    CHECK(distanceToOrbit(*background.ephemeris(), 10.0 * 86400.0) <= 1.0);
+    CHECK(std::filesystem::is_regular_file(file));
+    std::filesystem::remove(file);
+
+    background.reset();
+    CHECK(background.isIdle());
+    CHECK(background.ephemeris() == nullptr);
+
+    // Resetting cancels a fit that is still running, which is then not stored
+    std::atomic_int nSamples = 0;
+    background.start(
+        "Slow Orbit",
+        file,
+        3,
+        settings,
+        [&nSamples](double time, std::span<double> values) {
+            nSamples++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            circularOrbit(time, values);
+        }
+    );
+    while (nSamples == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    background.reset();
+    CHECK(background.isIdle());
+    CHECK_FALSE(std::filesystem::exists(file));
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/data/csvloader.h>
+#include <openspace/data/dataloader.h>
+#include <openspace/data/speckloader.h>
+#include <ghoul/misc/exception.h>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    // More rows than fit into a single conversion chunk so that the rows are converted
+    // in parallel
+    constexpr int NumLargeRows = 50000;
+
+    std::filesystem::path writeCsvFile(std::string_view name, int nRows,
+                                       std::string_view lastRow = "")
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+        std::ofstream file(path);
+        file << "x,y,z,value\n";
+        for (int i = 0; i < nRows; i++) {
+            file << std::format("{},{},{},{}\n", i, 2 * i, -i, 0.5 * i);
+        }
+        if (!lastRow.empty()) {
+            file << lastRow << '\n';
+        }
+        return path;
+    }
+
+    std::filesystem::path writeSpeckFile(std::string_view name, int nRows,
+                                         std::string_view lastRow = "")
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+        std::ofstream file(path);
+        file << "datavar 0 value\n";
+        // Rows that only contain zeros are skipped, so the first row starts at 1
+        for (int i = 1; i <= nRows; i++) {
+            file << std::format("{} {} {} {} # Star {}\n", i, 2 * i, -i, 0.5 * i, i);
+        }
+        if (!lastRow.empty()) {
+            file << lastRow << '\n';
+        }
+        return path;
+    }
+} // namespace
+
+TEST_CASE("Dataset: Append And Remove", "[dataloaders]") {
+    using namespace openspace::dataloader;
+
+    Dataset first;
+    const std::array<float, 2> a = { 1.f, 2.f };
+    first.addEntry(glm::vec3(1.f), a);
+    first.addEntry(glm::vec3(2.f), a);
+
+    // The comments of the second dataset have to be shifted when it is appended and
+    // the entries of the first dataset do not get a comment
+    Dataset second;
+    const std::array<float, 2> b = { 3.f, 4.f };
+    second.addEntry(glm::vec3(3.f), b, "Third");
+    second.addEntry(glm::vec3(4.f), b);
+    second.addEntry(glm::vec3(5.f), b, "Fifth");
+
+    first.append(second);
+    const std::vector<float> One = { 1.f, 1.f, 3.f, 3.f, 3.f };
+    const std::vector<float> Two = { 2.f, 2.f, 4.f, 4.f, 4.f };
+    REQUIRE(first.nEntries() == 5);
+    REQUIRE(first.values.size() == 2);
+    CHECK(first.values[0] == One);
+    CHECK(first.values[1] == Two);
+    CHECK(first.positions[4] == glm::vec3(5.f));
+    CHECK_FALSE(first.comment(0).has_value());
+    CHECK_FALSE(first.comment(1).has_value());
+    CHECK(first.comment(2) == "Third");
+    CHECK_FALSE(first.comment(3).has_value());
+    CHECK(first.comment(4) == "Fifth");
+
+    first.removeEntry(2);
+    const std::vector<float> Removed = { 1.f, 1.f, 3.f, 3.f };
+    REQUIRE(first.nEntries() == 4);
+    CHECK(first.values[0] == Removed);
+    CHECK(first.positions[2] == glm::vec3(4.f));
+    CHECK_FALSE(first.comment(2).has_value());
+    CHECK(first.comment(3) == "Fifth");
+
+    const DatasetView view = first.view();
+    REQUIRE(view.nEntries() == 4);
+    REQUIRE(view.values.size() == 2);
+    CHECK(view.values[1][3] == 4.f);
+    CHECK(view.comment(3) == "Fifth");
+}
+
+TEST_CASE("CsvLoader: Number Formats", "[dataloaders]") {
+    using namespace openspace::dataloader;
+
+    const std::filesystem::path path = writeCsvFile(
+        "test_dataloaders_numbers.csv",
+        0,
+        "  1.5,0x10,-2e2,abc"
+    );
+    const Dataset res = csv::loadCsvFile(path);
+    REQUIRE(res.nEntries() == 1);
+    CHECK(res.positions[0].x == 1.5f);
+    CHECK(res.positions[0].y == 16.f);
+    CHECK(res.positions[0].z == -200.f);
+    REQUIRE(res.values.size() == 1);
+    CHECK(std::isnan(res.values[0][0]));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CsvLoader: Parallel Conversion", "[dataloaders]") {
+    using namespace openspace::dataloader;
+
+    const std::filesystem::path path =
+        writeCsvFile("test_dataloaders_parallel.csv", NumLargeRows);
+    const Dataset res = csv::loadCsvFile(path);
+    REQUIRE(res.nEntries() == NumLargeRows);
+    REQUIRE(res.values.size() == 1);
+    REQUIRE(res.values[0].size() == NumLargeRows);
+    for (int i = 0; i < NumLargeRows; i++) {
+        CHECK(res.positions[i].x == static_cast<float>(i));
+        CHECK(res.positions[i].z == static_cast<float>(-i));
+        CHECK(res.values[0][i] == 0.5f * i);
+    }
+    CHECK(res.maxPositionComponent == 2.f * (NumLargeRows - 1));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CsvLoader: Out Of Range Value", "[dataloaders]") {
+    using namespace openspace::dataloader;
+
+    // Values that are out of range make std::stof throw, which must not be lost when
+    // the rows are converted in parallel
+    const std::filesystem::path path =
+        writeCsvFile("test_dataloaders_range.csv", NumLargeRows, "1,2,3,1e60");
+    CHECK_THROWS_AS(csv::loadCsvFile(path), std::out_of_range);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("SpeckLoader: Parallel Parsing", "[dataloaders]") {
+    using namespace openspace::dataloader;
+
+    // Large enough that the data section is split into multiple chunks
+    constexpr int NumRows = 150000;
+    const std::filesystem::path path =
+        writeSpeckFile("test_dataloaders_parallel.speck", NumRows);
+    const Dataset res = speck::loadSpeckFile(path);
+    REQUIRE(res.nEntries() == NumRows);
+    REQUIRE(res.values.size() == 1);
+    REQUIRE(res.values[0].size() == NumRows);
+    for (int i = 0; i < NumRows; i++) {
+        CHECK(res.positions[i].y == static_cast<float>(2 * (i + 1)));
+        CHECK(res.values[0][i] == 0.5f * (i + 1));
+        CHECK(res.comment(i) == std::format("Star {}", i + 1));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("SpeckLoader: Malformed Value", "[dataloaders]") {
+    using namespace openspace::dataloader;
+
+    const std::filesystem::path path =
+        writeSpeckFile("test_dataloaders_malformed.speck", 150000, "1 2 3 abc");
+    CHECK_THROWS_AS(speck::loadSpeckFile(path), ghoul::RuntimeError);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/data/dataloader.h>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace {
+    openspace::dataloader::Dataset createDataset() {
+        using namespace openspace::dataloader;
+
+        Dataset dataset;
+        dataset.variables = { { 0, "lum" }, { 1, "absmag" } };
+        dataset.textures = { { 1, "star.png" } };
+        dataset.textureDataIndex = 1;
+        dataset.maxPositionComponent = 100.f;
+        for (int i = 0; i < 100; i++) {
+            const std::array<float, 2> data = { 0.5f * i, static_cast<float>(i + 1) };
+            const std::string comment = std::format("Star {}", i);
+            dataset.addEntry(
+                glm::vec3(i, 2.f * i, -i),
+                data,
+                i % 3 == 0 ? std::optional<std::string_view>(comment) : std::nullopt
+            );
+        }
+        return dataset;
+    }
+} // namespace
+
+TEST_CASE("DatasetCache: Roundtrip", "[datasetcache]") {
+    using namespace openspace::dataloader;
+
+    const Dataset dataset = createDataset();
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_datasetcache_roundtrip.bin";
+    data::saveCachedFile(dataset, path);
+
+    const std::optional<Dataset> res = data::loadCachedFile(path);
+    REQUIRE(res.has_value());
+    REQUIRE(res->variables.size() == dataset.variables.size());
+    CHECK(res->variables[1].name == "absmag");
+    REQUIRE(res->textures.size() == 1);
+    CHECK(res->textures[0].file == "star.png");
+    CHECK(res->textureDataIndex == 1);
+    CHECK(res->orientationDataIndex == -1);
+    CHECK(res->maxPositionComponent == 100.f);
+    REQUIRE(res->nEntries() == dataset.nEntries());
+    CHECK(res->positions == dataset.positions);
+    CHECK(res->values == dataset.values);
+    for (size_t i = 0; i < dataset.nEntries(); i++) {
+        CHECK(res->comment(i) == dataset.comment(i));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("DatasetCache: Corrupt", "[datasetcache]") {
+    using namespace openspace::dataloader;
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_datasetcache_corrupt.bin";
+    data::saveCachedFile(createDataset(), path);
+
+    // The number of entries follows the header, which is 42 bytes for this dataset
+    {
+        std::fstream file = std::fstream(
+            path,
+            std::ios::binary | std::ios::in | std::ios::out
+        );
+        file.seekp(42);
+        const uint64_t nEntries = std::numeric_limits<uint64_t>::max() / 2;
+        file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    }
+
+    CHECK_FALSE(data::loadCachedFile(path).has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("DatasetCache: Truncated", "[datasetcache]") {
+    using namespace openspace::dataloader;
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_datasetcache_truncated.bin";
+    data::saveCachedFile(createDataset(), path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    CHECK_FALSE(data::loadCachedFile(path).has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("LabelCache: Roundtrip", "[datasetcache]") {
+    using namespace openspace::dataloader;
+
+    Labelset labelset;
+    labelset.textColorIndex = 2;
+    labelset.addEntry(glm::vec3(1.f, 2.f, 3.f), "Ori", "Orion");
+    labelset.addEntry(glm::vec3(-1.f), "", "Unnamed");
+    // The enabled state is not stored in the cache file
+    labelset.entries[1].isEnabled = false;
+    labelset.layout = Labelset::TextLayout{
+        .font = "Mono|50",
+        .glyphs = { { glm::vec4(0.f, 1.f, 2.f, 3.f), 'O' } },
+        .glyphOffsets = { 0, 1, 1 },
+        .sizes = { glm::vec2(2.f, 3.f), glm::vec2(0.f) }
+    };
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_labelcache_roundtrip.bin";
+    label::saveCachedFile(labelset, path);
+
+    const std::optional<Labelset> res = label::loadCachedFile(path);
+    REQUIRE(res.has_value());
+    CHECK(res->textColorIndex == 2);
+    REQUIRE(res->entries.size() == 2);
+    CHECK(res->entries[0].position == glm::vec3(1.f, 2.f, 3.f));
+    CHECK(res->identifier(res->entries[0]) == "Ori");
+    CHECK(res->text(res->entries[0]) == "Orion");
+    CHECK(res->identifier(res->entries[1]).empty());
+    CHECK(res->text(res->entries[1]) == "Unnamed");
+    CHECK(res->entries[1].isEnabled);
+    REQUIRE(res->layout.has_value());
+    CHECK(res->layout->font == "Mono|50");
+    REQUIRE(res->layout->glyphs.size() == 1);
+    CHECK(res->layout->glyphs[0].rectangle == glm::vec4(0.f, 1.f, 2.f, 3.f));
+    CHECK(res->layout->glyphs[0].character == 'O');
+    CHECK(res->layout->glyphOffsets == labelset.layout->glyphOffsets);
+    CHECK(res->layout->sizes == labelset.layout->sizes);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    CHECK_FALSE(label::loadCachedFile(path).has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("LabelCache: Without Layout", "[datasetcache]") {
+    using namespace openspace::dataloader;
+
+    Labelset labelset;
+    labelset.addEntry(glm::vec3(4.f, 5.f, 6.f), "And", "Andromeda");
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_labelcache_nolayout.bin";
+    label::saveCachedFile(labelset, path);
+
+    const std::optional<Labelset> res = label::loadCachedFile(path);
+    REQUIRE(res.has_value());
+    REQUIRE(res->entries.size() == 1);
+    CHECK(res->entries[0].position == glm::vec3(4.f, 5.f, 6.f));
+    CHECK(res->text(res->entries[0]) == "Andromeda");
+    CHECK_FALSE(res->layout.has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("LabelCache: SetText", "[datasetcache]") {
+    using namespace openspace::dataloader;
+
+    Labelset labelset;
+    labelset.addEntry(glm::vec3(0.f), "UMa", "UMa");
+    labelset.addEntry(glm::vec3(0.f), "Ori", "Ori");
+    labelset.layout = Labelset::TextLayout();
+
+    labelset.setText(labelset.entries[0], "Ursa Major");
+    CHECK(labelset.identifier(labelset.entries[0]) == "UMa");
+    CHECK(labelset.text(labelset.entries[0]) == "Ursa Major");
+    CHECK(labelset.text(labelset.entries[1]) == "Ori");
+    CHECK_FALSE(labelset.layout.has_value());
+}
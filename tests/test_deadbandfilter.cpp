@@ -0,0 +1,102 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_SERVER_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/server/include/deadbandfilter.h>
+
+using namespace openspace;
+
+TEST_CASE("DeadbandFilter: Without Deadband", "[deadbandfilter]") {
+    DeadbandFilter filter;
+
+    // The first value is always sent
+    CHECK(filter.update(1.0, 0.0));
+    // Unchanged values are not sent again
+    CHECK_FALSE(filter.update(1.0, 0.0));
+    CHECK_FALSE(filter.hasTrailingValue());
+    CHECK(filter.update(1.5, 0.0));
+    CHECK(filter.update("abc", 0.0));
+    CHECK_FALSE(filter.update("abc", 0.0));
+}
+
+TEST_CASE("DeadbandFilter: Numbers", "[deadbandfilter]") {
+    DeadbandFilter filter;
+
+    CHECK(filter.update(1.0, 0.5));
+    CHECK_FALSE(filter.update(1.2, 0.5));
+    CHECK_FALSE(filter.update(1.4, 0.5));
+    CHECK(filter.update(1.6, 0.5));
+    CHECK_FALSE(filter.hasTrailingValue());
+
+    // The differences are measured against the last sent value, not the previous one
+    CHECK_FALSE(filter.update(1.9, 0.5));
+    CHECK_FALSE(filter.update(2.0, 0.5));
+    CHECK(filter.update(2.2, 0.5));
+}
+
+TEST_CASE("DeadbandFilter: Vectors", "[deadbandfilter]") {
+    DeadbandFilter filter;
+
+    CHECK(filter.update(nlohmann::json::array({ 0.0, 0.0, 0.0 }), 0.1));
+    CHECK_FALSE(filter.update(nlohmann::json::array({ 0.05, 0.0, -0.05 }), 0.1));
+    // A single component exceeding the deadband is enough
+    CHECK(filter.update(nlohmann::json::array({ 0.0, 0.2, 0.0 }), 0.1));
+    // Changing the number of components is always significant
+    CHECK(filter.update(nlohmann::json::array({ 0.0, 0.2 }), 0.1));
+    // Non-numeric values ignore the deadband
+    CHECK(filter.update(nlohmann::json::array({ "a", "b" }), 0.1));
+}
+
+TEST_CASE("DeadbandFilter: Trailing Value", "[deadbandfilter]") {
+    DeadbandFilter filter;
+
+    CHECK(filter.update(0.0, 1.0));
+    CHECK_FALSE(filter.update(0.5, 1.0));
+    CHECK_FALSE(filter.update(0.7, 1.0));
+
+    // The last suppressed value is kept so that the client receives the final value
+    REQUIRE(filter.hasTrailingValue());
+    CHECK(filter.takeTrailingValue() == 0.7);
+    CHECK_FALSE(filter.hasTrailingValue());
+
+    // The trailing value counts as sent
+    CHECK_FALSE(filter.update(0.7, 1.0));
+    CHECK_FALSE(filter.hasTrailingValue());
+
+    // Returning to the last sent value does not leave a trailing value
+    CHECK_FALSE(filter.update(1.2, 1.0));
+    CHECK(filter.hasTrailingValue());
+    CHECK_FALSE(filter.update(0.7, 1.0));
+    CHECK_FALSE(filter.hasTrailingValue());
+
+    // A significant change replaces the trailing value
+    CHECK_FALSE(filter.update(1.0, 1.0));
+    CHECK(filter.update(2.0, 1.0));
+    CHECK_FALSE(filter.hasTrailingValue());
+}
+
+#endif // OPENSPACE_MODULE_SERVER_ENABLED
@@ -0,0 +1,310 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+#include <modules/fieldlinessequence/util/doublebuffer.h>
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/spicemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+namespace {
+    openspace::FieldlinesState createState() {
+        using namespace openspace;
+
+        FieldlinesState state;
+        state.setModel(fls::Model::Batsrus);
+        state.setTriggerTime(0.0);
+        state.setExtraQuantityNames({ "rho", "T" });
+
+        std::vector<float> rho;
+        std::vector<float> temperature;
+        for (int l = 0; l < 20; l++) {
+            std::vector<glm::vec3> line;
+            for (int i = 0; i < 10; i++) {
+                line.emplace_back(l * 1e7f, i * -2e6f, (l + i) * 5e5f);
+                rho.push_back(static_cast<float>(l * i));
+                temperature.push_back(1000.f + i);
+            }
+            state.addLine(line);
+        }
+        rho.insert(rho.end(), temperature.begin(), temperature.end());
+        state.setExtraQuantities(std::move(rho));
+        return state;
+    }
+
+    // Saves the state into an empty folder and returns the path of the written file
+    std::filesystem::path saveState(const openspace::FieldlinesState& state,
+                                    const std::filesystem::path& folder)
+    {
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directory(folder);
+        openspace::FieldlinesState copy = state;
+        copy.saveStateToOsfls(folder.string() + "/");
+        return std::filesystem::directory_iterator(folder)->path();
+    }
+
+    void overwrite(const std::filesystem::path& file, std::streamoff offset,
+                   const void* data, std::streamsize size)
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offset);
+        f.write(reinterpret_cast<const char*>(data), size);
+    }
+
+    struct Buffer {
+        int triggerTimeIndex = -1;
+        int nUploads = 0;
+    };
+} // namespace
+
+TEST_CASE("FieldlinesState: Extra Quantities", "[fieldlinesstate]") {
+    const openspace::FieldlinesState state = createState();
+
+    CHECK(state.nVertices() == 200);
+    CHECK(state.nExtraQuantities() == 2);
+    REQUIRE(state.extraQuantity(0).size() == 200);
+    CHECK(state.extraQuantity(0)[11] == 1.f);
+    REQUIRE(state.extraQuantity(1).size() == 200);
+    CHECK(state.extraQuantity(1)[11] == 1001.f);
+    CHECK(state.extraQuantity(2).empty());
+}
+
+TEST_CASE("FieldlinesState: Quantize", "[fieldlinesstate]") {
+    const openspace::FieldlinesState original = createState();
+    openspace::FieldlinesState state = original;
+    state.quantize();
+
+    REQUIRE(state.isQuantized());
+    CHECK(state.nVertices() == 200);
+    CHECK(state.vertexPositions().empty());
+    CHECK(state.extraQuantity(0).empty());
+    REQUIRE(state.quantizedVertexPositions().size() == 3 * 200);
+
+    // Every restored value has to be within half a quantization step of the original
+    const glm::vec3 offset = state.positionOffset();
+    const glm::vec3 scale = state.positionScale();
+    for (size_t i = 0; i < state.nVertices(); i++) {
+        for (int c = 0; c < 3; c++) {
+            const float value = state.quantizedVertexPositions()[3 * i + c] / 65535.f;
+            const float restored = offset[c] + scale[c] * value;
+            const float expected = original.vertexPositions()[i][c];
+            CHECK(std::abs(restored - expected) <= scale[c] / 65535.f);
+        }
+    }
+
+    for (size_t q = 0; q < state.nExtraQuantities(); q++) {
+        const std::span<const uint16_t> values = state.quantizedExtraQuantity(q);
+        REQUIRE(values.size() == 200);
+        const float qOffset = state.extraQuantityOffset(q);
+        const float qScale = state.extraQuantityScale(q);
+        for (size_t i = 0; i < values.size(); i++) {
+            const float restored = qOffset + qScale * values[i] / 65535.f;
+            CHECK(std::abs(restored - original.extraQuantity(q)[i]) <= qScale / 65535.f);
+        }
+    }
+}
+
+TEST_CASE("FieldlinesState: Osfls Roundtrip", "[fieldlinesstate]") {
+    using namespace openspace;
+
+    // The file name is derived from the trigger time
+    SpiceManager::initialize();
+    SpiceManager::ref().loadKernel(
+        absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls")
+    );
+
+    const std::filesystem::path folder =
+        std::filesystem::temp_directory_path() / "test_fieldlinesstate";
+    for (bool quantize : { false, true }) {
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directory(folder);
+
+        FieldlinesState state = createState();
+        if (quantize) {
+            state.quantize();
+        }
+        state.saveStateToOsfls(folder.string() + "/");
+        const std::filesystem::path file =
+            std::filesystem::directory_iterator(folder)->path();
+
+        // Only quantized states need the newer version, others stay readable by earlier
+        // versions of OpenSpace
+        int version = -1;
+        std::ifstream(file, std::ios::binary).read(
+            reinterpret_cast<char*>(&version),
+            sizeof(int)
+        );
+        CHECK(version == (quantize ? 1 : 0));
+
+        FieldlinesState loaded;
+        REQUIRE(loaded.loadStateFromOsfls(file.string()));
+        CHECK(loaded.isQuantized() == quantize);
+        CHECK(loaded.model() == fls::Model::Batsrus);
+        CHECK(loaded.extraQuantityNames() == state.extraQuantityNames());
+        CHECK(loaded.lineStart() == state.lineStart());
+        CHECK(loaded.lineCount() == state.lineCount());
+        CHECK(loaded.vertexPositions() == state.vertexPositions());
+        CHECK(std::ranges::equal(
+            loaded.quantizedVertexPositions(),
+            state.quantizedVertexPositions()
+        ));
+        for (size_t q = 0; q < state.nExtraQuantities(); q++) {
+            CHECK(std::ranges::equal(loaded.extraQuantity(q), state.extraQuantity(q)));
+            CHECK(std::ranges::equal(
+                loaded.quantizedExtraQuantity(q),
+                state.quantizedExtraQuantity(q)
+            ));
+            CHECK(loaded.extraQuantityOffset(q) == state.extraQuantityOffset(q));
+            CHECK(loaded.extraQuantityScale(q) == state.extraQuantityScale(q));
+        }
+
+        // A truncated file is rejected instead of being read past its end
+        std::filesystem::resize_file(file, std::filesystem::file_size(file) / 2);
+        FieldlinesState truncated;
+        CHECK_FALSE(truncated.loadStateFromOsfls(file.string()));
+    }
+    std::filesystem::remove_all(folder);
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("FieldlinesState: Corrupt Osfls", "[fieldlinesstate]") {
+    using namespace openspace;
+
+    SpiceManager::initialize();
+    SpiceManager::ref().loadKernel(
+        absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls")
+    );
+
+    const std::filesystem::path folder =
+        std::filesystem::temp_directory_path() / "test_fieldlinesstate_corrupt";
+    const FieldlinesState state = createState();
+
+    // Version, trigger time, model, morphable flag, and four sizes. The state is not
+    // quantized, so it is written as version 0 without the quantized flag
+    constexpr std::streamoff LineStartOffset = 4 + 8 + 4 + 1 + 4 * 8;
+    const std::streamoff lineCountOffset =
+        LineStartOffset + sizeof(int32_t) * state.lineStart().size();
+
+    // A line that reaches past the last vertex
+    {
+        const std::filesystem::path file = saveState(state, folder);
+        const int32_t count = 1000;
+        overwrite(file, lineCountOffset, &count, sizeof(int32_t));
+        FieldlinesState loaded;
+        CHECK_FALSE(loaded.loadStateFromOsfls(file.string()));
+    }
+
+    // A line that starts before the first vertex
+    {
+        const std::filesystem::path file = saveState(state, folder);
+        const int32_t start = -1;
+        overwrite(file, LineStartOffset, &start, sizeof(int32_t));
+        FieldlinesState loaded;
+        CHECK_FALSE(loaded.loadStateFromOsfls(file.string()));
+    }
+
+    // A name of an extra quantity without a null terminator
+    {
+        const std::filesystem::path file = saveState(state, folder);
+        const char c = 'x';
+        overwrite(file, std::filesystem::file_size(file) - 1, &c, 1);
+        FieldlinesState loaded;
+        CHECK_FALSE(loaded.loadStateFromOsfls(file.string()));
+    }
+
+    // A file without any content
+    {
+        const std::filesystem::path file = saveState(state, folder);
+        std::filesystem::resize_file(file, 0);
+        FieldlinesState loaded;
+        CHECK_FALSE(loaded.loadStateFromOsfls(file.string()));
+    }
+
+    // A path that can be opened but not read
+    {
+        std::filesystem::create_directories(folder);
+        FieldlinesState loaded;
+        CHECK_FALSE(loaded.loadStateFromOsfls(folder.string()));
+    }
+
+    std::filesystem::remove_all(folder);
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("FieldlinesState: Double Buffer", "[fieldlinesstate]") {
+    using namespace openspace;
+
+    std::array<Buffer, 2> buffers;
+    std::set<int> resident = { 0, 1, 2 };
+    auto upload = [&resident](Buffer& buffer, int index) {
+        if (resident.contains(index)) {
+            buffer.triggerTimeIndex = index;
+            buffer.nUploads++;
+        }
+    };
+
+    // The active state is uploaded directly and the next one is prepared in the back
+    fls::updateDoubleBuffer(buffers, 0, 1, upload);
+    CHECK(buffers[0].triggerTimeIndex == 0);
+    CHECK(buffers[1].triggerTimeIndex == 1);
+
+    // Nothing is uploaded while the active state doesn't change
+    fls::updateDoubleBuffer(buffers, 0, 1, upload);
+    CHECK(buffers[0].nUploads + buffers[1].nUploads == 2);
+
+    // Advancing swaps in the prepared state without uploading it again
+    fls::updateDoubleBuffer(buffers, 1, 2, upload);
+    CHECK(buffers[0].triggerTimeIndex == 1);
+    CHECK(buffers[0].nUploads == 1);
+    CHECK(buffers[1].triggerTimeIndex == 2);
+
+    // A state that is not in memory keeps the previous state visible
+    fls::updateDoubleBuffer(buffers, 5, 6, upload);
+    CHECK(buffers[0].triggerTimeIndex == 1);
+    CHECK(buffers[1].triggerTimeIndex == 2);
+
+    // Once it has arrived, it is shown
+    resident.insert(5);
+    fls::updateDoubleBuffer(buffers, 5, -1, upload);
+    CHECK(buffers[0].triggerTimeIndex == 5);
+    CHECK(buffers[1].triggerTimeIndex == 1);
+
+    // Reversing prepares the preceding state
+    fls::updateDoubleBuffer(buffers, 5, 4, upload);
+    CHECK(buffers[0].triggerTimeIndex == 5);
+    CHECK(buffers[1].triggerTimeIndex == 1);
+    resident.insert(4);
+    fls::updateDoubleBuffer(buffers, 5, 4, upload);
+    CHECK(buffers[1].triggerTimeIndex == 4);
+}
+#endif // OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
@@ -0,0 +1,141 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/horizonsstream.h>
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+namespace {
+    // The position moves along a straight line, so that the linear interpolation between
+    // the keyframes is exact
+    std::array<double, 3> linearPosition(double time) {
+        return { time, 2.0 * time, -time };
+    }
+
+    std::vector<openspace::HorizonsStream::Keyframe> createKeyframes(size_t n,
+                                                                     bool isUniform)
+    {
+        std::vector<openspace::HorizonsStream::Keyframe> keyframes;
+        for (size_t i = 0; i < n; i++) {
+            const double t = static_cast<double>(i);
+            const double time = isUniform ? 60.0 * t : t * t;
+            keyframes.push_back({ time, linearPosition(time) });
+        }
+        return keyframes;
+    }
+
+    bool isAtTime(const glm::dvec3& position, double time) {
+        const std::array<double, 3> expected = linearPosition(time);
+        return std::abs(position.x - expected[0]) < 1e-6 &&
+               std::abs(position.y - expected[1]) < 1e-6 &&
+               std::abs(position.z - expected[2]) < 1e-6;
+    }
+} // namespace
+
+TEST_CASE("HorizonsStream: Uniform Step", "[horizonsstream]") {
+    using namespace openspace;
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_horizonsstream_uniform.bin";
+    HorizonsStream::save(file, createKeyframes(10000, true));
+
+    std::unique_ptr<HorizonsStream> stream = HorizonsStream::open(file, 64);
+    REQUIRE(stream);
+    CHECK(stream->hasUniformStep());
+    CHECK(stream->nKeyframes() == 10000);
+    CHECK(stream->startTime() == 0.0);
+    CHECK(stream->endTime() == 60.0 * 9999.0);
+
+    CHECK(stream->isResident(100.0));
+    CHECK_FALSE(stream->isResident(300000.0));
+
+    // Positions outside of the window are read from the file
+    CHECK(isAtTime(stream->position(300000.0), 300000.0));
+    CHECK(isAtTime(stream->position(123456.7), 123456.7));
+
+    // Times outside of the trajectory are clamped
+    CHECK(isAtTime(stream->position(-100.0), 0.0));
+    CHECK(isAtTime(stream->position(1e9), stream->endTime()));
+
+    // Moving forward in time keeps the current time resident
+    for (double time = 0.0; time < 100000.0; time += 45.0) {
+        stream->update(time);
+        REQUIRE(stream->isResident(time));
+        REQUIRE(isAtTime(stream->position(time), time));
+    }
+
+    // Jumping and moving backwards
+    for (double time = 500000.0; time > 400000.0; time -= 45.0) {
+        stream->update(time);
+        REQUIRE(stream->isResident(time));
+        REQUIRE(isAtTime(stream->position(time), time));
+    }
+
+    stream = nullptr;
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("HorizonsStream: Non-Uniform Step", "[horizonsstream]") {
+    using namespace openspace;
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_horizonsstream_nonuniform.bin";
+    HorizonsStream::save(file, createKeyframes(2000, false));
+
+    std::unique_ptr<HorizonsStream> stream = HorizonsStream::open(file, 32);
+    REQUIRE(stream);
+    CHECK_FALSE(stream->hasUniformStep());
+
+    for (double time = 0.0; time < 1999.0 * 1999.0; time += 1234.5) {
+        REQUIRE(isAtTime(stream->position(time), time));
+    }
+
+    for (double time = 0.0; time < 100000.0; time += 10.0) {
+        stream->update(time);
+        REQUIRE(stream->isResident(time));
+        REQUIRE(isAtTime(stream->position(time), time));
+    }
+
+    stream = nullptr;
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("HorizonsStream: Invalid File", "[horizonsstream]") {
+    using namespace openspace;
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_horizonsstream_invalid.bin";
+    HorizonsStream::save(file, createKeyframes(100, true));
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 1);
+
+    CHECK_FALSE(HorizonsStream::open(file, 16));
+    CHECK_FALSE(HorizonsStream::open(file.string() + ".missing", 16));
+
+    std::filesystem::remove(file);
+}
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+#include <modules/kameleon/include/kameleonresampler.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("KameleonResampler: Visits Every Voxel Once", "[kameleonresampler]") {
+    using namespace openspace::kameleon;
+
+    const glm::uvec3 dimensions = glm::uvec3(37, 20, 45);
+    const size_t nVoxels = dimensions.x * dimensions.y * dimensions.z;
+
+    const ResamplingSettings settings = {
+        .nThreads = 4,
+        .brickSize = glm::uvec3(8, 16, 4)
+    };
+    const size_t nWorkers = nResamplingWorkers(dimensions, settings);
+    REQUIRE(nWorkers == 4);
+
+    std::vector<std::atomic_int> visits(nVoxels);
+    std::vector<size_t> nSamples(nWorkers, 0);
+    std::vector<size_t> errors(nWorkers, 0);
+    resampleVolume(
+        dimensions,
+        [&](size_t worker) {
+            return [&, count = &nSamples[worker], error = &errors[worker]]
+                (const glm::uvec3& voxel, size_t index)
+            {
+                const size_t expected = voxel.x + voxel.y * dimensions.x +
+                                        voxel.z * dimensions.x * dimensions.y;
+                if (index != expected) {
+                    (*error)++;
+                }
+                visits[index]++;
+                (*count)++;
+            };
+        },
+        settings
+    );
+
+    size_t total = 0;
+    for (size_t i = 0; i < nWorkers; i++) {
+        CHECK(errors[i] == 0);
+        total += nSamples[i];
+    }
+    CHECK(total == nVoxels);
+    for (const std::atomic_int& v : visits) {
+        REQUIRE(v == 1);
+    }
+}
+
+TEST_CASE("KameleonResampler: Worker Owns State", "[kameleonresampler]") {
+    using namespace openspace::kameleon;
+
+    const glm::uvec3 dimensions = glm::uvec3(16, 16, 64);
+    const ResamplingSettings settings = { .nThreads = 3 };
+
+    // A move-only worker, like one that owns its interpolator
+    std::atomic_int nCreated = 0;
+    std::vector<float> data(dimensions.x * dimensions.y * dimensions.z, 0.f);
+    resampleVolume(
+        dimensions,
+        [&](size_t) {
+            nCreated++;
+            return [&, scale = std::make_unique<float>(2.f)]
+                (const glm::uvec3& voxel, size_t index)
+            {
+                data[index] = *scale * voxel.z;
+            };
+        },
+        settings
+    );
+
+    CHECK(nCreated == 3);
+    for (size_t i = 0; i < data.size(); i++) {
+        const size_t z = i / (dimensions.x * dimensions.y);
+        REQUIRE(data[i] == 2.f * z);
+    }
+}
+
+TEST_CASE("KameleonResampler: Worker Count", "[kameleonresampler]") {
+    using namespace openspace::kameleon;
+
+    const ResamplingSettings settings = {
+        .nThreads = 8,
+        .brickSize = glm::uvec3(16)
+    };
+    CHECK(nResamplingWorkers(glm::uvec3(64, 64, 64), settings) == 4);
+    CHECK(nResamplingWorkers(glm::uvec3(64, 64, 1000), settings) == 8);
+    CHECK(nResamplingWorkers(glm::uvec3(64, 64, 0), settings) == 1);
+    CHECK(nResamplingWorkers(glm::uvec3(64, 64, 64)) >= 1);
+
+    size_t nCalls = 0;
+    resampleVolume(
+        glm::uvec3(0, 4, 4),
+        [&](size_t) { return [&](const glm::uvec3&, size_t) { nCalls++; }; },
+        settings
+    );
+    CHECK(nCalls == 0);
+}
+
+TEST_CASE("KameleonResampler: Exception", "[kameleonresampler]") {
+    using namespace openspace::kameleon;
+
+    const ResamplingSettings settings = { .nThreads = 4 };
+    CHECK_THROWS_AS(
+        resampleVolume(
+            glm::uvec3(32, 32, 128),
+            [](size_t) {
+                return [](const glm::uvec3& voxel, size_t) {
+                    if (voxel.z == 100) {
+                        throw std::runtime_error("Failed");
+                    }
+                };
+            },
+            settings
+        ),
+        std::runtime_error
+    );
+}
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/kepler.h>
+#include <ghoul/format.h>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    constexpr int NumObjects = 10;
+
+    std::vector<openspace::kepler::Parameters> createParameters() {
+        std::vector<openspace::kepler::Parameters> params;
+        for (int i = 0; i < NumObjects; i++) {
+            openspace::kepler::Parameters p;
+            p.name = std::format("Object {}", i);
+            p.id = std::format("{}", 1000 + i);
+            p.inclination = 1.0 * i;
+            p.semiMajorAxis = 7000.0 + i;
+            p.eccentricity = 0.01 * i;
+            p.epoch = 100.0 * i;
+            p.period = 5800.0;
+            params.push_back(std::move(p));
+        }
+        return params;
+    }
+
+    void overwrite(const std::filesystem::path& file, std::streamoff offset,
+                   uint32_t value)
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offset);
+        f.write(reinterpret_cast<const char*>(&value), sizeof(uint32_t));
+    }
+
+    // Version and number of objects
+    constexpr std::streamoff SizeOffset = sizeof(int8_t);
+    // Followed by eight columns of values
+    constexpr std::streamoff NameOffsetsOffset =
+        SizeOffset + sizeof(uint32_t) + 8 * NumObjects * sizeof(double);
+} // namespace
+
+TEST_CASE("KeplerCache: Roundtrip", "[keplercache]") {
+    using namespace openspace::kepler;
+
+    const std::vector<Parameters> params = createParameters();
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_keplercache_roundtrip.bin";
+    saveCache(params, path);
+
+    const std::optional<std::vector<Parameters>> res = loadCache(path);
+    REQUIRE(res.has_value());
+    REQUIRE(res->size() == params.size());
+    for (size_t i = 0; i < params.size(); i++) {
+        CHECK((*res)[i].name == params[i].name);
+        CHECK((*res)[i].id == params[i].id);
+        CHECK((*res)[i].inclination == params[i].inclination);
+        CHECK((*res)[i].semiMajorAxis == params[i].semiMajorAxis);
+        CHECK((*res)[i].eccentricity == params[i].eccentricity);
+        CHECK((*res)[i].epoch == params[i].epoch);
+        CHECK((*res)[i].period == params[i].period);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("KeplerCache: Truncated", "[keplercache]") {
+    using namespace openspace::kepler;
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_keplercache_truncated.bin";
+    saveCache(createParameters(), path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    CHECK_FALSE(loadCache(path).has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("KeplerCache: Corrupt", "[keplercache]") {
+    using namespace openspace::kepler;
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_keplercache_corrupt.bin";
+
+    // A number of objects that is larger than the file
+    saveCache(createParameters(), path);
+    overwrite(path, SizeOffset, 0xFFFFFFFF);
+    CHECK_FALSE(loadCache(path).has_value());
+
+    // A name that ends before it starts
+    saveCache(createParameters(), path);
+    overwrite(path, NameOffsetsOffset + sizeof(uint32_t), 20);
+    CHECK_FALSE(loadCache(path).has_value());
+
+    // A name that reaches past the end of the string pool
+    saveCache(createParameters(), path);
+    overwrite(path, NameOffsetsOffset + NumObjects * sizeof(uint32_t), 0xFFFF);
+    CHECK_FALSE(loadCache(path).has_value());
+
+    std::filesystem::remove(path);
+}
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/keplerpropagator.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+    openspace::kepler::Parameters createParameters(double eccentricity) {
+        openspace::kepler::Parameters p;
+        p.name = "Test";
+        p.eccentricity = eccentricity;
+        p.semiMajorAxis = 7000.0;
+        p.period = 5800.0;
+        return p;
+    }
+} // namespace
+
+TEST_CASE("KeplerPropagator: Valid Elements", "[keplerpropagator]") {
+    using namespace openspace::kepler;
+
+    CHECK(hasValidElements(createParameters(0.0)));
+    CHECK(hasValidElements(createParameters(0.99)));
+    CHECK_FALSE(hasValidElements(createParameters(1.0)));
+    CHECK_FALSE(hasValidElements(createParameters(-0.1)));
+
+    Parameters p = createParameters(0.5);
+    p.inclination = 360.0;
+    p.ascendingNode = 360.0;
+    CHECK(hasValidElements(p));
+    p.inclination = 361.0;
+    CHECK_FALSE(hasValidElements(p));
+    p.inclination = 10.0;
+    p.ascendingNode = -1.0;
+    CHECK_FALSE(hasValidElements(p));
+}
+
+TEST_CASE("KeplerPropagator: Eccentric Anomalies", "[keplerpropagator]") {
+    using namespace openspace::kepler;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> meanAnomaly(-50.0, 50.0);
+    std::uniform_real_distribution<double> eccentricity(0.0, 0.99);
+
+    constexpr size_t N = 1000;
+    std::vector<double> m(N);
+    std::vector<double> e(N);
+    for (size_t i = 0; i < N; i++) {
+        m[i] = meanAnomaly(rng);
+        e[i] = eccentricity(rng);
+    }
+    std::vector<double> result(N);
+    solveEccentricAnomalies(m, e, result);
+
+    // The eccentric anomalies have to solve Kepler's equation M = E - e * sin(E)
+    for (size_t i = 0; i < N; i++) {
+        CHECK(std::abs(result[i] - e[i] * std::sin(result[i]) - m[i]) < 1e-9);
+    }
+}
+
+TEST_CASE("KeplerPropagator: Sample Orbit", "[keplerpropagator]") {
+    using namespace openspace::kepler;
+
+    constexpr double Eccentricity = 0.5;
+    const OrbitBatch batch = createOrbitBatch({ createParameters(Eccentricity) });
+    REQUIRE(batch.size() == 1);
+
+    constexpr size_t N = 101;
+    std::vector<double> timeOffsets(N);
+    std::vector<glm::dvec3> positions(N);
+    sampleOrbit(batch, 0, timeOffsets, positions);
+
+    CHECK(timeOffsets.front() == 0.0);
+    CHECK(timeOffsets.back() == 5800.0);
+
+    // Without any rotation and mean anomaly, the orbit starts at the periapsis on the
+    // x axis and reaches the apoapsis after half of the period
+    const double a = 7000.0 * 1000.0;
+    CHECK(std::abs(positions[0].x - a * (1.0 - Eccentricity)) < 1e-3);
+    CHECK(std::abs(positions[0].y) < 1e-3);
+    CHECK(std::abs(positions[N / 2].x + a * (1.0 + Eccentricity)) < 1e-3);
+    CHECK(std::abs(positions[N / 2].y) < 1e-3);
+    CHECK(glm::length(positions.back() - positions.front()) < 1e-3);
+    for (const glm::dvec3& p : positions) {
+        CHECK(p.z == 0.0);
+    }
+}
+
+TEST_CASE("KeplerPropagator: Orbit Plane", "[keplerpropagator]") {
+    using namespace openspace::kepler;
+
+    // An inclination of 90 degrees rotates the orbit into the xz plane, and the ascending
+    // node rotates it around the z axis
+    Parameters p = createParameters(0.0);
+    p.inclination = 90.0;
+    p.ascendingNode = 90.0;
+    const OrbitBatch batch = createOrbitBatch({ p });
+
+    constexpr size_t N = 5;
+    std::vector<double> timeOffsets(N);
+    std::vector<glm::dvec3> positions(N);
+    sampleOrbit(batch, 0, timeOffsets, positions);
+
+    const double a = 7000.0 * 1000.0;
+    // Periapsis along the line of nodes, which is the y axis
+    CHECK(std::abs(positions[0].x) < 1e-3);
+    CHECK(std::abs(positions[0].y - a) < 1e-3);
+    CHECK(std::abs(positions[0].z) < 1e-3);
+    // A quarter of the orbit later the object is at the highest point above the plane
+    CHECK(std::abs(positions[1].x) < 1e-3);
+    CHECK(std::abs(positions[1].y) < 1e-3);
+    CHECK(std::abs(positions[1].z - a) < 1e-3);
+}
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
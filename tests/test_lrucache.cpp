@@ -96,3 +96,35 @@ TEST_CASE("LRUCache: StructKey", "[lrucache]") {
     CHECK(lru.get(key1) == val2);
     CHECK(lru.get(key2) == val2);
 }
+
+TEST_CASE("LRUCache: Touch", "[lrucache]") {
+    openspace::globebrowsing::cache::LRUCache<int, double, DefaultHasher> lru(3);
+    lru.put(1, 1.0);
+    lru.put(2, 2.0);
+    lru.put(3, 3.0);
+    CHECK(lru.touch(1));
+    CHECK_FALSE(lru.touch(4));
+    lru.put(4, 4.0);
+    CHECK(lru.exist(1));
+    CHECK_FALSE(lru.exist(2));
+    CHECK(lru.popLRU().first == 3);
+    CHECK(lru.popMRU().first == 4);
+    CHECK(lru.size() == 1);
+}
+
+TEST_CASE("LRUCache: Replace", "[lrucache]") {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(2);
+    lru.put(1, 1);
+    lru.put(2, 2);
+
+    // Replacing an item bumps it to the front without changing the number of items
+    lru.put(1, 5);
+    CHECK(lru.size() == 2);
+    CHECK(lru.get(1) == 5);
+
+    // So the other item is the one that has to go
+    lru.put(3, 3);
+    CHECK_FALSE(lru.exist(2));
+    CHECK(lru.exist(1));
+    CHECK(lru.exist(3));
+}
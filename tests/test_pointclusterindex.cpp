@@ -0,0 +1,140 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_BASE_ENABLED
+#include <modules/base/rendering/pointcloud/pointclusterindex.h>
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace {
+    std::vector<glm::dvec3> randomPositions(size_t n) {
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+        std::vector<glm::dvec3> res;
+        res.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            res.emplace_back(
+                distribution(generator),
+                distribution(generator),
+                // A flat distribution to get differently shaped octree nodes
+                0.01 * distribution(generator)
+            );
+        }
+        return res;
+    }
+
+    void checkIndex(const openspace::PointClusterIndex& index,
+                    const std::vector<glm::dvec3>& positions, uint32_t maxClusterSize)
+    {
+        using namespace openspace;
+
+        // Every point is part of the order exactly once
+        std::vector<uint32_t> sorted = index.order();
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(sorted.size() == positions.size());
+        for (size_t i = 0; i < sorted.size(); i++) {
+            REQUIRE(sorted[i] == i);
+        }
+
+        // The clusters cover the order without gaps and bound their points
+        uint32_t next = 0;
+        for (const PointClusterIndex::Cluster& cluster : index.clusters()) {
+            CHECK(cluster.first == next);
+            CHECK(cluster.count > 0);
+            CHECK(cluster.count <= maxClusterSize);
+            for (uint32_t i = cluster.first; i < cluster.first + cluster.count; i++) {
+                const glm::dvec3& p = positions[index.order()[i]];
+                CHECK(glm::distance(p, cluster.center) <= cluster.radius * (1.0 + 1e-12));
+            }
+            next += cluster.count;
+        }
+        CHECK(next == positions.size());
+    }
+} // namespace
+
+TEST_CASE("PointClusterIndex: Random Points", "[pointclusterindex]") {
+    using namespace openspace;
+
+    const std::vector<glm::dvec3> positions = randomPositions(20000);
+    const PointClusterIndex index = PointClusterIndex::build(positions, 256);
+    checkIndex(index, positions, 256);
+
+    // The points of a cluster are close together compared to the whole dataset
+    CHECK(index.clusters().size() > 20000 / 256);
+    for (const PointClusterIndex::Cluster& cluster : index.clusters()) {
+        CHECK(cluster.radius < 1000.0);
+    }
+}
+
+TEST_CASE("PointClusterIndex: Coincident Points", "[pointclusterindex]") {
+    using namespace openspace;
+
+    std::vector<glm::dvec3> positions = std::vector<glm::dvec3>(1000, glm::dvec3(5.0));
+    positions.emplace_back(-5.0);
+    const PointClusterIndex index = PointClusterIndex::build(positions, 100);
+    checkIndex(index, positions, 100);
+}
+
+TEST_CASE("PointClusterIndex: Empty", "[pointclusterindex]") {
+    using namespace openspace;
+
+    const PointClusterIndex index = PointClusterIndex::build({}, 100);
+    CHECK(index.order().empty());
+    CHECK(index.clusters().empty());
+}
+
+TEST_CASE("PointClusterIndex: Save and Load", "[pointclusterindex]") {
+    using namespace openspace;
+
+    const std::vector<glm::dvec3> positions = randomPositions(5000);
+    const PointClusterIndex index = PointClusterIndex::build(positions, 64);
+
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_pointclusterindex.bin";
+    index.save(file);
+
+    std::optional<PointClusterIndex> loaded = PointClusterIndex::load(file, 5000);
+    REQUIRE(loaded.has_value());
+    CHECK(loaded->order() == index.order());
+    REQUIRE(loaded->clusters().size() == index.clusters().size());
+    for (size_t i = 0; i < index.clusters().size(); i++) {
+        CHECK(loaded->clusters()[i].first == index.clusters()[i].first);
+        CHECK(loaded->clusters()[i].count == index.clusters()[i].count);
+        CHECK(loaded->clusters()[i].radius == index.clusters()[i].radius);
+    }
+
+    // The index has to match the number of points of the dataset
+    CHECK_FALSE(PointClusterIndex::load(file, 4999).has_value());
+
+    // A truncated file must be rejected
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 8);
+    CHECK_FALSE(PointClusterIndex::load(file, 5000).has_value());
+    std::filesystem::remove(file);
+}
+
+#endif // OPENSPACE_MODULE_BASE_ENABLED
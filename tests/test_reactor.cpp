@@ -0,0 +1,178 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_SERVER_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/server/include/nativesocket.h>
+#include <modules/server/include/reactor.h>
+#include <chrono>
+#include <thread>
+
+using namespace openspace;
+
+namespace {
+    nativesocket::Handle connectTo(int port) {
+        const nativesocket::Handle handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connect(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        return handle;
+    }
+
+    void sendAll(nativesocket::Handle handle, std::string_view data) {
+        ::send(handle, data.data(), static_cast<int>(data.size()), 0);
+    }
+
+    std::string receiveUntil(nativesocket::Handle handle, std::string_view terminator) {
+        std::string result;
+        while (result.find(terminator) == std::string::npos) {
+            char buffer[1024];
+            const auto n = ::recv(handle, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                break;
+            }
+            result.append(buffer, static_cast<size_t>(n));
+        }
+        return result;
+    }
+
+    template <typename Func>
+    bool waitFor(Func&& predicate) {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > timeout) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("Reactor: TCP Echo", "[reactor]") {
+    Reactor reactor;
+    const Reactor::ListenerId listener = reactor.listen(0, ReactorSocket::Protocol::Tcp);
+    REQUIRE(reactor.isListening(listener));
+    REQUIRE(reactor.port(listener) != 0);
+
+    const nativesocket::Handle client = connectTo(reactor.port(listener));
+    sendAll(client, "first\nsecond\n");
+
+    std::shared_ptr<ReactorSocket> socket;
+    REQUIRE(waitFor([&]() { return (socket = reactor.nextPendingSocket(listener)); }));
+    CHECK(socket->address() == "127.0.0.1");
+
+    std::string message;
+    REQUIRE(waitFor([&]() { return socket->nextMessage(message); }));
+    CHECK(message == "first");
+    REQUIRE(waitFor([&]() { return socket->nextMessage(message); }));
+    CHECK(message == "second");
+
+    CHECK(socket->putMessage("response"));
+    CHECK(receiveUntil(client, "\n") == "response\n");
+
+    // Binary messages are prefixed with their size instead of being newline-terminated
+    CHECK(socket->putMessage("binary", ReactorSocket::MessageType::Binary));
+    CHECK(receiveUntil(client, "binary") == std::string("\0\0\0\x06" "binary", 10));
+
+    nativesocket::close(client);
+    CHECK(waitFor([&]() { return !socket->isConnected(); }));
+    CHECK_FALSE(socket->putMessage("after close"));
+
+    reactor.close(listener);
+    CHECK_FALSE(reactor.isListening(listener));
+}
+
+TEST_CASE("Reactor: WebSocket Handshake", "[reactor]") {
+    Reactor reactor;
+    const Reactor::ListenerId listener =
+        reactor.listen(0, ReactorSocket::Protocol::WebSocket);
+
+    const nativesocket::Handle client = connectTo(reactor.port(listener));
+    // The example handshake from RFC 6455
+    sendAll(
+        client,
+        "GET /chat HTTP/1.1\r\n"
+        "Host: server.example.com\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n"
+    );
+    const std::string response = receiveUntil(client, "\r\n\r\n");
+    CHECK(response.starts_with("HTTP/1.1 101"));
+    CHECK(
+        response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") !=
+        std::string::npos
+    );
+
+    std::shared_ptr<ReactorSocket> socket;
+    REQUIRE(waitFor([&]() { return (socket = reactor.nextPendingSocket(listener)); }));
+
+    // A masked text frame containing "Hello" (RFC 6455, section 5.7)
+    sendAll(
+        client,
+        std::string_view("\x81\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58", 11)
+    );
+    std::string message;
+    REQUIRE(waitFor([&]() { return socket->nextMessage(message); }));
+    CHECK(message == "Hello");
+
+    CHECK(socket->putMessage("Hello"));
+    CHECK(receiveUntil(client, "Hello") == std::string("\x81\x05Hello", 7));
+
+    CHECK(socket->putMessage("Binary", ReactorSocket::MessageType::Binary));
+    CHECK(receiveUntil(client, "Binary") == std::string("\x82\x06" "Binary", 8));
+
+    socket->disconnect();
+    CHECK_FALSE(socket->isConnected());
+    nativesocket::close(client);
+}
+
+TEST_CASE("Reactor: Send Queue Limit", "[reactor]") {
+    Reactor reactor(1024 * 1024);
+    const Reactor::ListenerId listener = reactor.listen(0, ReactorSocket::Protocol::Tcp);
+
+    // The client never reads, so the queue fills up once the kernel buffers are full
+    const nativesocket::Handle client = connectTo(reactor.port(listener));
+    std::shared_ptr<ReactorSocket> socket;
+    REQUIRE(waitFor([&]() { return (socket = reactor.nextPendingSocket(listener)); }));
+
+    const std::string message = std::string(64 * 1024, 'x');
+    int nQueued = 0;
+    while (socket->putMessage(message) && nQueued < 100000) {
+        nQueued++;
+    }
+    CHECK(nQueued < 100000);
+    CHECK(socket->isCongested());
+    CHECK(socket->queuedBytes() <= 1024 * 1024);
+
+    nativesocket::close(client);
+}
+
+#endif // OPENSPACE_MODULE_SERVER_ENABLED
@@ -0,0 +1,126 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/scene/scene.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace {
+    // Returns the level of each node in the provided update levels
+    std::vector<size_t> levelOfNodes(const std::vector<std::vector<size_t>>& levels,
+                                     size_t nNodes)
+    {
+        std::vector<size_t> result(nNodes, std::numeric_limits<size_t>::max());
+        for (size_t level = 0; level < levels.size(); level++) {
+            for (size_t node : levels[level]) {
+                // Every node is only placed once
+                CHECK(result.at(node) == std::numeric_limits<size_t>::max());
+                result.at(node) = level;
+            }
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("SceneUpdateLevels: Hierarchy", "[sceneupdatelevels]") {
+    using namespace openspace;
+
+    // 0 is the root, 1 and 2 are its children, 3 is a child of 1 that depends on 2 and
+    // 4 is a child of 2
+    const std::vector<std::vector<size_t>> predecessors = {
+        {},
+        { 0 },
+        { 0 },
+        { 1, 2 },
+        { 2 }
+    };
+    const std::vector<std::vector<size_t>> levels =
+        Scene::groupIntoUpdateLevels(predecessors);
+
+    REQUIRE(levels.size() == 3);
+    CHECK(levels[0] == std::vector<size_t>({ 0 }));
+    CHECK(levels[1] == std::vector<size_t>({ 1, 2 }));
+    CHECK(levels[2] == std::vector<size_t>({ 3, 4 }));
+}
+
+TEST_CASE("SceneUpdateLevels: Dependency Chain", "[sceneupdatelevels]") {
+    using namespace openspace;
+
+    // All nodes are children of the root, but each one depends on the previous one
+    std::vector<std::vector<size_t>> predecessors = { {}, { 0 } };
+    for (size_t i = 2; i < 10; i++) {
+        predecessors.push_back({ 0, i - 1 });
+    }
+    const std::vector<std::vector<size_t>> levels =
+        Scene::groupIntoUpdateLevels(predecessors);
+
+    REQUIRE(levels.size() == 10);
+    for (size_t i = 0; i < levels.size(); i++) {
+        CHECK(levels[i] == std::vector<size_t>({ i }));
+    }
+}
+
+TEST_CASE("SceneUpdateLevels: Random Graphs", "[sceneupdatelevels]") {
+    using namespace openspace;
+
+    std::mt19937 random(1337);
+    for (int graph = 0; graph < 50; graph++) {
+        constexpr size_t NNodes = 200;
+        std::vector<std::vector<size_t>> predecessors(NNodes);
+        for (size_t i = 1; i < NNodes; i++) {
+            // A parent and a few dependencies, all of which are sorted before the node
+            std::uniform_int_distribution<size_t> earlier(0, i - 1);
+            predecessors[i].push_back(earlier(random));
+            const size_t nDependencies = random() % 3;
+            for (size_t d = 0; d < nDependencies; d++) {
+                predecessors[i].push_back(earlier(random));
+            }
+        }
+
+        const std::vector<std::vector<size_t>> levels =
+            Scene::groupIntoUpdateLevels(predecessors);
+        const std::vector<size_t> levelOf = levelOfNodes(levels, NNodes);
+
+        for (size_t i = 0; i < NNodes; i++) {
+            REQUIRE(levelOf[i] < levels.size());
+
+            // Parents and dependencies always end up in an earlier level, and a node is
+            // placed directly after the latest of them
+            size_t expected = 0;
+            for (size_t p : predecessors[i]) {
+                CHECK(levelOf[p] < levelOf[i]);
+                expected = std::max(expected, levelOf[p] + 1);
+            }
+            CHECK(levelOf[i] == expected);
+        }
+
+        // The nodes of each level keep their topological order
+        for (const std::vector<size_t>& level : levels) {
+            CHECK(std::is_sorted(level.begin(), level.end()));
+        }
+    }
+}
@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/scripting/scriptcache.h>
+#include <ghoul/lua/ghoul_lua.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/lua/luastate.h>
+
+using namespace openspace::scripting;
+
+TEST_CASE("ScriptCache: Template", "[scriptcache]") {
+    using Type = ScriptCache::Template::Parameter::Type;
+
+    std::optional<ScriptCache::Template> t = ScriptCache::createTemplate(
+        "openspace.setPropertyValueSingle('Scene.Earth.Renderable.Opacity', 0.5)"
+    );
+    REQUIRE(t.has_value());
+    CHECK(t->text ==
+        "local __osp1,__osp2=...;openspace.setPropertyValueSingle(__osp1, __osp2)"
+    );
+    REQUIRE(t->parameters.size() == 2);
+    CHECK(t->parameters[0].type == Type::String);
+    CHECK(t->parameters[0].value == "Scene.Earth.Renderable.Opacity");
+    CHECK(t->parameters[1].type == Type::Number);
+    CHECK(t->parameters[1].value == "0.5");
+
+    // Scripts that only differ in their literals share the same template
+    std::optional<ScriptCache::Template> t2 = ScriptCache::createTemplate(
+        "openspace.setPropertyValueSingle(\"Scene.Mars.Renderable.Opacity\", 1)"
+    );
+    REQUIRE(t2.has_value());
+    CHECK(t2->text == t->text);
+}
+
+TEST_CASE("ScriptCache: Template Numbers", "[scriptcache]") {
+    std::optional<ScriptCache::Template> t = ScriptCache::createTemplate(
+        "return 1, -2.5, .5, 1e-3, 0x1F, 0x1p4, a..b, x1"
+    );
+    REQUIRE(t.has_value());
+    CHECK(t->text ==
+        "local __osp1,__osp2,__osp3,__osp4,__osp5,__osp6=...;"
+        "return __osp1, -__osp2, __osp3, __osp4, __osp5, __osp6, a..b, x1"
+    );
+    REQUIRE(t->parameters.size() == 6);
+    CHECK(t->parameters[2].value == ".5");
+    CHECK(t->parameters[3].value == "1e-3");
+    CHECK(t->parameters[5].value == "0x1p4");
+
+    std::optional<ScriptCache::Template> noLiterals =
+        ScriptCache::createTemplate("openspace.time.togglePause()");
+    REQUIRE(noLiterals.has_value());
+    CHECK(noLiterals->text == "openspace.time.togglePause()");
+    CHECK(noLiterals->parameters.empty());
+}
+
+TEST_CASE("ScriptCache: Template Unsupported", "[scriptcache]") {
+    // Comments
+    CHECK_FALSE(ScriptCache::createTemplate("f(1) -- comment").has_value());
+    // Long strings
+    CHECK_FALSE(ScriptCache::createTemplate("f([[abc]])").has_value());
+    CHECK_FALSE(ScriptCache::createTemplate("f([==[abc]==])").has_value());
+    // Escape sequences
+    CHECK_FALSE(ScriptCache::createTemplate("f('a\\'b')").has_value());
+    // String call syntax
+    CHECK_FALSE(ScriptCache::createTemplate("f'abc'").has_value());
+    CHECK_FALSE(ScriptCache::createTemplate("f('a')'b'").has_value());
+    // Malformed numbers
+    CHECK_FALSE(ScriptCache::createTemplate("return 1..2").has_value());
+    CHECK_FALSE(ScriptCache::createTemplate("return 3x").has_value());
+    // Unterminated strings
+    CHECK_FALSE(ScriptCache::createTemplate("f('abc)").has_value());
+    // Clashing names
+    CHECK_FALSE(ScriptCache::createTemplate("__osp1 = 1").has_value());
+
+    // Keywords do not indicate a string call
+    CHECK(ScriptCache::createTemplate("return 'abc'").has_value());
+}
+
+TEST_CASE("ScriptCache: Execution", "[scriptcache]") {
+    ghoul::lua::LuaState state;
+    ScriptCache cache = ScriptCache(2);
+
+    auto run = [&](const std::string& script) {
+        const int nParameters = cache.load(state, script);
+        REQUIRE(lua_pcall(state, nParameters, 1, 0) == LUA_OK);
+        const double value = lua_tonumber(state, -1);
+        lua_pop(state, 1);
+        return value;
+    };
+
+    CHECK(run("return 1 + 2") == 3.0);
+    CHECK(cache.nMisses() == 1);
+    CHECK(run("return 2 + 5") == 7.0);
+    CHECK(cache.nHits() == 1);
+    CHECK(run("return #'abcd' * 0x10") == 64.0);
+    CHECK(cache.nMisses() == 2);
+
+    // Evicts the least recently used script
+    CHECK(run("return 1") == 1.0);
+    CHECK(cache.size() == 2);
+    CHECK(run("return 3 + 4") == 7.0);
+    CHECK(cache.nMisses() == 4);
+
+    cache.setCapacity(state, 1);
+    CHECK(cache.size() == 1);
+
+    CHECK_THROWS_AS(cache.load(state, "return 1 +"), ghoul::lua::LuaLoadingException);
+    CHECK(lua_gettop(state) == 0);
+
+    cache.clear(state);
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("ScriptCache: Template Errors", "[scriptcache]") {
+    ghoul::lua::LuaState state;
+    ScriptCache cache = ScriptCache(2);
+
+    auto error = [&](const std::string& script) {
+        const int nParameters = cache.load(state, script);
+        REQUIRE(lua_pcall(state, nParameters, 0, 0) != LUA_OK);
+        const std::string message = lua_tostring(state, -1);
+        lua_pop(state, 1);
+        return message;
+    };
+
+    // Both scripts share the same template, so the second one must not be reported
+    // with the text of the first one
+    CHECK(error("error('first')") == "[templated script]:1: first");
+    CHECK(error("error('second')") == "[templated script]:1: second");
+    CHECK(cache.nHits() == 1);
+
+    // Scripts without literals are not shared and keep their own text as the name
+    const std::string message = error("error(nil .. nil)");
+    CHECK(message.find("error(nil .. nil)") != std::string::npos);
+}
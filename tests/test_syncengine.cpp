@@ -0,0 +1,181 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/engine/syncengine.h>
+#include <openspace/util/syncable.h>
+#include <openspace/util/syncbuffer.h>
+#include <openspace/util/syncdata.h>
+#include <limits>
+#include <string>
+
+namespace {
+    struct Counter : public openspace::Syncable {
+        void encode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->encode(value);
+            nEncoded++;
+        }
+
+        void decode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->decode(value);
+            nDecoded++;
+        }
+
+        bool isDirty() const override {
+            return dirty;
+        }
+
+        int value = 0;
+        bool dirty = false;
+        int nEncoded = 0;
+        int nDecoded = 0;
+    };
+} // namespace
+
+TEST_CASE("SyncBuffer: Varint", "[syncengine]") {
+    using namespace openspace;
+
+    const std::vector<uint64_t> values = {
+        0, 1, 127, 128, 300, 16383, 16384, std::numeric_limits<uint32_t>::max(),
+        std::numeric_limits<uint64_t>::max()
+    };
+
+    SyncBuffer encoder(16);
+    for (uint64_t v : values) {
+        encoder.encodeVarint(v);
+    }
+    encoder.encode(std::string("OpenSpace"));
+    encoder.encode(std::string());
+    CHECK(encoder.encodedSize() == 1 + 1 + 1 + 2 + 2 + 2 + 3 + 5 + 10 + 1 + 9 + 1);
+
+    SyncBuffer decoder(16);
+    decoder.setData(encoder.data());
+    for (uint64_t v : values) {
+        CHECK(decoder.decodeVarint() == v);
+    }
+    CHECK(decoder.decode() == "OpenSpace");
+    CHECK(decoder.decode().empty());
+}
+
+TEST_CASE("SyncEngine: Delta Frames", "[syncengine]") {
+    using namespace openspace;
+
+    SyncEngine master = SyncEngine(64, 3);
+    SyncEngine client = SyncEngine(64, 3);
+
+    Counter masterA;
+    Counter masterB;
+    master.addSyncables({ &masterA, &masterB });
+    Counter clientA;
+    Counter clientB;
+    client.addSyncables({ &clientA, &clientB });
+
+    // The first frame is always a keyframe that contains all Syncables
+    masterA.value = 1;
+    masterB.value = 2;
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK(master.lastFrameStatistics().isKeyframe);
+    CHECK(master.lastFrameStatistics().nEncodedSyncables == 2);
+    CHECK(clientA.value == 1);
+    CHECK(clientB.value == 2);
+
+    // Delta frames only contain the Syncables that are dirty
+    masterB.value = 3;
+    masterB.dirty = true;
+    const std::vector<std::byte> delta = master.encodeSyncables();
+    client.decodeSyncables(delta);
+    CHECK_FALSE(master.lastFrameStatistics().isKeyframe);
+    CHECK(master.lastFrameStatistics().nEncodedSyncables == 1);
+    CHECK(master.lastFrameStatistics().nBytes == delta.size());
+    CHECK(clientA.nDecoded == 1);
+    CHECK(clientB.nDecoded == 2);
+    CHECK(clientB.value == 3);
+
+    masterB.dirty = false;
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK(master.lastFrameStatistics().nEncodedSyncables == 0);
+    CHECK(client.lastFrameStatistics().nEncodedSyncables == 0);
+    CHECK(clientB.nDecoded == 2);
+
+    // Every third frame is a keyframe again
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK(master.lastFrameStatistics().isKeyframe);
+    CHECK(client.lastFrameStatistics().isKeyframe);
+    CHECK(clientA.nDecoded == 2);
+    CHECK(clientB.nDecoded == 3);
+
+    // Changing the list of Syncables forces a keyframe
+    master.encodeSyncables();
+    CHECK_FALSE(master.lastFrameStatistics().isKeyframe);
+    master.removeSyncable(&masterB);
+    master.encodeSyncables();
+    CHECK(master.lastFrameStatistics().isKeyframe);
+    CHECK(master.lastFrameStatistics().nSyncables == 1);
+}
+
+TEST_CASE("SyncEngine: Mismatched Syncables", "[syncengine]") {
+    using namespace openspace;
+
+    SyncEngine master = SyncEngine(64);
+    SyncEngine client = SyncEngine(64);
+
+    Counter masterA;
+    masterA.value = 5;
+    master.addSyncable(&masterA);
+    Counter clientA;
+    Counter clientB;
+    client.addSyncables({ &clientA, &clientB });
+
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK(clientA.nDecoded == 0);
+    CHECK(clientB.nDecoded == 0);
+}
+
+TEST_CASE("SyncEngine: SyncData", "[syncengine]") {
+    using namespace openspace;
+
+    SyncEngine master = SyncEngine(64, 100);
+    SyncEngine client = SyncEngine(64, 100);
+
+    SyncData<double> masterValue = 1.0;
+    master.addSyncable(&masterValue);
+    SyncData<double> clientValue = 0.0;
+    client.addSyncable(&clientValue);
+
+    client.decodeSyncables(master.encodeSyncables());
+    client.postSynchronization(SyncEngine::IsMaster::No);
+    CHECK(clientValue.data() == 1.0);
+
+    // Unchanged values are not transmitted, but the client keeps the last value
+    client.decodeSyncables(master.encodeSyncables());
+    client.postSynchronization(SyncEngine::IsMaster::No);
+    CHECK(master.lastFrameStatistics().nEncodedSyncables == 0);
+    CHECK(clientValue.data() == 1.0);
+
+    masterValue = 2.0;
+    client.decodeSyncables(master.encodeSyncables());
+    client.postSynchronization(SyncEngine::IsMaster::No);
+    CHECK(master.lastFrameStatistics().nEncodedSyncables == 1);
+    CHECK(clientValue.data() == 2.0);
+}
@@ -0,0 +1,231 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <openspace/util/taskscheduler.h>
+#include <openspace/util/threadpool.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+TEST_CASE("TaskScheduler: Enqueue", "[taskscheduler]") {
+    using namespace openspace;
+
+    std::atomic_int counter = 0;
+    {
+        TaskScheduler scheduler(4);
+        TaskScheduler::TaskGroup group(scheduler);
+        for (int i = 0; i < 1000; i++) {
+            group.run([&counter]() { counter++; });
+        }
+        group.wait();
+        CHECK(counter == 1000);
+        CHECK_FALSE(scheduler.hasOutstandingTasks());
+    }
+}
+
+TEST_CASE("TaskScheduler: Nested Tasks", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskScheduler scheduler(2);
+    std::atomic_int counter = 0;
+
+    TaskScheduler::TaskGroup outer(scheduler);
+    for (int i = 0; i < 16; i++) {
+        outer.run([&scheduler, &counter]() {
+            // Waiting inside a task must not deadlock even with fewer workers than tasks
+            TaskScheduler::TaskGroup inner(scheduler);
+            for (int j = 0; j < 16; j++) {
+                inner.run([&counter]() { counter++; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    CHECK(counter == 16 * 16);
+}
+
+TEST_CASE("TaskScheduler: Exception", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskScheduler scheduler(1);
+    std::atomic_int counter = 0;
+
+    TaskScheduler::TaskGroup group(scheduler);
+    group.run([]() { throw std::runtime_error("Expected exception"); });
+    group.run([&counter]() { counter++; });
+    // The exception is passed on to the waiting thread after all tasks have finished
+    CHECK_THROWS_AS(group.wait(), std::runtime_error);
+    CHECK(counter == 1);
+
+    // The exception is only reported once
+    group.run([&counter]() { counter++; });
+    group.wait();
+    CHECK(counter == 2);
+}
+
+TEST_CASE("TaskScheduler: Nested Exception", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskScheduler scheduler(2);
+
+    TaskScheduler::TaskGroup outer(scheduler);
+    outer.run([&scheduler]() {
+        TaskScheduler::TaskGroup inner(scheduler);
+        inner.run([]() { throw std::runtime_error("Expected exception"); });
+        inner.wait();
+    });
+    CHECK_THROWS_AS(outer.wait(), std::runtime_error);
+}
+
+TEST_CASE("TaskScheduler: Submitted Tasks Run Concurrently", "[taskscheduler]") {
+    using namespace openspace;
+
+    // Tasks that are submitted from outside of the scheduler must be spread over the
+    // workers, so all of them have to be running at the same time at some point
+    TaskScheduler scheduler(4);
+    std::atomic_int nRunning = 0;
+    std::atomic_int maxRunning = 0;
+
+    TaskScheduler::TaskGroup group(scheduler);
+    for (int i = 0; i < 64; i++) {
+        group.run([&nRunning, &maxRunning]() {
+            const int n = ++nRunning;
+            int prev = maxRunning;
+            while (n > prev && !maxRunning.compare_exchange_weak(prev, n)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            nRunning--;
+        });
+    }
+    group.wait();
+    CHECK(maxRunning > 1);
+}
+
+TEST_CASE("TaskScheduler: Clear Tasks", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskScheduler scheduler(1);
+    std::atomic_bool release = false;
+    std::atomic_int counter = 0;
+
+    TaskScheduler::TaskGroup group(scheduler);
+    // Block the only worker so that the remaining tasks stay queued
+    group.run([&release]() {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    for (int i = 0; i < 10; i++) {
+        group.run([&counter]() { counter++; });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    scheduler.clearTasks();
+    release = true;
+    group.wait();
+
+    CHECK(counter < 10);
+    CHECK_FALSE(scheduler.hasOutstandingTasks());
+}
+
+TEST_CASE("TaskScheduler: Wait Only Runs Own Tasks", "[taskscheduler]") {
+    using namespace openspace;
+
+    TaskScheduler scheduler(1);
+    std::atomic_bool isBlocking = false;
+    std::atomic_bool release = false;
+
+    // Block the only worker so that the waiting thread has to run the tasks itself
+    scheduler.enqueue([&isBlocking, &release]() {
+        isBlocking = true;
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!isBlocking) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::atomic<std::thread::id> otherThread;
+    TaskScheduler::TaskGroup other(scheduler);
+    other.run([&otherThread]() { otherThread = std::this_thread::get_id(); });
+
+    std::atomic<std::thread::id> ownThread;
+    TaskScheduler::TaskGroup group(scheduler);
+    group.run([&ownThread]() { ownThread = std::this_thread::get_id(); });
+    group.wait();
+    CHECK(ownThread.load() == std::this_thread::get_id());
+    CHECK(otherThread.load() == std::thread::id());
+
+    release = true;
+    other.wait();
+    CHECK(otherThread.load() != std::thread::id());
+}
+
+TEST_CASE("TaskScheduler: Throughput", "[taskscheduler][.benchmark]") {
+    using namespace openspace;
+
+    constexpr int NTasks = 10000;
+
+    BENCHMARK("ThreadPool") {
+        std::atomic_int counter = 0;
+        ThreadPool pool(4);
+        for (int i = 0; i < NTasks; i++) {
+            pool.enqueue([&counter]() { counter++; });
+        }
+        while (counter < NTasks) {
+            std::this_thread::yield();
+        }
+        return counter.load();
+    };
+
+    BENCHMARK("TaskScheduler") {
+        std::atomic_int counter = 0;
+        TaskScheduler scheduler(4);
+        TaskScheduler::TaskGroup group(scheduler);
+        for (int i = 0; i < NTasks; i++) {
+            group.run([&counter]() { counter++; });
+        }
+        group.wait();
+        return counter.load();
+    };
+
+    BENCHMARK("TaskScheduler (nested)") {
+        std::atomic_int counter = 0;
+        TaskScheduler scheduler(4);
+        TaskScheduler::TaskGroup group(scheduler);
+        for (int i = 0; i < NTasks / 100; i++) {
+            group.run([&scheduler, &counter]() {
+                TaskScheduler::TaskGroup inner(scheduler);
+                for (int j = 0; j < 100; j++) {
+                    inner.run([&counter]() { counter++; });
+                }
+            });
+        }
+        group.wait();
+        return counter.load();
+    };
+}
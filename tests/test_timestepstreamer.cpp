@@ -0,0 +1,187 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_VOLUME_ENABLED
+#include <modules/volume/timestepstreamer.h>
+#include <openspace/util/taskscheduler.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+TEST_CASE("TimestepStreamer: Prefetch", "[timestepstreamer]") {
+    using namespace openspace::volume;
+
+    openspace::TaskScheduler scheduler;
+    std::atomic_int nLoads = 0;
+    TimestepStreamer<size_t> streamer(
+        scheduler,
+        100,
+        4,
+        2,
+        [&nLoads](size_t index) {
+            nLoads++;
+            return std::make_shared<size_t>(index);
+        }
+    );
+
+    streamer.update(10, true);
+    CHECK(nLoads + streamer.nLoading() >= 3);
+    REQUIRE(streamer.waitForTimestep(10));
+    CHECK(*streamer.waitForTimestep(10) == 10);
+    CHECK(*streamer.waitForTimestep(11) == 11);
+    CHECK(*streamer.waitForTimestep(12) == 12);
+    CHECK(nLoads == 3);
+
+    // Resident timesteps are not loaded again
+    streamer.update(10, true);
+    CHECK(streamer.nLoading() == 0);
+    CHECK(nLoads == 3);
+
+    // Moving backwards prefetches the preceding timesteps and evicts the least recently
+    // used ones
+    streamer.update(10, false);
+    CHECK(*streamer.waitForTimestep(9) == 9);
+    CHECK(*streamer.waitForTimestep(8) == 8);
+    CHECK(nLoads == 5);
+    CHECK(streamer.timestep(10));
+    CHECK_FALSE(streamer.timestep(11));
+}
+
+TEST_CASE("TimestepStreamer: Failed Timesteps", "[timestepstreamer]") {
+    using namespace openspace::volume;
+
+    openspace::TaskScheduler scheduler;
+    std::atomic_int nLoads = 0;
+    TimestepStreamer<size_t> streamer(
+        scheduler,
+        10,
+        2,
+        0,
+        [&nLoads](size_t index) -> std::shared_ptr<size_t> {
+            nLoads++;
+            return index == 5 ? nullptr : std::make_shared<size_t>(index);
+        }
+    );
+
+    CHECK_FALSE(streamer.waitForTimestep(5));
+    CHECK_FALSE(streamer.waitForTimestep(5));
+    streamer.update(5, true);
+    CHECK(streamer.nLoading() == 0);
+    CHECK(nLoads == 1);
+
+    CHECK(*streamer.waitForTimestep(9) == 9);
+}
+
+TEST_CASE("TimestepStreamer: Capacity", "[timestepstreamer]") {
+    using namespace openspace::volume;
+
+    // The loads are held back until released to simulate the window moving faster than
+    // the timesteps can be loaded
+    openspace::TaskScheduler scheduler(4);
+    std::atomic_int nLoads = 0;
+    std::atomic_bool isReleased = false;
+    TimestepStreamer<size_t> streamer(
+        scheduler,
+        100,
+        3,
+        2,
+        [&nLoads, &isReleased](size_t index) {
+            while (!isReleased) {
+                std::this_thread::yield();
+            }
+            nLoads++;
+            return std::make_shared<size_t>(index);
+        }
+    );
+
+    streamer.update(0, true);
+    CHECK(streamer.nLoading() == 3);
+
+    // The loads of the previous window occupy the memory, so nothing else is loaded
+    streamer.update(10, true);
+    CHECK(streamer.nLoading() == 3);
+
+    isReleased = true;
+    while (streamer.nLoading() > 0) {
+        streamer.update(10, true);
+        std::this_thread::yield();
+    }
+
+    // The results of the previous window are discarded once they arrive
+    CHECK(nLoads == 6);
+    CHECK_FALSE(streamer.timestep(0));
+    CHECK_FALSE(streamer.timestep(1));
+    CHECK_FALSE(streamer.timestep(2));
+    CHECK(streamer.timestep(10));
+    CHECK(streamer.timestep(11));
+    CHECK(streamer.timestep(12));
+}
+
+TEST_CASE("TimestepStreamer: Stale Loads", "[timestepstreamer]") {
+    using namespace openspace::volume;
+
+    openspace::TaskScheduler scheduler(4);
+    std::atomic_bool isReleased = true;
+    TimestepStreamer<size_t> streamer(
+        scheduler,
+        100,
+        4,
+        1,
+        [&isReleased](size_t index) {
+            while (!isReleased) {
+                std::this_thread::yield();
+            }
+            return std::make_shared<size_t>(index);
+        }
+    );
+
+    streamer.update(20, true);
+    CHECK(*streamer.waitForTimestep(20) == 20);
+    CHECK(*streamer.waitForTimestep(21) == 21);
+
+    // Scrub away and back while the loads are held back. The timesteps of the current
+    // window are loaded in place of the resident timesteps that are no longer needed
+    isReleased = false;
+    streamer.update(5, true);
+    CHECK(streamer.nLoading() == 2);
+    streamer.update(40, true);
+    CHECK(streamer.nLoading() == 4);
+    CHECK_FALSE(streamer.timestep(20));
+    CHECK_FALSE(streamer.timestep(21));
+
+    isReleased = true;
+    while (streamer.nLoading() > 0) {
+        streamer.update(40, true);
+        std::this_thread::yield();
+    }
+
+    // The stale loads did not evict the timesteps of the current window
+    CHECK_FALSE(streamer.timestep(5));
+    CHECK_FALSE(streamer.timestep(6));
+    CHECK(*streamer.timestep(40) == 40);
+    CHECK(*streamer.timestep(41) == 41);
+}
+#endif // OPENSPACE_MODULE_VOLUME_ENABLED